@@ -0,0 +1,27 @@
+#!/bin/sh
+#
+# Run all engine benchmarks and store their results as QTestLib XML
+# (one <name>.xml per benchmark) into the given directory, so that they
+# can be compared between builds. Usage: bench.sh [result directory]
+#
+
+RESULTDIR=${1:-results}
+mkdir -p ${RESULTDIR}
+RESULTDIR=`cd ${RESULTDIR} && pwd`
+
+export LD_LIBRARY_PATH=../../src
+export DYLD_FALLBACK_LIBRARY_PATH=../../src
+
+RESULT=0
+for bench in playback workspace
+do
+    cd `dirname $0`/${bench}
+    ./${bench}_bench -xml -o ${RESULTDIR}/${bench}.xml
+    if [ ${?} != 0 ]; then
+        echo "${bench} benchmark failed"
+        RESULT=1
+    fi
+    cd - > /dev/null
+done
+
+exit ${RESULT}
@@ -0,0 +1,140 @@
+/*
+  Q Light Controller - Benchmarks
+  benchworkspace.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QStringList>
+#include <QDebug>
+#include <QSize>
+#include <QDir>
+#include <cmath>
+
+#include "qlcfixturedefcache.h"
+#include "benchworkspace.h"
+#include "qlcfixturemode.h"
+#include "qlcfixturedef.h"
+#include "fixturegroup.h"
+#include "rgbalgorithm.h"
+#include "rgbmatrix.h"
+#include "rgbscript.h"
+#include "qlcfile.h"
+#include "fixture.h"
+#include "chaser.h"
+#include "scene.h"
+#include "doc.h"
+
+bool BenchWorkspace::loadDefinitions(Doc* doc)
+{
+    QDir dir(INTERNAL_FIXTUREDIR);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtFixture));
+    if (doc->fixtureDefCache()->load(dir) == false)
+        return false;
+
+    RGBScript::setCustomScriptDirectory(INTERNAL_SCRIPTDIR);
+    return true;
+}
+
+void BenchWorkspace::create(Doc* doc, int fixtures, int scenes, int chasers, int matrices)
+{
+    const QLCFixtureDef* def = doc->fixtureDefCache()->fixtureDef("Stairville", "LED PAR56");
+    Q_ASSERT(def != NULL);
+    const QLCFixtureMode* mode = def->modes().first();
+    Q_ASSERT(mode != NULL);
+
+    /* Fixtures */
+    QList <quint32> fixtureIds;
+    quint32 address = 0;
+    for (int i = 0; i < fixtures; i++)
+    {
+        Fixture* fxi = new Fixture(doc);
+        fxi->setName(QString("Fixture %1").arg(i));
+        fxi->setFixtureDefinition(def, mode);
+
+        /* Don't let a fixture span two universes */
+        if ((address % 512) + fxi->channels() > 512)
+            address += 512 - (address % 512);
+        fxi->setUniverse(address / 512);
+        fxi->setAddress(address % 512);
+        address += fxi->channels();
+
+        if (doc->addFixture(fxi) == true)
+            fixtureIds << fxi->id();
+        else
+            delete fxi;
+    }
+
+    Q_ASSERT(fixtureIds.isEmpty() == false);
+
+    /* Scenes */
+    QList <quint32> sceneIds;
+    int perScene = qMin(fixtureIds.size(), 32);
+    for (int i = 0; i < scenes; i++)
+    {
+        Scene* s = new Scene(doc);
+        s->setName(QString("Scene %1").arg(i));
+        for (int j = 0; j < perScene; j++)
+        {
+            quint32 fxi = fixtureIds.at((i * perScene + j) % fixtureIds.size());
+            for (quint32 ch = 0; ch < quint32(mode->channels().size()); ch++)
+                s->setValue(fxi, ch, uchar((i + j + ch) % 256));
+        }
+
+        doc->addFunction(s);
+        sceneIds << s->id();
+    }
+
+    /* Chasers */
+    for (int i = 0; i < chasers && sceneIds.isEmpty() == false; i++)
+    {
+        Chaser* c = new Chaser(doc);
+        c->setName(QString("Chaser %1").arg(i));
+        for (int j = 0; j < 16; j++)
+            c->addStep(ChaserStep(sceneIds.at((i * 16 + j) % sceneIds.size()), 0, 0, 500));
+        doc->addFunction(c);
+    }
+
+    /* Pixel matrices */
+    if (matrices > 0)
+    {
+        int side = int(ceil(sqrt(qreal(fixtureIds.size()))));
+        FixtureGroup* grp = new FixtureGroup(doc);
+        grp->setName("Matrix");
+        grp->setSize(QSize(side, side));
+        doc->addFixtureGroup(grp);
+        foreach (quint32 id, fixtureIds)
+            grp->assignFixture(id);
+
+        QStringList algorithms(RGBAlgorithm::algorithms());
+        for (int i = 0; i < matrices; i++)
+        {
+            RGBMatrix* mtx = new RGBMatrix(doc);
+            mtx->setName(QString("Matrix %1").arg(i));
+            mtx->setFixtureGroup(grp->id());
+            mtx->setAlgorithm(RGBAlgorithm::algorithm(algorithms.at(i % algorithms.size())));
+            doc->addFunction(mtx);
+        }
+    }
+}
+
+QString BenchWorkspace::name(int fixtures, int scenes, int chasers, int matrices)
+{
+    return QString("%1fx-%2sc-%3ch-%4mx").arg(fixtures).arg(scenes)
+                                         .arg(chasers).arg(matrices);
+}
@@ -0,0 +1,63 @@
+/*
+  Q Light Controller - Benchmarks
+  benchworkspace.h
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#ifndef BENCHWORKSPACE_H
+#define BENCHWORKSPACE_H
+
+#include <QString>
+
+class Doc;
+
+#define INTERNAL_FIXTUREDIR "../../../fixtures/"
+#define INTERNAL_SCRIPTDIR "../../../rgbscripts/"
+
+/** Number of output universes in benchmark documents */
+#define KBenchUniverses 16
+
+/**
+ * BenchWorkspace fills a Doc with a synthetic workspace of the given size,
+ * so that benchmarks can measure how things scale with large shows. The
+ * contents are deterministic, so results are comparable between runs.
+ */
+class BenchWorkspace
+{
+public:
+    /** Load fixture definitions and RGB scripts from the source tree */
+    static bool loadDefinitions(Doc* doc);
+
+    /**
+     * Create a synthetic workspace
+     *
+     * @param doc The document to fill; should have KBenchUniverses universes
+     * @param fixtures Number of RGB fixtures, patched one after another
+     * @param scenes Number of scenes, each one setting all channels of up
+     *               to 32 fixtures
+     * @param chasers Number of chasers, each one with 16 scene steps
+     * @param matrices Number of RGB matrices, all running on one fixture
+     *                 group that contains all of the fixtures
+     */
+    static void create(Doc* doc, int fixtures, int scenes, int chasers, int matrices);
+
+    /** Get a name for the given size, for benchmark data tags */
+    static QString name(int fixtures, int scenes, int chasers, int matrices);
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*
+  Q Light Controller - Benchmarks
+  playback_bench.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QtTest>
+
+#include "playback_bench.h"
+#include "benchworkspace.h"
+#include "qlcfixturemode.h"
+#include "qlcfixturedef.h"
+#include "universearray.h"
+#include "genericfader.h"
+#include "fadechannel.h"
+#include "efxfixture.h"
+#include "qlcchannel.h"
+#include "rgbmatrix.h"
+#include "fixture.h"
+#include "qlcfile.h"
+#include "chaser.h"
+#include "efx.h"
+
+#define private public
+#include "mastertimer.h"
+#undef private
+
+#define protected public
+#include "outputmap.h"
+#include "doc.h"
+#undef protected
+
+#define OUTPUT_TESTPLUGINDIR "../../test/outputpluginstub"
+
+/** Number of universes provided by the output plugin stub */
+#define KStubUniverses 4
+
+void Playback_Bench::init()
+{
+    m_doc = new Doc(this, KBenchUniverses);
+    QVERIFY(BenchWorkspace::loadDefinitions(m_doc) == true);
+}
+
+void Playback_Bench::cleanup()
+{
+    delete m_doc;
+    m_doc = NULL;
+}
+
+void Playback_Bench::fixtureCounts()
+{
+    QTest::addColumn <int> ("fixtures");
+
+    QTest::newRow("16fx") << 16;
+    QTest::newRow("128fx") << 128;
+    QTest::newRow("1024fx") << 1024;
+}
+
+/****************************************************************************
+ * Single components
+ ****************************************************************************/
+
+void Playback_Bench::universeArrayWrite_data()
+{
+    QTest::addColumn <int> ("group");
+
+    QTest::newRow("HTP") << int(QLCChannel::Intensity);
+    QTest::newRow("LTP") << int(QLCChannel::Pan);
+}
+
+void Playback_Bench::universeArrayWrite()
+{
+    QFETCH(int, group);
+
+    UniverseArray ua(KBenchUniverses * 512);
+    QLCChannel::Group grp = QLCChannel::Group(group);
+    uchar value = 0;
+
+    /* One tick's worth of writes to every channel */
+    QBENCHMARK
+    {
+        ua.zeroIntensityChannels();
+        for (int i = 0; i < ua.size(); i++)
+            ua.write(i, value, grp);
+        value++;
+    }
+}
+
+void Playback_Bench::genericFaderWrite_data()
+{
+    fixtureCounts();
+}
+
+void Playback_Bench::genericFaderWrite()
+{
+    QFETCH(int, fixtures);
+    BenchWorkspace::create(m_doc, fixtures, 0, 0, 0);
+
+    GenericFader fader(m_doc);
+    foreach (Fixture* fxi, m_doc->fixtures())
+    {
+        for (quint32 ch = 0; ch < fxi->channels(); ch++)
+        {
+            /* A fade that doesn't finish during the benchmark */
+            FadeChannel fc;
+            fc.setFixture(fxi->id());
+            fc.setChannel(ch);
+            fc.setStart(0);
+            fc.setTarget(255);
+            fc.setFadeTime(UINT_MAX / 2);
+            fader.add(fc);
+        }
+    }
+
+    UniverseArray ua(KBenchUniverses * 512);
+    QBENCHMARK
+    {
+        fader.write(&ua);
+    }
+}
+
+void Playback_Bench::rgbMatrixWrite_data()
+{
+    fixtureCounts();
+}
+
+void Playback_Bench::rgbMatrixWrite()
+{
+    QFETCH(int, fixtures);
+    BenchWorkspace::create(m_doc, fixtures, 0, 0, 1);
+
+    RGBMatrix* mtx = NULL;
+    foreach (Function* function, m_doc->functions())
+    {
+        if (function->type() == Function::RGBMatrix)
+            mtx = qobject_cast<RGBMatrix*> (function);
+    }
+    QVERIFY(mtx != NULL);
+
+    /* Step on every tick, so that a new map is computed each time */
+    mtx->setDuration(MasterTimer::tick());
+
+    MasterTimer* timer = m_doc->masterTimer();
+    UniverseArray ua(KBenchUniverses * 512);
+    mtx->preRun(timer);
+
+    QBENCHMARK
+    {
+        mtx->write(timer, &ua);
+    }
+
+    mtx->postRun(timer, &ua);
+}
+
+void Playback_Bench::efxWrite_data()
+{
+    fixtureCounts();
+}
+
+void Playback_Bench::efxWrite()
+{
+    QFETCH(int, fixtures);
+
+    const QLCFixtureDef* def = m_doc->fixtureDefCache()->fixtureDef("Futurelight", "DJScan250");
+    QVERIFY(def != NULL);
+    const QLCFixtureMode* mode = def->mode("Mode 1");
+    QVERIFY(mode != NULL);
+
+    EFX* efx = new EFX(m_doc);
+    efx->setDuration(UINT_MAX / 2);
+    m_doc->addFunction(efx);
+
+    quint32 address = 0;
+    for (int i = 0; i < fixtures; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setFixtureDefinition(def, mode);
+        if ((address % 512) + fxi->channels() > 512)
+            address += 512 - (address % 512);
+        fxi->setUniverse(address / 512);
+        fxi->setAddress(address % 512);
+        address += fxi->channels();
+        QVERIFY(m_doc->addFixture(fxi) == true);
+
+        EFXFixture* ef = new EFXFixture(efx);
+        ef->setFixture(fxi->id());
+        QVERIFY(efx->addFixture(ef) == true);
+    }
+
+    MasterTimer* timer = m_doc->masterTimer();
+    UniverseArray ua(KBenchUniverses * 512);
+    efx->preRun(timer);
+
+    QBENCHMARK
+    {
+        efx->write(timer, &ua);
+    }
+
+    efx->postRun(timer, &ua);
+}
+
+/****************************************************************************
+ * Whole engine
+ ****************************************************************************/
+
+void Playback_Bench::timerTick_data()
+{
+    QTest::addColumn <int> ("fixtures");
+    QTest::addColumn <int> ("chasers");
+    QTest::addColumn <int> ("matrices");
+
+    /* All of these must fit into the universes of the output plugin stub */
+    QTest::newRow("16fx-4ch-1mx") << 16 << 4 << 1;
+    QTest::newRow("128fx-32ch-4mx") << 128 << 32 << 4;
+    QTest::newRow("384fx-128ch-8mx") << 384 << 128 << 8;
+}
+
+void Playback_Bench::timerTick()
+{
+    QFETCH(int, fixtures);
+    QFETCH(int, chasers);
+    QFETCH(int, matrices);
+
+    /* Route everything thru the output plugin stub, like real hardware */
+    QDir dir(OUTPUT_TESTPLUGINDIR);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtPlugin));
+    m_doc->outputMap()->loadPlugins(dir);
+    QVERIFY(m_doc->outputMap()->pluginNames().size() == 1);
+    QString plugin(m_doc->outputMap()->pluginNames().first());
+    for (quint32 i = 0; i < KStubUniverses; i++)
+        QVERIFY(m_doc->outputMap()->setPatch(i, plugin, i) == true);
+
+    BenchWorkspace::create(m_doc, fixtures, chasers * 4, chasers, matrices);
+
+    /* Run every chaser & matrix, as in a busy show */
+    MasterTimer* timer = m_doc->masterTimer();
+    foreach (Function* function, m_doc->functions())
+    {
+        if (function->type() == Function::Chaser || function->type() == Function::RGBMatrix)
+            function->start(timer);
+    }
+
+    QBENCHMARK
+    {
+        timer->timerTick();
+    }
+
+    /* MasterTimer's own thread isn't running, so stop the functions by
+       ticking instead of stopAllFunctions(), which would wait forever */
+    timer->m_stopAllFunctions = true;
+    while (timer->runningFunctions() > 0)
+        timer->timerTick();
+    timer->m_stopAllFunctions = false;
+}
+
+QTEST_MAIN(Playback_Bench)
@@ -0,0 +1,55 @@
+/*
+  Q Light Controller - Benchmarks
+  playback_bench.h
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#ifndef PLAYBACK_BENCH_H
+#define PLAYBACK_BENCH_H
+
+#include <QObject>
+
+class Doc;
+
+class Playback_Bench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void universeArrayWrite_data();
+    void universeArrayWrite();
+    void genericFaderWrite_data();
+    void genericFaderWrite();
+    void rgbMatrixWrite_data();
+    void rgbMatrixWrite();
+    void efxWrite_data();
+    void efxWrite();
+    void timerTick_data();
+    void timerTick();
+
+private:
+    void fixtureCounts();
+
+private:
+    Doc* m_doc;
+};
+
+#endif
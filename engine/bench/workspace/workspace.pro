@@ -0,0 +1,17 @@
+include(../../../variables.pri)
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = workspace_bench
+
+QT      += testlib xml script
+CONFIG  -= app_bundle
+
+DEPENDPATH   += ../../src
+INCLUDEPATH  += ../../../plugins/interfaces
+INCLUDEPATH  += ../../src
+INCLUDEPATH  += ../common
+QMAKE_LIBDIR += ../../src
+LIBS         += -lqlcengine
+
+SOURCES += workspace_bench.cpp ../common/benchworkspace.cpp
+HEADERS += workspace_bench.h ../common/benchworkspace.h
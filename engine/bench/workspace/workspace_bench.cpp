@@ -0,0 +1,235 @@
+/*
+  Q Light Controller - Benchmarks
+  workspace_bench.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
+#include <QBuffer>
+#include <QtTest>
+#include <QtXml>
+
+#include "workspace_bench.h"
+#include "benchworkspace.h"
+#include "doc.h"
+
+void Workspace_Bench::initTestCase()
+{
+    m_doc = NULL;
+}
+
+void Workspace_Bench::init()
+{
+    m_doc = new Doc(this, KBenchUniverses);
+    QVERIFY(BenchWorkspace::loadDefinitions(m_doc) == true);
+}
+
+void Workspace_Bench::cleanup()
+{
+    delete m_doc;
+    m_doc = NULL;
+}
+
+void Workspace_Bench::sizes()
+{
+    QTest::addColumn <int> ("fixtures");
+    QTest::addColumn <int> ("scenes");
+    QTest::addColumn <int> ("chasers");
+    QTest::addColumn <int> ("matrices");
+
+    QList <QList <int> > sizes;
+    sizes << (QList <int> () << 64 << 100 << 10 << 2);
+    sizes << (QList <int> () << 256 << 1000 << 100 << 8);
+    sizes << (QList <int> () << 1024 << 5000 << 500 << 32);
+
+    foreach (QList <int> size, sizes)
+    {
+        QString name(BenchWorkspace::name(size[0], size[1], size[2], size[3]));
+        QTest::newRow(name.toAscii().constData()) << size[0] << size[1] << size[2] << size[3];
+    }
+}
+
+void Workspace_Bench::createWorkspace()
+{
+    QFETCH(int, fixtures);
+    QFETCH(int, scenes);
+    QFETCH(int, chasers);
+    QFETCH(int, matrices);
+
+    BenchWorkspace::create(m_doc, fixtures, scenes, chasers, matrices);
+}
+
+QByteArray Workspace_Bench::engineXML()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter xml(&buffer);
+    m_doc->saveXML(xml);
+    return data;
+}
+
+/****************************************************************************
+ * Save
+ ****************************************************************************/
+
+void Workspace_Bench::saveXMLDom_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::saveXMLDom()
+{
+    createWorkspace();
+
+    QBENCHMARK
+    {
+        QDomDocument doc;
+        QDomElement root = doc.createElement("Workspace");
+        doc.appendChild(root);
+        m_doc->saveXML(&doc, &root);
+        QByteArray data(doc.toByteArray(1));
+        Q_UNUSED(data);
+    }
+}
+
+void Workspace_Bench::saveXMLStream_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::saveXMLStream()
+{
+    createWorkspace();
+
+    QBENCHMARK
+    {
+        QByteArray data(engineXML());
+        Q_UNUSED(data);
+    }
+}
+
+void Workspace_Bench::saveXMLFragments_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::saveXMLFragments()
+{
+    createWorkspace();
+
+    /* Measure a save after a save, when unchanged objects are cached */
+    QList <QByteArray> fragments;
+    m_doc->saveXMLFragments(fragments);
+
+    QBENCHMARK
+    {
+        fragments.clear();
+        m_doc->saveXMLFragments(fragments);
+    }
+}
+
+void Workspace_Bench::saveBinary_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::saveBinary()
+{
+    createWorkspace();
+
+    QBENCHMARK
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_4_6);
+        QVERIFY(m_doc->saveBinary(stream) == true);
+    }
+}
+
+/****************************************************************************
+ * Load
+ ****************************************************************************/
+
+void Workspace_Bench::loadXMLDom_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::loadXMLDom()
+{
+    createWorkspace();
+    QByteArray data(engineXML());
+    m_doc->clearContents();
+
+    /* Parsing is part of loading, so it's measured too */
+    QBENCHMARK
+    {
+        m_doc->clearContents();
+        QDomDocument doc;
+        QVERIFY(doc.setContent(data) == true);
+        QVERIFY(m_doc->loadXML(doc.documentElement()) == true);
+    }
+}
+
+void Workspace_Bench::loadXMLStream_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::loadXMLStream()
+{
+    createWorkspace();
+    QByteArray data(engineXML());
+    m_doc->clearContents();
+
+    QBENCHMARK
+    {
+        m_doc->clearContents();
+        QXmlStreamReader xml(data);
+        QVERIFY(xml.readNextStartElement() == true);
+        QVERIFY(m_doc->loadXML(xml) == true);
+    }
+}
+
+void Workspace_Bench::loadBinary_data()
+{
+    sizes();
+}
+
+void Workspace_Bench::loadBinary()
+{
+    createWorkspace();
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_6);
+    QVERIFY(m_doc->saveBinary(out) == true);
+    m_doc->clearContents();
+
+    QBENCHMARK
+    {
+        m_doc->clearContents();
+        QDataStream in(data);
+        in.setVersion(QDataStream::Qt_4_6);
+        QVERIFY(m_doc->loadBinary(in) == true);
+    }
+}
+
+QTEST_MAIN(Workspace_Bench)
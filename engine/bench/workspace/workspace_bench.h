@@ -0,0 +1,62 @@
+/*
+  Q Light Controller - Benchmarks
+  workspace_bench.h
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#ifndef WORKSPACE_BENCH_H
+#define WORKSPACE_BENCH_H
+
+#include <QObject>
+
+class Doc;
+
+class Workspace_Bench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void saveXMLDom_data();
+    void saveXMLDom();
+    void saveXMLStream_data();
+    void saveXMLStream();
+    void saveXMLFragments_data();
+    void saveXMLFragments();
+    void loadXMLDom_data();
+    void loadXMLDom();
+    void loadXMLStream_data();
+    void loadXMLStream();
+    void saveBinary_data();
+    void saveBinary();
+    void loadBinary_data();
+    void loadBinary();
+
+private:
+    void sizes();
+    void createWorkspace();
+    QByteArray engineXML();
+
+private:
+    Doc* m_doc;
+};
+
+#endif
@@ -2,3 +2,4 @@ TEMPLATE = subdirs
 CONFIG  += ordered
 SUBDIRS += src
 SUBDIRS += test
+SUBDIRS += bench
@@ -23,6 +23,7 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QStringList>
+#include <QMutex>
 #include <QDebug>
 
 #include "avolitesd4parser.h"
@@ -106,9 +107,12 @@
 // Static attibute map shared between instances of the parser, initialized only
 // once per application.
 AvolitesD4Parser::StringToEnumMap AvolitesD4Parser::s_attributesMap;
+static QMutex s_attributesMapMutex;
 
 AvolitesD4Parser::AvolitesD4Parser()
 {
+    /* Fixture definitions may be parsed in several threads at once */
+    QMutexLocker locker(&s_attributesMapMutex);
     if (s_attributesMap.isEmpty() == true)
     {
         // Setup our attribute mapping map helper
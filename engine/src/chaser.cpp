@@ -19,11 +19,15 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QDebug>
 #include <QFile>
 #include <QtXml>
 
 #include "qlcfixturedef.h"
+#include "qlcxmltags.h"
 #include "qlcfile.h"
 
 #include "universearray.h"
@@ -285,6 +289,82 @@ bool Chaser::saveXML(QDomDocument* doc, QDomElement* wksp_root)
     return true;
 }
 
+bool Chaser::saveXML(QXmlStreamWriter& xml)
+{
+    /* Function tag */
+    xml.writeStartElement(KXMLQLCFunction);
+    xml.writeAttribute(KXMLQLCFunctionID, QString::number(id()));
+    xml.writeAttribute(KXMLQLCFunctionType, Function::typeToString(type()));
+    xml.writeAttribute(KXMLQLCFunctionName, name());
+
+    /* Speed */
+    saveXMLSpeed(xml);
+
+    /* Direction */
+    saveXMLDirection(xml);
+
+    /* Run order */
+    saveXMLRunOrder(xml);
+
+    /* Speed modes */
+    xml.writeStartElement(KXMLQLCChaserSpeedModes);
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeIn, speedModeToString(fadeInMode()));
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeOut, speedModeToString(fadeOutMode()));
+    xml.writeAttribute(KXMLQLCFunctionSpeedDuration, speedModeToString(durationMode()));
+    xml.writeEndElement();
+
+    /* Steps */
+    for (int i = 0; i < m_steps.size(); i++)
+        m_steps.at(i).saveXML(xml, i);
+
+    xml.writeEndElement();
+
+    return true;
+}
+
+bool Chaser::saveBinary(QDataStream& data)
+{
+    saveBinaryProperties(data);
+    data << quint8(m_fadeInMode) << quint8(m_fadeOutMode) << quint8(m_durationMode);
+
+    QMutexLocker locker(&m_stepListMutex);
+    data << quint32(m_steps.size());
+    QListIterator <ChaserStep> it(m_steps);
+    while (it.hasNext() == true)
+    {
+        const ChaserStep& step(it.next());
+        data << step.fid << quint32(step.fadeIn) << quint32(step.fadeOut)
+             << quint32(step.duration);
+    }
+
+    return (data.status() == QDataStream::Ok);
+}
+
+bool Chaser::loadBinary(QDataStream& data)
+{
+    loadBinaryProperties(data);
+
+    quint8 fadeInMode = 0, fadeOutMode = 0, durationMode = 0;
+    data >> fadeInMode >> fadeOutMode >> durationMode;
+    m_fadeInMode = SpeedMode(fadeInMode);
+    m_fadeOutMode = SpeedMode(fadeOutMode);
+    m_durationMode = SpeedMode(durationMode);
+
+    quint32 count = 0;
+    data >> count;
+
+    QMutexLocker locker(&m_stepListMutex);
+    m_steps.clear();
+    for (quint32 i = 0; i < count && data.status() == QDataStream::Ok; i++)
+    {
+        quint32 fid = 0, fadeIn = 0, fadeOut = 0, duration = 0;
+        data >> fid >> fadeIn >> fadeOut >> duration;
+        m_steps.append(ChaserStep(fid, fadeIn, fadeOut, duration));
+    }
+
+    return (data.status() == QDataStream::Ok);
+}
+
 bool Chaser::loadXML(const QDomElement& root)
 {
     if (root.tagName() != KXMLQLCFunction)
@@ -359,6 +439,87 @@ bool Chaser::loadXML(const QDomElement& root)
     return true;
 }
 
+bool Chaser::loadXML(QXmlStreamReader& xml)
+{
+    enum { TagBus, TagSpeed, TagDirection, TagRunOrder, TagSpeedModes, TagStep };
+    static const QLCXMLTags tags(QStringList() << KXMLQLCBus
+                                               << KXMLQLCFunctionSpeed
+                                               << KXMLQLCFunctionDirection
+                                               << KXMLQLCFunctionRunOrder
+                                               << KXMLQLCChaserSpeedModes
+                                               << KXMLQLCFunctionStep);
+
+    if (xml.name() != QLatin1String(KXMLQLCFunction))
+    {
+        qWarning() << Q_FUNC_INFO << "Function node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    if (xml.attributes().value(KXMLQLCFunctionType) != typeToString(Function::Chaser))
+    {
+        qWarning() << Q_FUNC_INFO << xml.attributes().value(KXMLQLCFunctionType).toString()
+                   << "is not a chaser";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Load chaser contents */
+    while (xml.readNextStartElement() == true)
+    {
+        switch (tags.id(xml.name()))
+        {
+        case TagBus:
+            m_legacyHoldBus = xml.readElementText().toUInt();
+            break;
+
+        case TagSpeed:
+            loadXMLSpeed(xml);
+            break;
+
+        case TagDirection:
+            loadXMLDirection(xml);
+            break;
+
+        case TagRunOrder:
+            loadXMLRunOrder(xml);
+            break;
+
+        case TagSpeedModes:
+        {
+            QXmlStreamAttributes attrs(xml.attributes());
+            setFadeInMode(stringToSpeedMode(attrs.value(KXMLQLCFunctionSpeedFadeIn).toString()));
+            setFadeOutMode(stringToSpeedMode(attrs.value(KXMLQLCFunctionSpeedFadeOut).toString()));
+            setDurationMode(stringToSpeedMode(attrs.value(KXMLQLCFunctionSpeedDuration).toString()));
+            xml.skipCurrentElement();
+            break;
+        }
+
+        case TagStep:
+        {
+            //! @todo stepNumber is useless if the steps are in the wrong order
+            ChaserStep step;
+            int stepNumber = -1;
+            if (step.loadXML(xml, stepNumber) == true)
+            {
+                if (stepNumber >= m_steps.size())
+                    m_steps.append(step);
+                else
+                    m_steps.insert(stepNumber, step);
+            }
+            break;
+        }
+
+        default:
+            qWarning() << Q_FUNC_INFO << "Unknown chaser tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+            break;
+        }
+    }
+
+    return (xml.hasError() == false);
+}
+
 void Chaser::postLoad()
 {
     if (m_legacyHoldBus != Bus::invalid())
@@ -32,6 +32,8 @@ class QString;
 class ChaserStep;
 class MasterTimer;
 class ChaserRunner;
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 
 /**
@@ -163,9 +165,21 @@ public:
     /** Save this function to an XML document */
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root);
 
+    /** Save this function to an XML stream */
+    bool saveXML(QXmlStreamWriter& xml);
+
+    /** Save this function to a binary workspace cache */
+    bool saveBinary(QDataStream& data);
+
+    /** Load this function from a binary workspace cache */
+    bool loadBinary(QDataStream& data);
+
     /** Load this function contents from an XML document */
     bool loadXML(const QDomElement& root);
 
+    /** Load this function contents from an XML stream */
+    bool loadXML(QXmlStreamReader& xml);
+
     /** @reimp */
     void postLoad();
 
@@ -19,6 +19,8 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomText>
@@ -104,6 +106,32 @@ bool ChaserStep::loadXML(const QDomElement& root, int& stepNumber)
     return true;
 }
 
+bool ChaserStep::loadXML(QXmlStreamReader& xml, int& stepNumber)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunctionStep))
+    {
+        qWarning() << Q_FUNC_INFO << "ChaserStep node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    QXmlStreamAttributes attrs(xml.attributes());
+    if (attrs.hasAttribute(KXMLQLCFunctionSpeedFadeIn) == true)
+        fadeIn = attrs.value(KXMLQLCFunctionSpeedFadeIn).toString().toUInt();
+    if (attrs.hasAttribute(KXMLQLCFunctionSpeedFadeOut) == true)
+        fadeOut = attrs.value(KXMLQLCFunctionSpeedFadeOut).toString().toUInt();
+    if (attrs.hasAttribute(KXMLQLCFunctionSpeedDuration) == true)
+        duration = attrs.value(KXMLQLCFunctionSpeedDuration).toString().toUInt();
+    if (attrs.hasAttribute(KXMLQLCFunctionNumber) == true)
+        stepNumber = attrs.value(KXMLQLCFunctionNumber).toString().toInt();
+
+    QString text = xml.readElementText();
+    if (text.isEmpty() == false)
+        fid = text.toUInt();
+
+    return true;
+}
+
 bool ChaserStep::saveXML(QDomDocument* doc, QDomElement* root, int stepNumber) const
 {
     QDomElement tag;
@@ -127,3 +155,16 @@ bool ChaserStep::saveXML(QDomDocument* doc, QDomElement* root, int stepNumber) c
 
     return true;
 }
+
+bool ChaserStep::saveXML(QXmlStreamWriter& xml, int stepNumber) const
+{
+    xml.writeStartElement(KXMLQLCFunctionStep);
+    xml.writeAttribute(KXMLQLCFunctionNumber, QString::number(stepNumber));
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeIn, QString::number(fadeIn));
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeOut, QString::number(fadeOut));
+    xml.writeAttribute(KXMLQLCFunctionSpeedDuration, QString::number(duration));
+    xml.writeCharacters(QString::number(fid));
+    xml.writeEndElement();
+
+    return true;
+}
@@ -25,6 +25,8 @@
 #include <QVariant>
 #include "function.h"
 
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 
@@ -69,9 +71,15 @@ public:
     /** Load ChaserStep contents from $root and return step index in $stepNumber */
     bool loadXML(const QDomElement& root, int& stepNumber);
 
+    /** Load ChaserStep contents from the current element of $xml */
+    bool loadXML(QXmlStreamReader& xml, int& stepNumber);
+
     /** Save ChaserStep contents to $doc, under $root with $stepNumber */
     bool saveXML(QDomDocument* doc, QDomElement* root, int stepNumber) const;
 
+    /** Save ChaserStep contents to $xml with $stepNumber */
+    bool saveXML(QXmlStreamWriter& xml, int stepNumber) const;
+
 public:
     quint32 fid;    //! The function ID
     uint fadeIn;    //! Fade in speed
@@ -19,6 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QString>
 #include <QDebug>
 #include <QFile>
@@ -174,6 +177,48 @@ bool Collection::saveXML(QDomDocument* doc, QDomElement* wksp_root)
     return true;
 }
 
+bool Collection::saveXML(QXmlStreamWriter& xml)
+{
+    /* Function tag */
+    xml.writeStartElement(KXMLQLCFunction);
+    xml.writeAttribute(KXMLQLCFunctionID, QString::number(id()));
+    xml.writeAttribute(KXMLQLCFunctionType, Function::typeToString(type()));
+    xml.writeAttribute(KXMLQLCFunctionName, name());
+
+    /* Steps */
+    for (int i = 0; i < m_functions.size(); i++)
+    {
+        xml.writeStartElement(KXMLQLCFunctionStep);
+        xml.writeAttribute(KXMLQLCFunctionNumber, QString::number(i));
+        xml.writeCharacters(QString::number(m_functions.at(i)));
+        xml.writeEndElement();
+    }
+
+    xml.writeEndElement();
+
+    return true;
+}
+
+bool Collection::saveBinary(QDataStream& data)
+{
+    saveBinaryProperties(data);
+
+    QMutexLocker locker(&m_functionListMutex);
+    data << m_functions;
+
+    return (data.status() == QDataStream::Ok);
+}
+
+bool Collection::loadBinary(QDataStream& data)
+{
+    loadBinaryProperties(data);
+
+    QMutexLocker locker(&m_functionListMutex);
+    data >> m_functions;
+
+    return (data.status() == QDataStream::Ok);
+}
+
 bool Collection::loadXML(const QDomElement& root)
 {
     if (root.tagName() != KXMLQLCFunction)
@@ -206,6 +251,40 @@ bool Collection::loadXML(const QDomElement& root)
     return true;
 }
 
+bool Collection::loadXML(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunction))
+    {
+        qWarning() << Q_FUNC_INFO << "Function node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    if (xml.attributes().value(KXMLQLCFunctionType) != typeToString(Function::Collection))
+    {
+        qWarning() << Q_FUNC_INFO << xml.attributes().value(KXMLQLCFunctionType).toString()
+                   << "is not a collection";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Load collection contents */
+    while (xml.readNextStartElement() == true)
+    {
+        if (xml.name() == QLatin1String(KXMLQLCFunctionStep))
+        {
+            addFunction(xml.readElementText().toInt());
+        }
+        else
+        {
+            qWarning() << Q_FUNC_INFO << "Unknown collection tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+        }
+    }
+
+    return (xml.hasError() == false);
+}
+
 void Collection::postLoad()
 {
     Doc* doc = qobject_cast <Doc*> (parent());
@@ -28,6 +28,8 @@
 
 #include "function.h"
 
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 
 class Collection : public Function
@@ -95,9 +97,21 @@ public:
     /** Save function's contents to an XML document */
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root);
 
+    /** Save function's contents to an XML stream */
+    bool saveXML(QXmlStreamWriter& xml);
+
+    /** Save function's contents to a binary workspace cache */
+    bool saveBinary(QDataStream& data);
+
+    /** Load function's contents from a binary workspace cache */
+    bool loadBinary(QDataStream& data);
+
     /** Load function's contents from an XML document */
     bool loadXML(const QDomElement& root);
 
+    /** Load function's contents from an XML stream */
+    bool loadXML(QXmlStreamReader& xml);
+
     /** @reimp */
     void postLoad();
 
@@ -19,9 +19,13 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QStringList>
 #include <QString>
 #include <QDebug>
+#include <QBuffer>
 #include <QList>
 #include <QtXml>
 #include <QDir>
@@ -29,6 +33,7 @@
 #include "qlcfixturedefcache.h"
 #include "qlcfixturemode.h"
 #include "qlcfixturedef.h"
+#include "qlcxmltags.h"
 #include "qlcfile.h"
 
 #include "collection.h"
@@ -40,6 +45,45 @@
 #include "doc.h"
 #include "bus.h"
 
+/**
+ * IDs below this limit are looked up from the dense ID-indexed arrays. IDs
+ * above it (which are rare, but possible in hand-edited workspaces) are
+ * looked up from the maps so that the arrays can't grow without bounds.
+ */
+#define KDenseIdLimit 65536
+
+template <class T>
+static void setDenseItem(QVector <T*>& array, quint32 id, T* item)
+{
+    if (id >= KDenseIdLimit)
+        return;
+
+    if (id >= quint32(array.size()))
+    {
+        if (item == NULL)
+            return;
+
+        int oldSize = array.size();
+        array.resize(id + 1);
+        for (int i = oldSize; i < array.size(); i++)
+            array[i] = NULL;
+    }
+
+    array[id] = item;
+}
+
+template <class T>
+static T* denseItem(const QVector <T*>& array, const QMap <quint32,T*>& map,
+                    quint32 id)
+{
+    if (id < quint32(array.size()))
+        return array.at(id);
+    else if (id < KDenseIdLimit)
+        return NULL;
+    else
+        return map.value(id, NULL);
+}
+
 Doc::Doc(QObject* parent, int outputUniverses, int inputUniverses)
     : QObject(parent)
     , m_fixtureDefCache(new QLCFixtureDefCache)
@@ -50,9 +94,18 @@ Doc::Doc(QObject* parent, int outputUniverses, int inputUniverses)
     , m_kiosk(false)
     , m_latestFixtureId(0)
     , m_latestFixtureGroupId(0)
+    , m_patchSnapshot(NULL)
+    , m_patchSnapshotVersion(0)
+    , m_publishPatchSnapshots(true)
     , m_latestFunctionId(0)
+    , m_functionStateSerial(0)
+    , m_batchDepth(0)
+    , m_batchModified(false)
+    , m_batchPatchChanged(false)
 {
     Bus::init(this);
+    m_addressTable.fill(PatchSnapshot::unpatchedAddress(), m_outputMap->universes() * 512);
+    publishPatchSnapshot();
     resetModified();
 }
 
@@ -63,6 +116,10 @@ Doc::~Doc()
 
     clearContents();
 
+    /* The timer is gone, so nobody can be using the snapshots anymore */
+    reclaimPatchSnapshots(true);
+    delete m_patchSnapshot.fetchAndStoreOrdered(NULL);
+
     if (isKiosk() == false)
         m_outputMap->saveDefaults();
     delete m_outputMap;
@@ -81,12 +138,18 @@ void Doc::clearContents()
 {
     emit clearing();
 
+    /* Publish the empty patch only once, when everything is gone */
+    m_publishPatchSnapshots = false;
+
     // Delete all function instances
     QListIterator <quint32> funcit(m_functions.keys());
     while (funcit.hasNext() == true)
     {
         Function* func = m_functions.take(funcit.next());
+        setDenseItem(m_functionArray, func->id(), (Function*) NULL);
         emit functionRemoved(func->id());
+        if (m_batchDepth > 0)
+            m_batchChanges.functions.remove(func->id());
         delete func;
     }
 
@@ -95,7 +158,10 @@ void Doc::clearContents()
     while (fxit.hasNext() == true)
     {
         Fixture* fxi = m_fixtures.take(fxit.next());
+        setDenseItem(m_fixtureArray, fxi->id(), (Fixture*) NULL);
         emit fixtureRemoved(fxi->id());
+        if (m_batchDepth > 0)
+            m_batchChanges.fixtures.remove(fxi->id());
         delete fxi;
     }
 
@@ -104,14 +170,29 @@ void Doc::clearContents()
     while (grpit.hasNext() == true)
     {
         FixtureGroup* grp = m_fixtureGroups.take(grpit.next());
+        setDenseItem(m_fixtureGroupArray, grp->id(), (FixtureGroup*) NULL);
         emit fixtureGroupRemoved(grp->id());
+        if (m_batchDepth > 0)
+            m_batchChanges.fixtureGroups.remove(grp->id());
         delete grp;
     }
 
     m_latestFunctionId = 0;
     m_latestFixtureId = 0;
     m_latestFixtureGroupId = 0;
-    m_addresses.clear();
+    m_fixtureArray.clear();
+    m_fixtureGroupArray.clear();
+    m_functionArray.clear();
+    m_addressTable.fill(PatchSnapshot::unpatchedAddress());
+    m_patchedRanges.clear();
+    m_fixtureInfos.clear();
+    m_groupInfos.clear();
+    m_publishPatchSnapshots = true;
+    publishPatchSnapshot();
+
+    m_fixtureXMLCache.clear();
+    m_functionXMLCache.clear();
+    m_fixtureGroupXMLCache.clear();
 
     emit cleared();
 }
@@ -152,12 +233,16 @@ bool Doc::isModified() const
 void Doc::setModified()
 {
     m_modified = true;
-    emit modified(true);
+    if (m_batchDepth > 0)
+        m_batchModified = true;
+    else
+        emit modified(true);
 }
 
 void Doc::resetModified()
 {
     m_modified = false;
+    m_batchModified = false;
     emit modified(false);
 }
 
@@ -223,21 +308,30 @@ bool Doc::addFixture(Fixture* fixture, quint32 id)
     }
     else
     {
+        /* The ID of a fixture removed earlier in this batch is reused, so
+           functions must forget the old fixture before the new one appears */
+        if (m_batchRemovedFixtures.remove(id) == true)
+        {
+            foreach (Function* func, m_functions)
+                func->slotFixtureRemoved(id);
+        }
+
         fixture->setID(id);
         m_fixtures[id] = fixture;
+        setDenseItem(m_fixtureArray, id, fixture);
 
         /* Patch fixture change signals thru Doc */
         connect(fixture, SIGNAL(changed(quint32)),
                 this, SLOT(slotFixtureChanged(quint32)));
 
         /* Keep track of fixture addresses */
-        for (uint i = fixture->universeAddress();
-             i < fixture->universeAddress() + fixture->channels(); i++)
-        {
-            m_addresses[i] = id;
-        }
+        patchFixture(fixture);
+        updateFixtureInfo(fixture);
+        publishPatchSnapshot();
 
         emit fixtureAdded(id);
+        if (m_batchDepth > 0)
+            m_batchChanges.fixtures.add(id);
         setModified();
 
         return true;
@@ -250,17 +344,26 @@ bool Doc::deleteFixture(quint32 id)
     {
         Fixture* fxi = m_fixtures.take(id);
         Q_ASSERT(fxi != NULL);
+        setDenseItem(m_fixtureArray, id, (Fixture*) NULL);
 
         /* Keep track of fixture addresses */
-        QMutableHashIterator <uint,uint> it(m_addresses);
-        while (it.hasNext() == true)
+        unpatchFixture(id);
+        m_fixtureInfos.remove(id);
+        publishPatchSnapshot();
+        m_fixtureXMLCache.remove(id);
+
+        emit fixtureRemoved(id);
+        if (m_batchDepth > 0)
         {
-            it.next();
-            if (it.value() == id)
-                it.remove();
+            m_batchChanges.fixtures.remove(id);
+            m_batchRemovedFixtures << id;
+        }
+        else
+        {
+            foreach (Function* func, m_functions)
+                func->slotFixtureRemoved(id);
         }
 
-        emit fixtureRemoved(id);
         setModified();
         delete fxi;
 
@@ -280,18 +383,99 @@ QList <Fixture*> Doc::fixtures() const
 
 Fixture* Doc::fixture(quint32 id) const
 {
-    if (m_fixtures.contains(id) == true)
-        return m_fixtures[id];
-    else
-        return NULL;
+    return denseItem(m_fixtureArray, m_fixtures, id);
 }
 
 quint32 Doc::fixtureForAddress(quint32 universeAddress) const
 {
-    if (m_addresses.contains(universeAddress) == true)
-        return m_addresses[universeAddress];
+    return addressInfo(universeAddress).fixture;
+}
+
+const Doc::AddressInfo& Doc::addressInfo(quint32 universeAddress) const
+{
+    if (universeAddress < quint32(m_addressTable.size()))
+        return m_addressTable.at(universeAddress);
     else
-        return Fixture::invalidId();
+        return PatchSnapshot::unpatchedAddress();
+}
+
+void Doc::patchFixture(const Fixture* fixture)
+{
+    Q_ASSERT(fixture != NULL);
+
+    quint32 address = fixture->universeAddress();
+    quint32 channels = fixture->channels();
+    m_patchedRanges[fixture->id()] = QPair <quint32,quint32> (address, channels);
+
+    for (quint32 i = 0; i < channels; i++)
+    {
+        if (address + i >= quint32(m_addressTable.size()))
+            break;
+
+        AddressInfo& info(m_addressTable[address + i]);
+        info.fixture = fixture->id();
+        info.channel = i;
+
+        const QLCChannel* ch = fixture->channel(i);
+        if (ch != NULL)
+            info.group = ch->group();
+        else
+            info.group = QLCChannel::Intensity;
+    }
+}
+
+void Doc::unpatchFixture(quint32 id)
+{
+    if (m_patchedRanges.contains(id) == false)
+        return;
+
+    QPair <quint32,quint32> range = m_patchedRanges.take(id);
+    quint32 first = range.first;
+    quint32 last = qMin(range.first + range.second, quint32(m_addressTable.size()));
+
+    quint32 freed = 0;
+    for (quint32 i = first; i < last; i++)
+    {
+        if (m_addressTable[i].fixture == id)
+        {
+            m_addressTable[i] = PatchSnapshot::unpatchedAddress();
+            freed++;
+        }
+    }
+
+    /* Give the freed addresses to other fixtures overlapping them. Go thru
+       the fixtures in descending ID order (the map is ordered by ID, so no
+       sorting is needed) so that the fixture with the highest ID gets each
+       address. Stop as soon as all freed addresses have an owner again. */
+    QMapIterator <quint32,QPair <quint32,quint32> > it(m_patchedRanges);
+    it.toBack();
+    while (freed > 0 && it.hasPrevious() == true)
+    {
+        it.previous();
+        quint32 otherId = it.key();
+        const QPair <quint32,quint32>& other(it.value());
+        quint32 start = qMax(first, other.first);
+        quint32 end = qMin(last, other.first + other.second);
+        if (start >= end)
+            continue;
+
+        const Fixture* fxi = fixture(otherId);
+        if (fxi == NULL)
+            continue;
+
+        for (quint32 i = start; i < end; i++)
+        {
+            AddressInfo& info(m_addressTable[i]);
+            if (info.fixture != Fixture::invalidId())
+                continue;
+
+            const QLCChannel* ch = fxi->channel(i - other.first);
+            info.fixture = otherId;
+            info.channel = i - other.first;
+            info.group = (ch != NULL) ? ch->group() : QLCChannel::Intensity;
+            freed--;
+        }
+    }
 }
 
 int Doc::totalPowerConsumption(int& fuzzy) const
@@ -327,15 +511,20 @@ int Doc::totalPowerConsumption(int& fuzzy) const
 
 void Doc::slotFixtureChanged(quint32 id)
 {
-    /* Keep track of fixture addresses */
+    /* Keep track of fixture addresses. The fixture may have moved, so
+       remove it from its previous addresses first. */
     Fixture* fxi = fixture(id);
-    for (uint i = fxi->universeAddress(); i < fxi->universeAddress() + fxi->channels(); i++)
-    {
-        m_addresses[i] = id;
-    }
+    Q_ASSERT(fxi != NULL);
+    unpatchFixture(id);
+    patchFixture(fxi);
+    updateFixtureInfo(fxi);
+    publishPatchSnapshot();
+    m_fixtureXMLCache.remove(id);
 
     setModified();
     emit fixtureChanged(id);
+    if (m_batchDepth > 0)
+        m_batchChanges.fixtures.change(id);
 }
 
 /*****************************************************************************
@@ -359,12 +548,18 @@ bool Doc::addFixtureGroup(FixtureGroup* grp, quint32 id)
     {
         grp->setId(id);
         m_fixtureGroups[id] = grp;
+        setDenseItem(m_fixtureGroupArray, id, grp);
 
         /* Patch fixture group change signals thru Doc */
         connect(grp, SIGNAL(changed(quint32)),
                 this, SLOT(slotFixtureGroupChanged(quint32)));
 
+        updateGroupInfo(grp);
+        publishPatchSnapshot();
+
         emit fixtureGroupAdded(id);
+        if (m_batchDepth > 0)
+            m_batchChanges.fixtureGroups.add(id);
         setModified();
 
         return true;
@@ -377,8 +572,14 @@ bool Doc::deleteFixtureGroup(quint32 id)
     {
         FixtureGroup* grp = m_fixtureGroups.take(id);
         Q_ASSERT(grp != NULL);
+        setDenseItem(m_fixtureGroupArray, id, (FixtureGroup*) NULL);
+        m_groupInfos.remove(id);
+        publishPatchSnapshot();
+        m_fixtureGroupXMLCache.remove(id);
 
         emit fixtureGroupRemoved(id);
+        if (m_batchDepth > 0)
+            m_batchChanges.fixtureGroups.remove(id);
         setModified();
         delete grp;
 
@@ -393,10 +594,7 @@ bool Doc::deleteFixtureGroup(quint32 id)
 
 FixtureGroup* Doc::fixtureGroup(quint32 id) const
 {
-    if (m_fixtureGroups.contains(id) == true)
-        return m_fixtureGroups[id];
-    else
-        return NULL;
+    return denseItem(m_fixtureGroupArray, m_fixtureGroups, id);
 }
 
 QList <FixtureGroup*> Doc::fixtureGroups() const
@@ -420,8 +618,114 @@ quint32 Doc::createFixtureGroupId()
 
 void Doc::slotFixtureGroupChanged(quint32 id)
 {
+    FixtureGroup* grp = fixtureGroup(id);
+    Q_ASSERT(grp != NULL);
+    updateGroupInfo(grp);
+    publishPatchSnapshot();
+    m_fixtureGroupXMLCache.remove(id);
+
     setModified();
     emit fixtureGroupChanged(id);
+    if (m_batchDepth > 0)
+        m_batchChanges.fixtureGroups.change(id);
+}
+
+/*****************************************************************************
+ * Patch snapshots
+ *****************************************************************************/
+
+const PatchSnapshot* Doc::patchSnapshot() const
+{
+    return m_patchSnapshot;
+}
+
+void Doc::publishPatchSnapshot()
+{
+    if (m_publishPatchSnapshots == false)
+        return;
+
+    if (m_batchDepth > 0)
+    {
+        m_batchPatchChanged = true;
+        return;
+    }
+
+    /* The containers are implicitly shared, so this copies only pointers.
+       Doc's own copies detach the next time they're modified. */
+    PatchSnapshot* snapshot = new PatchSnapshot(++m_patchSnapshotVersion,
+                                                m_addressTable,
+                                                m_fixtureInfos,
+                                                m_groupInfos);
+    PatchSnapshot* old = m_patchSnapshot.fetchAndStoreOrdered(snapshot);
+    if (old != NULL)
+    {
+        /* The timer thread might still be using the old snapshot if a tick
+           is in progress. Remember which tick that was. */
+        int generation = (m_masterTimer != NULL) ? m_masterTimer->tickGeneration() : 0;
+        m_retiredPatchSnapshots << QPair <PatchSnapshot*,int> (old, generation);
+    }
+
+    reclaimPatchSnapshots(m_masterTimer == NULL);
+}
+
+void Doc::updateFixtureInfo(const Fixture* fxi)
+{
+    Q_ASSERT(fxi != NULL);
+
+    PatchSnapshot::FixtureInfo info;
+    info.address = fxi->universeAddress();
+
+    quint32 channels = fxi->channels();
+    info.groups.resize(channels);
+    info.channels.resize(channels);
+    for (quint32 i = 0; i < channels; i++)
+    {
+        const QLCChannel* ch = fxi->channel(i);
+        info.groups[i] = (ch != NULL) ? ch->group() : QLCChannel::Intensity;
+
+        /* Generic dimmer channels belong to the fixture itself and they
+           would be gone with it, so don't share them with the timer. */
+        if (fxi->isDimmer() == false)
+            info.channels[i] = ch;
+        else
+            info.channels[i] = NULL;
+    }
+
+    for (int i = 0; i < fxi->heads(); i++)
+        info.heads << fxi->head(i);
+    info.dimmer = fxi->isDimmer();
+
+    m_fixtureInfos[fxi->id()] = info;
+}
+
+void Doc::updateGroupInfo(const FixtureGroup* grp)
+{
+    Q_ASSERT(grp != NULL);
+
+    PatchSnapshot::GroupInfo info;
+    info.size = grp->size();
+    info.heads = grp->headHash();
+    m_groupInfos[grp->id()] = info;
+}
+
+void Doc::reclaimPatchSnapshots(bool force)
+{
+    /* A tick generation is odd while a tick is in progress. A snapshot
+       retired between ticks, or during a tick that has since ended, can't
+       be in use anymore because each tick fetches the snapshot anew. */
+    int generation = (m_masterTimer != NULL) ? m_masterTimer->tickGeneration() : 0;
+
+    QMutableListIterator <QPair <PatchSnapshot*,int> > it(m_retiredPatchSnapshots);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        if (force == true || (it.value().second % 2) == 0 ||
+            it.value().second != generation)
+        {
+            delete it.value().first;
+            it.remove();
+        }
+    }
 }
 
 /*****************************************************************************
@@ -460,14 +764,13 @@ bool Doc::addFunction(Function* func, quint32 id)
         connect(func, SIGNAL(changed(quint32)),
                 this, SLOT(slotFunctionChanged(quint32)));
 
-        // Make the function listen to fixture removals
-        connect(this, SIGNAL(fixtureRemoved(quint32)),
-                func, SLOT(slotFixtureRemoved(quint32)));
-
         // Place the function in the map and assign it the new ID
         m_functions[id] = func;
+        setDenseItem(m_functionArray, id, func);
         func->setID(id);
         emit functionAdded(id);
+        if (m_batchDepth > 0)
+            m_batchChanges.functions.add(id);
         setModified();
 
         return true;
@@ -485,8 +788,12 @@ bool Doc::deleteFunction(quint32 id)
     {
         Function* func = m_functions.take(id);
         Q_ASSERT(func != NULL);
+        setDenseItem(m_functionArray, id, (Function*) NULL);
+        m_functionXMLCache.remove(id);
 
         emit functionRemoved(id);
+        if (m_batchDepth > 0)
+            m_batchChanges.functions.remove(id);
         setModified();
         delete func;
 
@@ -501,16 +808,120 @@ bool Doc::deleteFunction(quint32 id)
 
 Function* Doc::function(quint32 id) const
 {
-    if (m_functions.contains(id) == true)
-        return m_functions[id];
-    else
-        return NULL;
+    return denseItem(m_functionArray, m_functions, id);
 }
 
 void Doc::slotFunctionChanged(quint32 fid)
 {
+    m_functionXMLCache.remove(fid);
     setModified();
     emit functionChanged(fid);
+    if (m_batchDepth > 0)
+        m_batchChanges.functions.change(fid);
+}
+
+/*****************************************************************************
+ * Function state
+ *****************************************************************************/
+
+int Doc::functionStateSerial() const
+{
+    return m_functionStateSerial;
+}
+
+void Doc::notifyFunctionStateChanged()
+{
+    m_functionStateSerial.fetchAndAddOrdered(1);
+}
+
+/*****************************************************************************
+ * Batch changes
+ *****************************************************************************/
+
+void Doc::ChangeSet::add(quint32 id)
+{
+    added << id;
+}
+
+void Doc::ChangeSet::remove(quint32 id)
+{
+    /* Something that came and went during the batch is of no interest */
+    if (added.remove(id) == false)
+        removed << id;
+    changed.remove(id);
+}
+
+void Doc::ChangeSet::change(quint32 id)
+{
+    if (added.contains(id) == false)
+        changed << id;
+}
+
+bool Doc::ChangeSet::isEmpty() const
+{
+    return (added.isEmpty() && removed.isEmpty() && changed.isEmpty());
+}
+
+int Doc::ChangeSet::size() const
+{
+    return added.size() + removed.size() + changed.size();
+}
+
+bool Doc::BatchChanges::isEmpty() const
+{
+    return (fixtures.isEmpty() && fixtureGroups.isEmpty() && functions.isEmpty());
+}
+
+void Doc::beginBatch()
+{
+    m_batchDepth++;
+}
+
+void Doc::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    if (m_batchDepth <= 0)
+        return;
+
+    if (m_batchDepth > 1)
+    {
+        m_batchDepth--;
+        return;
+    }
+
+    /* Let each function forget all of the removed fixtures in one pass.
+       Any changes this causes are still part of this batch. */
+    if (m_batchRemovedFixtures.isEmpty() == false)
+    {
+        QSet <quint32> ids(m_batchRemovedFixtures);
+        m_batchRemovedFixtures.clear();
+        foreach (Function* func, m_functions)
+            func->fixturesRemoved(ids);
+    }
+
+    m_batchDepth = 0;
+
+    if (m_batchPatchChanged == true)
+    {
+        m_batchPatchChanged = false;
+        publishPatchSnapshot();
+    }
+
+    if (m_batchModified == true)
+    {
+        m_batchModified = false;
+        emit modified(true);
+    }
+
+    BatchChanges changes(m_batchChanges);
+    m_batchChanges = BatchChanges();
+    if (changes.isEmpty() == false)
+        emit batchFinished(changes);
+}
+
+bool Doc::isBatching() const
+{
+    return (m_batchDepth > 0);
 }
 
 /*****************************************************************************
@@ -525,6 +936,10 @@ bool Doc::loadXML(const QDomElement& root)
         return false;
     }
 
+    /* Publish the patch and report the new objects only once, after
+       everything has been loaded */
+    beginBatch();
+
     QDomNode node = root.firstChild();
     while (node.isNull() == false)
     {
@@ -556,10 +971,69 @@ bool Doc::loadXML(const QDomElement& root)
     }
 
     postLoad();
+    endBatch();
 
     return true;
 }
 
+bool Doc::loadXML(QXmlStreamReader& xml)
+{
+    enum { TagFixture, TagFunction, TagBus, TagFixtureGroup };
+    static const QLCXMLTags tags(QStringList() << KXMLFixture
+                                               << KXMLQLCFunction
+                                               << KXMLQLCBus
+                                               << KXMLQLCFixtureGroup);
+
+    if (xml.name() != QLatin1String(KXMLQLCEngine))
+    {
+        qWarning() << Q_FUNC_INFO << "Engine node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Publish the patch and report the new objects only once, after
+       everything has been loaded */
+    beginBatch();
+
+    while (xml.readNextStartElement() == true)
+    {
+        switch (tags.id(xml.name()))
+        {
+        case TagFixture:
+            Fixture::loader(xml, this);
+            break;
+
+        case TagFunction:
+            Function::loader(xml, this);
+            break;
+
+        case TagBus:
+        {
+            /* LEGACY */
+            QDomDocument doc;
+            QDomElement tag = QLCFile::readXMLElement(xml, doc);
+            if (tag.isNull() == false)
+                Bus::instance()->loadXML(tag);
+            break;
+        }
+
+        case TagFixtureGroup:
+            FixtureGroup::loader(xml, this);
+            break;
+
+        default:
+            qWarning() << Q_FUNC_INFO << "Unknown engine tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+            break;
+        }
+    }
+
+    postLoad();
+    endBatch();
+
+    return (xml.hasError() == false);
+}
+
 bool Doc::saveXML(QDomDocument* doc, QDomElement* wksp_root)
 {
     QDomElement root;
@@ -600,6 +1074,167 @@ bool Doc::saveXML(QDomDocument* doc, QDomElement* wksp_root)
     return true;
 }
 
+bool Doc::saveXML(QXmlStreamWriter& xml)
+{
+    /* Create the master Engine node */
+    xml.writeStartElement(KXMLQLCEngine);
+
+    /* Write fixtures */
+    QListIterator <Fixture*> fxit(fixtures());
+    while (fxit.hasNext() == true)
+        fxit.next()->saveXML(xml);
+
+    /* Write functions */
+    QListIterator <Function*> funcit(functions());
+    while (funcit.hasNext() == true)
+        funcit.next()->saveXML(xml);
+
+    /* Write fixture groups */
+    QListIterator <FixtureGroup*> grpit(fixtureGroups());
+    while (grpit.hasNext() == true)
+        grpit.next()->saveXML(xml);
+
+    xml.writeEndElement();
+
+    return (xml.hasError() == false);
+}
+
+/**
+ * Serialize $object with its saveXML(QXmlStreamWriter&) method into
+ * a stand-alone piece of XML.
+ */
+template <typename T> static QByteArray serializeXML(T* object)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    QXmlStreamWriter xml(&buffer);
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(1);
+    object->saveXML(xml);
+
+    return data;
+}
+
+void Doc::saveXMLFragments(QList <QByteArray>& fragments)
+{
+    fragments << QByteArray("\n<" KXMLQLCEngine ">");
+
+    QListIterator <Fixture*> fxit(fixtures());
+    while (fxit.hasNext() == true)
+    {
+        Fixture* fxi(fxit.next());
+        QHash <quint32,QByteArray>::iterator it = m_fixtureXMLCache.find(fxi->id());
+        if (it == m_fixtureXMLCache.end())
+            it = m_fixtureXMLCache.insert(fxi->id(), serializeXML(fxi));
+        fragments << it.value();
+    }
+
+    QListIterator <Function*> funcit(functions());
+    while (funcit.hasNext() == true)
+    {
+        Function* func(funcit.next());
+        if (isSaveCacheable(func) == false)
+        {
+            fragments << serializeXML(func);
+            continue;
+        }
+
+        QHash <quint32,QByteArray>::iterator it = m_functionXMLCache.find(func->id());
+        if (it == m_functionXMLCache.end())
+            it = m_functionXMLCache.insert(func->id(), serializeXML(func));
+        fragments << it.value();
+    }
+
+    QListIterator <FixtureGroup*> grpit(fixtureGroups());
+    while (grpit.hasNext() == true)
+    {
+        FixtureGroup* grp(grpit.next());
+        QHash <quint32,QByteArray>::iterator it = m_fixtureGroupXMLCache.find(grp->id());
+        if (it == m_fixtureGroupXMLCache.end())
+            it = m_fixtureGroupXMLCache.insert(grp->id(), serializeXML(grp));
+        fragments << it.value();
+    }
+
+    fragments << QByteArray("\n</" KXMLQLCEngine ">");
+}
+
+bool Doc::isSaveCacheable(const Function* function)
+{
+    /* EFX fixtures, RGB matrix algorithms and script data can be edited
+       without the function emitting changed(), so they're always saved
+       from scratch. */
+    switch (function->type())
+    {
+    case Function::Scene:
+    case Function::Chaser:
+    case Function::Collection:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*****************************************************************************
+ * Binary cache
+ *****************************************************************************/
+
+bool Doc::saveBinary(QDataStream& data)
+{
+    data << quint32(m_fixtures.size());
+    QListIterator <Fixture*> fxit(fixtures());
+    while (fxit.hasNext() == true)
+        fxit.next()->saveBinary(data);
+
+    data << quint32(m_fixtureGroups.size());
+    QListIterator <FixtureGroup*> grpit(fixtureGroups());
+    while (grpit.hasNext() == true)
+        grpit.next()->saveBinary(data);
+
+    data << quint32(m_functions.size());
+    QListIterator <Function*> funcit(functions());
+    while (funcit.hasNext() == true)
+        Function::binarySaver(data, funcit.next());
+
+    return (data.status() == QDataStream::Ok);
+}
+
+bool Doc::loadBinary(QDataStream& data)
+{
+    bool result = true;
+    quint32 count = 0;
+
+    /* Publish the patch and report the new objects only once, after
+       everything has been loaded */
+    beginBatch();
+
+    data >> count;
+    for (quint32 i = 0; i < count && result == true; i++)
+        result = Fixture::binaryLoader(data, this);
+
+    count = 0;
+    data >> count;
+    for (quint32 i = 0; i < count && result == true; i++)
+        result = FixtureGroup::binaryLoader(data, this);
+
+    count = 0;
+    data >> count;
+    for (quint32 i = 0; i < count && result == true; i++)
+        result = Function::binaryLoader(data, this);
+
+    if (result == false || data.status() != QDataStream::Ok)
+    {
+        endBatch();
+        return false;
+    }
+
+    postLoad();
+    endBatch();
+
+    return true;
+}
+
 void Doc::postLoad()
 {
     QListIterator <Function*> functionit(functions());
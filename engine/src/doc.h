@@ -22,19 +22,30 @@
 #ifndef DOC_H
 #define DOC_H
 
+#include <QAtomicPointer>
+#include <QAtomicInt>
 #include <QObject>
+#include <QVector>
 #include <QList>
+#include <QSet>
+#include <QByteArray>
 #include <QFile>
+#include <QHash>
+#include <QPair>
 #include <QMap>
 
 #include "qlcfixturedefcache.h"
 #include "fixturegroup.h"
+#include "patchsnapshot.h"
 #include "mastertimer.h"
 #include "outputmap.h"
 #include "inputmap.h"
 #include "function.h"
 #include "fixture.h"
 
+class QXmlStreamWriter;
+class QDataStream;
+class QXmlStreamReader;
 class QDomDocument;
 class QString;
 
@@ -137,7 +148,8 @@ public:
     bool isModified() const;
 
     /**
-     * Set Doc into modified state (i.e. it is in need of saving)
+     * Set Doc into modified state (i.e. it is in need of saving). During a
+     * batch, modified() is emitted only once when the batch ends.
      */
     void setModified();
 
@@ -201,6 +213,20 @@ public:
      */
     quint32 fixtureForAddress(quint32 universeAddress) const;
 
+    /** Patch information of a single DMX address */
+    typedef PatchSnapshot::AddressInfo AddressInfo;
+
+    /**
+     * Get the patch information of the given DMX address in constant time.
+     * Addresses that are not occupied by any fixture (or are outside of
+     * the output universes) have an invalid fixture ID and channel and
+     * their group is QLCChannel::Intensity.
+     *
+     * @param universeAddress The universe & address to look for
+     * @return Patch information for the address
+     */
+    const AddressInfo& addressInfo(quint32 universeAddress) const;
+
     /**
      * Get the total power consumption of all fixtures in the current
      * workspace.
@@ -216,6 +242,15 @@ protected:
      */
     quint32 createFixtureId();
 
+    /** Write the given fixture's channels to the address table */
+    void patchFixture(const Fixture* fixture);
+
+    /**
+     * Remove the given fixture from the address table and give the freed
+     * addresses back to any other fixtures that overlap them.
+     */
+    void unpatchFixture(quint32 id);
+
 signals:
     /** Signal that a fixture has been added */
     void fixtureAdded(quint32 fxi_id);
@@ -234,8 +269,18 @@ protected:
     /** Fixtures */
     QMap <quint32,Fixture*> m_fixtures;
 
-    /** Addresses occupied by fixtures */
-    QHash <quint32,quint32> m_addresses;
+    /** Fixtures indexed directly by their IDs (see KDenseIdLimit) */
+    QVector <Fixture*> m_fixtureArray;
+
+    /** Patch information for each DMX address in all output universes */
+    QVector <AddressInfo> m_addressTable;
+
+    /** The address & channel count each fixture was last patched with,
+        ordered by fixture ID */
+    QMap <quint32,QPair <quint32,quint32> > m_patchedRanges;
+
+    /** Snapshot information of each fixture, shared with patch snapshots */
+    QHash <quint32,PatchSnapshot::FixtureInfo> m_fixtureInfos;
 
     /** Latest assigned fixture ID */
     quint32 m_latestFixtureId;
@@ -276,9 +321,64 @@ private:
     /** Fixture Groups */
     QMap <quint32,FixtureGroup*> m_fixtureGroups;
 
+    /** Fixture groups indexed directly by their IDs */
+    QVector <FixtureGroup*> m_fixtureGroupArray;
+
+    /** Snapshot information of each group, shared with patch snapshots */
+    QHash <quint32,PatchSnapshot::GroupInfo> m_groupInfos;
+
     /** Latest assigned fixture group ID */
     quint32 m_latestFixtureGroupId;
 
+    /*********************************************************************
+     * Patch snapshots
+     *********************************************************************/
+public:
+    /**
+     * Get the most recently published patch snapshot. This is meant to be
+     * called from the MasterTimer thread, during a timer tick, to look up
+     * fixture addresses, channels and group heads without locking. The
+     * snapshot stays valid until the end of the current tick, so it must
+     * not be stored anywhere for later use. Never returns NULL.
+     */
+    const PatchSnapshot* patchSnapshot() const;
+
+    /**
+     * Build a new snapshot from the current patch and publish it to the
+     * timer thread. Doc calls this automatically whenever fixtures or
+     * fixture groups change, so there should rarely be any need to call
+     * it explicitly. During a batch, the snapshot is published only once
+     * when the batch ends. Must be called from the main thread.
+     */
+    void publishPatchSnapshot();
+
+private:
+    /** Update the snapshot information of the given fixture */
+    void updateFixtureInfo(const Fixture* fxi);
+
+    /** Update the snapshot information of the given fixture group */
+    void updateGroupInfo(const FixtureGroup* grp);
+
+    /**
+     * Delete those retired snapshots that the timer thread can no longer
+     * be using, i.e. those that were replaced before the current tick
+     * started. If force is true, delete all of them.
+     */
+    void reclaimPatchSnapshots(bool force = false);
+
+private:
+    /** The currently published snapshot */
+    QAtomicPointer <PatchSnapshot> m_patchSnapshot;
+
+    /** Replaced snapshots & the MasterTimer tick generation at that time */
+    QList <QPair <PatchSnapshot*,int> > m_retiredPatchSnapshots;
+
+    /** Latest snapshot version */
+    quint32 m_patchSnapshotVersion;
+
+    /** When false, publishPatchSnapshot() does nothing (while clearing) */
+    bool m_publishPatchSnapshots;
+
     /*********************************************************************
      * Functions
      *********************************************************************/
@@ -354,9 +454,122 @@ protected:
     /** Functions */
     QMap <quint32,Function*> m_functions;
 
+    /** Functions indexed directly by their IDs */
+    QVector <Function*> m_functionArray;
+
     /** Latest assigned function ID */
     quint32 m_latestFunctionId;
 
+    /*********************************************************************
+     * Function state
+     *********************************************************************/
+public:
+    /**
+     * Get a number that changes whenever any function publishes a new
+     * running, flashing or intensity state (see Function::publishedState()).
+     * Pollers can skip looking at individual functions while this stays
+     * the same. Safe to call from any thread.
+     */
+    int functionStateSerial() const;
+
+    /**
+     * Called by functions after they have published a new state. Safe to
+     * call from any thread.
+     */
+    void notifyFunctionStateChanged();
+
+private:
+    QAtomicInt m_functionStateSerial;
+
+    /*********************************************************************
+     * Batch changes
+     *********************************************************************/
+public:
+    /** IDs of the objects of one kind that were added, removed or changed */
+    struct ChangeSet
+    {
+        QSet <quint32> added;
+        QSet <quint32> removed;
+        QSet <quint32> changed;
+
+        /** Record an addition of the given ID */
+        void add(quint32 id);
+
+        /** Record a removal of the given ID */
+        void remove(quint32 id);
+
+        /** Record a change of the given ID */
+        void change(quint32 id);
+
+        /** Check, whether nothing has been recorded */
+        bool isEmpty() const;
+
+        /** Get the total number of recorded IDs */
+        int size() const;
+    };
+
+    /**
+     * Everything that was added, removed or changed during a batch. An
+     * object that was both added and removed during the batch is not listed
+     * at all and an object that was added and then changed is listed only
+     * as added. An ID that was removed and then given to a new object is
+     * listed both as removed and as added, so listeners should process the
+     * removals first.
+     */
+    struct BatchChanges
+    {
+        ChangeSet fixtures;
+        ChangeSet fixtureGroups;
+        ChangeSet functions;
+
+        /** Check, whether nothing has been recorded */
+        bool isEmpty() const;
+    };
+
+    /**
+     * Start a batch of changes. Doc keeps emitting its usual signals for
+     * each object during the batch, but it also records the IDs of the
+     * objects that change, and emits them all in one batchFinished() signal
+     * when the batch ends. Listeners that would do expensive work for each
+     * object (like rebuilding a tree view) can check isBatching() and wait
+     * for batchFinished() instead.
+     *
+     * Doc's own bookkeeping is deferred in the same way: the patch snapshot
+     * is published, modified() is emitted and functions are told about
+     * removed fixtures (see Function::fixturesRemoved()) only once, when
+     * the batch ends.
+     *
+     * Batches can be nested; only the outermost endBatch() finishes the
+     * batch. Each call to beginBatch() must be matched with endBatch().
+     */
+    void beginBatch();
+
+    /** End a batch of changes. See beginBatch(). */
+    void endBatch();
+
+    /** Check, whether a batch of changes is in progress */
+    bool isBatching() const;
+
+signals:
+    /** Emitted by the outermost endBatch(), if anything changed */
+    void batchFinished(const Doc::BatchChanges& changes);
+
+private:
+    /** Number of nested beginBatch() calls */
+    int m_batchDepth;
+
+    /** Changes recorded during the current batch */
+    BatchChanges m_batchChanges;
+
+    /** Fixtures removed during the current batch, for functions to forget */
+    QSet <quint32> m_batchRemovedFixtures;
+
+    /** True if setModified() was called during the current batch */
+    bool m_batchModified;
+
+    /** True if publishPatchSnapshot() was called during the current batch */
+    bool m_batchPatchChanged;
+
     /*********************************************************************
      * Load & Save
      *********************************************************************/
@@ -369,6 +582,17 @@ public:
      */
     bool loadXML(const QDomElement& root);
 
+    /**
+     * Load contents from the current element of an XML stream. Produces the
+     * same contents as loadXML(const QDomElement&) without building a DOM
+     * tree of the whole workspace first.
+     *
+     * @param xml A reader positioned at the Engine StartElement. When this
+     *            method returns, the reader is at the matching EndElement.
+     * @return true if successful, otherwise false
+     */
+    bool loadXML(QXmlStreamReader& xml);
+
     /**
      * Save contents to the given XML file.
      *
@@ -378,6 +602,64 @@ public:
      */
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root);
 
+    /**
+     * Save contents to an XML stream, as an Engine element.
+     *
+     * @param xml The stream to write to
+     * @return true if successful, otherwise false
+     */
+    bool saveXML(QXmlStreamWriter& xml);
+
+    /**
+     * Save contents as a list of serialized XML fragments that together make
+     * up an Engine element. The fragments are plain data that doesn't refer
+     * to anything in Doc, so they can be written to a file in another thread
+     * while the document is being edited.
+     *
+     * Fixtures, fixture groups, scenes, chasers and collections that haven't
+     * changed since the previous call reuse the fragments serialized back
+     * then, so saving a large workspace after a small edit serializes only
+     * the objects that were edited.
+     *
+     * @param fragments A list to append the fragments to
+     */
+    void saveXMLFragments(QList <QByteArray>& fragments);
+
+private:
+    /**
+     * Check, whether the given function always tells about its changes thru
+     * Function::changed(), so that its serialized XML can be cached.
+     */
+    static bool isSaveCacheable(const Function* function);
+
+    /** Serialized XML of unchanged objects, by ID (see saveXMLFragments()) */
+    QHash <quint32,QByteArray> m_fixtureXMLCache;
+    QHash <quint32,QByteArray> m_functionXMLCache;
+    QHash <quint32,QByteArray> m_fixtureGroupXMLCache;
+
+    /*********************************************************************
+     * Binary cache
+     *********************************************************************/
+public:
+    /**
+     * Save contents to a binary workspace cache (see WorkspaceCache).
+     *
+     * @param data The stream to write to
+     * @return true if successful, otherwise false
+     */
+    bool saveBinary(QDataStream& data);
+
+    /**
+     * Load contents from a binary workspace cache. Since a binary cache
+     * can't skip over anything it doesn't understand, loading stops at the
+     * first error and the caller should then clear the contents and load
+     * the workspace from XML instead.
+     *
+     * @param data The stream to read from
+     * @return true if successful, otherwise false
+     */
+    bool loadBinary(QDataStream& data);
+
 private:
     /**
      * Calls postLoad() for each Function after everything has been loaded
@@ -386,4 +668,6 @@ private:
     void postLoad();
 };
 
+Q_DECLARE_METATYPE(Doc::BatchChanges)
+
 #endif
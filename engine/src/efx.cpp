@@ -516,23 +516,27 @@ const QList <EFXFixture*> EFX::fixtures() const
     return m_fixtures;
 }
 
-void EFX::slotFixtureRemoved(quint32 fxi_id)
+void EFX::fixturesRemoved(const QSet <quint32>& ids)
 {
-    /* Remove the destroyed fixture from our list */
+    /* Remove the destroyed fixtures from our list */
     QMutableListIterator <EFXFixture*> it(m_fixtures);
     while (it.hasNext() == true)
     {
         it.next();
 
-        if (it.value()->fixture() == fxi_id)
+        if (ids.contains(it.value()->fixture()) == true)
         {
             delete it.value();
             it.remove();
-            break;
         }
     }
 }
 
+void EFX::slotFixtureRemoved(quint32 fxi_id)
+{
+    fixturesRemoved(QSet <quint32> () << fxi_id);
+}
+
 /*****************************************************************************
  * Fixture propagation mode
  *****************************************************************************/
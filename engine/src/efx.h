@@ -420,8 +420,11 @@ public:
     /** Get a list of fixtures taking part in this EFX */
     const QList <EFXFixture*> fixtures() const;
 
+    /** @reimpl */
+    void fixturesRemoved(const QSet <quint32>& ids);
+
 public slots:
-    /** Slot that captures Doc::fixtureRemoved signals */
+    /** Called by Doc whenever a fixture is removed outside of a batch */
     void slotFixtureRemoved(quint32 fxi_id);
 
 private:
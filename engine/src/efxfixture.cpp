@@ -113,11 +113,11 @@ uchar EFXFixture::fadeIntensity() const
 
 bool EFXFixture::isValid() const
 {
-    Fixture* fxi = doc()->fixture(fixture());
+    const PatchSnapshot::FixtureInfo* fxi = doc()->patchSnapshot()->fixture(fixture());
     if (fxi == NULL)
         return false;
-    else if (fxi->panMsbChannel() == QLCChannel::invalid() && // Maybe a device can pan OR tilt
-             fxi->tiltMsbChannel() == QLCChannel::invalid())   // but not both. Teh sux0r.
+    else if (fxi->head(0).panMsbChannel() == QLCChannel::invalid() && // Maybe a device can pan OR tilt
+             fxi->head(0).tiltMsbChannel() == QLCChannel::invalid())   // but not both. Teh sux0r.
         return false;
     else
         return true;
@@ -314,31 +314,49 @@ void EFXFixture::setPoint(UniverseArray* universes, qreal pan, qreal tilt)
 {
     Q_ASSERT(universes != NULL);
 
-    Fixture* fxi = doc()->fixture(fixture());
+    /* Called from the MasterTimer thread, so use the patch snapshot */
+    const PatchSnapshot::FixtureInfo* fxi = doc()->patchSnapshot()->fixture(fixture());
     Q_ASSERT(fxi != NULL);
+    const QLCFixtureHead& head(fxi->head(0));
 
-    /* Write coarse point data to universes */
-    if (fxi->panMsbChannel() != QLCChannel::invalid())
-        universes->write(fxi->universeAddress() + fxi->panMsbChannel(),
-                         static_cast<char>(pan), QLCChannel::Pan);
-    if (fxi->tiltMsbChannel() != QLCChannel::invalid())
-        universes->write(fxi->universeAddress() + fxi->tiltMsbChannel(),
-                         static_cast<char> (tilt), QLCChannel::Tilt);
+    int channels[4];
+    uchar values[4];
+    QLCChannel::Group groups[4];
+    int count = 0;
 
-    /* Write fine point data to universes if applicable */
-    if (fxi->panLsbChannel() != QLCChannel::invalid())
+    /* Coarse point data */
+    if (head.panMsbChannel() != QLCChannel::invalid())
+    {
+        channels[count] = fxi->address + head.panMsbChannel();
+        values[count] = static_cast<char> (pan);
+        groups[count++] = QLCChannel::Pan;
+    }
+
+    if (head.tiltMsbChannel() != QLCChannel::invalid())
+    {
+        channels[count] = fxi->address + head.tiltMsbChannel();
+        values[count] = static_cast<char> (tilt);
+        groups[count++] = QLCChannel::Tilt;
+    }
+
+    /* Fine point data, if applicable */
+    if (head.panLsbChannel() != QLCChannel::invalid())
     {
         /* Leave only the fraction */
-        char value = static_cast<char> ((pan - floor(pan)) * double(UCHAR_MAX));
-        universes->write(fxi->universeAddress() + fxi->panLsbChannel(), value, QLCChannel::Pan);
+        channels[count] = fxi->address + head.panLsbChannel();
+        values[count] = static_cast<char> ((pan - floor(pan)) * double(UCHAR_MAX));
+        groups[count++] = QLCChannel::Pan;
     }
 
-    if (fxi->tiltLsbChannel() != QLCChannel::invalid())
+    if (head.tiltLsbChannel() != QLCChannel::invalid())
     {
         /* Leave only the fraction */
-        char value = static_cast<char> ((tilt - floor(tilt)) * double(UCHAR_MAX));
-        universes->write(fxi->universeAddress() + fxi->tiltLsbChannel(), value, QLCChannel::Tilt);
+        channels[count] = fxi->address + head.tiltLsbChannel();
+        values[count] = static_cast<char> ((tilt - floor(tilt)) * double(UCHAR_MAX));
+        groups[count++] = QLCChannel::Tilt;
     }
+
+    universes->write(channels, values, groups, count);
 }
 
 void EFXFixture::start(MasterTimer* timer, UniverseArray* universes)
@@ -348,14 +366,15 @@ void EFXFixture::start(MasterTimer* timer, UniverseArray* universes)
 
     if (fadeIntensity() > 0 && m_started == false)
     {
-        Fixture* fxi = doc()->fixture(fixture());
+        const PatchSnapshot::FixtureInfo* fxi = doc()->patchSnapshot()->fixture(fixture());
         Q_ASSERT(fxi != NULL);
 
-        if (fxi->masterIntensityChannel() != QLCChannel::invalid())
+        quint32 master = fxi->masterIntensityChannel();
+        if (master != QLCChannel::invalid())
         {
             FadeChannel fc;
             fc.setFixture(fixture());
-            fc.setChannel(fxi->masterIntensityChannel());
+            fc.setChannel(master);
             if (m_parent->overrideFadeInSpeed() != Function::defaultSpeed())
                 fc.setFadeTime(m_parent->overrideFadeInSpeed());
             else
@@ -379,14 +398,15 @@ void EFXFixture::stop(MasterTimer* timer, UniverseArray* universes)
 
     if (fadeIntensity() > 0 && m_started == true)
     {
-        Fixture* fxi = doc()->fixture(fixture());
+        const PatchSnapshot::FixtureInfo* fxi = doc()->patchSnapshot()->fixture(fixture());
         Q_ASSERT(fxi != NULL);
 
-        if (fxi->masterIntensityChannel() != QLCChannel::invalid())
+        quint32 master = fxi->masterIntensityChannel();
+        if (master != QLCChannel::invalid())
         {
             FadeChannel fc;
             fc.setFixture(fixture());
-            fc.setChannel(fxi->masterIntensityChannel());
+            fc.setChannel(master);
 
             if (m_parent->overrideFadeOutSpeed() != Function::defaultSpeed())
                 fc.setFadeTime(m_parent->overrideFadeOutSpeed());
@@ -85,49 +85,25 @@ quint32 FadeChannel::address(const Doc* doc) const
     if (fixture() == Fixture::invalidId())
         return channel(); // No fixture, assume absolute DMX address
 
-    Fixture* fxi = doc->fixture(fixture());
-    if (fxi == NULL)
-        return QLCChannel::invalid();
-    else
-        return (fxi->universeAddress() + channel());
+    // FadeChannels are used from the MasterTimer thread, so look the
+    // fixture up from the published patch snapshot instead of Doc's
+    // fixture instances that the main thread may be modifying.
+    return doc->patchSnapshot()->channelAddress(fixture(), channel());
 }
 
 QLCChannel::Group FadeChannel::group(const Doc* doc) const
 {
-    uint chnum = QLCChannel::invalid();
-    Fixture* fxi = NULL;
+    const PatchSnapshot* patch = doc->patchSnapshot();
 
+    // Do a reverse lookup; which fixture occupies channel() which is now
+    // treated as an absolute DMX address. The patch snapshot already
+    // knows the group of each address.
     if (fixture() == Fixture::invalidId())
-    {
-        // Do a reverse lookup; which fixture occupies channel()
-        // which is now treated as an absolute DMX address.
-        quint32 id = doc->fixtureForAddress(channel());
-        if (id == Fixture::invalidId())
-            return QLCChannel::Intensity;
-
-        fxi = doc->fixture(id);
-        if (fxi == NULL)
-            return QLCChannel::Intensity;
-
-        // Convert channel() to a relative channel number
-        chnum = channel() - fxi->universeAddress();
-    }
-    else
-    {
-        // This FadeChannel contains a valid fixture ID
-        fxi = doc->fixture(fixture());
-        if (fxi == NULL)
-            return QLCChannel::Intensity;
-
-        // channel() is already a relative channel number
-        chnum = channel();
-    }
+        return patch->addressInfo(channel()).group;
 
-    const QLCChannel* ch = fxi->channel(chnum);
-    if (ch == NULL)
-        return QLCChannel::Intensity;
-    else
-        return ch->group();
+    // This FadeChannel contains a valid fixture ID and channel() is
+    // already a relative channel number
+    return patch->channelGroup(fixture(), channel());
 }
 
 void FadeChannel::setStart(uchar value)
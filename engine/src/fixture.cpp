@@ -19,6 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QString>
 #include <QDebug>
 #include <QtXml>
@@ -28,6 +31,7 @@
 #include "qlcfixturehead.h"
 #include "qlcfixturedef.h"
 #include "qlccapability.h"
+#include "qlcxmltags.h"
 #include "qlcchannel.h"
 
 #include "fixture.h"
@@ -173,6 +177,7 @@ quint32 Fixture::universeAddress() const
 void Fixture::setChannels(quint32 channels)
 {
     m_channels = channels;
+    emit changed(m_id);
 }
 
 quint32 Fixture::channels() const
@@ -466,14 +471,19 @@ QLCFixtureHead Fixture::head(int index) const
  * Load & Save
  *****************************************************************************/
 
-bool Fixture::loader(const QDomElement& root, Doc* doc)
+/**
+ * Add a freshly loaded fixture to doc or delete it if loading failed
+ *
+ * @param fxi The fixture that was loaded
+ * @param loaded true if the fixture was loaded successfully
+ * @param doc The doc that owns all fixtures
+ * @return true if the fixture was added to doc
+ */
+static bool addLoadedFixture(Fixture* fxi, bool loaded, Doc* doc)
 {
     bool result = false;
 
-    Fixture* fxi = new Fixture(doc);
-    Q_ASSERT(fxi != NULL);
-
-    if (fxi->loadXML(root, doc->fixtureDefCache()) == true)
+    if (loaded == true)
     {
         if (doc->addFixture(fxi, fxi->id()) == true)
         {
@@ -497,11 +507,27 @@ bool Fixture::loader(const QDomElement& root, Doc* doc)
     return result;
 }
 
+bool Fixture::loader(const QDomElement& root, Doc* doc)
+{
+    Fixture* fxi = new Fixture(doc);
+    Q_ASSERT(fxi != NULL);
+
+    bool loaded = fxi->loadXML(root, doc->fixtureDefCache());
+    return addLoadedFixture(fxi, loaded, doc);
+}
+
+bool Fixture::loader(QXmlStreamReader& xml, Doc* doc)
+{
+    Fixture* fxi = new Fixture(doc);
+    Q_ASSERT(fxi != NULL);
+
+    bool loaded = fxi->loadXML(xml, doc->fixtureDefCache());
+    return addLoadedFixture(fxi, loaded, doc);
+}
+
 bool Fixture::loadXML(const QDomElement& root,
                       const QLCFixtureDefCache* fixtureDefCache)
 {
-    const QLCFixtureDef* fixtureDef = NULL;
-    const QLCFixtureMode* fixtureMode = NULL;
     QString manufacturer;
     QString model;
     QString modeName;
@@ -562,6 +588,91 @@ bool Fixture::loadXML(const QDomElement& root,
         node = node.nextSibling();
     }
 
+    return loadXMLValues(manufacturer, model, modeName, name, id,
+                         universe, address, channels, fixtureDefCache);
+}
+
+bool Fixture::loadXML(QXmlStreamReader& xml,
+                      const QLCFixtureDefCache* fixtureDefCache)
+{
+    enum { TagManufacturer, TagModel, TagMode, TagID, TagName,
+           TagUniverse, TagAddress, TagChannels };
+    static const QLCXMLTags tags(QStringList() << KXMLQLCFixtureDefManufacturer
+                                               << KXMLQLCFixtureDefModel
+                                               << KXMLQLCFixtureMode
+                                               << KXMLFixtureID
+                                               << KXMLFixtureName
+                                               << KXMLFixtureUniverse
+                                               << KXMLFixtureAddress
+                                               << KXMLFixtureChannels);
+
+    QString manufacturer;
+    QString model;
+    QString modeName;
+    QString name;
+    quint32 id = Fixture::invalidId();
+    quint32 universe = 0;
+    quint32 address = 0;
+    quint32 channels = 0;
+
+    if (xml.name() != QLatin1String(KXMLFixture))
+    {
+        qWarning() << Q_FUNC_INFO << "Fixture node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    while (xml.readNextStartElement() == true)
+    {
+        switch (tags.id(xml.name()))
+        {
+        case TagManufacturer:
+            manufacturer = xml.readElementText();
+            break;
+        case TagModel:
+            model = xml.readElementText();
+            break;
+        case TagMode:
+            modeName = xml.readElementText();
+            break;
+        case TagID:
+            id = xml.readElementText().toUInt();
+            break;
+        case TagName:
+            name = xml.readElementText();
+            break;
+        case TagUniverse:
+            universe = xml.readElementText().toInt();
+            break;
+        case TagAddress:
+            address = xml.readElementText().toInt();
+            break;
+        case TagChannels:
+            channels = xml.readElementText().toInt();
+            break;
+        default:
+            qWarning() << Q_FUNC_INFO << "Unknown fixture tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+            break;
+        }
+    }
+
+    if (xml.hasError() == true)
+        return false;
+
+    return loadXMLValues(manufacturer, model, modeName, name, id,
+                         universe, address, channels, fixtureDefCache);
+}
+
+bool Fixture::loadXMLValues(const QString& manufacturer, const QString& model,
+                            const QString& modeName, const QString& name,
+                            quint32 id, quint32 universe, quint32 address,
+                            quint32 channels,
+                            const QLCFixtureDefCache* fixtureDefCache)
+{
+    const QLCFixtureDef* fixtureDef = NULL;
+    const QLCFixtureMode* fixtureMode = NULL;
+
     /* Find the given fixture definition, unless its a generic dimmer */
     if (manufacturer != KXMLFixtureGeneric && model != KXMLFixtureGeneric)
     {
@@ -712,6 +823,88 @@ bool Fixture::saveXML(QDomDocument* doc, QDomElement* wksp_root) const
     return true;
 }
 
+bool Fixture::saveXML(QXmlStreamWriter& xml) const
+{
+    /* Fixture Instance entry */
+    xml.writeStartElement(KXMLFixture);
+
+    if (m_fixtureDef != NULL)
+    {
+        xml.writeTextElement(KXMLQLCFixtureDefManufacturer, m_fixtureDef->manufacturer());
+        xml.writeTextElement(KXMLQLCFixtureDefModel, m_fixtureDef->model());
+    }
+    else
+    {
+        xml.writeTextElement(KXMLQLCFixtureDefManufacturer, KXMLFixtureGeneric);
+        xml.writeTextElement(KXMLQLCFixtureDefModel, KXMLFixtureGeneric);
+    }
+
+    if (m_fixtureMode != NULL)
+        xml.writeTextElement(KXMLQLCFixtureMode, m_fixtureMode->name());
+    else
+        xml.writeTextElement(KXMLQLCFixtureMode, KXMLFixtureGeneric);
+
+    xml.writeTextElement(KXMLFixtureID, QString::number(id()));
+    xml.writeTextElement(KXMLFixtureName, m_name);
+    xml.writeTextElement(KXMLFixtureUniverse, QString::number(universe()));
+    xml.writeTextElement(KXMLFixtureAddress, QString::number(address()));
+    xml.writeTextElement(KXMLFixtureChannels, QString::number(channels()));
+
+    xml.writeEndElement();
+
+    return true;
+}
+
+/*****************************************************************************
+ * Binary cache
+ *****************************************************************************/
+
+bool Fixture::binaryLoader(QDataStream& data, Doc* doc)
+{
+    Fixture* fxi = new Fixture(doc);
+    Q_ASSERT(fxi != NULL);
+
+    bool loaded = fxi->loadBinary(data, doc->fixtureDefCache());
+    return addLoadedFixture(fxi, loaded, doc);
+}
+
+bool Fixture::loadBinary(QDataStream& data, const QLCFixtureDefCache* fixtureDefCache)
+{
+    QString manufacturer;
+    QString model;
+    QString modeName;
+    QString name;
+    quint32 id = Fixture::invalidId();
+    quint32 universe = 0;
+    quint32 address = 0;
+    quint32 channels = 0;
+
+    data >> manufacturer >> model >> modeName >> name;
+    data >> id >> universe >> address >> channels;
+    if (data.status() != QDataStream::Ok)
+        return false;
+
+    return loadXMLValues(manufacturer, model, modeName, name, id, universe,
+                         address, channels, fixtureDefCache);
+}
+
+bool Fixture::saveBinary(QDataStream& data) const
+{
+    if (m_fixtureDef != NULL)
+        data << m_fixtureDef->manufacturer() << m_fixtureDef->model();
+    else
+        data << QString(KXMLFixtureGeneric) << QString(KXMLFixtureGeneric);
+
+    if (m_fixtureMode != NULL)
+        data << m_fixtureMode->name();
+    else
+        data << QString(KXMLFixtureGeneric);
+
+    data << m_name << id() << universe() << address() << channels();
+
+    return (data.status() == QDataStream::Ok);
+}
+
 /*****************************************************************************
  * Status
  *****************************************************************************/
@@ -36,6 +36,9 @@
 #define KXMLFixtureChannels "Channels"
 #define KXMLFixtureDimmer "Dimmer"
 
+class QXmlStreamWriter;
+class QDataStream;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 class QString;
@@ -355,6 +358,15 @@ public:
      */
     static bool loader(const QDomElement& root, Doc* doc);
 
+    /**
+     * Load a fixture from the current element of the given XML stream and
+     * attempt to add it to the given QLC Doc instance.
+     *
+     * @param xml A reader positioned at a Fixture StartElement
+     * @param doc The doc that owns all fixtures
+     */
+    static bool loader(QXmlStreamReader& xml, Doc* doc);
+
     /**
      * Load a fixture's contents from the given XML node.
      *
@@ -364,6 +376,29 @@ public:
     bool loadXML(const QDomElement& root,
                  const QLCFixtureDefCache* fixtureDefCache);
 
+    /**
+     * Load a fixture's contents from the current element of an XML stream.
+     *
+     * @param xml A reader positioned at a Fixture StartElement. When this
+     *            method returns, the reader is at the matching EndElement.
+     * @return true if the fixture was loaded successfully, otherwise false
+     */
+    bool loadXML(QXmlStreamReader& xml,
+                 const QLCFixtureDefCache* fixtureDefCache);
+
+private:
+    /**
+     * Set up the fixture from the values read by either of the loadXML()
+     * methods.
+     */
+    bool loadXMLValues(const QString& manufacturer, const QString& model,
+                       const QString& modeName, const QString& name,
+                       quint32 id, quint32 universe, quint32 address,
+                       quint32 channels,
+                       const QLCFixtureDefCache* fixtureDefCache);
+
+public:
+
     /**
      * Save the fixture instance into an XML document, under the given
      * XML element (tag).
@@ -373,6 +408,32 @@ public:
      */
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root) const;
 
+    /**
+     * Save the fixture instance into an XML stream.
+     *
+     * @param xml The stream to write to
+     */
+    bool saveXML(QXmlStreamWriter& xml) const;
+
+    /*********************************************************************
+     * Binary cache
+     *********************************************************************/
+public:
+    /**
+     * Load a fixture from a binary workspace cache (see WorkspaceCache)
+     * and attempt to add it to the given QLC Doc instance.
+     *
+     * @param data The stream to read from
+     * @param doc The doc that owns all fixtures
+     */
+    static bool binaryLoader(QDataStream& data, Doc* doc);
+
+    /** Load the fixture's contents from a binary workspace cache */
+    bool loadBinary(QDataStream& data, const QLCFixtureDefCache* fixtureDefCache);
+
+    /** Save the fixture's contents to a binary workspace cache */
+    bool saveBinary(QDataStream& data) const;
+
     /*********************************************************************
      * Status
      *********************************************************************/
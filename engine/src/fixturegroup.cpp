@@ -19,6 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNode>
@@ -26,6 +29,7 @@
 #include <QDebug>
 
 #include "fixturegroup.h"
+#include "qlcxmltags.h"
 #include "qlcpoint.h"
 #include "fixture.h"
 #include "doc.h"
@@ -220,6 +224,11 @@ QList <GroupHead> FixtureGroup::headList() const
     return m_heads.values();
 }
 
+bool FixtureGroup::hasHead(const QLCPoint& pt) const
+{
+    return m_heads.contains(pt);
+}
+
 QHash <QLCPoint,GroupHead> FixtureGroup::headHash() const
 {
     return m_heads;
@@ -238,8 +247,16 @@ QList <quint32> FixtureGroup::fixtureList() const
 
 void FixtureGroup::slotFixtureRemoved(quint32 id)
 {
-    // Remove the fixture from group records since it's no longer there
-    resignFixture(id);
+    // Remove the fixture from group records since it's no longer there.
+    // Don't bother the group's listeners if the fixture wasn't a member.
+    foreach (const GroupHead& head, m_heads)
+    {
+        if (head.fxi == id)
+        {
+            resignFixture(id);
+            break;
+        }
+    }
 }
 
 /****************************************************************************
@@ -342,6 +359,100 @@ bool FixtureGroup::loadXML(const QDomElement& root)
     return true;
 }
 
+bool FixtureGroup::loader(QXmlStreamReader& xml, Doc* doc)
+{
+    bool result = false;
+
+    FixtureGroup* grp = new FixtureGroup(doc);
+    Q_ASSERT(grp != NULL);
+
+    if (grp->loadXML(xml) == true)
+    {
+        doc->addFixtureGroup(grp, grp->id());
+        result = true;
+    }
+    else
+    {
+        qWarning() << Q_FUNC_INFO << "FixtureGroup" << grp->name() << "cannot be loaded.";
+        delete grp;
+        result = false;
+    }
+
+    return result;
+}
+
+bool FixtureGroup::loadXML(QXmlStreamReader& xml)
+{
+    enum { TagHead, TagSize, TagName };
+    static const QLCXMLTags tags(QStringList() << KXMLQLCFixtureGroupHead
+                                               << KXMLQLCFixtureGroupSize
+                                               << KXMLQLCFixtureGroupName);
+
+    if (xml.name() != QLatin1String(KXMLQLCFixtureGroup))
+    {
+        qWarning() << Q_FUNC_INFO << "Fixture group node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    bool ok = false;
+    QString idStr = xml.attributes().value(KXMLQLCFixtureGroupID).toString();
+    quint32 id = idStr.toUInt(&ok);
+    if (ok == false)
+    {
+        qWarning() << "Invalid FixtureGroup ID:" << idStr;
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    // Assign the ID to myself
+    m_id = id;
+
+    while (xml.readNextStartElement() == true)
+    {
+        QXmlStreamAttributes attrs(xml.attributes());
+        switch (tags.id(xml.name()))
+        {
+        case TagHead:
+        {
+            bool xok = false, yok = false, idok = false, headok = false;
+            int x = attrs.value("X").toString().toInt(&xok);
+            int y = attrs.value("Y").toString().toInt(&yok);
+            quint32 id = attrs.value("Fixture").toString().toUInt(&idok);
+            int head = xml.readElementText().toInt(&headok);
+
+            // Don't use assignFixture() here because it assigns complete fixtures at once
+            if (xok == true && yok == true && idok == true && headok == true)
+                m_heads[QLCPoint(x, y)] = GroupHead(id, head);
+            break;
+        }
+
+        case TagSize:
+        {
+            bool xok = false, yok = false;
+            int x = attrs.value("X").toString().toInt(&xok);
+            int y = attrs.value("Y").toString().toInt(&yok);
+
+            if (xok == true && yok == true)
+                m_size = QSize(x, y);
+            xml.skipCurrentElement();
+            break;
+        }
+
+        case TagName:
+            m_name = xml.readElementText();
+            break;
+
+        default:
+            qWarning() << Q_FUNC_INFO << "Unknown fixture group tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+            break;
+        }
+    }
+
+    return (xml.hasError() == false);
+}
+
 bool FixtureGroup::saveXML(QDomDocument* doc, QDomElement* wksp_root)
 {
     QDomElement root;
@@ -384,3 +495,91 @@ bool FixtureGroup::saveXML(QDomDocument* doc, QDomElement* wksp_root)
 
     return true;
 }
+
+bool FixtureGroup::saveXML(QXmlStreamWriter& xml) const
+{
+    /* Fixture Group entry */
+    xml.writeStartElement(KXMLQLCFixtureGroup);
+    xml.writeAttribute(KXMLQLCFixtureGroupID, QString::number(id()));
+
+    /* Name */
+    xml.writeTextElement(KXMLQLCFixtureGroupName, name());
+
+    /* Matrix size */
+    xml.writeStartElement(KXMLQLCFixtureGroupSize);
+    xml.writeAttribute("X", QString::number(size().width()));
+    xml.writeAttribute("Y", QString::number(size().height()));
+    xml.writeEndElement();
+
+    /* Fixture heads */
+    QHashIterator <QLCPoint,GroupHead> it(m_heads);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        xml.writeStartElement(KXMLQLCFixtureGroupHead);
+        xml.writeAttribute("X", QString::number(it.key().x()));
+        xml.writeAttribute("Y", QString::number(it.key().y()));
+        xml.writeAttribute("Fixture", QString::number(it.value().fxi));
+        xml.writeCharacters(QString::number(it.value().head));
+        xml.writeEndElement();
+    }
+
+    xml.writeEndElement();
+
+    return true;
+}
+
+/****************************************************************************
+ * Binary cache
+ ****************************************************************************/
+
+bool FixtureGroup::binaryLoader(QDataStream& data, Doc* doc)
+{
+    FixtureGroup* grp = new FixtureGroup(doc);
+    Q_ASSERT(grp != NULL);
+
+    if (grp->loadBinary(data) == true)
+    {
+        doc->addFixtureGroup(grp, grp->id());
+        return true;
+    }
+    else
+    {
+        qWarning() << Q_FUNC_INFO << "FixtureGroup" << grp->name() << "cannot be loaded.";
+        delete grp;
+        return false;
+    }
+}
+
+bool FixtureGroup::loadBinary(QDataStream& data)
+{
+    quint32 count = 0;
+    data >> m_id >> m_name >> m_size >> count;
+
+    m_heads.clear();
+    for (quint32 i = 0; i < count && data.status() == QDataStream::Ok; i++)
+    {
+        qint32 x = 0, y = 0;
+        quint32 fxi = 0;
+        qint32 head = 0;
+        data >> x >> y >> fxi >> head;
+        m_heads[QLCPoint(x, y)] = GroupHead(fxi, head);
+    }
+
+    return (data.status() == QDataStream::Ok);
+}
+
+bool FixtureGroup::saveBinary(QDataStream& data) const
+{
+    data << m_id << m_name << m_size << quint32(m_heads.size());
+
+    QHashIterator <QLCPoint,GroupHead> it(m_heads);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        data << qint32(it.key().x()) << qint32(it.key().y())
+             << it.value().fxi << qint32(it.value().head);
+    }
+
+    return (data.status() == QDataStream::Ok);
+}
@@ -33,6 +33,9 @@
 
 #define KXMLQLCFixtureGroup "FixtureGroup"
 
+class QXmlStreamWriter;
+class QDataStream;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 class Doc;
@@ -145,6 +148,9 @@ public:
      */
     GroupHead head(const QLCPoint& pt) const;
 
+    /** Check, whether a fixture head has been assigned at the given point */
+    bool hasHead(const QLCPoint& pt) const;
+
     /** Get a list of fixtures assigned to a group */
     QList <GroupHead> headList() const;
 
@@ -179,8 +185,19 @@ private:
      ************************************************************************/
 public:
     static bool loader(const QDomElement& root, Doc* doc);
+    static bool loader(QXmlStreamReader& xml, Doc* doc);
     bool loadXML(const QDomElement& root);
+    bool loadXML(QXmlStreamReader& xml);
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root);
+    bool saveXML(QXmlStreamWriter& xml) const;
+
+    /************************************************************************
+     * Binary cache
+     ************************************************************************/
+public:
+    static bool binaryLoader(QDataStream& data, Doc* doc);
+    bool loadBinary(QDataStream& data);
+    bool saveBinary(QDataStream& data) const;
 };
 
 #endif
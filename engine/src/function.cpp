@@ -19,6 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QDataStream>
 #include <QString>
 #include <QDebug>
 #include <QtXml>
@@ -51,6 +54,14 @@ const QString KSingleShotString ( "SingleShot" );
 const QString KBackwardString   (   "Backward" );
 const QString KForwardString    (    "Forward" );
 
+/* Layout of the published state word */
+#define KStateRunning        (1 << 0)
+#define KStateFlashing       (1 << 1)
+#define KStateIntensityShift 8
+#define KStateIntensityMask  (0xFF << KStateIntensityShift)
+#define KStateRunCountShift  16
+#define KStateRunCountMask   (0x7FFF << KStateRunCountShift)
+
 /*****************************************************************************
  * Initialization
  *****************************************************************************/
@@ -73,6 +84,7 @@ Function::Function(Doc* doc, Type t)
     , m_running(false)
     , m_startedAsChild(false)
     , m_intensity(1.0)
+    , m_publishedState(KStateIntensityMask)
 {
     Q_ASSERT(doc != NULL);
 }
@@ -258,6 +270,12 @@ bool Function::saveXMLRunOrder(QDomDocument* doc, QDomElement* root) const
     return true;
 }
 
+bool Function::saveXMLRunOrder(QXmlStreamWriter& xml) const
+{
+    xml.writeTextElement(KXMLQLCFunctionRunOrder, runOrderToString(runOrder()));
+    return true;
+}
+
 bool Function::loadXMLRunOrder(const QDomElement& root)
 {
     if (root.tagName() != KXMLQLCFunctionRunOrder)
@@ -271,6 +289,20 @@ bool Function::loadXMLRunOrder(const QDomElement& root)
     return true;
 }
 
+bool Function::loadXMLRunOrder(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunctionRunOrder))
+    {
+        qWarning() << Q_FUNC_INFO << "RunOrder node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    setRunOrder(stringToRunOrder(xml.readElementText()));
+
+    return true;
+}
+
 /*****************************************************************************
  * Direction
  *****************************************************************************/
@@ -325,6 +357,12 @@ bool Function::saveXMLDirection(QDomDocument* doc, QDomElement* root) const
     return true;
 }
 
+bool Function::saveXMLDirection(QXmlStreamWriter& xml) const
+{
+    xml.writeTextElement(KXMLQLCFunctionDirection, directionToString(direction()));
+    return true;
+}
+
 bool Function::loadXMLDirection(const QDomElement& root)
 {
     if (root.tagName() != KXMLQLCFunctionDirection)
@@ -338,6 +376,20 @@ bool Function::loadXMLDirection(const QDomElement& root)
     return true;
 }
 
+bool Function::loadXMLDirection(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunctionDirection))
+    {
+        qWarning() << Q_FUNC_INFO << "Direction node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    setDirection(stringToDirection(xml.readElementText()));
+
+    return true;
+}
+
 /****************************************************************************
  * Speed
  ****************************************************************************/
@@ -454,6 +506,23 @@ bool Function::loadXMLSpeed(const QDomElement& speedRoot)
     return true;
 }
 
+bool Function::loadXMLSpeed(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunctionSpeed))
+    {
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    QXmlStreamAttributes attrs(xml.attributes());
+    m_fadeInSpeed = attrs.value(KXMLQLCFunctionSpeedFadeIn).toString().toUInt();
+    m_fadeOutSpeed = attrs.value(KXMLQLCFunctionSpeedFadeOut).toString().toUInt();
+    m_duration = attrs.value(KXMLQLCFunctionSpeedDuration).toString().toUInt();
+    xml.skipCurrentElement();
+
+    return true;
+}
+
 bool Function::saveXMLSpeed(QDomDocument* doc, QDomElement* root) const
 {
     QDomElement tag;
@@ -467,6 +536,17 @@ bool Function::saveXMLSpeed(QDomDocument* doc, QDomElement* root) const
     return true;
 }
 
+bool Function::saveXMLSpeed(QXmlStreamWriter& xml) const
+{
+    xml.writeStartElement(KXMLQLCFunctionSpeed);
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeIn, QString::number(fadeInSpeed()));
+    xml.writeAttribute(KXMLQLCFunctionSpeedFadeOut, QString::number(fadeOutSpeed()));
+    xml.writeAttribute(KXMLQLCFunctionSpeedDuration, QString::number(duration()));
+    xml.writeEndElement();
+
+    return true;
+}
+
 uint Function::infiniteSpeed()
 {
     return (uint) -2;
@@ -481,6 +561,12 @@ uint Function::defaultSpeed()
  * Fixtures
  *****************************************************************************/
 
+void Function::fixturesRemoved(const QSet <quint32>& ids)
+{
+    foreach (quint32 id, ids)
+        slotFixtureRemoved(id);
+}
+
 void Function::slotFixtureRemoved(quint32 fid)
 {
     Q_UNUSED(fid);
@@ -490,6 +576,29 @@ void Function::slotFixtureRemoved(quint32 fid)
  * Load & Save
  *****************************************************************************/
 
+/**
+ * Create a new, empty function of the given type
+ *
+ * @return A new function or NULL if the type is unknown
+ */
+static Function* createFunction(Function::Type type, Doc* doc)
+{
+    if (type == Function::Scene)
+        return new class Scene(doc);
+    else if (type == Function::Chaser)
+        return new class Chaser(doc);
+    else if (type == Function::Collection)
+        return new class Collection(doc);
+    else if (type == Function::EFX)
+        return new class EFX(doc);
+    else if (type == Function::Script)
+        return new class Script(doc);
+    else if (type == Function::RGBMatrix)
+        return new class RGBMatrix(doc);
+    else
+        return NULL;
+}
+
 bool Function::loader(const QDomElement& root, Doc* doc)
 {
     if (root.tagName() != KXMLQLCFunction)
@@ -511,20 +620,8 @@ bool Function::loader(const QDomElement& root, Doc* doc)
     }
 
     /* Create a new function according to the type */
-    Function* function = NULL;
-    if (type == Function::Scene)
-        function = new class Scene(doc);
-    else if (type == Function::Chaser)
-        function = new class Chaser(doc);
-    else if (type == Function::Collection)
-        function = new class Collection(doc);
-    else if (type == Function::EFX)
-        function = new class EFX(doc);
-    else if (type == Function::Script)
-        function = new class Script(doc);
-    else if (type == Function::RGBMatrix)
-        function = new class RGBMatrix(doc);
-    else
+    Function* function = createFunction(type, doc);
+    if (function == NULL)
         return false;
 
     function->setName(name);
@@ -550,11 +647,181 @@ bool Function::loader(const QDomElement& root, Doc* doc)
     }
 }
 
+bool Function::loader(QXmlStreamReader& xml, Doc* doc)
+{
+    if (xml.name() != QLatin1String(KXMLQLCFunction))
+    {
+        qWarning("Function node not found!");
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Get common information from the tag's attributes */
+    QXmlStreamAttributes attrs(xml.attributes());
+    quint32 id = attrs.value(KXMLQLCFunctionID).toString().toInt();
+    QString name = attrs.value(KXMLQLCFunctionName).toString();
+    Type type = Function::stringToType(attrs.value(KXMLQLCFunctionType).toString());
+
+    /* Check for ID validity before creating the function */
+    if (id == Function::invalidId())
+    {
+        qWarning() << Q_FUNC_INFO << "Function ID" << id << "is not allowed.";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Create a new function according to the type */
+    Function* function = createFunction(type, doc);
+    if (function == NULL)
+    {
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    function->setName(name);
+    if (function->loadXML(xml) == true)
+    {
+        if (doc->addFunction(function, id) == true)
+        {
+            /* Success */
+            return true;
+        }
+        else
+        {
+            qWarning() << "Function" << name << "cannot be created.";
+            delete function;
+            return false;
+        }
+    }
+    else
+    {
+        qWarning() << "Function" << name << "cannot be loaded.";
+        delete function;
+        return false;
+    }
+}
+
+bool Function::loadXML(QXmlStreamReader& xml)
+{
+    QDomDocument doc;
+    QDomElement root = QLCFile::readXMLElement(xml, doc);
+    if (root.isNull() == true)
+        return false;
+    else
+        return loadXML(root);
+}
+
+bool Function::saveXML(QXmlStreamWriter& xml)
+{
+    QDomDocument doc;
+    QDomElement root = doc.createElement(KXMLQLCFunction);
+    doc.appendChild(root);
+    if (saveXML(&doc, &root) == false)
+        return false;
+
+    QDomElement tag = root.firstChildElement();
+    if (tag.isNull() == true)
+        return false;
+
+    QLCFile::writeXMLElement(xml, tag);
+    return true;
+}
+
 void Function::postLoad()
 {
     /* NOP */
 }
 
+/*****************************************************************************
+ * Binary cache
+ *****************************************************************************/
+
+bool Function::saveBinary(QDataStream& data)
+{
+    QByteArray xml;
+    QXmlStreamWriter writer(&xml);
+    if (saveXML(writer) == false)
+        return false;
+
+    data << xml;
+    return (data.status() == QDataStream::Ok);
+}
+
+bool Function::loadBinary(QDataStream& data)
+{
+    QByteArray xml;
+    data >> xml;
+
+    QDomDocument doc;
+    if (data.status() != QDataStream::Ok || doc.setContent(xml) == false)
+        return false;
+
+    QDomElement root = doc.documentElement();
+    setName(root.attribute(KXMLQLCFunctionName));
+    return loadXML(root);
+}
+
+bool Function::binarySaver(QDataStream& data, Function* function)
+{
+    Q_ASSERT(function != NULL);
+
+    data << quint32(function->type()) << function->id();
+    return function->saveBinary(data);
+}
+
+bool Function::binaryLoader(QDataStream& data, Doc* doc)
+{
+    quint32 type = Undefined;
+    quint32 id = Function::invalidId();
+    data >> type >> id;
+
+    if (data.status() != QDataStream::Ok || id == Function::invalidId())
+    {
+        qWarning() << Q_FUNC_INFO << "Invalid function entry";
+        return false;
+    }
+
+    /* Unlike with XML, a function that can't be loaded can't be skipped
+       either, because its length in the stream isn't known. */
+    Function* function = createFunction(Function::Type(type), doc);
+    if (function == NULL)
+        return false;
+
+    if (function->loadBinary(data) == true && doc->addFunction(function, id) == true)
+    {
+        return true;
+    }
+    else
+    {
+        qWarning() << "Function" << id << "cannot be loaded.";
+        delete function;
+        return false;
+    }
+}
+
+void Function::saveBinaryProperties(QDataStream& data) const
+{
+    data << m_name;
+    data << quint32(m_fadeInSpeed) << quint32(m_fadeOutSpeed) << quint32(m_duration);
+    data << quint8(m_runOrder) << quint8(m_direction);
+}
+
+void Function::loadBinaryProperties(QDataStream& data)
+{
+    quint32 fadeIn = 0, fadeOut = 0, duration = 0;
+    quint8 runOrder = 0, direction = 0;
+
+    data >> m_name;
+    data >> fadeIn >> fadeOut >> duration;
+    data >> runOrder >> direction;
+
+    m_fadeInSpeed = fadeIn;
+    m_fadeOutSpeed = fadeOut;
+    m_duration = duration;
+    m_runOrder = RunOrder(runOrder);
+    m_direction = Direction(direction);
+}
+
 /*****************************************************************************
  * Flash
  *****************************************************************************/
@@ -563,7 +830,10 @@ void Function::flash(MasterTimer* timer)
 {
     Q_UNUSED(timer);
     if (m_flashing == false)
+    {
+        publishState(KStateFlashing, KStateFlashing);
         emit flashing(m_id, true);
+    }
     m_flashing = true;
 }
 
@@ -571,7 +841,10 @@ void Function::unFlash(MasterTimer* timer)
 {
     Q_UNUSED(timer);
     if (m_flashing == true)
+    {
+        publishState(KStateFlashing, 0);
         emit flashing(m_id, false);
+    }
     m_flashing = false;
 }
 
@@ -589,6 +862,7 @@ void Function::preRun(MasterTimer* timer)
     Q_UNUSED(timer);
 
     m_running = true;
+    publishState(KStateRunning, KStateRunning, true);
 
     emit running(m_id);
 }
@@ -609,6 +883,7 @@ void Function::postRun(MasterTimer* timer, UniverseArray* universes)
     m_stopMutex.unlock();
 
     m_running = false;
+    publishState(KStateRunning, 0);
     emit stopped(m_id);
 }
 
@@ -703,6 +978,7 @@ bool Function::stopAndWait()
 void Function::adjustIntensity(qreal fraction)
 {
     m_intensity = CLAMP(fraction, 0.0, 1.0);
+    publishState(KStateIntensityMask, qRound(m_intensity * 255.0) << KStateIntensityShift);
     emit intensityChanged(m_intensity);
 }
 
@@ -715,3 +991,53 @@ qreal Function::intensity() const
 {
     return m_intensity;
 }
+
+/*****************************************************************************
+ * Published state
+ *****************************************************************************/
+
+int Function::publishedState() const
+{
+    return m_publishedState;
+}
+
+bool Function::stateRunning(int state)
+{
+    return (state & KStateRunning) != 0;
+}
+
+bool Function::stateFlashing(int state)
+{
+    return (state & KStateFlashing) != 0;
+}
+
+uchar Function::stateIntensity(int state)
+{
+    return uchar((state & KStateIntensityMask) >> KStateIntensityShift);
+}
+
+int Function::stateRunCount(int state)
+{
+    return (state & KStateRunCountMask) >> KStateRunCountShift;
+}
+
+void Function::publishState(int mask, int bits, bool newRun)
+{
+    int oldState;
+    int newState;
+
+    do
+    {
+        oldState = m_publishedState;
+        newState = (oldState & ~mask) | bits;
+        if (newRun == true)
+        {
+            int count = (stateRunCount(oldState) + 1) << KStateRunCountShift;
+            newState = (newState & ~KStateRunCountMask) | (count & KStateRunCountMask);
+        }
+    } while (m_publishedState.testAndSetOrdered(oldState, newState) == false);
+
+    Doc* parentDoc = doc();
+    if (newState != oldState && parentDoc != NULL)
+        parentDoc->notifyFunctionStateChanged();
+}
@@ -23,11 +23,16 @@
 #define FUNCTION_H
 
 #include <QWaitCondition>
+#include <QAtomicInt>
 #include <QObject>
 #include <QString>
 #include <QMutex>
 #include <QList>
+#include <QSet>
 
+class QXmlStreamWriter;
+class QDataStream;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 
@@ -239,9 +244,15 @@ protected:
     /** Save function's running order in $doc, under $root */
     bool saveXMLRunOrder(QDomDocument* doc, QDomElement* root) const;
 
+    /** Save function's running order to $xml */
+    bool saveXMLRunOrder(QXmlStreamWriter& xml) const;
+
     /** Load function's direction from $root */
     bool loadXMLRunOrder(const QDomElement& root);
 
+    /** Load function's running order from the current element of $xml */
+    bool loadXMLRunOrder(QXmlStreamReader& xml);
+
 private:
     RunOrder m_runOrder;
 
@@ -282,9 +293,15 @@ protected:
     /** Save function's direction in $doc, under $root */
     bool saveXMLDirection(QDomDocument* doc, QDomElement* root) const;
 
+    /** Save function's direction to $xml */
+    bool saveXMLDirection(QXmlStreamWriter& xml) const;
+
     /** Load function's direction from $root */
     bool loadXMLDirection(const QDomElement& root);
 
+    /** Load function's direction from the current element of $xml */
+    bool loadXMLDirection(QXmlStreamReader& xml);
+
 private:
     Direction m_direction;
 
@@ -341,9 +358,15 @@ protected:
     /** Load the contents of a speed node */
     bool loadXMLSpeed(const QDomElement& speedRoot);
 
+    /** Load the contents of a speed node from the current element of $xml */
+    bool loadXMLSpeed(QXmlStreamReader& xml);
+
     /** Save function's speed values under the given $root element in $doc */
     bool saveXMLSpeed(QDomDocument* doc, QDomElement* root) const;
 
+    /** Save function's speed values to $xml */
+    bool saveXMLSpeed(QXmlStreamWriter& xml) const;
+
 private:
     uint m_fadeInSpeed;
     uint m_fadeOutSpeed;
@@ -356,8 +379,18 @@ private:
     /*********************************************************************
      * Fixtures
      *********************************************************************/
+public:
+    /**
+     * Forget several removed fixtures at once. Doc calls this at the end of
+     * a batch instead of calling slotFixtureRemoved() for each fixture. The
+     * default implementation calls slotFixtureRemoved() for each ID.
+     *
+     * @param ids The IDs of the removed fixtures
+     */
+    virtual void fixturesRemoved(const QSet <quint32>& ids);
+
 public slots:
-    /** Slot that captures Doc::fixtureRemoved signals */
+    /** Called by Doc whenever a fixture is removed outside of a batch */
     virtual void slotFixtureRemoved(quint32 fxi_id);
 
     /*********************************************************************
@@ -372,6 +405,17 @@ public:
      */
     virtual bool saveXML(QDomDocument* doc, QDomElement* wksp_root) = 0;
 
+    /**
+     * Write this function to an XML stream. The default implementation
+     * saves the function into a temporary QDomDocument with
+     * saveXML(QDomDocument*, QDomElement*) and writes that out. Function
+     * types that make up the bulk of large workspaces implement this
+     * directly.
+     *
+     * @param xml The stream to write to
+     */
+    virtual bool saveXML(QXmlStreamWriter& xml);
+
     /**
      * Read this function's contents from an XML document
      *
@@ -380,6 +424,18 @@ public:
      */
     virtual bool loadXML(const QDomElement& root) = 0;
 
+    /**
+     * Read this function's contents from an XML stream. The default
+     * implementation reads the function's element into a DOM element
+     * and calls loadXML(const QDomElement&). Function types that make
+     * up the bulk of large workspaces implement this directly.
+     *
+     * @param xml A reader positioned at the function's StartElement. When
+     *            this method returns, the reader is at the matching
+     *            EndElement.
+     */
+    virtual bool loadXML(QXmlStreamReader& xml);
+
     /**
      * Load a new function from an XML tag and add it to the given doc
      * object, if loading was successful.
@@ -390,6 +446,16 @@ public:
      */
     static bool loader(const QDomElement& root, Doc* doc);
 
+    /**
+     * Load a new function from the current element of an XML stream and
+     * add it to the given doc object, if loading was successful.
+     *
+     * @param xml A reader positioned at a function's StartElement
+     * @param doc The QLC document object, that owns all functions
+     * @return true if successful, otherwise false
+     */
+    static bool loader(QXmlStreamReader& xml, Doc* doc);
+
     /**
      * Called for each Function-based object after everything has been loaded.
      * Do any post-load cleanup, function mappings etc. if needed. Default
@@ -397,6 +463,50 @@ public:
      */
     virtual void postLoad();
 
+    /*********************************************************************
+     * Binary cache
+     *********************************************************************/
+public:
+    /**
+     * Save this function's contents to a binary workspace cache (see
+     * WorkspaceCache). The default implementation stores the function's
+     * XML, which loadBinary() then parses. Function types that make up the
+     * bulk of large workspaces store their contents directly.
+     *
+     * @param data The stream to write to
+     */
+    virtual bool saveBinary(QDataStream& data);
+
+    /**
+     * Load this function's contents from a binary workspace cache.
+     *
+     * @param data The stream to read from
+     */
+    virtual bool loadBinary(QDataStream& data);
+
+    /**
+     * Save the given function's type & ID and its contents to a binary
+     * workspace cache, to be loaded with binaryLoader().
+     */
+    static bool binarySaver(QDataStream& data, Function* function);
+
+    /**
+     * Load a new function from a binary workspace cache and add it to the
+     * given doc object, if loading was successful.
+     *
+     * @param data The stream to read from
+     * @param doc The QLC document object, that owns all functions
+     * @return true if successful, otherwise false
+     */
+    static bool binaryLoader(QDataStream& data, Doc* doc);
+
+protected:
+    /** Save the properties common to all functions (name, speed etc.) */
+    void saveBinaryProperties(QDataStream& data) const;
+
+    /** Load the properties common to all functions (name, speed etc.) */
+    void loadBinaryProperties(QDataStream& data);
+
     /*********************************************************************
      * Flash
      *********************************************************************/
@@ -608,6 +718,44 @@ signals:
 private:
     bool m_startedAsChild;
     qreal m_intensity;
+
+    /*************************************************************************
+     * Published state
+     *************************************************************************/
+public:
+    /**
+     * Get the function's running, flashing and intensity state packed into
+     * one word. The word is updated atomically whenever the state changes
+     * (in whichever thread that happens) so it can be read from any thread
+     * without locking. Two states can be compared with == to find out
+     * whether anything has changed; use the state*() methods to unpack it.
+     *
+     * Each preRun() increments a run count in the state, so a function that
+     * has been stopped and started again between two reads is also noticed.
+     */
+    int publishedState() const;
+
+    /** Check, whether the function was running in the given state */
+    static bool stateRunning(int state);
+
+    /** Check, whether the function was flashing in the given state */
+    static bool stateFlashing(int state);
+
+    /** Get the function's intensity (0 - 255) in the given state */
+    static uchar stateIntensity(int state);
+
+    /** Get the number of times the function had been started in the state */
+    static int stateRunCount(int state);
+
+private:
+    /**
+     * Replace the state bits in $mask with $bits, optionally incrementing
+     * the run count, and tell Doc if the state changed.
+     */
+    void publishState(int mask, int bits, bool newRun = false);
+
+private:
+    QAtomicInt m_publishedState;
 };
 
 #endif
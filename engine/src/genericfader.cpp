@@ -69,6 +69,17 @@ const QHash <FadeChannel,FadeChannel>& GenericFader::channels() const
 
 void GenericFader::write(UniverseArray* ua)
 {
+    // Collect all values first and write them to ua in one go
+    const int count = m_channels.size();
+    m_writeChannels.resize(count);
+    m_writeValues.resize(count);
+    m_writeGroups.resize(count);
+
+    int* channel = m_writeChannels.data();
+    uchar* val = m_writeValues.data();
+    QLCChannel::Group* group = m_writeGroups.data();
+    int i = 0;
+
     QMutableHashIterator <FadeChannel,FadeChannel> it(m_channels);
     while (it.hasNext() == true)
     {
@@ -83,7 +94,10 @@ void GenericFader::write(UniverseArray* ua)
         if (grp == QLCChannel::Intensity)
             value = fc.current(intensity());
 
-        ua->write(addr, value, grp);
+        channel[i] = int(addr);
+        val[i] = value;
+        group[i] = grp;
+        i++;
 
         if (grp == QLCChannel::Intensity)
         {
@@ -99,6 +113,8 @@ void GenericFader::write(UniverseArray* ua)
                 remove(fc);
         }
     }
+
+    ua->write(channel, val, group, i);
 }
 
 void GenericFader::adjustIntensity(qreal fraction)
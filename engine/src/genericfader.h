@@ -22,9 +22,12 @@
 #ifndef GENERICFADER
 #define GENERICFADER
 
+#include <QVector>
 #include <QList>
 #include <QHash>
 
+#include "qlcchannel.h"
+
 class UniverseArray;
 class FadeChannel;
 class Doc;
@@ -86,6 +89,12 @@ private:
     QHash <FadeChannel,FadeChannel> m_channels;
     qreal m_intensity;
     Doc* m_doc;
+
+    /** Channels, values & groups of one write() pass, kept between passes
+        to avoid allocating them again on every tick */
+    QVector <int> m_writeChannels;
+    QVector <uchar> m_writeValues;
+    QVector <QLCChannel::Group> m_writeGroups;
 };
 
 #endif
@@ -20,6 +20,7 @@
 */
 
 #include <QCoreApplication>
+#include <QtConcurrentMap>
 #include <QPluginLoader>
 #include <QStringList>
 #include <QSettings>
@@ -32,9 +33,15 @@
 #   include <windows.h>
 #endif
 
+#if !defined(WIN32) && !defined(__APPLE__)
+#   include "ioreactor.h"
+#endif
+
 #include "qlcinputchannel.h"
 #include "hotplugmonitor.h"
 #include "qlcinputsource.h"
+#include "inputlistener.h"
+#include "latencyprobe.h"
 #include "qlcinplugin.h"
 #include "inputpatch.h"
 #include "qlcconfig.h"
@@ -50,6 +57,13 @@ InputMap::InputMap(QObject*parent, quint32 universes) : QObject(parent)
 {
     m_universes = universes;
     m_editorUniverse = 0;
+    m_flushScheduled = false;
+
+#if !defined(WIN32) && !defined(__APPLE__)
+    m_ioReactor = new IOReactor(this);
+#else
+    m_ioReactor = NULL;
+#endif
 
     initPatch();
 }
@@ -65,6 +79,8 @@ InputMap::~InputMap()
         m_patch[i] = NULL;
     }
 
+    /* Plugins remove their handles from the reactor when they're deleted,
+       so the reactor (a child object) must outlive them */
     while (m_plugins.isEmpty() == false)
         delete m_plugins.takeFirst();
 
@@ -114,14 +130,117 @@ void InputMap::slotValueChanged(quint32 input, quint32 channel, uchar value)
     if (plugin == NULL)
         return;
 
-    for (quint32 i = 0; i < m_universes; i++)
+    QHash <QLCInPlugin*,QList <QPair <quint32,quint32> > >::const_iterator it =
+        m_patchIndex.find(plugin);
+    if (it == m_patchIndex.end())
+        return;
+
+    QListIterator <QPair <quint32,quint32> > pit(it.value());
+    while (pit.hasNext() == true)
+    {
+        const QPair <quint32,quint32>& pair(pit.next());
+        if (pair.first == input)
+            queueValue(pair.second, channel, value);
+    }
+}
+
+void InputMap::queueValue(quint32 universe, quint32 channel, uchar value)
+{
+    /* Only patched input counts; unpatched values never reach the output */
+    LatencyProbe::mark(LatencyProbe::InputReceived);
+
+    const quint64 key = inputKey(universe, channel);
+
+    QHash <quint64,int>::iterator it = m_queuedIndex.find(key);
+    if (it != m_queuedIndex.end())
+    {
+        /* Coalesce with the queued value, unless either one is zero,
+           since that would swallow a button press or release */
+        InputValue& queued(m_queuedValues[it.value()]);
+        if (queued.value != 0 && value != 0)
+        {
+            queued.value = value;
+            return;
+        }
+
+        flushValues();
+    }
+
+    InputValue iv;
+    iv.universe = universe;
+    iv.channel = channel;
+    iv.value = value;
+    m_queuedIndex[key] = m_queuedValues.size();
+    m_queuedValues.append(iv);
+
+    if (m_flushScheduled == false)
+    {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, "flushValues", Qt::QueuedConnection);
+    }
+}
+
+void InputMap::flushValues()
+{
+    m_flushScheduled = false;
+    if (m_queuedValues.isEmpty() == true)
+        return;
+
+    /* Take the values first so that listeners can safely cause new input
+       to be queued (e.g. thru feedback) */
+    QVector <InputValue> values(m_queuedValues);
+    m_queuedValues.clear();
+    m_queuedIndex.clear();
+
+    QVectorIterator <InputValue> it(values);
+    while (it.hasNext() == true)
     {
-        if (m_patch[i]->plugin() == plugin &&
-                m_patch[i]->input() == input)
+        const InputValue& iv(it.next());
+
+        QHash <quint64,QList <InputListener*> >::const_iterator lit =
+            m_listeners.find(inputKey(iv.universe, iv.channel));
+        if (lit != m_listeners.end())
         {
-            emit inputValueChanged(i, channel, value);
+            /* Copy, since a listener might unregister itself */
+            QList <InputListener*> listeners(lit.value());
+            foreach (InputListener* listener, listeners)
+                listener->inputValueChanged(iv.universe, iv.channel, iv.value);
         }
+
+        emit inputValueChanged(iv.universe, iv.channel, iv.value);
     }
+
+    LatencyProbe::mark(LatencyProbe::InputHandled);
+}
+
+quint64 InputMap::inputKey(quint32 universe, quint32 channel)
+{
+    return (quint64(universe) << 32) | quint64(channel);
+}
+
+/*****************************************************************************
+ * Listeners
+ *****************************************************************************/
+
+void InputMap::registerListener(InputListener* listener, quint32 universe,
+                                quint32 channel)
+{
+    Q_ASSERT(listener != NULL);
+    m_listeners[inputKey(universe, channel)].append(listener);
+}
+
+void InputMap::unregisterListener(InputListener* listener, quint32 universe,
+                                  quint32 channel)
+{
+    const quint64 key = inputKey(universe, channel);
+
+    QHash <quint64,QList <InputListener*> >::iterator it = m_listeners.find(key);
+    if (it == m_listeners.end())
+        return;
+
+    it.value().removeOne(listener);
+    if (it.value().isEmpty() == true)
+        m_listeners.erase(it);
 }
 
 bool InputMap::feedBack(quint32 universe, quint32 channel, uchar value)
@@ -157,6 +276,9 @@ void InputMap::slotConfigurationChanged()
             ip->reconnect();
     }
 
+    /* The plugin's inputs might have changed */
+    updatePatchIndex();
+
     emit pluginConfigurationChanged(plugin->name());
 }
 
@@ -185,10 +307,25 @@ bool InputMap::setPatch(quint32 universe, const QString& pluginName,
        clear the patch completely. */
     m_patch[universe]->set(plugin(pluginName), input, enableFeedback,
                            profile(profileName));
+    updatePatchIndex();
 
     return true;
 }
 
+void InputMap::updatePatchIndex()
+{
+    m_patchIndex.clear();
+
+    for (quint32 i = 0; i < m_universes; i++)
+    {
+        /* InputPatch::input() validates the input against the plugin's
+           current inputs, which is too expensive to do for every value */
+        InputPatch* ip = m_patch[i];
+        if (ip->plugin() != NULL && ip->input() != QLCInPlugin::invalidInput())
+            m_patchIndex[ip->plugin()].append(qMakePair(ip->input(), i));
+    }
+}
+
 InputPatch* InputMap::patch(quint32 universe) const
 {
     if (universe < m_universes)
@@ -235,6 +372,7 @@ void InputMap::loadPlugins(const QDir& dir)
             {
                 /* New plugin. Append and init. */
                 qDebug() << "Input plugin" << p->name() << "from" << fileName;
+                p->setIOReactor(m_ioReactor);
                 p->init();
                 appendPlugin(p);
                 QLCi18n::loadTranslation(p->name().replace(" ", "_"));
@@ -375,31 +513,53 @@ QDir InputMap::systemPluginDirectory()
 
 void InputMap::loadProfiles(const QDir& dir)
 {
-    if (dir.exists() == false || dir.isReadable() == false)
-        return;
+    addProfiles(parseProfiles(QList <QDir> () << dir));
+}
+
+QList <QLCInputProfile*> InputMap::parseProfiles(const QList <QDir>& dirs)
+{
+    QStringList paths;
+    QListIterator <QDir> dit(dirs);
+    while (dit.hasNext() == true)
+    {
+        const QDir& dir(dit.next());
+        if (dir.exists() == false || dir.isReadable() == false)
+            continue;
+
+        QStringListIterator it(dir.entryList());
+        while (it.hasNext() == true)
+            paths << dir.absoluteFilePath(it.next());
+    }
 
     /* Go thru all found file entries and attempt to load an input
        profile from each of them. */
-    QStringListIterator it(dir.entryList());
+    QList <QLCInputProfile*> parsed = QtConcurrent::blockingMapped(paths, QLCInputProfile::loader);
+
+    QList <QLCInputProfile*> profiles;
+    for (int i = 0; i < parsed.size(); i++)
+    {
+        if (parsed.at(i) != NULL)
+            profiles << parsed.at(i);
+        else
+            qWarning() << Q_FUNC_INFO << "Unable to find an input profile from" << paths.at(i);
+    }
+
+    return profiles;
+}
+
+void InputMap::addProfiles(const QList <QLCInputProfile*>& profiles)
+{
+    QListIterator <QLCInputProfile*> it(profiles);
     while (it.hasNext() == true)
     {
-        QLCInputProfile* prof;
-        QString path;
+        QLCInputProfile* prof(it.next());
+        Q_ASSERT(prof != NULL);
 
-        path = dir.absoluteFilePath(it.next());
-        prof = QLCInputProfile::loader(path);
-        if (prof != NULL)
-        {
-            /* Check for duplicates */
-            if (profile(prof->name()) == NULL)
-                addProfile(prof);
-            else
-                delete prof;
-        }
+        /* Check for duplicates */
+        if (profile(prof->name()) == NULL)
+            addProfile(prof);
         else
-        {
-            qWarning() << Q_FUNC_INFO << "Unable to find an input profile from" << path;
-        }
+            delete prof;
     }
 }
 
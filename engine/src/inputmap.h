@@ -24,12 +24,16 @@
 
 #include <QObject>
 #include <QVector>
+#include <QHash>
 #include <QList>
+#include <QPair>
 #include <QDir>
 
 #include "qlcinputprofile.h"
 
 class QLCInputSource;
+class QLCIOReactor;
+class InputListener;
 class QLCInPlugin;
 class InputPatch;
 class InputMap;
@@ -70,21 +74,83 @@ public:
      * Input data
      *************************************************************************/
 public slots:
-    /** Slot that catches input plugins' value changes */
+    /**
+     * Slot that catches input plugins' value changes. Values are not
+     * delivered immediately but queued until the event loop gets to run
+     * flushValues(). If a channel changes many times before that, only its
+     * latest value is delivered, unless the channel goes to or from zero
+     * (e.g. button press & release), which is always delivered.
+     */
     void slotValueChanged(quint32 input, quint32 channel, uchar value);
 
     /** Slot that catches plugin configuration change notifications */
     void slotConfigurationChanged();
 
+    /**
+     * Deliver all queued input values to registered listeners and thru
+     * inputValueChanged(). Called automatically from the event loop.
+     */
+    void flushValues();
+
 public:
     /** Send feedback value to the input profile e.g. to move a motorized
         sliders & knobs, set indicator leds etc. */
     bool feedBack(quint32 universe, quint32 channel, uchar value);
 
 signals:
-    /** Everyone interested in input data should connect to this signal */
+    /** Everyone interested in all input data should connect to this signal.
+        Objects interested in only a few channels should use listeners. */
     void inputValueChanged(quint32 universe, quint32 channel, uchar value);
 
+protected:
+    /** Queue a value to be delivered in the next flushValues() */
+    void queueValue(quint32 universe, quint32 channel, uchar value);
+
+    /** Make a unique key from a universe and a channel */
+    static quint64 inputKey(quint32 universe, quint32 channel);
+
+protected:
+    /** A single queued input value */
+    struct InputValue
+    {
+        quint32 universe;
+        quint32 channel;
+        uchar value;
+    };
+
+    /** Queued input values in the order they arrived */
+    QVector <InputValue> m_queuedValues;
+
+    /** Position of each (universe,channel) in m_queuedValues */
+    QHash <quint64,int> m_queuedIndex;
+
+    /** True when a flushValues() call has been scheduled */
+    bool m_flushScheduled;
+
+    /*************************************************************************
+     * Listeners
+     *************************************************************************/
+public:
+    /**
+     * Register a listener for the given input universe & channel. The same
+     * listener should register each (universe, channel) pair only once.
+     *
+     * @param listener The listener to call when the channel changes
+     * @param universe The input universe to listen to
+     * @param channel The input channel to listen to
+     */
+    void registerListener(InputListener* listener, quint32 universe,
+                          quint32 channel);
+
+    /** Remove a previous registration of the listener for universe/channel */
+    void unregisterListener(InputListener* listener, quint32 universe,
+                            quint32 channel);
+
+protected:
+    /** Listeners for each (universe,channel) key */
+    QHash <quint64,QList <InputListener*> > m_listeners;
+
+signals:
     /** Notifies (InputManager) of plugin configuration changes */
     void pluginConfigurationChanged(const QString& pluginName);
 
@@ -164,11 +230,17 @@ protected:
     /** Initialize the patch table */
     void initPatch();
 
+    /** Rebuild m_patchIndex after patch or plugin configuration changes */
+    void updatePatchIndex();
+
 protected:
     /** Vector containing all active input plugins and the internal
         universes that they are associated to. */
     QVector <InputPatch*> m_patch;
 
+    /** Patched (input, universe) pairs for each plugin */
+    QHash <QLCInPlugin*,QList <QPair <quint32,quint32> > > m_patchIndex;
+
     /*************************************************************************
      * Plugins
      *************************************************************************/
@@ -254,6 +326,9 @@ protected:
     /** List containing all available input plugins */
     QList <QLCInPlugin*> m_plugins;
 
+    /** Shared I/O thread for plugins that read file descriptors (or NULL) */
+    QLCIOReactor* m_ioReactor;
+
     /*************************************************************************
      * Input profiles
      *************************************************************************/
@@ -261,6 +336,23 @@ public:
     /** Load all input profiles from the given directory using QDir filters */
     void loadProfiles(const QDir& dir);
 
+    /**
+     * Parse all input profiles from the given directories using their QDir
+     * filters. The files are parsed in parallel, but the profiles are
+     * returned in the order of $dirs and their files. This doesn't touch
+     * any InputMap, so it can be run in any thread.
+     *
+     * @param dirs The directories to parse profiles from
+     * @return New profiles, owned by the caller
+     */
+    static QList <QLCInputProfile*> parseProfiles(const QList <QDir>& dirs);
+
+    /**
+     * Add the given profiles in their order. Profiles whose name is already
+     * taken are deleted.
+     */
+    void addProfiles(const QList <QLCInputProfile*>& profiles);
+
     /** Get a list of available profile names */
     QStringList profileNames();
 
@@ -0,0 +1,214 @@
+/*
+  Q Light Controller
+  ioreactor.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <QDebug>
+
+#include "ioreactor.h"
+
+/** Maximum number of events fetched with one epoll_wait() call */
+#define KMaxEvents 32
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+IOReactor::IOReactor(QObject* parent)
+    : QThread(parent)
+    , m_epoll(-1)
+    , m_wakeup(-1)
+    , m_running(false)
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll == -1)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to create epoll instance:"
+                   << strerror(errno);
+        return;
+    }
+
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeup == -1)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to create wakeup eventfd:"
+                   << strerror(errno);
+        return;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wakeup;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &ev) == -1)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to watch wakeup eventfd:"
+                   << strerror(errno);
+    }
+}
+
+IOReactor::~IOReactor()
+{
+    stop();
+
+    if (m_wakeup != -1)
+        ::close(m_wakeup);
+    if (m_epoll != -1)
+        ::close(m_epoll);
+}
+
+/****************************************************************************
+ * Handles
+ ****************************************************************************/
+
+bool IOReactor::addHandle(int fd, QLCIOHandler* handler, bool edgeTriggered)
+{
+    Q_ASSERT(handler != NULL);
+
+    if (fd < 0 || m_epoll == -1 || m_wakeup == -1)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_handlers.contains(fd) == true)
+        return false;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    if (edgeTriggered == true)
+        ev.events |= EPOLLET;
+    ev.data.fd = fd;
+
+    /* epoll_ctl() takes effect immediately even if the reactor thread is
+       currently sleeping in epoll_wait(), so there's no need to wake it. */
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev) == -1)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to watch fd" << fd << ":"
+                   << strerror(errno);
+        return false;
+    }
+
+    m_handlers.insert(fd, handler);
+
+    if (m_running == false)
+    {
+        m_running = true;
+        start();
+    }
+
+    return true;
+}
+
+bool IOReactor::removeHandle(int fd)
+{
+    /* Taking the mutex also waits for a possibly running handler call to
+       finish, so the handler may be deleted once this method returns. */
+    QMutexLocker locker(&m_mutex);
+
+    if (m_handlers.remove(fd) == 0)
+        return false;
+
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, NULL);
+
+    return true;
+}
+
+int IOReactor::handleCount()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_handlers.count();
+}
+
+/****************************************************************************
+ * Reactor thread
+ ****************************************************************************/
+
+void IOReactor::stop()
+{
+    m_mutex.lock();
+    if (m_running == false)
+    {
+        m_mutex.unlock();
+        return;
+    }
+
+    m_running = false;
+    m_mutex.unlock();
+
+    quint64 one = 1;
+    if (::write(m_wakeup, &one, sizeof(one)) == -1)
+        qWarning() << Q_FUNC_INFO << "Unable to wake up reactor:" << strerror(errno);
+
+    wait();
+}
+
+void IOReactor::run()
+{
+    struct epoll_event events[KMaxEvents];
+
+    while (true)
+    {
+        int n = epoll_wait(m_epoll, events, KMaxEvents, -1);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            qWarning() << Q_FUNC_INFO << "epoll_wait:" << strerror(errno);
+            m_mutex.lock();
+            m_running = false;
+            m_mutex.unlock();
+            break;
+        }
+
+        QMutexLocker locker(&m_mutex);
+
+        if (m_running == false)
+            break;
+
+        for (int i = 0; i < n; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == m_wakeup)
+                continue;
+
+            /* The handle may have been removed after epoll_wait() returned */
+            QLCIOHandler* handler = m_handlers.value(fd, NULL);
+            if (handler == NULL)
+                continue;
+
+            if (handler->readyRead(fd) == false)
+            {
+                m_handlers.remove(fd);
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, NULL);
+            }
+        }
+    }
+
+    /* Consume the wakeup so that a restarted thread doesn't see it */
+    quint64 count = 0;
+    while (::read(m_wakeup, &count, sizeof(count)) > 0);
+}
@@ -0,0 +1,83 @@
+/*
+  Q Light Controller
+  ioreactor.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef IOREACTOR_H
+#define IOREACTOR_H
+
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+
+#include "qlcioreactor.h"
+
+/**
+ * IOReactor is the Linux implementation of QLCIOReactor. It runs a single
+ * thread that sleeps in epoll_wait() until one of the registered file
+ * descriptors becomes readable, so there is no periodic wakeup and no
+ * descriptor array rebuild when devices come and go. An eventfd is used to
+ * wake the thread up when it needs to stop.
+ */
+class IOReactor : public QThread, public QLCIOReactor
+{
+    Q_OBJECT
+
+public:
+    IOReactor(QObject* parent);
+    ~IOReactor();
+
+    /*************************************************************************
+     * Handles
+     *************************************************************************/
+public:
+    /** @reimp */
+    bool addHandle(int fd, QLCIOHandler* handler, bool edgeTriggered = true);
+
+    /** @reimp */
+    bool removeHandle(int fd);
+
+    /** Get the number of currently watched file descriptors */
+    int handleCount();
+
+protected:
+    /** Registered handlers by their file descriptors */
+    QHash <int,QLCIOHandler*> m_handlers;
+
+    /** Protects m_handlers and serializes handler calls vs. removal */
+    QMutex m_mutex;
+
+    /*************************************************************************
+     * Reactor thread
+     *************************************************************************/
+public:
+    /** Stop the reactor thread */
+    void stop();
+
+protected:
+    /** @reimp */
+    void run();
+
+protected:
+    int m_epoll;
+    int m_wakeup;
+    bool m_running;
+};
+
+#endif
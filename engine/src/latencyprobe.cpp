@@ -0,0 +1,171 @@
+/*
+  Q Light Controller
+  latencyprobe.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QMutexLocker>
+#include <QtAlgorithms>
+#include <QAtomicInt>
+#include <QVector>
+#include <QMutex>
+#include <QTime>
+
+#include "latencyprobe.h"
+
+/** A sample that hasn't completed in this time is considered lost */
+#define KSampleTimeoutMs 1000
+
+/* Written by the UI thread, read by the input, timer & output threads */
+static QAtomicInt s_enabled(0);
+static QMutex s_mutex;
+static QTime s_timer;
+static bool s_inFlight = false;
+static LatencyProbe::Sample s_current;
+static QList <LatencyProbe::Sample> s_samples;
+
+/****************************************************************************
+ * Control
+ ****************************************************************************/
+
+void LatencyProbe::setEnabled(bool enable)
+{
+    QMutexLocker locker(&s_mutex);
+
+    s_samples.clear();
+    s_inFlight = false;
+    if (enable == true)
+        s_timer.start();
+    s_enabled.fetchAndStoreOrdered(enable ? 1 : 0);
+}
+
+bool LatencyProbe::isEnabled()
+{
+    return (s_enabled.fetchAndAddOrdered(0) != 0);
+}
+
+void LatencyProbe::clear()
+{
+    QMutexLocker locker(&s_mutex);
+    s_samples.clear();
+    s_inFlight = false;
+}
+
+/****************************************************************************
+ * Marking
+ ****************************************************************************/
+
+void LatencyProbe::mark(Stage stage)
+{
+    if (isEnabled() == false)
+        return;
+
+    QMutexLocker locker(&s_mutex);
+
+    qint64 now = s_timer.elapsed();
+
+    if (stage == InputReceived)
+    {
+        /* Start a new sample unless one is already in flight. Samples that
+           never reach the output (e.g. input that isn't patched anywhere)
+           are dropped after a while. */
+        if (s_inFlight == true && now - s_current.msecs[InputReceived] < KSampleTimeoutMs)
+            return;
+
+        s_current.msecs[InputReceived] = now;
+        for (int i = InputHandled; i < StageCount; i++)
+            s_current.msecs[i] = -1;
+        s_inFlight = true;
+    }
+    else if (s_inFlight == true && s_current.msecs[stage] == -1 &&
+             s_current.msecs[stage - 1] != -1)
+    {
+        s_current.msecs[stage] = now;
+
+        if (stage == OutputDispatched)
+        {
+            /* Make the stages relative to input reception */
+            qint64 start = s_current.msecs[InputReceived];
+            for (int i = InputReceived; i < StageCount; i++)
+                s_current.msecs[i] -= start;
+
+            s_samples << s_current;
+            s_inFlight = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Results
+ ****************************************************************************/
+
+QList <LatencyProbe::Sample> LatencyProbe::samples()
+{
+    QMutexLocker locker(&s_mutex);
+    return s_samples;
+}
+
+qint64 LatencyProbe::percentile(Stage stage, int percent)
+{
+    QList <Sample> list(samples());
+    if (list.isEmpty() == true)
+        return -1;
+
+    QVector <qint64> values;
+    values.reserve(list.size());
+    foreach (const Sample& sample, list)
+        values << sample.msecs[stage];
+    qSort(values);
+
+    int index = ((values.size() - 1) * qBound(0, percent, 100)) / 100;
+    return values[index];
+}
+
+QString LatencyProbe::stageToString(Stage stage)
+{
+    switch (stage)
+    {
+    case InputReceived:
+        return QString("InputReceived");
+    case InputHandled:
+        return QString("InputHandled");
+    case SourceWritten:
+        return QString("SourceWritten");
+    case OutputDispatched:
+        return QString("OutputDispatched");
+    default:
+        return QString("Unknown");
+    }
+}
+
+QString LatencyProbe::summary()
+{
+    QString str;
+    int count = samples().size();
+
+    for (int i = InputHandled; i < StageCount; i++)
+    {
+        Stage stage = Stage(i);
+        str += QString("%1 samples=%2 min=%3 p50=%4 p95=%5 max=%6\n")
+                .arg(stageToString(stage)).arg(count)
+                .arg(percentile(stage, 0)).arg(percentile(stage, 50))
+                .arg(percentile(stage, 95)).arg(percentile(stage, 100));
+    }
+
+    return str;
+}
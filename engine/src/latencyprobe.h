@@ -0,0 +1,98 @@
+/*
+  Q Light Controller
+  latencyprobe.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QString>
+#include <QList>
+
+/**
+ * LatencyProbe measures how long it takes for an input value to travel from
+ * InputMap thru input handling and DMX sources to the output plugins. Input
+ * plugins don't link against the engine, so the time a value spends inside
+ * the plugin and in the event queue before InputMap receives it is not
+ * included.
+ *
+ * The engine marks each stage of the pipeline with mark(). Only one sample
+ * is in flight at a time: an InputReceived mark starts a new sample and each
+ * following stage is recorded only once, and only after the previous stage
+ * has been recorded. The sample is complete when the changed universes have
+ * been dispatched to the output plugins.
+ *
+ * The probe is disabled by default, in which case mark() does nothing but
+ * check a flag.
+ */
+class LatencyProbe
+{
+public:
+    /** Pipeline stages in the order they're passed thru */
+    enum Stage
+    {
+        InputReceived = 0, //! InputMap received a patched plugin value
+        InputHandled,      //! InputMap delivered the value to listeners (VC)
+        SourceWritten,     //! MasterTimer ran DMXSource::writeDMX()
+        OutputDispatched,  //! OutputMap dumped universes to output plugins
+        StageCount
+    };
+
+    /** A completed sample; milliseconds from InputReceived to each stage */
+    struct Sample
+    {
+        qint64 msecs[StageCount];
+    };
+
+    /** Enable/disable the probe. Enabling clears previous samples. */
+    static void setEnabled(bool enable);
+
+    /** Check, whether the probe is enabled */
+    static bool isEnabled();
+
+    /** Mark that the given stage has been reached */
+    static void mark(Stage stage);
+
+    /** Get all completed samples */
+    static QList <Sample> samples();
+
+    /** Remove all samples, including the one in flight */
+    static void clear();
+
+    /**
+     * Get the given percentile of the given stage's latency over all
+     * completed samples.
+     *
+     * @param stage The stage to inspect
+     * @param percent Percentile (0 = minimum, 50 = median, 100 = maximum)
+     * @return Latency in milliseconds or -1 if there are no samples
+     */
+    static qint64 percentile(Stage stage, int percent);
+
+    /** Get a stage's name */
+    static QString stageToString(Stage stage);
+
+    /**
+     * Get a machine-readable summary of all stages, one line per stage:
+     * "<stage> samples=<n> min=<ms> p50=<ms> p95=<ms> max=<ms>"
+     */
+    static QString summary();
+};
+
+#endif
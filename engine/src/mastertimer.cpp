@@ -29,6 +29,7 @@
 
 #include "universearray.h"
 #include "genericfader.h"
+#include "latencyprobe.h"
 #include "mastertimer.h"
 #include "outputmap.h"
 #include "dmxsource.h"
@@ -45,6 +46,7 @@ const uint MasterTimer::s_frequency = 50;
 
 MasterTimer::MasterTimer(Doc* doc)
     : QObject(doc)
+    , m_tickGeneration(0)
     , m_stopAllFunctions(false)
     , m_fader(new GenericFader(doc))
     , d_ptr(new MasterTimerPrivate(this))
@@ -80,6 +82,9 @@ void MasterTimer::timerTick()
     Doc* doc = qobject_cast<Doc*> (parent());
     Q_ASSERT(doc != NULL);
 
+    /* Tell Doc that patch snapshots fetched from now on may be in use */
+    m_tickGeneration.fetchAndAddOrdered(1);
+
     UniverseArray* universes = doc->outputMap()->claimUniverses();
     universes->zeroIntensityChannels();
 
@@ -89,6 +94,8 @@ void MasterTimer::timerTick()
 
     doc->outputMap()->releaseUniverses();
     doc->outputMap()->dumpUniverses();
+
+    m_tickGeneration.fetchAndAddOrdered(1);
 }
 
 uint MasterTimer::frequency()
@@ -101,6 +108,12 @@ uint MasterTimer::tick()
     return uint(double(1000) / double(s_frequency));
 }
 
+int MasterTimer::tickGeneration() const
+{
+    /* QAtomicInt has no const load, but adding zero is a full barrier */
+    return const_cast <QAtomicInt&> (m_tickGeneration).fetchAndAddOrdered(0);
+}
+
 /*****************************************************************************
  * Functions
  *****************************************************************************/
@@ -246,6 +259,8 @@ void MasterTimer::timerTickDMXSources(UniverseArray* universes)
 
     /* No more sources. Get out and wait for next timer event. */
     m_dmxSourceListMutex.unlock();
+
+    LatencyProbe::mark(LatencyProbe::SourceWritten);
 }
 
 /****************************************************************************
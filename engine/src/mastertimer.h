@@ -22,6 +22,7 @@
 #ifndef MASTERTIMER_H
 #define MASTERTIMER_H
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QMutex>
 #include <QList>
@@ -69,6 +70,14 @@ public:
     /** Get the length of one timer tick in milliseconds */
     static uint tick();
 
+    /**
+     * Get the current tick generation. The generation is incremented both
+     * when a tick starts and when it ends, so it's odd while a tick is in
+     * progress. Doc uses this to find out when the timer thread can no
+     * longer be using a replaced patch snapshot.
+     */
+    int tickGeneration() const;
+
 private:
     /** Execute one timer tick (called by MasterTimerPrivate) */
     void timerTick();
@@ -77,6 +86,9 @@ private:
     /** An OutputMap instance that routes all values to correct plugins. */
     static const uint s_frequency;
 
+    /** See tickGeneration() */
+    QAtomicInt m_tickGeneration;
+
     /*********************************************************************
      * Functions
      *********************************************************************/
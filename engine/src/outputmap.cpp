@@ -36,6 +36,7 @@
 
 #include "hotplugmonitor.h"
 #include "universearray.h"
+#include "latencyprobe.h"
 #include "outputpatch.h"
 #include "outputmap.h"
 
@@ -48,6 +49,7 @@ OutputMap::OutputMap(QObject* parent, quint32 universes) : QObject(parent)
     m_universes = universes;
     m_blackout = false;
     m_universeChanged = false;
+    m_universeSerial = 1;
 
     m_universeArray = new UniverseArray(512 * universes);
 
@@ -196,25 +198,19 @@ uchar OutputMap::grandMasterValue()
 
 void OutputMap::dumpUniverses()
 {
-    QByteArray ba;
-
     m_universeMutex.lock();
     if (m_universeChanged == true && m_blackout == false)
     {
         const QByteArray* postGM = m_universeArray->postGMValues();
         for (quint32 i = 0; i < m_universes; i++)
             m_patch[i]->dump(postGM->mid(i * 512, 512));
+        LatencyProbe::mark(LatencyProbe::OutputDispatched);
 
-        // Grab a copy of universe values to prevent timer thread blocking
-        ba = *postGM;
-
+        if (++m_universeSerial == 0)
+            m_universeSerial = 1;
         m_universeChanged = false;
     }
     m_universeMutex.unlock();
-
-    // Emit new values
-    if (ba.isEmpty() == false)
-        emit universesWritten(ba);
 }
 
 void OutputMap::resetUniverses()
@@ -224,6 +220,20 @@ void OutputMap::resetUniverses()
     releaseUniverses();
 }
 
+QByteArray OutputMap::universeSnapshot(quint32& serial)
+{
+    QByteArray ba;
+
+    QMutexLocker locker(&m_universeMutex);
+    if (serial != m_universeSerial)
+    {
+        ba = *(m_universeArray->postGMValues());
+        serial = m_universeSerial;
+    }
+
+    return ba;
+}
+
 /*****************************************************************************
  * Patch
  *****************************************************************************/
@@ -152,8 +152,22 @@ public:
      */
     void resetUniverses();
 
+    /**
+     * Get the latest post-GM values of all universes for monitoring. Nothing
+     * is copied or queued on behalf of monitors when universes are written;
+     * monitors poll this method at their own pace and always get only the
+     * latest values. The returned array is implicitly shared with the
+     * universe array until the next write.
+     *
+     * @param serial The serial number of the values that the caller already
+     *               has (0 for none). Updated to the serial number of the
+     *               returned values.
+     * @return The latest values or an empty array if nothing has been written
+     *         since $serial
+     */
+    QByteArray universeSnapshot(quint32& serial);
+
 signals:
-    void universesWritten(const QByteArray& universes);
     void grandMasterValueChanged(uchar value);
 
 protected:
@@ -163,6 +177,9 @@ protected:
     /** When true, universes are dumped. Otherwise not. */
     bool m_universeChanged;
 
+    /** Incremented each time universes are dumped, never 0 */
+    quint32 m_universeSerial;
+
     /** Mutex guarding m_universeArray */
     QMutex m_universeMutex;
 
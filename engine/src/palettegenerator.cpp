@@ -178,6 +178,8 @@ void PaletteGenerator::purgeScenes()
 
 void PaletteGenerator::addScenesToDoc()
 {
+    m_doc->beginBatch();
+
     QHashIterator <QString,Scene*> it(m_scenes);
     while (it.hasNext() == true)
     {
@@ -185,4 +187,6 @@ void PaletteGenerator::addScenesToDoc()
         if (m_doc->addFunction(it.value()) == false)
             break;
     }
+
+    m_doc->endBatch();
 }
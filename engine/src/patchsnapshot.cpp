@@ -0,0 +1,119 @@
+/*
+  Q Light Controller
+  patchsnapshot.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "patchsnapshot.h"
+#include "fixture.h"
+
+/****************************************************************************
+ * FixtureInfo
+ ****************************************************************************/
+
+const QLCFixtureHead& PatchSnapshot::FixtureInfo::head(int index) const
+{
+    static const QLCFixtureHead noHead;
+    if (index >= 0 && index < heads.size())
+        return heads.at(index);
+    else
+        return noHead;
+}
+
+quint32 PatchSnapshot::FixtureInfo::masterIntensityChannel(int index) const
+{
+    if (dimmer == true)
+        return QLCChannel::invalid();
+    else
+        return head(index).masterIntensityChannel();
+}
+
+/****************************************************************************
+ * Snapshot
+ ****************************************************************************/
+
+PatchSnapshot::PatchSnapshot(quint32 version,
+                             const QVector <AddressInfo>& addresses,
+                             const QHash <quint32,FixtureInfo>& fixtures,
+                             const QHash <quint32,GroupInfo>& groups)
+    : m_version(version)
+    , m_addresses(addresses)
+    , m_fixtures(fixtures)
+    , m_groups(groups)
+{
+}
+
+PatchSnapshot::~PatchSnapshot()
+{
+}
+
+quint32 PatchSnapshot::version() const
+{
+    return m_version;
+}
+
+const PatchSnapshot::AddressInfo& PatchSnapshot::addressInfo(quint32 universeAddress) const
+{
+    if (universeAddress < quint32(m_addresses.size()))
+        return m_addresses.at(universeAddress);
+    else
+        return unpatchedAddress();
+}
+
+const PatchSnapshot::FixtureInfo* PatchSnapshot::fixture(quint32 id) const
+{
+    QHash <quint32,FixtureInfo>::const_iterator it = m_fixtures.constFind(id);
+    if (it == m_fixtures.constEnd())
+        return NULL;
+    else
+        return &(it.value());
+}
+
+const PatchSnapshot::GroupInfo* PatchSnapshot::fixtureGroup(quint32 id) const
+{
+    QHash <quint32,GroupInfo>::const_iterator it = m_groups.constFind(id);
+    if (it == m_groups.constEnd())
+        return NULL;
+    else
+        return &(it.value());
+}
+
+quint32 PatchSnapshot::channelAddress(quint32 fxi, quint32 channel) const
+{
+    const FixtureInfo* info = fixture(fxi);
+    if (info == NULL)
+        return QLCChannel::invalid();
+    else
+        return info->address + channel;
+}
+
+QLCChannel::Group PatchSnapshot::channelGroup(quint32 fxi, quint32 channel) const
+{
+    const FixtureInfo* info = fixture(fxi);
+    if (info == NULL || channel >= quint32(info->groups.size()))
+        return QLCChannel::Intensity;
+    else
+        return info->groups.at(channel);
+}
+
+const PatchSnapshot::AddressInfo& PatchSnapshot::unpatchedAddress()
+{
+    static const AddressInfo unpatched =
+        { Fixture::invalidId(), QLCChannel::invalid(), QLCChannel::Intensity };
+    return unpatched;
+}
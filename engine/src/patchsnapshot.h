@@ -0,0 +1,155 @@
+/*
+  Q Light Controller
+  patchsnapshot.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef PATCHSNAPSHOT_H
+#define PATCHSNAPSHOT_H
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QSize>
+
+#include "qlcfixturehead.h"
+#include "qlcchannel.h"
+#include "grouphead.h"
+#include "qlcpoint.h"
+
+/**
+ * PatchSnapshot is an immutable copy of everything the MasterTimer thread
+ * needs to know about the current patch: which fixture channel occupies
+ * each DMX address, the channels and heads of each fixture and the heads
+ * of each fixture group.
+ *
+ * Doc builds a new snapshot in the main thread whenever the patch changes
+ * and publishes it atomically (see Doc::patchSnapshot()). Since a snapshot
+ * never changes after it has been published, the timer thread can read it
+ * without any locking. The containers are implicitly shared with Doc's own
+ * bookkeeping, so publishing a snapshot copies only reference counts.
+ */
+class PatchSnapshot
+{
+public:
+    /** Patch information of a single DMX address */
+    struct AddressInfo
+    {
+        quint32 fixture;          //! ID of the fixture occupying the address
+        quint32 channel;          //! Fixture-relative channel number
+        QLCChannel::Group group;  //! Group of the fixture channel
+    };
+
+    /** Patch information of a single fixture */
+    struct FixtureInfo
+    {
+        /** The fixture's universe & address */
+        quint32 address;
+
+        /** Group of each fixture channel */
+        QVector <QLCChannel::Group> groups;
+
+        /** Channel definitions; NULL for generic dimmer channels */
+        QVector <const QLCChannel*> channels;
+
+        /** The fixture's heads */
+        QList <QLCFixtureHead> heads;
+
+        /** True for generic dimmers, whose heads are single channels */
+        bool dimmer;
+
+        /** Get a head or an empty head if index is out of range */
+        const QLCFixtureHead& head(int index) const;
+
+        /**
+         * Get the master intensity channel of a head, like
+         * Fixture::masterIntensityChannel(). Generic dimmers don't have one.
+         */
+        quint32 masterIntensityChannel(int index = 0) const;
+    };
+
+    /** Patch information of a single fixture group */
+    struct GroupInfo
+    {
+        /** The group's matrix size */
+        QSize size;
+
+        /** The fixture heads at each point of the group's matrix */
+        QHash <QLCPoint,GroupHead> heads;
+    };
+
+public:
+    /**
+     * Create a new snapshot
+     *
+     * @param version A number that increases each time a new snapshot is made
+     * @param addresses Patch information of each DMX address
+     * @param fixtures Patch information of each fixture, by ID
+     * @param groups Patch information of each fixture group, by ID
+     */
+    PatchSnapshot(quint32 version,
+                  const QVector <AddressInfo>& addresses,
+                  const QHash <quint32,FixtureInfo>& fixtures,
+                  const QHash <quint32,GroupInfo>& groups);
+    ~PatchSnapshot();
+
+    /** Get the version of this snapshot */
+    quint32 version() const;
+
+    /**
+     * Get the patch information of the given DMX address. Addresses that are
+     * not occupied by any fixture have an invalid fixture ID and channel and
+     * their group is QLCChannel::Intensity.
+     */
+    const AddressInfo& addressInfo(quint32 universeAddress) const;
+
+    /** Get the patch information of a fixture or NULL if there's no such ID */
+    const FixtureInfo* fixture(quint32 id) const;
+
+    /** Get the patch information of a fixture group or NULL if not found */
+    const GroupInfo* fixtureGroup(quint32 id) const;
+
+    /**
+     * Get the absolute DMX address of a fixture's channel
+     *
+     * @return Universe & address or QLCChannel::invalid() if the fixture
+     *         doesn't exist
+     */
+    quint32 channelAddress(quint32 fxi, quint32 channel) const;
+
+    /**
+     * Get the group of a fixture's channel
+     *
+     * @return The channel's group or QLCChannel::Intensity if the fixture
+     *         or the channel doesn't exist
+     */
+    QLCChannel::Group channelGroup(quint32 fxi, quint32 channel) const;
+
+    /** An address that is not occupied by any fixture */
+    static const AddressInfo& unpatchedAddress();
+
+private:
+    Q_DISABLE_COPY(PatchSnapshot)
+
+    quint32 m_version;
+    QVector <AddressInfo> m_addresses;
+    QHash <quint32,FixtureInfo> m_fixtures;
+    QHash <quint32,GroupInfo> m_groups;
+};
+
+#endif
@@ -84,6 +84,7 @@ QLCChannel& QLCChannel::operator=(const QLCChannel& channel)
         m_colour = channel.m_colour;
 
         /* Clear old capabilities */
+        invalidateCapabilityIndex();
         while (m_capabilities.isEmpty() == false)
             delete m_capabilities.takeFirst();
 
@@ -296,28 +297,28 @@ const QList <QLCCapability*> QLCChannel::capabilities() const
 
 QLCCapability* QLCChannel::searchCapability(uchar value) const
 {
-    QListIterator <QLCCapability*> it(m_capabilities);
-    while (it.hasNext() == true)
-    {
-        QLCCapability* capability = it.next();
-        if (capability->min() <= value && capability->max() >= value)
-            return capability;
-    }
+    if (m_valueIndex.isEmpty() == true)
+        buildCapabilityIndex();
 
-    return NULL;
+    return m_valueIndex.at(value);
 }
 
 QLCCapability* QLCChannel::searchCapability(const QString& name,
         bool exactMatch) const
 {
+    if (exactMatch == true)
+    {
+        if (m_valueIndex.isEmpty() == true)
+            buildCapabilityIndex();
+
+        return m_nameIndex.value(name, NULL);
+    }
+
     QListIterator <QLCCapability*> it(m_capabilities);
     while (it.hasNext() == true)
     {
         QLCCapability* capability = it.next();
-        if (exactMatch == true && capability->name() == name)
-            return capability;
-        else if (exactMatch == false &&
-                 capability->name().contains(name) == true)
+        if (capability->name().contains(name) == true)
             return capability;
     }
 
@@ -336,6 +337,7 @@ bool QLCChannel::addCapability(QLCCapability* cap)
     }
 
     m_capabilities.append(cap);
+    invalidateCapabilityIndex();
     return true;
 }
 
@@ -349,6 +351,7 @@ bool QLCChannel::removeCapability(QLCCapability* cap)
         if (it.next() == cap)
         {
             it.remove();
+            invalidateCapabilityIndex();
             delete cap;
             return true;
         }
@@ -365,6 +368,29 @@ static bool capsort(const QLCCapability* cap1, const QLCCapability* cap2)
 void QLCChannel::sortCapabilities()
 {
     qSort(m_capabilities.begin(), m_capabilities.end(), capsort);
+    invalidateCapabilityIndex();
+}
+
+void QLCChannel::invalidateCapabilityIndex()
+{
+    m_valueIndex.clear();
+    m_nameIndex.clear();
+}
+
+void QLCChannel::buildCapabilityIndex() const
+{
+    m_valueIndex.fill(NULL, 256);
+    m_nameIndex.clear();
+
+    /* Capabilities don't overlap, but the first one wins just like with
+       a linear search if they still do */
+    for (int i = m_capabilities.size() - 1; i >= 0; i--)
+    {
+        QLCCapability* cap = m_capabilities.at(i);
+        for (int value = cap->min(); value <= cap->max(); value++)
+            m_valueIndex[value] = cap;
+        m_nameIndex[cap->name()] = cap;
+    }
 }
 
 /*****************************************************************************
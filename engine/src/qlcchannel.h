@@ -23,7 +23,9 @@
 #define QLC_CHANNEL_H
 
 #include <climits>
+#include <QVector>
 #include <QString>
+#include <QHash>
 #include <QList>
 
 #define KXMLQLCChannel          QString("Channel")
@@ -180,7 +182,10 @@ public:
     /** Get a list of channel's capabilities */
     const QList <QLCCapability*> capabilities() const;
 
-    /** Search for a particular capability by its channel value */
+    /**
+     * Search for a particular capability by its channel value. This is a
+     * table lookup, the table being built on first use.
+     */
     QLCCapability* searchCapability(uchar value) const;
 
     /**
@@ -206,10 +211,27 @@ public:
     /** Sort capabilities to ascending order by their values */
     void sortCapabilities();
 
+    /**
+     * Discard the capability lookup tables. Adding, removing and sorting
+     * capabilities does this automatically, but it must be called after
+     * modifying a capability of this channel directly.
+     */
+    void invalidateCapabilityIndex();
+
+protected:
+    /** Build the capability lookup tables */
+    void buildCapabilityIndex() const;
+
 protected:
     /** List of channel's capabilities */
     QList <QLCCapability*> m_capabilities;
 
+    /** Capability of each channel value, empty until built */
+    mutable QVector <QLCCapability*> m_valueIndex;
+
+    /** First capability with each name, valid when m_valueIndex is built */
+    mutable QHash <QString,QLCCapability*> m_nameIndex;
+
     /*********************************************************************
      * File operations
      *********************************************************************/
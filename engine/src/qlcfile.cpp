@@ -19,6 +19,8 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QFile>
 #include <QtXml>
 
@@ -65,6 +67,48 @@ QDomDocument QLCFile::readXML(const QString& path)
     return doc;
 }
 
+QDomElement QLCFile::readXMLElement(QXmlStreamReader& xml, QDomDocument& doc)
+{
+    Q_ASSERT(xml.isStartElement() == true);
+    Q_ASSERT(doc.documentElement().isNull() == true);
+
+    QDomNode parent = doc;
+    int depth = 0;
+    while (xml.hasError() == false)
+    {
+        if (xml.isStartElement() == true)
+        {
+            QDomElement tag = doc.createElement(xml.name().toString());
+            foreach (const QXmlStreamAttribute& attr, xml.attributes())
+                tag.setAttribute(attr.name().toString(), attr.value().toString());
+            parent.appendChild(tag);
+            parent = tag;
+            depth++;
+        }
+        else if (xml.isEndElement() == true)
+        {
+            parent = parent.parentNode();
+            if (--depth == 0)
+                break;
+        }
+        else if (xml.isCharacters() == true && xml.isWhitespace() == false)
+        {
+            parent.appendChild(doc.createTextNode(xml.text().toString()));
+        }
+
+        xml.readNext();
+    }
+
+    if (xml.hasError() == true)
+    {
+        qWarning() << Q_FUNC_INFO << "XML error at line" << xml.lineNumber()
+                   << ":" << xml.errorString();
+        return QDomElement();
+    }
+
+    return doc.documentElement();
+}
+
 QDomDocument QLCFile::getXMLHeader(const QString& content, const QString& author)
 {
     if (content.isEmpty() == true)
@@ -109,6 +153,51 @@ QDomDocument QLCFile::getXMLHeader(const QString& content, const QString& author
     return doc;
 }
 
+void QLCFile::writeXMLElement(QXmlStreamWriter& xml, const QDomElement& element)
+{
+    xml.writeStartElement(element.tagName());
+
+    QDomNamedNodeMap attrs = element.attributes();
+    for (int i = 0; i < attrs.count(); i++)
+    {
+        QDomAttr attr = attrs.item(i).toAttr();
+        xml.writeAttribute(attr.name(), attr.value());
+    }
+
+    QDomNode node = element.firstChild();
+    while (node.isNull() == false)
+    {
+        if (node.isElement() == true)
+            writeXMLElement(xml, node.toElement());
+        else if (node.isText() == true)
+            xml.writeCharacters(node.toText().data());
+        node = node.nextSibling();
+    }
+
+    xml.writeEndElement();
+}
+
+void QLCFile::writeXMLHeader(QXmlStreamWriter& xml, const QString& content)
+{
+    Q_ASSERT(content.isEmpty() == false);
+
+    xml.writeStartDocument();
+    xml.writeDTD(QString("<!DOCTYPE %1>").arg(content));
+    xml.writeStartElement(content);
+}
+
+void QLCFile::writeXMLCreator(QXmlStreamWriter& xml, const QString& author)
+{
+    xml.writeStartElement(KXMLQLCCreator);
+    xml.writeTextElement(KXMLQLCCreatorName, APPNAME);
+    xml.writeTextElement(KXMLQLCCreatorVersion, QString(APPVERSION));
+    if (author.isEmpty() == true)
+        xml.writeTextElement(KXMLQLCCreatorAuthor, currentUserName());
+    else
+        xml.writeTextElement(KXMLQLCCreatorAuthor, author);
+    xml.writeEndElement();
+}
+
 QString QLCFile::errorString(QFile::FileError error)
 {
     switch (error)
@@ -24,6 +24,8 @@
 
 #include <QFile>
 
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 class QString;
@@ -63,6 +65,19 @@ public:
      */
     static QDomDocument readXML(const QString& path);
 
+    /**
+     * Read the element at the current position of the given stream reader,
+     * including all of its children, into a DOM element. This lets streaming
+     * loaders hand subtrees over to such objects that can only load
+     * themselves from a QDomElement.
+     *
+     * @param xml A reader positioned at a StartElement. When this method
+     *            returns, the reader is at the matching EndElement.
+     * @param doc An empty document that becomes the owner of the element
+     * @return The element (null element if the reader encountered an error)
+     */
+    static QDomElement readXMLElement(QXmlStreamReader& xml, QDomDocument& doc);
+
     /**
      * Get a common XML file header as a QDomDocument
      *
@@ -72,6 +87,36 @@ public:
      */
     static QDomDocument getXMLHeader(const QString& content, const QString& author = QString());
 
+    /**
+     * Write the element given, including all of its children, to an XML
+     * stream. This lets streaming savers write out such objects that can
+     * only save themselves into a QDomDocument.
+     *
+     * @param xml The stream to write to
+     * @param element The element to write
+     */
+    static void writeXMLElement(QXmlStreamWriter& xml, const QDomElement& element);
+
+    /**
+     * Write the beginning of a common XML file to a stream: the document
+     * type and the start tag of the root element. The caller may then add
+     * attributes to the root element before writing its contents, which
+     * normally start with writeXMLCreator().
+     *
+     * @param xml The stream to write to
+     * @param content The content type (Settings, Workspace)
+     */
+    static void writeXMLHeader(QXmlStreamWriter& xml, const QString& content);
+
+    /**
+     * Write the same creator information to a stream that getXMLHeader()
+     * puts into a QDomDocument.
+     *
+     * @param xml The stream to write to
+     * @param author The file's author (overridden by current user name if empty)
+     */
+    static void writeXMLCreator(QXmlStreamWriter& xml, const QString& author = QString());
+
     /**
      * Get a string that gives a textual description for the given file
      * error code.
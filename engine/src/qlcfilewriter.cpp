@@ -0,0 +1,170 @@
+/*
+  Q Light Controller
+  qlcfilewriter.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QMutexLocker>
+#include <QDebug>
+
+#ifdef WIN32
+#   include <windows.h>
+#   include <io.h>
+#else
+#   include <unistd.h>
+#   include <stdio.h>
+#endif
+
+#include "qlcfilewriter.h"
+
+#define KTempSuffix ".tmp"
+
+QLCFileWriter::QLCFileWriter(QObject* parent)
+    : QThread(parent)
+    , m_running(false)
+{
+    qRegisterMetaType <QFile::FileError> ("QFile::FileError");
+}
+
+QLCFileWriter::~QLCFileWriter()
+{
+    waitForWritten();
+    wait();
+}
+
+void QLCFileWriter::write(const QString& fileName, const QList <QByteArray>& data)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.append(QPair <QString,QList <QByteArray> > (fileName, data));
+
+    if (m_running == false)
+    {
+        /* The previous run() may have returned without the thread having
+           finished yet, in which case start() would do nothing. */
+        wait();
+        m_running = true;
+        start();
+    }
+}
+
+void QLCFileWriter::waitForWritten()
+{
+    m_mutex.lock();
+    while (m_running == true)
+    {
+        m_mutex.unlock();
+        wait();
+        m_mutex.lock();
+    }
+    m_mutex.unlock();
+}
+
+QFile::FileError QLCFileWriter::lastError(const QString& fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errors.value(fileName, QFile::NoError);
+}
+
+void QLCFileWriter::run()
+{
+    while (true)
+    {
+        m_mutex.lock();
+        if (m_queue.isEmpty() == true)
+        {
+            m_running = false;
+            m_mutex.unlock();
+            return;
+        }
+
+        QPair <QString,QList <QByteArray> > job(m_queue.takeFirst());
+        m_mutex.unlock();
+
+        QFile::FileError error = writeFile(job.first, job.second);
+
+        m_mutex.lock();
+        m_errors[job.first] = error;
+        m_mutex.unlock();
+
+        emit written(job.first, error);
+    }
+}
+
+QFile::FileError QLCFileWriter::writeFile(const QString& fileName,
+                                          const QList <QByteArray>& data)
+{
+    QFile file(fileName + KTempSuffix);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to open" << file.fileName()
+                   << "for writing:" << file.errorString();
+        return file.error();
+    }
+
+    QListIterator <QByteArray> it(data);
+    while (it.hasNext() == true)
+    {
+        const QByteArray& block(it.next());
+        if (file.write(block) != block.size())
+            break;
+    }
+
+    /* Make sure the data is on the disk before the old file is replaced */
+    if (file.error() == QFile::NoError && file.flush() == true)
+    {
+#ifdef WIN32
+        _commit(file.handle());
+#else
+        fsync(file.handle());
+#endif
+    }
+
+    QFile::FileError error = file.error();
+    file.close();
+    if (error != QFile::NoError)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to write" << file.fileName();
+        file.remove();
+        return error;
+    }
+
+    /* Keep the permissions of the file being replaced */
+    if (QFile::exists(fileName) == true)
+        file.setPermissions(QFile::permissions(fileName));
+
+    if (replaceFile(file.fileName(), fileName) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to rename" << file.fileName()
+                   << "to" << fileName;
+        file.remove();
+        return QFile::RenameError;
+    }
+
+    return QFile::NoError;
+}
+
+bool QLCFileWriter::replaceFile(const QString& source, const QString& target)
+{
+#ifdef WIN32
+    return MoveFileExW((LPCWSTR) source.utf16(), (LPCWSTR) target.utf16(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return ::rename(QFile::encodeName(source).constData(),
+                  QFile::encodeName(target).constData()) == 0;
+#endif
+}
@@ -0,0 +1,119 @@
+/*
+  Q Light Controller
+  qlcfilewriter.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCFILEWRITER_H
+#define QLCFILEWRITER_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QThread>
+#include <QString>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QFile>
+
+/**
+ * QLCFileWriter writes files in a separate thread so that saving a large
+ * workspace doesn't block the UI. The data to write is given as a list of
+ * byte arrays, which the caller has serialized beforehand (for example
+ * with Doc::saveXMLFragments()); the writer thread never touches any
+ * engine objects.
+ *
+ * Files are replaced atomically: data is first written to a temporary file
+ * next to the target file, flushed to disk and then renamed over the
+ * target. A crash or a full disk during saving thus leaves the previous
+ * version of the file intact.
+ */
+class QLCFileWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    QLCFileWriter(QObject* parent = 0);
+
+    /** Destroy the writer. Waits until all queued files have been written. */
+    ~QLCFileWriter();
+
+    /**
+     * Queue the given data to be written to a file in the writer thread.
+     * Files are written in the order they were queued. written() is emitted
+     * when the file is done.
+     *
+     * @param fileName The name of the file to write
+     * @param data The file contents
+     */
+    void write(const QString& fileName, const QList <QByteArray>& data);
+
+    /** Block until all queued files have been written */
+    void waitForWritten();
+
+    /**
+     * Get the result of the latest finished write of the given file. This
+     * is for callers that can't wait for written() to arrive thru the
+     * event loop, e.g. when the application is about to quit.
+     *
+     * @param fileName The name of a file given to write()
+     * @return The file's latest error or QFile::NoError if it hasn't been
+     *         written at all
+     */
+    QFile::FileError lastError(const QString& fileName) const;
+
+    /**
+     * Write the given data atomically to a file in the calling thread.
+     *
+     * @param fileName The name of the file to write
+     * @param data The file contents
+     * @return QFile::NoError if successful
+     */
+    static QFile::FileError writeFile(const QString& fileName,
+                                      const QList <QByteArray>& data);
+
+signals:
+    /** Tells that writing the given file has finished with $error */
+    void written(const QString& fileName, QFile::FileError error);
+
+protected:
+    /** @reimp */
+    void run();
+
+private:
+    /** Replace $target with $source, atomically if the platform allows */
+    static bool replaceFile(const QString& source, const QString& target);
+
+private:
+    /** Files waiting to be written */
+    QList <QPair <QString,QList <QByteArray> > > m_queue;
+
+    /** The latest result of each written file */
+    QHash <QString,QFile::FileError> m_errors;
+
+    /** Protects m_queue, m_errors and m_running */
+    mutable QMutex m_mutex;
+
+    /** true while run() is processing m_queue */
+    bool m_running;
+};
+
+Q_DECLARE_METATYPE(QFile::FileError)
+
+#endif
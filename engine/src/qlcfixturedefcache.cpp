@@ -20,9 +20,13 @@
 */
 
 #include <QCoreApplication>
-#include <QList>
+#include <QXmlStreamReader>
+#include <QtConcurrentMap>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QDebug>
-#include <QSet>
+#include <QFile>
 
 #ifdef WIN32
 #   include <windows.h>
@@ -31,10 +35,15 @@
 #include "qlcfixturedefcache.h"
 #include "avolitesd4parser.h"
 #include "qlcfixturedef.h"
+#include "qlcfilewriter.h"
 #include "qlcconfig.h"
 #include "qlcfile.h"
 
+#define KIndexMagic   0x51584649 // 'QXFI'
+#define KIndexVersion 1
+
 QLCFixtureDefCache::QLCFixtureDefCache()
+    : m_indexModified(false)
 {
 }
 
@@ -46,51 +55,49 @@ QLCFixtureDefCache::~QLCFixtureDefCache()
 const QLCFixtureDef* QLCFixtureDefCache::fixtureDef(
     const QString& manufacturer, const QString& model) const
 {
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
+    QHash <QString, QHash <QString, Entry> >::iterator mit = m_models.find(manufacturer);
+    if (mit == m_models.end())
+        return NULL;
+
+    QHash <QString, Entry>::iterator it = mit.value().find(model);
+    if (it == mit.value().end())
+        return NULL;
+
+    /* Parse the definition on first use */
+    Entry& entry(it.value());
+    if (entry.path.isEmpty() == false)
     {
-        const QLCFixtureDef* def = it.next();
-        if (def->manufacturer() == manufacturer && def->model() == model)
-            return def;
+        QString path(entry.path);
+        entry.path = QString();
+
+        if (path.toLower().endsWith(KExtAvolitesFixture) == true)
+            entry.def = loadD4(path);
+        else
+            entry.def = loadQXF(path);
+
+        /* The file has been edited without its directory changing */
+        if (entry.def != NULL && (entry.def->manufacturer() != manufacturer ||
+                                  entry.def->model() != model))
+        {
+            qWarning() << Q_FUNC_INFO << path << "is no longer"
+                       << manufacturer << model;
+            delete entry.def;
+            entry.def = NULL;
+            invalidateIndex(path);
+        }
     }
 
-    return NULL;
+    return entry.def;
 }
 
 QStringList QLCFixtureDefCache::manufacturers() const
 {
-    QSet <QString> makers;
-
-    // Gather a list of manufacturers
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
-        makers << it.next()->manufacturer();
-
-    // Bounce the QSet into a QStringList
-    QStringList list;
-    foreach (QString manuf, makers)
-        list << manuf;
-
-    return list;
+    return m_models.keys();
 }
 
 QStringList QLCFixtureDefCache::models(const QString& manufacturer) const
 {
-    QSet <QString> models;
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
-    {
-        QLCFixtureDef* def = it.next();
-        if (def->manufacturer() == manufacturer)
-            models << def->model();
-    }
-
-    // Bounce the QSet into a QStringList
-    QStringList list;
-    foreach (QString manuf, models)
-        list << manuf;
-
-    return list;
+    return m_models.value(manufacturer).keys();
 }
 
 bool QLCFixtureDefCache::addFixtureDef(QLCFixtureDef* fixtureDef)
@@ -98,9 +105,12 @@ bool QLCFixtureDefCache::addFixtureDef(QLCFixtureDef* fixtureDef)
     if (fixtureDef == NULL)
         return false;
 
-    if (models(fixtureDef->manufacturer()).contains(fixtureDef->model()) == false)
+    QHash <QString, Entry>& models(m_models[fixtureDef->manufacturer()]);
+    if (models.contains(fixtureDef->model()) == false)
     {
-        m_defs << fixtureDef;
+        Entry entry;
+        entry.def = fixtureDef;
+        models.insert(fixtureDef->model(), entry);
         return true;
     }
     else
@@ -118,18 +128,12 @@ bool QLCFixtureDefCache::load(const QDir& dir)
     if (dir.exists() == false || dir.isReadable() == false)
         return false;
 
-    /* Attempt to read all specified files from the given directory */
-    QStringListIterator it(dir.entryList());
+    /* Add all definitions of the directory without parsing them yet */
+    QListIterator <FileIndex> it(dirIndex(dir).files);
     while (it.hasNext() == true)
     {
-        QString path(dir.absoluteFilePath(it.next()));
-
-        if (path.toLower().endsWith(KExtFixture) == true)
-            loadQXF(path);
-        else if (path.toLower().endsWith(KExtAvolitesFixture) == true)
-            loadD4(path);
-        else
-            qWarning() << Q_FUNC_INFO << "Unrecognized fixture extension:" << path;
+        const FileIndex& file(it.next());
+        addEntry(file.manufacturer, file.model, dir.absoluteFilePath(file.fileName));
     }
 
     return true;
@@ -137,8 +141,15 @@ bool QLCFixtureDefCache::load(const QDir& dir)
 
 void QLCFixtureDefCache::clear()
 {
-    while (m_defs.isEmpty() == false)
-        delete m_defs.takeFirst();
+    QMutableHashIterator <QString, QHash <QString, Entry> > mit(m_models);
+    while (mit.hasNext() == true)
+    {
+        QMutableHashIterator <QString, Entry> it(mit.next().value());
+        while (it.hasNext() == true)
+            delete it.next().value().def;
+    }
+
+    m_models.clear();
 }
 
 QDir QLCFixtureDefCache::systemDefinitionDirectory()
@@ -194,36 +205,48 @@ QDir QLCFixtureDefCache::userDefinitionDirectory()
     return dir;
 }
 
-void QLCFixtureDefCache::loadQXF(const QString& path)
+void QLCFixtureDefCache::addEntry(const QString& manufacturer, const QString& model,
+                                  const QString& path)
+{
+    QHash <QString, Entry>& models(m_models[manufacturer]);
+    if (models.contains(model) == false)
+    {
+        Entry entry;
+        entry.path = path;
+        entry.def = NULL;
+        models.insert(model, entry);
+    }
+    else
+    {
+        qDebug() << Q_FUNC_INFO << "Ignoring duplicate" << path;
+    }
+}
+
+QLCFixtureDef* QLCFixtureDefCache::loadQXF(const QString& path)
 {
     QLCFixtureDef* fxi = new QLCFixtureDef();
     Q_ASSERT(fxi != NULL);
 
     QFile::FileError error = fxi->loadXML(path);
-    if (error == QFile::NoError)
-    {
-        /* Delete the def if it's a duplicate. */
-        if (addFixtureDef(fxi) == false)
-            delete fxi;
-        fxi = NULL;
-    }
-    else
+    if (error != QFile::NoError)
     {
         qWarning() << Q_FUNC_INFO << "Fixture definition loading from"
                    << path << "failed:" << QLCFile::errorString(error);
         delete fxi;
         fxi = NULL;
     }
+
+    return fxi;
 }
 
-void QLCFixtureDefCache::loadD4(const QString& path)
+QLCFixtureDef* QLCFixtureDefCache::loadD4(const QString& path)
 {
     AvolitesD4Parser parser;
     if (parser.loadXML(path) == false)
     {
         qWarning() << Q_FUNC_INFO << "Unable to load D4 fixture from" << path
                    << ":" << parser.lastError();
-        return;
+        return NULL;
     }
 
     QLCFixtureDef* fxi = new QLCFixtureDef();
@@ -233,14 +256,264 @@ void QLCFixtureDefCache::loadD4(const QString& path)
         qWarning() << Q_FUNC_INFO << "Unable to parse D4 fixture from" << path
                    << ":" << parser.lastError();
         delete fxi;
-        return;
+        return NULL;
     }
 
-    /* Delete the def if it's a duplicate. */
-    if (addFixtureDef(fxi) == false)
+    return fxi;
+}
+
+bool QLCFixtureDefCache::scanFile(const QString& path, QString* manufacturer,
+                                  QString* model)
+{
+    Q_ASSERT(manufacturer != NULL);
+    Q_ASSERT(model != NULL);
+
+    if (path.toLower().endsWith(KExtAvolitesFixture) == true)
     {
-        qDebug() << Q_FUNC_INFO << "Deleting duplicate" << path;
+        /* D4 files are rare, so just parse them */
+        QLCFixtureDef* fxi = loadD4(path);
+        if (fxi == NULL)
+            return false;
+
+        *manufacturer = fxi->manufacturer();
+        *model = fxi->model();
         delete fxi;
+        return true;
+    }
+    else if (path.toLower().endsWith(KExtFixture) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unrecognized fixture extension:" << path;
+        return false;
+    }
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to open" << path;
+        return false;
+    }
+
+    /* Manufacturer & model are at the very beginning of the file, so
+       stop reading as soon as both have been found */
+    QXmlStreamReader xml(&file);
+    QString docType;
+    while (xml.atEnd() == false && xml.isStartElement() == false)
+    {
+        xml.readNext();
+        if (xml.isDTD() == true)
+            docType = xml.dtdName().toString();
+    }
+
+    if (docType != KXMLQLCFixtureDefDocument ||
+        xml.name() != QLatin1String(KXMLQLCFixtureDef))
+    {
+        qWarning() << Q_FUNC_INFO << path << "is not a fixture definition file";
+        return false;
+    }
+
+    bool hasManufacturer = false;
+    bool hasModel = false;
+    while ((hasManufacturer == false || hasModel == false) &&
+           xml.readNextStartElement() == true)
+    {
+        if (xml.name() == QLatin1String(KXMLQLCFixtureDefManufacturer))
+        {
+            *manufacturer = xml.readElementText();
+            hasManufacturer = true;
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCFixtureDefModel))
+        {
+            *model = xml.readElementText();
+            hasModel = true;
+        }
+        else
+        {
+            xml.skipCurrentElement();
+        }
+    }
+
+    if (hasManufacturer == false || hasModel == false)
+    {
+        qWarning() << Q_FUNC_INFO << "No manufacturer or model in" << path;
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************
+ * Directory index
+ *****************************************************************************/
+
+QLCFixtureDefCache::FileIndex QLCFixtureDefCache::scanFileIndex(const QString& path)
+{
+    FileIndex file;
+    if (scanFile(path, &file.manufacturer, &file.model) == true)
+        file.fileName = QFileInfo(path).fileName();
+    return file;
+}
+
+bool QLCFixtureDefCache::loadIndex(const QString& path)
+{
+    m_indexPath = path;
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly) == false)
+        return false;
+
+    QDataStream data(&file);
+    data.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    data >> magic >> version;
+    if (magic != KIndexMagic || version != KIndexVersion)
+    {
+        qDebug() << Q_FUNC_INFO << path << "is not a usable fixture index";
+        return false;
+    }
+
+    QHash <QString, DirIndex> dirIndex;
+    quint32 dirs = 0;
+    data >> dirs;
+    for (quint32 i = 0; i < dirs && data.status() == QDataStream::Ok; i++)
+    {
+        QString dirPath;
+        DirIndex index;
+        quint32 files = 0;
+        data >> dirPath >> index.nameFilters >> index.modified >> files;
+        for (quint32 j = 0; j < files && data.status() == QDataStream::Ok; j++)
+        {
+            FileIndex file;
+            data >> file.fileName >> file.manufacturer >> file.model;
+            index.files << file;
+        }
+
+        dirIndex[dirPath] = index;
+    }
+
+    if (data.status() != QDataStream::Ok)
+    {
+        qWarning() << Q_FUNC_INFO << "Fixture index" << path << "is corrupt";
+        return false;
+    }
+
+    m_dirIndex = dirIndex;
+    m_indexModified = false;
+
+    return true;
+}
+
+bool QLCFixtureDefCache::saveIndex(const QString& path)
+{
+    m_indexPath = path;
+
+    if (m_indexModified == false)
+        return true;
+    else
+        return writeIndex(path);
+}
+
+QString QLCFixtureDefCache::defaultIndexPath()
+{
+    QDir dir(userDefinitionDirectory());
+    dir.cdUp();
+    return dir.absoluteFilePath(KFixtureDefIndex);
+}
+
+bool QLCFixtureDefCache::writeIndex(const QString& path) const
+{
+    QByteArray bytes;
+    QDataStream data(&bytes, QIODevice::WriteOnly);
+    data.setVersion(QDataStream::Qt_4_6);
+
+    data << quint32(KIndexMagic) << quint32(KIndexVersion);
+    data << quint32(m_dirIndex.size());
+
+    QHashIterator <QString, DirIndex> it(m_dirIndex);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        const DirIndex& index(it.value());
+        data << it.key() << index.nameFilters << index.modified;
+        data << quint32(index.files.size());
+
+        QListIterator <FileIndex> fit(index.files);
+        while (fit.hasNext() == true)
+        {
+            const FileIndex& file(fit.next());
+            data << file.fileName << file.manufacturer << file.model;
+        }
+    }
+
+    if (QLCFileWriter::writeFile(path, QList <QByteArray> () << bytes) != QFile::NoError)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to write fixture index" << path;
+        return false;
+    }
+
+    m_indexModified = false;
+    return true;
+}
+
+const QLCFixtureDefCache::DirIndex& QLCFixtureDefCache::dirIndex(const QDir& dir)
+{
+    QString path(dir.absolutePath());
+    uint modified = QFileInfo(path).lastModified().toTime_t();
+
+    if (m_dirIndex.contains(path) == true)
+    {
+        const DirIndex& index(m_dirIndex[path]);
+        if (index.modified != 0 && index.modified == modified &&
+            index.nameFilters == dir.nameFilters())
+        {
+            return index;
+        }
+    }
+
+    qDebug() << Q_FUNC_INFO << "Indexing" << path;
+
+    DirIndex index;
+    index.nameFilters = dir.nameFilters();
+
+    /* Modification times have a resolution of one second, so a directory
+       modified just now could still change without its time changing */
+    if (modified + 2 < QDateTime::currentDateTime().toTime_t())
+        index.modified = modified;
+    else
+        index.modified = 0;
+
+    /* Read the files in parallel; the results come in the original order */
+    QStringList paths;
+    QStringListIterator it(dir.entryList());
+    while (it.hasNext() == true)
+        paths << dir.absoluteFilePath(it.next());
+
+    QList <FileIndex> files = QtConcurrent::blockingMapped(paths, scanFileIndex);
+    QListIterator <FileIndex> fit(files);
+    while (fit.hasNext() == true)
+    {
+        const FileIndex& file(fit.next());
+        if (file.fileName.isEmpty() == false)
+            index.files << file;
+    }
+
+    m_dirIndex[path] = index;
+    m_indexModified = true;
+
+    return m_dirIndex[path];
+}
+
+void QLCFixtureDefCache::invalidateIndex(const QString& path) const
+{
+    QString dirPath(QFileInfo(path).absolutePath());
+    if (m_dirIndex.contains(dirPath) == true)
+    {
+        m_dirIndex[dirPath].modified = 0;
+        m_indexModified = true;
+
+        /* Otherwise the stale index would be used again on next start */
+        if (m_indexPath.isEmpty() == false)
+            writeIndex(m_indexPath);
     }
-    fxi = NULL;
 }
@@ -24,22 +24,31 @@
 
 #include <QStringList>
 #include <QString>
-#include <QMap>
+#include <QHash>
+#include <QList>
 #include <QDir>
 
 class QLCFixtureDef;
 
+#define KFixtureDefIndex "fixtures.index"
+
 /**
  * QLCFixtureDefCache is a cache of fixture definitions that are currently
  * available to the application. Application can get a list of available
  * manufacturer names with QLCFixturedefCache::manufacturers() and subsequently
  * all models for a particular manufacturer with QLCFixtureDefCache::models().
  *
- * The internal structure is a two-tier map (m_models), with the first tier
- * containing manufacturer names as the keys for the first map. The value of
- * each key is another map (the second-tier) whose keys are model names. The
- * value for each model name entry in the second-tier map is the actual
- * QLCFixtureDef instance.
+ * The internal structure is a two-tier hash (m_models), with the first tier
+ * containing manufacturer names as the keys for the first hash. The value of
+ * each key is another hash (the second-tier) whose keys are model names. The
+ * value for each model name entry in the second-tier hash is the file that
+ * the definition comes from and the actual QLCFixtureDef instance.
+ *
+ * Definitions are loaded lazily: load() reads only the manufacturer and model
+ * of each file and the rest of a definition is parsed when it's first asked
+ * for with fixtureDef(). The manufacturers & models of each directory can
+ * also be stored into an index file (see loadIndex() & saveIndex()) so that
+ * unchanged directories don't need to be read at all.
  *
  * Multiple manufacturer & model combinations are discarded.
  *
@@ -65,6 +74,7 @@ public:
     /**
      * Get a fixture definition by its manufacturer and model. Only
      * const methods can be accessed for returned fixture definitions.
+     * If the definition hasn't been used before, it is parsed now.
      *
      * @param manufacturer The fixture definition's manufacturer
      * @param model The fixture definition's model
@@ -96,6 +106,9 @@ public:
      * Returns true even if $fixturePath doesn't contain any fixtures,
      * if it is still accessible (and exists).
      *
+     * Only the manufacturer and model of each definition are read here,
+     * or taken from the index if the directory hasn't changed since.
+     *
      * @param dir The directory to load definitions from.
      * @return true, if the path could be accessed, otherwise false.
      */
@@ -103,7 +116,7 @@ public:
 
     /**
      * Cleans the contents of the fixture definition cache, deleting
-     * all fixture definitions.
+     * all fixture definitions. The directory index is kept.
      */
     void clear();
 
@@ -126,14 +139,117 @@ public:
     static QDir userDefinitionDirectory();
 
 private:
-    /** Load a QLC native fixture definition from the file specified in $path */
-    void loadQXF(const QString& path);
+    /** A model in m_models */
+    struct Entry
+    {
+        /** The file to parse the definition from, empty when parsed */
+        QString path;
+
+        /** The definition, NULL until parsed or if parsing failed */
+        QLCFixtureDef* def;
+    };
+
+    /** Add a definition from $path to m_models unless it's a duplicate */
+    void addEntry(const QString& manufacturer, const QString& model,
+                  const QString& path);
 
-    /** Load an Avolites D4 fixture definition from the file specified in $path */
-    void loadD4(const QString& path);
+    /** Parse a QLC native fixture definition from the file specified in $path */
+    static QLCFixtureDef* loadQXF(const QString& path);
+
+    /** Parse an Avolites D4 fixture definition from the file specified in $path */
+    static QLCFixtureDef* loadD4(const QString& path);
+
+    /**
+     * Read only the manufacturer & model of a fixture definition file
+     *
+     * @return true if the file looks like a fixture definition
+     */
+    static bool scanFile(const QString& path, QString* manufacturer, QString* model);
 
 private:
-    QList <QLCFixtureDef*> m_defs;
+    /** Manufacturer => model => definition */
+    mutable QHash <QString, QHash <QString, Entry> > m_models;
+
+    /*********************************************************************
+     * Directory index
+     *********************************************************************/
+public:
+    /**
+     * Load a directory index saved earlier with saveIndex(). Directories
+     * whose modification time or name filters differ from the index are
+     * read normally by load().
+     *
+     * @param path The index file
+     * @return true if the index was loaded, otherwise false
+     */
+    bool loadIndex(const QString& path);
+
+    /**
+     * Save the index of all directories given to load(), if it has changed
+     * since loadIndex(). The path is remembered so that the index can be
+     * saved again if a definition turns out to have changed later on.
+     *
+     * @param path The index file
+     * @return true if the index was written or didn't need to be
+     */
+    bool saveIndex(const QString& path);
+
+    /**
+     * Get the default index file for the user's & system definitions. It
+     * is kept next to userDefinitionDirectory() instead of inside it, since
+     * writing it there would change the directory's modification time and
+     * so invalidate the directory's own index every time.
+     *
+     * @return Index file path
+     */
+    static QString defaultIndexPath();
+
+private:
+    /** A fixture definition file in a DirIndex */
+    struct FileIndex
+    {
+        QString fileName;
+        QString manufacturer;
+        QString model;
+    };
+
+    /** The fixture definition files of a directory */
+    struct DirIndex
+    {
+        /** Name filters of the QDir given to load() */
+        QStringList nameFilters;
+
+        /** Modification time of the directory, 0 if it must be re-read */
+        uint modified;
+
+        QList <FileIndex> files;
+    };
+
+    /**
+     * Read the manufacturer & model of a file for a DirIndex. This is called
+     * from several threads at once.
+     *
+     * @return File index, with an empty file name if $path couldn't be read
+     */
+    static FileIndex scanFileIndex(const QString& path);
+
+    /** Get the index of $dir, reading it again if it's out of date */
+    const DirIndex& dirIndex(const QDir& dir);
+
+    /** Forget the index of the directory containing $path and save the
+        index file again, if one has been saved or loaded */
+    void invalidateIndex(const QString& path) const;
+
+    /** Write m_dirIndex to $path */
+    bool writeIndex(const QString& path) const;
+
+private:
+    /** Absolute path => index of directories given to load() */
+    mutable QHash <QString, DirIndex> m_dirIndex;
+    mutable bool m_indexModified;
+
+    /** The index file given to loadIndex() or saveIndex() */
+    QString m_indexPath;
 };
 
 #endif
@@ -0,0 +1,76 @@
+/*
+  Q Light Controller
+  qlcxmltags.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QDebug>
+
+#include "qlcxmltags.h"
+
+QLCXMLTags::QLCXMLTags(const QStringList& names)
+    : m_names(names)
+{
+    for (int i = 0; i < names.size(); i++)
+    {
+        const QString& name(names.at(i));
+        if (id(QStringRef(&name)) != -1)
+            qWarning() << Q_FUNC_INFO << "Duplicate tag name:" << name;
+        else
+            m_ids.insert(hash(name.unicode(), name.size()), i);
+    }
+}
+
+QLCXMLTags::~QLCXMLTags()
+{
+}
+
+int QLCXMLTags::id(const QStringRef& name) const
+{
+    /* Called for every element that is loaded, so compare the reader's
+       characters in place instead of converting them into a QString */
+    const uint key = hash(name.unicode(), name.size());
+    QMultiHash <uint,int>::const_iterator it = m_ids.find(key);
+    while (it != m_ids.end() && it.key() == key)
+    {
+        if (m_names.at(it.value()) == name)
+            return it.value();
+        ++it;
+    }
+
+    return -1;
+}
+
+int QLCXMLTags::count() const
+{
+    return m_ids.size();
+}
+
+uint QLCXMLTags::hash(const QChar* chars, int size)
+{
+    /* Same as qHash(const QString&) */
+    uint h = 0;
+    for (int i = 0; i < size; i++)
+    {
+        h = (h << 4) + chars[i].unicode();
+        h ^= (h & 0xf0000000) >> 23;
+        h &= 0x0fffffff;
+    }
+
+    return h;
+}
@@ -0,0 +1,78 @@
+/*
+  Q Light Controller
+  qlcxmltags.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCXMLTAGS_H
+#define QLCXMLTAGS_H
+
+#include <QStringList>
+#include <QStringRef>
+#include <QString>
+#include <QHash>
+
+/**
+ * QLCXMLTags maps a fixed set of XML tag names to integer IDs so that
+ * streaming loaders can dispatch on IDs with a switch instead of comparing
+ * tag names one by one. Each loader keeps its own static table and gives the
+ * tags in the order of its own enum:
+ *
+ * @code
+ * enum { TagSpeed, TagValue };
+ * static const QLCXMLTags tags(QStringList() << KXMLQLCFunctionSpeed
+ *                                            << KXMLQLCFunctionValue);
+ * switch (tags.id(xml.name()))
+ * @endcode
+ */
+class QLCXMLTags
+{
+public:
+    /**
+     * Create a new tag table
+     *
+     * @param names Tag names. The ID of each name is its index in the list.
+     */
+    QLCXMLTags(const QStringList& names);
+    ~QLCXMLTags();
+
+    /**
+     * Get the ID of a tag name
+     *
+     * @param name The name to look up (e.g. QXmlStreamReader::name())
+     * @return The index of the name given in the constructor or -1 if the
+     *         name is not in the table
+     */
+    int id(const QStringRef& name) const;
+
+    /** Get the number of tags in the table */
+    int count() const;
+
+private:
+    /** Hash the given characters without making a QString of them */
+    static uint hash(const QChar* chars, int size);
+
+private:
+    /** Tag names in the order given to the constructor */
+    QStringList m_names;
+
+    /** Indices to m_names by the hash of each name */
+    QMultiHash <uint,int> m_ids;
+};
+
+#endif
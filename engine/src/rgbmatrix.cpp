@@ -136,17 +136,35 @@ QList <RGBMap> RGBMatrix::previewMaps()
 {
     QList <RGBMap> steps;
 
+    int count = previewStepCount();
+    for (int i = 0; i < count; i++)
+        steps << previewMap(i);
+
+    return steps;
+}
+
+int RGBMatrix::previewStepCount()
+{
     if (m_algorithm == NULL)
-        return steps;
+        return 0;
 
     FixtureGroup* grp = doc()->fixtureGroup(fixtureGroup());
-    if (grp != NULL)
-    {
-        for (int i = 0; i < m_algorithm->rgbMapStepCount(grp->size()); i++)
-            steps << m_algorithm->rgbMap(grp->size(), monoColor().rgb(), i);
-    }
+    if (grp == NULL)
+        return 0;
 
-    return steps;
+    return m_algorithm->rgbMapStepCount(grp->size());
+}
+
+RGBMap RGBMatrix::previewMap(int step)
+{
+    if (m_algorithm == NULL)
+        return RGBMap();
+
+    FixtureGroup* grp = doc()->fixtureGroup(fixtureGroup());
+    if (grp == NULL)
+        return RGBMap();
+
+    return m_algorithm->rgbMap(grp->size(), monoColor().rgb(), step);
 }
 
 /****************************************************************************
@@ -287,7 +305,7 @@ void RGBMatrix::preRun(MasterTimer* timer)
 {
     Q_UNUSED(timer);
 
-    FixtureGroup* grp = doc()->fixtureGroup(fixtureGroup());
+    const PatchSnapshot::GroupInfo* grp = doc()->patchSnapshot()->fixtureGroup(fixtureGroup());
     if (grp != NULL && m_algorithm != NULL)
     {
         m_direction = direction();
@@ -298,7 +316,7 @@ void RGBMatrix::preRun(MasterTimer* timer)
         if (m_direction == Forward)
             m_step = 0;
         else
-            m_step = m_algorithm->rgbMapStepCount(grp->size());
+            m_step = m_algorithm->rgbMapStepCount(grp->size);
     }
 
     m_roundTime->start();
@@ -311,7 +329,10 @@ void RGBMatrix::write(MasterTimer* timer, UniverseArray* universes)
     Q_UNUSED(timer);
     Q_UNUSED(universes);
 
-    FixtureGroup* grp = doc()->fixtureGroup(fixtureGroup());
+    // Look the group & fixtures up from the patch snapshot since the main
+    // thread may be modifying the real ones at the same time.
+    const PatchSnapshot* patch = doc()->patchSnapshot();
+    const PatchSnapshot::GroupInfo* grp = patch->fixtureGroup(fixtureGroup());
     if (grp == NULL)
     {
         // No fixture group to control
@@ -330,8 +351,8 @@ void RGBMatrix::write(MasterTimer* timer, UniverseArray* universes)
     // Get new map every time when elapsed is reset to zero
     if (elapsed() == 0)
     {
-        RGBMap map = m_algorithm->rgbMap(grp->size(), monoColor().rgb(), m_step);
-        updateMapChannels(map, grp);
+        RGBMap map = m_algorithm->rgbMap(grp->size, monoColor().rgb(), m_step);
+        updateMapChannels(map, patch, grp);
     }
 
     // Run the generic fader that takes care of fading in/out individual channels
@@ -342,7 +363,7 @@ void RGBMatrix::write(MasterTimer* timer, UniverseArray* universes)
 
     // Check if we need to change direction, stop completely or go to next step
     if (elapsed() >= duration())
-        roundCheck(grp->size());
+        roundCheck(grp->size);
 }
 
 void RGBMatrix::postRun(MasterTimer* timer, UniverseArray* universes)
@@ -414,7 +435,8 @@ void RGBMatrix::roundCheck(const QSize& size)
     resetElapsed();
 }
 
-void RGBMatrix::updateMapChannels(const RGBMap& map, const FixtureGroup* grp)
+void RGBMatrix::updateMapChannels(const RGBMap& map, const PatchSnapshot* patch,
+                                  const PatchSnapshot::GroupInfo* grp)
 {
     // Create/modify fade channels for ALL pixels in the color map.
     for (int y = 0; y < map.size(); y++)
@@ -422,12 +444,12 @@ void RGBMatrix::updateMapChannels(const RGBMap& map, const FixtureGroup* grp)
         for (int x = 0; x < map[y].size(); x++)
         {
             QLCPoint pt(x, y);
-            GroupHead grpHead(grp->head(pt));
-            Fixture* fxi = doc()->fixture(grpHead.fxi);
+            GroupHead grpHead(grp->heads.value(pt));
+            const PatchSnapshot::FixtureInfo* fxi = patch->fixture(grpHead.fxi);
             if (fxi == NULL)
                 continue;
 
-            QLCFixtureHead head = fxi->head(grpHead.head);
+            const QLCFixtureHead& head(fxi->head(grpHead.head));
 
             QList <quint32> rgb = head.rgbChannels();
             QList <quint32> cmy = head.cmyChannels();
@@ -29,6 +29,7 @@
 #include <QPair>
 #include <QMap>
 
+#include "patchsnapshot.h"
 #include "rgbscript.h"
 #include "function.h"
 
@@ -83,6 +84,16 @@ public:
     /** Get a list of RGBMap steps for preview purposes, using the current algorithm. */
     QList <RGBMap> previewMaps();
 
+    /**
+     * Get the number of preview steps with the current algorithm & group.
+     * Together with previewMap() this lets previews compute only the steps
+     * that they actually need.
+     */
+    int previewStepCount();
+
+    /** Get a single RGBMap step for preview purposes, using the current algorithm. */
+    RGBMap previewMap(int step);
+
 private:
     RGBAlgorithm* m_algorithm;
 
@@ -127,7 +138,8 @@ private:
     void roundCheck(const QSize& size);
 
     /** Update new FadeChannels to m_fader when $map has changed since last time */
-    void updateMapChannels(const RGBMap& map, const FixtureGroup* grp);
+    void updateMapChannels(const RGBMap& map, const PatchSnapshot* patch,
+                           const PatchSnapshot::GroupInfo* grp);
 
     /** Grab starting values for a fade channel from $fader if available */
     void insertStartValues(FadeChannel& fc) const;
@@ -19,13 +19,19 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QVarLengthArray>
 #include <QDomDocument>
+#include <QDataStream>
 #include <QDomElement>
+#include <QtEndian>
 #include <QDebug>
 #include <QList>
 #include <QFile>
 
 #include "qlcfixturedef.h"
+#include "qlcxmltags.h"
 #include "qlcmacros.h"
 #include "qlcfile.h"
 
@@ -138,17 +144,30 @@ void Scene::clear()
  * Fixtures
  *****************************************************************************/
 
-void Scene::slotFixtureRemoved(quint32 fxi_id)
+void Scene::fixturesRemoved(const QSet <quint32>& ids)
 {
+    bool removed = false;
+
+    m_valueListMutex.lock();
     QMutableListIterator <SceneValue> it(m_values);
     while (it.hasNext() == true)
     {
-        SceneValue scv = it.next();
-        if (scv.fxi == fxi_id)
+        if (ids.contains(it.next().fxi) == true)
+        {
             it.remove();
+            removed = true;
+        }
     }
+    m_valueListMutex.unlock();
 
-    emit changed(this->id());
+    /* Most scenes don't contain the removed fixtures at all */
+    if (removed == true)
+        emit changed(this->id());
+}
+
+void Scene::slotFixtureRemoved(quint32 fxi_id)
+{
+    fixturesRemoved(QSet <quint32> () << fxi_id);
 }
 
 /*****************************************************************************
@@ -184,6 +203,76 @@ bool Scene::saveXML(QDomDocument* doc, QDomElement* wksp_root)
     return true;
 }
 
+bool Scene::saveXML(QXmlStreamWriter& xml)
+{
+    /* Function tag */
+    xml.writeStartElement(KXMLQLCFunction);
+    xml.writeAttribute(KXMLQLCFunctionID, QString::number(id()));
+    xml.writeAttribute(KXMLQLCFunctionType, Function::typeToString(type()));
+    xml.writeAttribute(KXMLQLCFunctionName, name());
+
+    /* Speed */
+    saveXMLSpeed(xml);
+
+    /* Scene contents */
+    QListIterator <SceneValue> it(m_values);
+    while (it.hasNext() == true)
+        it.next().saveXML(xml);
+
+    xml.writeEndElement();
+
+    return true;
+}
+
+bool Scene::saveBinary(QDataStream& data)
+{
+    saveBinaryProperties(data);
+
+    /* Values as a packed array of 9-byte records: fixture, channel, value */
+    QMutexLocker locker(&m_valueListMutex);
+    QByteArray packed(m_values.size() * 9, 0);
+    uchar* ptr = reinterpret_cast<uchar*> (packed.data());
+    QListIterator <SceneValue> it(m_values);
+    while (it.hasNext() == true)
+    {
+        const SceneValue& scv(it.next());
+        qToBigEndian <quint32> (scv.fxi, ptr);
+        qToBigEndian <quint32> (scv.channel, ptr + 4);
+        ptr[8] = scv.value;
+        ptr += 9;
+    }
+
+    data << packed;
+    return (data.status() == QDataStream::Ok);
+}
+
+bool Scene::loadBinary(QDataStream& data)
+{
+    loadBinaryProperties(data);
+
+    QByteArray packed;
+    data >> packed;
+    if (data.status() != QDataStream::Ok || (packed.size() % 9) != 0)
+        return false;
+
+    QMutexLocker locker(&m_valueListMutex);
+    m_values.clear();
+    m_values.reserve(packed.size() / 9);
+    const uchar* ptr = reinterpret_cast<const uchar*> (packed.constData());
+    const uchar* end = ptr + packed.size();
+    for (; ptr < end; ptr += 9)
+    {
+        m_values.append(SceneValue(qFromBigEndian <quint32> (ptr),
+                                   qFromBigEndian <quint32> (ptr + 4),
+                                   ptr[8]));
+    }
+
+    /* The values were saved sorted, but the file might not be ours */
+    qSort(m_values.begin(), m_values.end());
+
+    return true;
+}
+
 bool Scene::loadXML(const QDomElement& root)
 {
     if (root.tagName() != KXMLQLCFunction)
@@ -230,6 +319,59 @@ bool Scene::loadXML(const QDomElement& root)
     return true;
 }
 
+bool Scene::loadXML(QXmlStreamReader& xml)
+{
+    enum { TagBus, TagSpeed, TagValue };
+    static const QLCXMLTags tags(QStringList() << KXMLQLCBus
+                                               << KXMLQLCFunctionSpeed
+                                               << KXMLQLCFunctionValue);
+
+    if (xml.name() != QLatin1String(KXMLQLCFunction))
+    {
+        qWarning() << Q_FUNC_INFO << "Function node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    if (xml.attributes().value(KXMLQLCFunctionType) != typeToString(Function::Scene))
+    {
+        qWarning() << Q_FUNC_INFO << "Function is not a scene";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    /* Load scene contents */
+    while (xml.readNextStartElement() == true)
+    {
+        switch (tags.id(xml.name()))
+        {
+        case TagBus:
+            m_legacyFadeBus = xml.readElementText().toUInt();
+            break;
+
+        case TagSpeed:
+            loadXMLSpeed(xml);
+            break;
+
+        case TagValue:
+        {
+            /* Channel value */
+            SceneValue scv;
+            if (scv.loadXML(xml) == true)
+                setValue(scv);
+            break;
+        }
+
+        default:
+            qWarning() << Q_FUNC_INFO << "Unknown scene tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+            break;
+        }
+    }
+
+    return (xml.hasError() == false);
+}
+
 void Scene::postLoad()
 {
     // Map legacy bus speed to fixed speed values
@@ -283,13 +425,23 @@ void Scene::writeDMX(MasterTimer* timer, UniverseArray* ua)
     {
         // Keep HTP and LTP channels up. Flash is more or less a forceful intervention
         // so enforce all values that the user has chosen to flash.
-        foreach (const SceneValue& sv, m_values)
+        QVarLengthArray <int,512> channels(m_values.size());
+        QVarLengthArray <uchar,512> values(m_values.size());
+        QVarLengthArray <QLCChannel::Group,512> groups(m_values.size());
+
+        for (int i = 0; i < m_values.size(); i++)
         {
+            const SceneValue& sv(m_values.at(i));
             FadeChannel fc;
             fc.setFixture(sv.fxi);
             fc.setChannel(sv.channel);
-            ua->write(fc.address(doc()), sv.value, fc.group(doc()));
+            channels[i] = int(fc.address(doc()));
+            values[i] = sv.value;
+            groups[i] = fc.group(doc());
         }
+
+        ua->write(channels.constData(), values.constData(), groups.constData(),
+                  m_values.size());
     }
     else
     {
@@ -32,6 +32,8 @@
 #include "function.h"
 #include "fixture.h"
 
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 
@@ -120,6 +122,10 @@ protected:
     /*********************************************************************
      * Fixtures
      *********************************************************************/
+public:
+    /** @reimpl */
+    void fixturesRemoved(const QSet <quint32>& ids);
+
 public slots:
     void slotFixtureRemoved(quint32 fxi_id);
 
@@ -130,9 +136,21 @@ public:
     /** @reimpl */
     bool saveXML(QDomDocument* doc, QDomElement* wksp_root);
 
+    /** @reimpl */
+    bool saveXML(QXmlStreamWriter& xml);
+
+    /** @reimpl */
+    bool saveBinary(QDataStream& data);
+
+    /** @reimpl */
+    bool loadBinary(QDataStream& data);
+
     /** @reimpl */
     bool loadXML(const QDomElement& root);
 
+    /** @reimpl */
+    bool loadXML(QXmlStreamReader& xml);
+
     /** @reimpl */
     void postLoad();
 
@@ -19,6 +19,8 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDebug>
@@ -93,6 +95,23 @@ bool SceneValue::loadXML(const QDomElement& tag)
     return isValid();
 }
 
+bool SceneValue::loadXML(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCSceneValue))
+    {
+        qWarning() << Q_FUNC_INFO << "Scene node not found";
+        xml.skipCurrentElement();
+        return false;
+    }
+
+    QXmlStreamAttributes attrs(xml.attributes());
+    fxi = attrs.value(KXMLQLCSceneValueFixture).toString().toUInt();
+    channel = attrs.value(KXMLQLCSceneValueChannel).toString().toUInt();
+    value = uchar(xml.readElementText().toUInt());
+
+    return isValid();
+}
+
 bool SceneValue::saveXML(QDomDocument* doc, QDomElement* scene_root) const
 {
     QDomElement tag;
@@ -113,3 +132,14 @@ bool SceneValue::saveXML(QDomDocument* doc, QDomElement* scene_root) const
 
     return true;
 }
+
+bool SceneValue::saveXML(QXmlStreamWriter& xml) const
+{
+    xml.writeStartElement(KXMLQLCSceneValue);
+    xml.writeAttribute(KXMLQLCSceneValueFixture, QString::number(fxi));
+    xml.writeAttribute(KXMLQLCSceneValueChannel, QString::number(channel));
+    xml.writeCharacters(QString::number(value));
+    xml.writeEndElement();
+
+    return true;
+}
@@ -26,6 +26,8 @@
 
 #include "fixture.h"
 
+class QXmlStreamWriter;
+class QXmlStreamReader;
 class QDomDocument;
 class QDomElement;
 
@@ -77,9 +79,15 @@ public:
     /** Load this SceneValue's contents from an XML tag */
     bool loadXML(const QDomElement& tag);
 
+    /** Load this SceneValue's contents from the current element of $xml */
+    bool loadXML(QXmlStreamReader& xml);
+
     /** Save this SceneValue to an XML document */
     bool saveXML(QDomDocument* doc, QDomElement* scene_root) const;
 
+    /** Save this SceneValue to an XML stream */
+    bool saveXML(QXmlStreamWriter& xml) const;
+
 public:
     quint32 fxi;
     quint32 channel;
@@ -39,6 +39,7 @@ HEADERS += avolitesd4parser.h \
            qlccapability.h \
            qlcchannel.h \
            qlcfile.h \
+           qlcfilewriter.h \
            qlcfixturedef.h \
            qlcfixturedefcache.h \
            qlcfixturehead.h \
@@ -48,6 +49,7 @@ HEADERS += avolitesd4parser.h \
            qlcinputprofile.h \
            qlcinputsource.h \
            qlcphysical.h \
+           qlcxmltags.h \
            qlccapability.h
 
 # Engine
@@ -68,14 +70,18 @@ HEADERS += bus.h \
            genericdmxsource.h \
            genericfader.h \
            grouphead.h \
+           inputlistener.h \
            inputmap.h \
            inputpatch.h \
            intensitygenerator.h \
+           latencyprobe.h \
            mastertimer.h \
            universearray.h \
+           universemonitor.h \
            outputmap.h \
            outputpatch.h \
            palettegenerator.h \
+           patchsnapshot.h \
            qlcpoint.h \
            rgbalgorithm.h \
            rgbmatrix.h \
@@ -83,7 +89,8 @@ HEADERS += bus.h \
            rgbtext.h \
            scene.h \
            scenevalue.h \
-           script.h
+           script.h \
+           workspacecache.h
 
 win32:HEADERS += mastertimer-win32.h
 unix:HEADERS  += mastertimer-unix.h
@@ -93,6 +100,7 @@ SOURCES += avolitesd4parser.cpp \
            qlccapability.cpp \
            qlcchannel.cpp \
            qlcfile.cpp \
+           qlcfilewriter.cpp \
            qlcfixturedef.cpp \
            qlcfixturedefcache.cpp \
            qlcfixturehead.cpp \
@@ -101,7 +109,8 @@ SOURCES += avolitesd4parser.cpp \
            qlcinputchannel.cpp \
            qlcinputprofile.cpp \
            qlcinputsource.cpp \
-           qlcphysical.cpp
+           qlcphysical.cpp \
+           qlcxmltags.cpp
 
 # Engine
 SOURCES += bus.cpp \
@@ -124,11 +133,14 @@ SOURCES += bus.cpp \
            inputmap.cpp \
            inputpatch.cpp \
            intensitygenerator.cpp \
+           latencyprobe.cpp \
            mastertimer.cpp \
            universearray.cpp \
+           universemonitor.cpp \
            outputmap.cpp \
            outputpatch.cpp \
            palettegenerator.cpp \
+           patchsnapshot.cpp \
            qlcpoint.cpp \
            rgbalgorithm.cpp \
            rgbmatrix.cpp \
@@ -136,13 +148,18 @@ SOURCES += bus.cpp \
            rgbtext.cpp \
            scene.cpp \
            scenevalue.cpp \
-           script.cpp
+           script.cpp \
+           workspacecache.cpp
 
 win32:SOURCES += mastertimer-win32.cpp
 unix:SOURCES  += mastertimer-unix.cpp
 
+unix:!macx:HEADERS += ioreactor.h
+unix:!macx:SOURCES += ioreactor.cpp
+
 # Interfaces
 HEADERS += ../../plugins/interfaces/qlcinplugin.h \
+           ../../plugins/interfaces/qlcioreactor.h \
            ../../plugins/interfaces/qlcoutplugin.h
 
 #############################################################################
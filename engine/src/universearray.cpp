@@ -29,6 +29,10 @@
 #define KXMLQLCGMChannelModeAllChannels "All"
 #define KXMLQLCGMChannelModeIntensity "Intensity"
 
+/* Bits of m_gMTracked */
+#define KGMTrackedIntensity    (1 << 0)
+#define KGMTrackedNonIntensity (1 << 1)
+
 /****************************************************************************
  * Initialization
  ****************************************************************************/
@@ -42,6 +46,8 @@ UniverseArray::UniverseArray(int size)
     m_gMValueMode = GMReduce;
     m_gMValue = 255;
     m_gMFraction = 1.0;
+    m_gMTracked.fill(0, size);
+    updateGMTable();
 }
 
 UniverseArray::~UniverseArray()
@@ -61,6 +67,7 @@ void UniverseArray::reset()
     m_postGMValues->fill(0);
     m_gMIntensityChannels.clear();
     m_gMNonIntensityChannels.clear();
+    m_gMTracked.fill(0);
 }
 
 void UniverseArray::reset(int address, int range)
@@ -71,6 +78,7 @@ void UniverseArray::reset(int address, int range)
         m_postGMValues->data()[i] = 0;
         m_gMIntensityChannels.remove(i);
         m_gMNonIntensityChannels.remove(i);
+        m_gMTracked.data()[i] = 0;
     }
 }
 
@@ -91,7 +99,7 @@ void UniverseArray::zeroIntensityChannels()
 
 bool UniverseArray::checkHTP(int channel, uchar value, QLCChannel::Group group) const
 {
-    if (group == QLCChannel::Intensity && value < uchar(preGMValues()[channel]))
+    if (group == QLCChannel::Intensity && value < uchar(m_preGMValues->at(channel)))
     {
         /* Current value is higher than new value and HTP applies: reject. */
         return false;
@@ -190,6 +198,7 @@ void UniverseArray::setGMValue(uchar value)
 {
     m_gMValue = value;
     m_gMFraction = CLAMP(double(value) / double(UCHAR_MAX), 0.0, 1.0);
+    updateGMTable();
 
     QSetIterator <int> it(m_gMIntensityChannels);
     while (it.hasNext() == true)
@@ -233,30 +242,55 @@ const QByteArray UniverseArray::preGMValues() const
 
 uchar UniverseArray::applyGM(int channel, uchar value, QLCChannel::Group group)
 {
-    if (value == 0)
+    trackGM(channel, value, group);
+    return gMFiltered(value, group);
+}
+
+uchar UniverseArray::gMFiltered(uchar value, QLCChannel::Group group) const
+{
+    if (gMChannelMode() == GMAllChannels || group == QLCChannel::Intensity)
+        return m_gMTable[value];
+    else
+        return value;
+}
+
+void UniverseArray::trackGM(int channel, uchar value, QLCChannel::Group group)
+{
+    /* Touch the sets only when the channel actually enters or leaves them */
+    char& tracked(m_gMTracked.data()[channel]);
+    if (group == QLCChannel::Intensity)
     {
-        if (group == QLCChannel::Intensity)
+        if (value == 0 && (tracked & KGMTrackedIntensity) != 0)
             m_gMIntensityChannels.remove(channel);
+        else if (value != 0 && (tracked & KGMTrackedIntensity) == 0)
+            m_gMIntensityChannels.insert(channel);
         else
+            return;
+
+        tracked ^= KGMTrackedIntensity;
+    }
+    else
+    {
+        if (value == 0 && (tracked & KGMTrackedNonIntensity) != 0)
             m_gMNonIntensityChannels.remove(channel);
-        return value;
+        else if (value != 0 && (tracked & KGMTrackedNonIntensity) == 0)
+            m_gMNonIntensityChannels.insert(channel);
+        else
+            return;
+
+        tracked ^= KGMTrackedNonIntensity;
     }
+}
 
-    if ((gMChannelMode() == GMIntensity && group == QLCChannel::Intensity) ||
-        (gMChannelMode() == GMAllChannels))
+void UniverseArray::updateGMTable()
+{
+    for (int i = 0; i <= UCHAR_MAX; i++)
     {
         if (gMValueMode() == GMLimit)
-            value = MIN(value, gMValue());
+            m_gMTable[i] = MIN(uchar(i), gMValue());
         else
-            value = char(floor((double(value) * gMFraction()) + 0.5));
+            m_gMTable[i] = uchar(floor((double(i) * gMFraction()) + 0.5));
     }
-
-    if (group == QLCChannel::Intensity)
-        m_gMIntensityChannels << channel;
-    else
-        m_gMNonIntensityChannels << channel;
-
-    return value;
 }
 
 /****************************************************************************
@@ -272,8 +306,91 @@ bool UniverseArray::write(int channel, uchar value, QLCChannel::Group group)
         return false;
 
     m_preGMValues->data()[channel] = char(value);
-    value = applyGM(channel, value, group);
-    m_postGMValues->data()[channel] = char(value);
+    m_postGMValues->data()[channel] = char(gMFiltered(value, group));
+    trackGM(channel, value, group);
 
     return true;
 }
+
+void UniverseArray::fill(const QVector <int>& channels, uchar value,
+                         QLCChannel::Group group)
+{
+    const uchar post = gMFiltered(value, group);
+    const bool htp = (group == QLCChannel::Intensity);
+
+    char* preData = m_preGMValues->data();
+    char* postData = m_postGMValues->data();
+    const int* channel = channels.constData();
+    const int count = channels.size();
+
+    for (int i = 0; i < count; i++)
+    {
+        const int ch = channel[i];
+        if (uint(ch) >= uint(m_size))
+            continue;
+
+        /* Same rules as checkHTP() */
+        if (htp == true && value < uchar(preData[ch]))
+            continue;
+
+        preData[ch] = char(value);
+        postData[ch] = char(post);
+        trackGM(ch, value, group);
+    }
+}
+
+void UniverseArray::write(const QVector <int>& channels, const QVector <uchar>& values,
+                          const QVector <QLCChannel::Group>& groups)
+{
+    Q_ASSERT(values.size() >= channels.size());
+    Q_ASSERT(groups.size() >= channels.size());
+
+    write(channels.constData(), values.constData(), groups.constData(), channels.size());
+}
+
+void UniverseArray::write(const int* channels, const uchar* values,
+                          const QLCChannel::Group* groups, int count)
+{
+    char* preData = m_preGMValues->data();
+    char* postData = m_postGMValues->data();
+
+    for (int i = 0; i < count; i++)
+    {
+        const int ch = channels[i];
+        if (uint(ch) >= uint(m_size))
+            continue;
+
+        /* Same rules as checkHTP() */
+        if (groups[i] == QLCChannel::Intensity && values[i] < uchar(preData[ch]))
+            continue;
+
+        preData[ch] = char(values[i]);
+        postData[ch] = char(gMFiltered(values[i], groups[i]));
+        trackGM(ch, values[i], groups[i]);
+    }
+}
+
+void UniverseArray::writeRange(int address, const uchar* values, int count,
+                               QLCChannel::Group group)
+{
+    const int first = MAX(address, 0);
+    const int last = MIN(address + count, m_size);
+    const bool htp = (group == QLCChannel::Intensity);
+    const uchar* table = (htp == true || gMChannelMode() == GMAllChannels) ? m_gMTable : NULL;
+
+    char* preData = m_preGMValues->data();
+    char* postData = m_postGMValues->data();
+
+    for (int ch = first; ch < last; ch++)
+    {
+        const uchar value = values[ch - address];
+
+        /* Same rules as checkHTP() */
+        if (htp == true && value < uchar(preData[ch]))
+            continue;
+
+        preData[ch] = char(value);
+        postData[ch] = char((table != NULL) ? table[value] : value);
+        trackGM(ch, value, group);
+    }
+}
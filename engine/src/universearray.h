@@ -23,6 +23,7 @@
 #define UNIVERSEARRAY_H
 
 #include <QByteArray>
+#include <QVector>
 #include <QSet>
 
 #include "qlcchannel.h"
@@ -170,6 +171,29 @@ protected:
      */
     uchar applyGM(int channel, uchar value, QLCChannel::Group group);
 
+    /**
+     * Get the value that Grand Master would turn the given value into,
+     * without keeping track of the channel.
+     *
+     * @param value The value to filter
+     * @param group The group of the channel that the value is for
+     * @return Value filtered through grand master (if applicable)
+     */
+    uchar gMFiltered(uchar value, QLCChannel::Group group) const;
+
+    /**
+     * Keep track of the channels that Grand Master must be re-applied to
+     * when its value or mode changes.
+     *
+     * @param channel The channel that was written to
+     * @param value The channel's new pre-Grand-Master value
+     * @param group The channel's channel group
+     */
+    void trackGM(int channel, uchar value, QLCChannel::Group group);
+
+    /** Compute m_gMTable from the current Grand Master value & mode */
+    void updateGMTable();
+
 protected:
     GMValueMode m_gMValueMode;
     GMChannelMode m_gMChannelMode;
@@ -177,6 +201,13 @@ protected:
     double m_gMFraction;
     QSet <int> m_gMIntensityChannels;
     QSet <int> m_gMNonIntensityChannels;
+
+    /** The sets above that each channel is in, to skip redundant updates */
+    QByteArray m_gMTracked;
+
+    /** Grand Master applied to each possible value, see gMFiltered() */
+    uchar m_gMTable[256];
+
     QByteArray* m_preGMValues;
     QByteArray* m_postGMValues;
 
@@ -195,6 +226,59 @@ public:
      */
     bool write(int channel, uchar value,
                QLCChannel::Group group = QLCChannel::NoGroup);
+
+    /**
+     * Write the same value to several channels of the same group. This is
+     * equivalent to calling write() for each channel, except that Grand
+     * Master is computed only once. Channels that are out of range are
+     * skipped.
+     *
+     * @param channels The channel numbers to write to
+     * @param value The value to write
+     * @param group The channels' channel group
+     */
+    void fill(const QVector <int>& channels, uchar value,
+              QLCChannel::Group group = QLCChannel::NoGroup);
+
+    /**
+     * Write a value to each of the given channels. This is equivalent to
+     * calling write() for each channel, except that channels are accessed
+     * directly without any intermediate copies. Channels that are out of
+     * range are skipped.
+     *
+     * @param channels The channel numbers to write to
+     * @param values The value to write to each channel
+     * @param groups The channel group of each channel
+     */
+    void write(const QVector <int>& channels, const QVector <uchar>& values,
+               const QVector <QLCChannel::Group>& groups);
+
+    /**
+     * Write a value to each of the given channels, like above, but from
+     * plain arrays so that callers can use buffers on the stack.
+     *
+     * @param channels The channel numbers to write to
+     * @param values The value to write to each channel
+     * @param groups The channel group of each channel
+     * @param count Number of items in each array
+     */
+    void write(const int* channels, const uchar* values,
+               const QLCChannel::Group* groups, int count);
+
+    /**
+     * Write consecutive values to consecutive channels of the same group.
+     * This is equivalent to calling write() for each channel. Writing a
+     * whole buffer of QLCChannel::Intensity values merges it with the
+     * current values in HTP fashion. Channels that are out of range are
+     * skipped.
+     *
+     * @param address The channel to write the first value to
+     * @param values The values to write
+     * @param count Number of values to write
+     * @param group The channels' channel group
+     */
+    void writeRange(int address, const uchar* values, int count,
+                    QLCChannel::Group group = QLCChannel::NoGroup);
 };
 
 #endif
@@ -0,0 +1,115 @@
+/*
+  Q Light Controller
+  universemonitor.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QTimer>
+#include <QDebug>
+
+#include "universemonitor.h"
+#include "qlcmacros.h"
+#include "outputmap.h"
+
+UniverseMonitor::UniverseMonitor(OutputMap* outputMap, QObject* parent)
+    : QObject(parent)
+    , m_outputMap(outputMap)
+    , m_timer(new QTimer(this))
+    , m_rate(0)
+    , m_serial(0)
+{
+    Q_ASSERT(outputMap != NULL);
+
+    setRate(defaultRate());
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(update()));
+}
+
+UniverseMonitor::~UniverseMonitor()
+{
+}
+
+void UniverseMonitor::setRate(int rate)
+{
+    m_rate = CLAMP(rate, 1, 100);
+    m_timer->setInterval(1000 / m_rate);
+}
+
+int UniverseMonitor::rate() const
+{
+    return m_rate;
+}
+
+int UniverseMonitor::defaultRate()
+{
+    return 20;
+}
+
+void UniverseMonitor::start()
+{
+    m_timer->start();
+}
+
+void UniverseMonitor::stop()
+{
+    m_timer->stop();
+}
+
+bool UniverseMonitor::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+void UniverseMonitor::reset()
+{
+    m_serial = 0;
+    m_values.clear();
+}
+
+QByteArray UniverseMonitor::values() const
+{
+    return m_values;
+}
+
+void UniverseMonitor::update()
+{
+    QByteArray values(m_outputMap->universeSnapshot(m_serial));
+    if (values.isEmpty() == true)
+        return;
+
+    QList <quint32> channels;
+    if (values.size() != m_values.size())
+    {
+        /* Nothing to compare against; everything has changed */
+        for (int i = 0; i < values.size(); i++)
+            channels << quint32(i);
+    }
+    else
+    {
+        const char* now = values.constData();
+        const char* before = m_values.constData();
+        for (int i = 0; i < values.size(); i++)
+        {
+            if (now[i] != before[i])
+                channels << quint32(i);
+        }
+    }
+
+    m_values = values;
+    if (channels.isEmpty() == false)
+        emit valuesChanged(m_values, channels);
+}
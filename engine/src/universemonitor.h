@@ -0,0 +1,101 @@
+/*
+  Q Light Controller
+  universemonitor.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef UNIVERSEMONITOR_H
+#define UNIVERSEMONITOR_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QList>
+
+class OutputMap;
+class QTimer;
+
+/**
+ * UniverseMonitor delivers universe values to monitor views at a fixed rate,
+ * independent of the MasterTimer frequency. On each update it takes the
+ * latest snapshot from OutputMap and compares it to the previous one, so
+ * that views get to know exactly which channels have changed. Intermediate
+ * values written between two updates are never delivered, so a slow view
+ * can't make updates pile up.
+ */
+class UniverseMonitor : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(UniverseMonitor)
+
+public:
+    UniverseMonitor(OutputMap* outputMap, QObject* parent = 0);
+    ~UniverseMonitor();
+
+    /** Set the number of updates per second (1-100) */
+    void setRate(int rate);
+
+    /** Get the number of updates per second */
+    int rate() const;
+
+    /** The default number of updates per second */
+    static int defaultRate();
+
+    /** Start delivering updates */
+    void start();
+
+    /** Stop delivering updates */
+    void stop();
+
+    /** Check, whether updates are being delivered */
+    bool isRunning() const;
+
+    /**
+     * Report all channels as changed on the next update, for example after
+     * a view has been rebuilt.
+     */
+    void reset();
+
+    /** Get the values that were delivered last */
+    QByteArray values() const;
+
+public slots:
+    /** Check for new values and emit valuesChanged() if there are any */
+    void update();
+
+signals:
+    /**
+     * Emitted when universe values have changed since the previous update
+     *
+     * @param values The post-GM values of all universes
+     * @param channels The universe addresses of changed channels, ascending
+     */
+    void valuesChanged(const QByteArray& values, const QList <quint32>& channels);
+
+private:
+    OutputMap* m_outputMap;
+    QTimer* m_timer;
+    int m_rate;
+
+    /** Serial number of the latest values, from OutputMap */
+    quint32 m_serial;
+
+    /** The latest delivered values */
+    QByteArray m_values;
+};
+
+#endif
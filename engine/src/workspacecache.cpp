@@ -0,0 +1,119 @@
+/*
+  Q Light Controller
+  workspacecache.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+
+#include "workspacecache.h"
+#include "doc.h"
+
+#define KCacheMagic   0x51585742 // 'QXWB'
+#define KCacheVersion 1
+
+QString WorkspaceCache::fileName(const QString& workspaceFileName)
+{
+    return workspaceFileName + KExtWorkspaceCache;
+}
+
+QByteArray WorkspaceCache::hash(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QByteArray WorkspaceCache::hash(const QList <QByteArray>& data)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QListIterator <QByteArray> it(data);
+    while (it.hasNext() == true)
+        hash.addData(it.next());
+    return hash.result();
+}
+
+QByteArray WorkspaceCache::save(const QByteArray& hash, Doc* doc,
+                                const QByteArray& appData)
+{
+    Q_ASSERT(doc != NULL);
+
+    QByteArray cache;
+    QDataStream data(&cache, QIODevice::WriteOnly);
+    data.setVersion(QDataStream::Qt_4_6);
+
+    data << quint32(KCacheMagic) << quint32(KCacheVersion) << hash;
+    if (doc->saveBinary(data) == false)
+        return QByteArray();
+    data << appData;
+
+    return cache;
+}
+
+bool WorkspaceCache::load(const QString& fileName, const QByteArray& hash,
+                          Doc* doc, QByteArray* appData)
+{
+    Q_ASSERT(doc != NULL);
+    Q_ASSERT(appData != NULL);
+
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly) == false)
+        return false;
+
+    /* Read straight from the page cache if possible */
+    QByteArray contents;
+    uchar* map = file.map(0, file.size());
+    if (map != NULL)
+        contents = QByteArray::fromRawData(reinterpret_cast<char*> (map), file.size());
+    else
+        contents = file.readAll();
+
+    QDataStream data(contents);
+    data.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray cachedHash;
+    data >> magic >> version;
+    if (magic != KCacheMagic || version != KCacheVersion)
+    {
+        qDebug() << Q_FUNC_INFO << fileName << "is not a usable workspace cache";
+        return false;
+    }
+
+    data >> cachedHash;
+    if (cachedHash != hash)
+    {
+        qDebug() << Q_FUNC_INFO << fileName << "is out of date";
+        return false;
+    }
+
+    if (doc->loadBinary(data) == true)
+    {
+        data >> *appData;
+        if (data.status() == QDataStream::Ok)
+            return true;
+    }
+
+    qWarning() << Q_FUNC_INFO << "Unable to load workspace cache" << fileName;
+    doc->clearContents();
+    appData->clear();
+
+    return false;
+}
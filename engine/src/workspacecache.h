@@ -0,0 +1,93 @@
+/*
+  Q Light Controller
+  workspacecache.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef WORKSPACECACHE_H
+#define WORKSPACECACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+class Doc;
+
+#define KExtWorkspaceCache ".bin" // Appended to the workspace file name
+
+/**
+ * WorkspaceCache reads and writes binary sidecar files (".qxw.bin") that
+ * hold the same contents as a workspace file in a format that loads much
+ * faster than XML. Fixtures, fixture groups, scenes, chasers and
+ * collections are stored as plain binary records (scene values as packed
+ * arrays); other function types and the application's own data (Virtual
+ * Console etc.) are stored as XML that the application loads as usual.
+ *
+ * Each cache file stores a hash of the workspace file it was made from. A
+ * cache is used only if the hash matches the workspace file's current
+ * contents and its format version is the current one, so a stale or
+ * foreign cache simply causes the workspace to be loaded from XML.
+ *
+ * The file layout is (thru QDataStream, version Qt_4_6):
+ * @code
+ * quint32    magic ('QXWB')
+ * quint32    format version
+ * QByteArray workspace file hash
+ * ...        Doc contents (see Doc::saveBinary())
+ * QByteArray application data
+ * @endcode
+ */
+class WorkspaceCache
+{
+public:
+    /** Get the name of the cache file of the given workspace file */
+    static QString fileName(const QString& workspaceFileName);
+
+    /** Compute the hash of the given workspace file contents */
+    static QByteArray hash(const QByteArray& data);
+
+    /** Compute the hash of workspace file contents given as fragments */
+    static QByteArray hash(const QList <QByteArray>& data);
+
+    /**
+     * Serialize the contents of a cache file.
+     *
+     * @param hash The hash of the workspace file that the cache belongs to
+     * @param doc The document whose contents to store
+     * @param appData Application-specific data to store
+     * @return The cache file contents
+     */
+    static QByteArray save(const QByteArray& hash, Doc* doc,
+                           const QByteArray& appData);
+
+    /**
+     * Load a cache file into $doc, if the cache is valid for the workspace
+     * file with the given hash. The file is memory-mapped when possible.
+     * If loading fails half-way, $doc is cleared.
+     *
+     * @param fileName The name of the cache file
+     * @param hash The hash of the workspace file's current contents
+     * @param doc The document to load to
+     * @param appData The application-specific data is stored here
+     * @return true if the cache was loaded, otherwise false
+     */
+    static bool load(const QString& fileName, const QByteArray& hash,
+                     Doc* doc, QByteArray* appData);
+};
+
+#endif
@@ -19,6 +19,8 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QPointer>
 #include <QtTest>
 #include <QtXml>
@@ -36,6 +38,7 @@
 #include "fixture.h"
 #include "chaser.h"
 #include "scene.h"
+#include "efxfixture.h"
 #include "efx.h"
 #include "bus.h"
 #include "doc.h"
@@ -76,7 +79,12 @@ void Doc_Test::cleanup()
     QCOMPARE(m_doc->m_latestFunctionId, quint32(0));
     QCOMPARE(m_doc->m_latestFixtureId, quint32(0));
     QCOMPARE(m_doc->m_latestFixtureGroupId, quint32(0));
-    QCOMPARE(m_doc->m_addresses.size(), 0);
+    QCOMPARE(m_doc->m_patchedRanges.size(), 0);
+    for (int i = 0; i < m_doc->m_addressTable.size(); i++)
+        QCOMPARE(m_doc->fixtureForAddress(i), Fixture::invalidId());
+    QCOMPARE(m_doc->m_fixtureInfos.size(), 0);
+    QCOMPARE(m_doc->m_groupInfos.size(), 0);
+    QVERIFY(m_doc->patchSnapshot()->fixture(0) == NULL);
 }
 
 void Doc_Test::defaults()
@@ -300,6 +308,233 @@ void Doc_Test::fixture()
     QVERIFY(m_doc->fixture(Fixture::invalidId()) == NULL);
 }
 
+void Doc_Test::addressInfo()
+{
+    QCOMPARE(m_doc->m_addressTable.size(), int(m_doc->outputMap()->universes() * 512));
+
+    Fixture* f1 = new Fixture(m_doc);
+    f1->setChannels(5);
+    f1->setAddress(0);
+    f1->setUniverse(0);
+    m_doc->addFixture(f1);
+
+    /* Overlaps f1's last two channels, which now belong to f2 */
+    Fixture* f2 = new Fixture(m_doc);
+    f2->setChannels(5);
+    f2->setAddress(3);
+    f2->setUniverse(0);
+    m_doc->addFixture(f2);
+
+    for (quint32 i = 0; i < 3; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), f1->id());
+        QCOMPARE(m_doc->addressInfo(i).channel, i);
+        QCOMPARE(m_doc->addressInfo(i).group, QLCChannel::Intensity);
+    }
+    for (quint32 i = 3; i < 8; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), f2->id());
+        QCOMPARE(m_doc->addressInfo(i).channel, i - 3);
+    }
+    QCOMPARE(m_doc->fixtureForAddress(8), Fixture::invalidId());
+    QCOMPARE(m_doc->addressInfo(8).channel, QLCChannel::invalid());
+    QCOMPARE(m_doc->addressInfo(8).group, QLCChannel::Intensity);
+
+    /* Addresses outside of the output universes */
+    QCOMPARE(m_doc->fixtureForAddress(m_doc->outputMap()->universes() * 512),
+             Fixture::invalidId());
+    QCOMPARE(m_doc->fixtureForAddress(UINT_MAX), Fixture::invalidId());
+
+    /* Moving f2 gives f1 its last two channels back */
+    f2->setAddress(10);
+    for (quint32 i = 0; i < 5; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), f1->id());
+        QCOMPARE(m_doc->addressInfo(i).channel, i);
+    }
+    for (quint32 i = 5; i < 10; i++)
+        QCOMPARE(m_doc->fixtureForAddress(i), Fixture::invalidId());
+    for (quint32 i = 10; i < 15; i++)
+        QCOMPARE(m_doc->fixtureForAddress(i), f2->id());
+
+    /* Move f2 to the second universe */
+    f2->setUniverse(1);
+    for (quint32 i = 10; i < 15; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), Fixture::invalidId());
+        QCOMPARE(m_doc->fixtureForAddress(512 + i), f2->id());
+    }
+
+    /* Deleting a fixture frees its addresses */
+    quint32 id = f1->id();
+    QVERIFY(m_doc->deleteFixture(id) == true);
+    for (quint32 i = 0; i < 5; i++)
+        QCOMPARE(m_doc->fixtureForAddress(i), Fixture::invalidId());
+
+    /* Channel groups come from the fixture definition */
+    const QLCFixtureDef* def = m_doc->fixtureDefCache()->fixtureDef("Showtec", "MiniMax 250");
+    QVERIFY(def != NULL);
+    const QLCFixtureMode* mode = def->modes().at(0);
+    QVERIFY(mode != NULL);
+
+    Fixture* f3 = new Fixture(m_doc);
+    f3->setAddress(100);
+    f3->setUniverse(0);
+    f3->setChannels(mode->channels().size());
+    f3->setFixtureDefinition(def, mode);
+    m_doc->addFixture(f3);
+    for (quint32 i = 0; i < f3->channels(); i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(100 + i), f3->id());
+        QCOMPARE(m_doc->addressInfo(100 + i).channel, i);
+        QCOMPARE(m_doc->addressInfo(100 + i).group, f3->channel(i)->group());
+    }
+}
+
+void Doc_Test::addressInfoOverlap()
+{
+    /* Three fixtures on the same addresses; the last one added owns them */
+    QList <Fixture*> fixtures;
+    for (int i = 0; i < 3; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setChannels(5);
+        fxi->setAddress(i);
+        fxi->setUniverse(0);
+        m_doc->addFixture(fxi);
+        fixtures << fxi;
+    }
+
+    QCOMPARE(m_doc->fixtureForAddress(0), fixtures[0]->id());
+    QCOMPARE(m_doc->fixtureForAddress(1), fixtures[1]->id());
+    for (quint32 i = 2; i < 7; i++)
+        QCOMPARE(m_doc->fixtureForAddress(i), fixtures[2]->id());
+
+    /* Freed addresses always go to the remaining fixture with the highest ID,
+       regardless of the order the fixtures are stored in */
+    QVERIFY(m_doc->deleteFixture(fixtures[2]->id()) == true);
+    QCOMPARE(m_doc->fixtureForAddress(0), fixtures[0]->id());
+    for (quint32 i = 1; i < 6; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), fixtures[1]->id());
+        QCOMPARE(m_doc->addressInfo(i).channel, i - 1);
+    }
+    QCOMPARE(m_doc->fixtureForAddress(6), Fixture::invalidId());
+
+    QVERIFY(m_doc->deleteFixture(fixtures[1]->id()) == true);
+    for (quint32 i = 0; i < 5; i++)
+    {
+        QCOMPARE(m_doc->fixtureForAddress(i), fixtures[0]->id());
+        QCOMPARE(m_doc->addressInfo(i).channel, i);
+    }
+    QCOMPARE(m_doc->fixtureForAddress(5), Fixture::invalidId());
+}
+
+void Doc_Test::denseIds()
+{
+    /* IDs beyond the dense arrays still work thru the maps */
+    Fixture* f1 = new Fixture(m_doc);
+    f1->setChannels(1);
+    QVERIFY(m_doc->addFixture(f1, 100000) == true);
+    QVERIFY(m_doc->fixture(100000) == f1);
+    QVERIFY(m_doc->m_fixtureArray.size() == 0);
+
+    Fixture* f2 = new Fixture(m_doc);
+    f2->setChannels(1);
+    QVERIFY(m_doc->addFixture(f2, 5) == true);
+    QVERIFY(m_doc->fixture(5) == f2);
+    QVERIFY(m_doc->fixture(4) == NULL);
+    QVERIFY(m_doc->fixture(6) == NULL);
+    QCOMPARE(m_doc->m_fixtureArray.size(), 6);
+
+    QVERIFY(m_doc->deleteFixture(5) == true);
+    QVERIFY(m_doc->fixture(5) == NULL);
+    QVERIFY(m_doc->deleteFixture(100000) == true);
+    QVERIFY(m_doc->fixture(100000) == NULL);
+
+    Scene* s1 = new Scene(m_doc);
+    QVERIFY(m_doc->addFunction(s1, 70000) == true);
+    QVERIFY(m_doc->function(70000) == s1);
+    Scene* s2 = new Scene(m_doc);
+    QVERIFY(m_doc->addFunction(s2, 3) == true);
+    QVERIFY(m_doc->function(3) == s2);
+    QVERIFY(m_doc->function(2) == NULL);
+    QVERIFY(m_doc->deleteFunction(3) == true);
+    QVERIFY(m_doc->function(3) == NULL);
+
+    FixtureGroup* g1 = new FixtureGroup(m_doc);
+    QVERIFY(m_doc->addFixtureGroup(g1, 80000) == true);
+    QVERIFY(m_doc->fixtureGroup(80000) == g1);
+    FixtureGroup* g2 = new FixtureGroup(m_doc);
+    QVERIFY(m_doc->addFixtureGroup(g2, 1) == true);
+    QVERIFY(m_doc->fixtureGroup(1) == g2);
+    QVERIFY(m_doc->fixtureGroup(0) == NULL);
+    QVERIFY(m_doc->deleteFixtureGroup(1) == true);
+    QVERIFY(m_doc->fixtureGroup(1) == NULL);
+}
+
+void Doc_Test::patchSnapshot()
+{
+    const PatchSnapshot* snap = m_doc->patchSnapshot();
+    QVERIFY(snap != NULL);
+    quint32 version = snap->version();
+
+    Fixture* f1 = new Fixture(m_doc);
+    f1->setChannels(4);
+    f1->setAddress(10);
+    m_doc->addFixture(f1);
+
+    /* Adding a fixture publishes a new snapshot */
+    snap = m_doc->patchSnapshot();
+    QVERIFY(snap->version() > version);
+    QVERIFY(snap->fixture(f1->id()) != NULL);
+    QCOMPARE(snap->fixture(f1->id())->address, quint32(10));
+    QCOMPARE(snap->fixture(f1->id())->groups.size(), 4);
+    QCOMPARE(snap->fixture(f1->id())->heads.size(), 4);
+    QCOMPARE(snap->channelAddress(f1->id(), 2), quint32(12));
+    QCOMPARE(snap->channelGroup(f1->id(), 2), QLCChannel::Intensity);
+    QCOMPARE(snap->addressInfo(11).fixture, f1->id());
+    QCOMPARE(snap->addressInfo(11).channel, quint32(1));
+    QVERIFY(snap->fixture(12345) == NULL);
+    QCOMPARE(snap->channelAddress(12345, 0), QLCChannel::invalid());
+
+    /* A snapshot replaced during a tick must survive until the tick ends */
+    m_doc->masterTimer()->m_tickGeneration.fetchAndAddOrdered(1);
+    f1->setAddress(20);
+    QVERIFY(m_doc->patchSnapshot() != snap);
+    QCOMPARE(m_doc->patchSnapshot()->channelAddress(f1->id(), 0), quint32(20));
+    QCOMPARE(m_doc->m_retiredPatchSnapshots.size(), 1);
+    QCOMPARE(snap->channelAddress(f1->id(), 0), quint32(10));
+    QCOMPARE(snap->addressInfo(11).fixture, f1->id());
+    m_doc->masterTimer()->m_tickGeneration.fetchAndAddOrdered(1);
+
+    /* Snapshots replaced between ticks are reclaimed right away */
+    f1->setAddress(30);
+    QCOMPARE(m_doc->m_retiredPatchSnapshots.size(), 0);
+    QCOMPARE(m_doc->patchSnapshot()->channelAddress(f1->id(), 0), quint32(30));
+
+    /* Fixture groups */
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    grp->setSize(QSize(4, 1));
+    m_doc->addFixtureGroup(grp);
+    grp->assignFixture(f1->id());
+    snap = m_doc->patchSnapshot();
+    QVERIFY(snap->fixtureGroup(grp->id()) != NULL);
+    QCOMPARE(snap->fixtureGroup(grp->id())->size, QSize(4, 1));
+    QVERIFY(snap->fixtureGroup(grp->id())->heads == grp->headHash());
+    QVERIFY(snap->fixtureGroup(grp->id())->heads.value(QLCPoint(3, 0)) == GroupHead(f1->id(), 3));
+
+    /* Deleting things removes them from new snapshots */
+    quint32 id = grp->id();
+    QVERIFY(m_doc->deleteFixtureGroup(id) == true);
+    QVERIFY(m_doc->patchSnapshot()->fixtureGroup(id) == NULL);
+
+    id = f1->id();
+    QVERIFY(m_doc->deleteFixture(id) == true);
+    QVERIFY(m_doc->patchSnapshot()->fixture(id) == NULL);
+    QCOMPARE(m_doc->patchSnapshot()->addressInfo(30).fixture, Fixture::invalidId());
+}
+
 void Doc_Test::totalPowerConsumption()
 {
     int fuzzy = 0;
@@ -548,6 +783,163 @@ void Doc_Test::function()
     QVERIFY(m_doc->function(id) == NULL);
 }
 
+void Doc_Test::batch()
+{
+    qRegisterMetaType <Doc::BatchChanges> ("Doc::BatchChanges");
+    QSignalSpy batchSpy(m_doc, SIGNAL(batchFinished(Doc::BatchChanges)));
+    QSignalSpy addSpy(m_doc, SIGNAL(functionAdded(quint32)));
+
+    Scene* s1 = new Scene(m_doc);
+    m_doc->addFunction(s1);
+    Fixture* f1 = new Fixture(m_doc);
+    f1->setChannels(4);
+    m_doc->addFixture(f1);
+    QVERIFY(m_doc->isBatching() == false);
+    QCOMPARE(batchSpy.size(), 0);
+
+    m_doc->beginBatch();
+    QVERIFY(m_doc->isBatching() == true);
+
+    // Added & changed
+    Scene* s2 = new Scene(m_doc);
+    m_doc->addFunction(s2);
+    s2->setName("Foo");
+
+    // Added & removed
+    Scene* s3 = new Scene(m_doc);
+    m_doc->addFunction(s3);
+    quint32 s3id = s3->id();
+    m_doc->deleteFunction(s3id);
+
+    // Changed & removed
+    s1->setName("Bar");
+    quint32 s1id = s1->id();
+    m_doc->deleteFunction(s1id);
+
+    // Changed
+    f1->setAddress(10);
+
+    // Individual signals are still emitted
+    QCOMPARE(addSpy.size(), 3);
+    QCOMPARE(batchSpy.size(), 0);
+
+    m_doc->endBatch();
+    QVERIFY(m_doc->isBatching() == false);
+    QCOMPARE(batchSpy.size(), 1);
+
+    Doc::BatchChanges changes = batchSpy.at(0).at(0).value <Doc::BatchChanges> ();
+    QCOMPARE(changes.functions.added, QSet <quint32> () << s2->id());
+    QCOMPARE(changes.functions.removed, QSet <quint32> () << s1id);
+    QCOMPARE(changes.functions.changed.size(), 0);
+    QCOMPARE(changes.fixtures.added.size(), 0);
+    QCOMPARE(changes.fixtures.removed.size(), 0);
+    QCOMPARE(changes.fixtures.changed, QSet <quint32> () << f1->id());
+    QVERIFY(changes.fixtureGroups.isEmpty() == true);
+
+    // Nothing changes in an empty batch, so nothing is emitted
+    m_doc->beginBatch();
+    m_doc->endBatch();
+    QCOMPARE(batchSpy.size(), 1);
+
+    // Changes are not recorded outside of batches
+    s2->setName("Xyzzy");
+    m_doc->beginBatch();
+    m_doc->endBatch();
+    QCOMPARE(batchSpy.size(), 1);
+}
+
+void Doc_Test::batchNested()
+{
+    qRegisterMetaType <Doc::BatchChanges> ("Doc::BatchChanges");
+    QSignalSpy batchSpy(m_doc, SIGNAL(batchFinished(Doc::BatchChanges)));
+
+    m_doc->beginBatch();
+    m_doc->addFunction(new Scene(m_doc));
+
+    m_doc->beginBatch();
+    m_doc->addFunction(new Scene(m_doc));
+    m_doc->endBatch();
+    QVERIFY(m_doc->isBatching() == true);
+    QCOMPARE(batchSpy.size(), 0);
+
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    m_doc->addFixtureGroup(grp);
+
+    m_doc->endBatch();
+    QVERIFY(m_doc->isBatching() == false);
+    QCOMPARE(batchSpy.size(), 1);
+
+    Doc::BatchChanges changes = batchSpy.at(0).at(0).value <Doc::BatchChanges> ();
+    QCOMPARE(changes.functions.added.size(), 2);
+    QCOMPARE(changes.fixtureGroups.added, QSet <quint32> () << grp->id());
+    QVERIFY(changes.fixtures.isEmpty() == true);
+}
+
+void Doc_Test::batchDeferred()
+{
+    Fixture* f1 = new Fixture(m_doc);
+    f1->setChannels(4);
+    m_doc->addFixture(f1);
+    quint32 f1id = f1->id();
+
+    Fixture* f2 = new Fixture(m_doc);
+    f2->setChannels(4);
+    f2->setAddress(10);
+    m_doc->addFixture(f2);
+    quint32 f2id = f2->id();
+
+    Scene* s1 = new Scene(m_doc);
+    s1->setValue(f1id, 0, 255);
+    s1->setValue(f2id, 0, 255);
+    s1->setValue(f2id, 1, 127);
+    m_doc->addFunction(s1);
+
+    Scene* s2 = new Scene(m_doc);
+    m_doc->addFunction(s2);
+
+    QSignalSpy modifiedSpy(m_doc, SIGNAL(modified(bool)));
+    QSignalSpy changedSpy(m_doc, SIGNAL(functionChanged(quint32)));
+    quint32 version = m_doc->patchSnapshot()->version();
+
+    m_doc->beginBatch();
+    m_doc->deleteFixture(f1id);
+    m_doc->deleteFixture(f2id);
+
+    // Patch, modified status & functions are updated only at the end
+    QCOMPARE(m_doc->patchSnapshot()->version(), version);
+    QVERIFY(m_doc->patchSnapshot()->fixture(f1id) != NULL);
+    QCOMPARE(modifiedSpy.size(), 0);
+    QCOMPARE(s1->values().size(), 3);
+    QCOMPARE(changedSpy.size(), 0);
+
+    // Reusing a removed fixture's ID makes functions forget it right away
+    Fixture* f3 = new Fixture(m_doc);
+    f3->setChannels(1);
+    m_doc->addFixture(f3);
+    QCOMPARE(f3->id(), f2id);
+    QCOMPARE(s1->values().size(), 1);
+    QCOMPARE(changedSpy.size(), 1);
+
+    m_doc->endBatch();
+    QCOMPARE(m_doc->patchSnapshot()->version(), version + 1);
+    QVERIFY(m_doc->patchSnapshot()->fixture(f1id) == NULL);
+    QVERIFY(m_doc->patchSnapshot()->fixture(f2id) != NULL);
+    QCOMPARE(modifiedSpy.size(), 1);
+    QCOMPARE(modifiedSpy.at(0).at(0).toBool(), true);
+    QCOMPARE(s1->values().size(), 0);
+
+    // Only the scene that contained the fixtures has changed
+    QCOMPARE(changedSpy.size(), 2);
+    QCOMPARE(changedSpy.at(1).at(0).toUInt(), s1->id());
+
+    // Outside of batches functions forget removed fixtures immediately
+    s2->setValue(f2id, 0, 1);
+    QCOMPARE(s2->values().size(), 1);
+    m_doc->deleteFixture(f2id);
+    QCOMPARE(s2->values().size(), 0);
+    QCOMPARE(m_doc->patchSnapshot()->version(), version + 2);
+}
+
 void Doc_Test::load()
 {
     QDomDocument document;
@@ -616,6 +1008,162 @@ void Doc_Test::loadWrongRoot()
     QVERIFY(m_doc->loadXML(root) == false);
 }
 
+void Doc_Test::loadStream()
+{
+    QDomDocument document;
+    QDomElement root = document.createElement("Engine");
+
+    root.appendChild(createFixtureNode(document, 0));
+    root.appendChild(createFixtureNode(document, 72));
+    root.appendChild(createFixtureNode(document, 15));
+
+    root.appendChild(createFixtureGroupNode(document, 0));
+    root.appendChild(createFixtureGroupNode(document, 42));
+    root.appendChild(createFixtureGroupNode(document, 72));
+
+    root.appendChild(createCollectionNode(document, 5));
+    root.appendChild(createCollectionNode(document, 9));
+    root.appendChild(createCollectionNode(document, 1));
+    root.appendChild(createCollectionNode(document, 7));
+
+    root.appendChild(createBusNode(document, 0, 10));
+    root.appendChild(createBusNode(document, 7, 20));
+    root.appendChild(createBusNode(document, 12, 30));
+    root.appendChild(createBusNode(document, 29, 40));
+    root.appendChild(createBusNode(document, 31, 5000));
+
+    root.appendChild(document.createElement("ExtraTag"));
+
+    QString str;
+    QTextStream stream(&str);
+    root.save(stream, 1);
+
+    QXmlStreamReader xml(str);
+    QVERIFY(xml.readNextStartElement() == true);
+
+    QVERIFY(m_doc->fixtures().size() == 0);
+    QVERIFY(m_doc->functions().size() == 0);
+    QVERIFY(m_doc->loadXML(xml) == true);
+    QVERIFY(xml.isEndElement() == true);
+    QVERIFY(xml.name() == QLatin1String("Engine"));
+    QVERIFY(m_doc->fixtures().size() == 3);
+    QVERIFY(m_doc->functions().size() == 4);
+    QVERIFY(m_doc->fixtureGroups().size() == 3);
+    QVERIFY(m_doc->fixture(72) != NULL);
+    QCOMPARE(m_doc->fixture(72)->name(), QString("Fixture 72"));
+    QCOMPARE(m_doc->fixtureGroup(42)->name(), QString("Group with ID 42"));
+    QVERIFY(Bus::instance()->value(0) == 10);
+    QVERIFY(Bus::instance()->value(7) == 20);
+    QVERIFY(Bus::instance()->value(12) == 30);
+    QVERIFY(Bus::instance()->value(29) == 40);
+    QVERIFY(Bus::instance()->value(31) == 5000);
+}
+
+void Doc_Test::loadStreamIdentical()
+{
+    /* Create a workspace with plenty of everything */
+    for (int i = 0; i < 64; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setName(QString("Dimmer %1").arg(i));
+        fxi->setChannels(8);
+        fxi->setAddress((i * 8) % 512);
+        fxi->setUniverse(i / 64);
+        m_doc->addFixture(fxi);
+    }
+
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    grp->setName("Matrix");
+    grp->setSize(QSize(8, 8));
+    m_doc->addFixtureGroup(grp);
+    for (int i = 0; i < 8; i++)
+        grp->assignFixture(i);
+
+    QList <quint32> scenes;
+    for (int i = 0; i < 500; i++)
+    {
+        Scene* s = new Scene(m_doc);
+        s->setName(QString("Scene %1").arg(i));
+        s->setFadeInSpeed(i * 10);
+        for (quint32 fxi = 0; fxi < 64; fxi += 4)
+            s->setValue(fxi, i % 8, uchar(i));
+        m_doc->addFunction(s);
+        scenes << s->id();
+    }
+
+    for (int i = 0; i < 20; i++)
+    {
+        Chaser* c = new Chaser(m_doc);
+        c->setName(QString("Chaser %1").arg(i));
+        c->setRunOrder(Function::PingPong);
+        c->setDirection(Function::Backward);
+        c->setDurationMode(Chaser::Common);
+        for (int j = 0; j < 25; j++)
+            c->addStep(ChaserStep(scenes[i * 25 + j], j, j * 2, j * 3));
+        m_doc->addFunction(c);
+    }
+
+    Collection* o = new Collection(m_doc);
+    o->addFunction(scenes[0]);
+    o->addFunction(scenes[1]);
+    m_doc->addFunction(o);
+
+    /* EFX has no stream loader of its own */
+    EFX* e = new EFX(m_doc);
+    e->setName("Circle");
+    EFXFixture* ef = new EFXFixture(e);
+    ef->setFixture(0);
+    e->addFixture(ef);
+    m_doc->addFunction(e);
+
+    QDomDocument original(QLCFile::getXMLHeader("Workspace"));
+    QDomElement root = original.documentElement();
+    QVERIFY(m_doc->saveXML(&original, &root) == true);
+    QVERIFY(root.firstChildElement("Engine").isNull() == false);
+    QString text(original.toString());
+
+    /* Load it both ways */
+    Doc domDoc(this);
+    QDomDocument parsed;
+    QVERIFY(parsed.setContent(text) == true);
+    QVERIFY(domDoc.loadXML(parsed.documentElement().firstChildElement("Engine")) == true);
+
+    Doc streamDoc(this);
+    QXmlStreamReader xml(text);
+    QVERIFY(xml.readNextStartElement() == true);
+    QVERIFY(xml.readNextStartElement() == true);
+    while (xml.name() != QLatin1String("Engine"))
+    {
+        xml.skipCurrentElement();
+        QVERIFY(xml.readNextStartElement() == true);
+    }
+    QVERIFY(streamDoc.loadXML(xml) == true);
+
+    /* Both must produce the same contents */
+    QCOMPARE(streamDoc.fixtures().size(), m_doc->fixtures().size());
+    QCOMPARE(streamDoc.functions().size(), m_doc->functions().size());
+    QCOMPARE(streamDoc.fixtureGroups().size(), m_doc->fixtureGroups().size());
+
+    QDomDocument domSaved(QLCFile::getXMLHeader("Workspace"));
+    QDomElement domRoot = domSaved.documentElement();
+    domDoc.saveXML(&domSaved, &domRoot);
+
+    QDomDocument streamSaved(QLCFile::getXMLHeader("Workspace"));
+    QDomElement streamRoot = streamSaved.documentElement();
+    streamDoc.saveXML(&streamSaved, &streamRoot);
+
+    QString domResult;
+    QTextStream domStream(&domResult);
+    domRoot.firstChildElement("Engine").save(domStream, 1);
+
+    QString streamResult;
+    QTextStream streamStream(&streamResult);
+    streamRoot.firstChildElement("Engine").save(streamStream, 1);
+
+    QVERIFY(domResult.isEmpty() == false);
+    QCOMPARE(streamResult, domResult);
+}
+
 void Doc_Test::save()
 {
     Scene* s = new Scene(m_doc);
@@ -699,6 +1247,183 @@ void Doc_Test::save()
     QVERIFY(m_doc->isModified() == true);
 }
 
+void Doc_Test::saveStream()
+{
+    for (int i = 0; i < 4; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setName(QString("Fixture <%1> & co").arg(i));
+        fxi->setChannels(6);
+        fxi->setAddress(i * 6);
+        m_doc->addFixture(fxi);
+    }
+
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    grp->setName("Group");
+    grp->setSize(QSize(2, 2));
+    m_doc->addFixtureGroup(grp);
+    for (quint32 i = 0; i < 4; i++)
+        grp->assignFixture(i);
+
+    Scene* s = new Scene(m_doc);
+    s->setName("Scene \"1\"");
+    s->setFadeOutSpeed(500);
+    s->setValue(0, 0, 255);
+    s->setValue(3, 5, 17);
+    m_doc->addFunction(s);
+
+    Chaser* c = new Chaser(m_doc);
+    c->setRunOrder(Function::SingleShot);
+    c->setFadeInMode(Chaser::PerStep);
+    c->addStep(ChaserStep(s->id(), 10, 20, 30));
+    c->addStep(ChaserStep(s->id(), 40, 50, 60));
+    m_doc->addFunction(c);
+
+    Collection* o = new Collection(m_doc);
+    o->addFunction(s->id());
+    o->addFunction(c->id());
+    m_doc->addFunction(o);
+
+    EFX* e = new EFX(m_doc);
+    EFXFixture* ef = new EFXFixture(e);
+    ef->setFixture(2);
+    e->addFixture(ef);
+    m_doc->addFunction(e);
+
+    /* Save the same document thru DOM and thru a stream */
+    QDomDocument document;
+    QDomElement root = document.createElement("Workspace");
+    document.appendChild(root);
+    QVERIFY(m_doc->saveXML(&document, &root) == true);
+
+    QByteArray streamed;
+    QXmlStreamWriter xml(&streamed);
+    QVERIFY(m_doc->saveXML(xml) == true);
+
+    QDomDocument parsed;
+    QVERIFY(parsed.setContent(streamed) == true);
+    QCOMPARE(parsed.documentElement().tagName(), QString("Engine"));
+
+    /* Both must load into identical contents */
+    Doc domDoc(this);
+    QVERIFY(domDoc.loadXML(root.firstChildElement("Engine")) == true);
+    Doc streamDoc(this);
+    QVERIFY(streamDoc.loadXML(parsed.documentElement()) == true);
+
+    QCOMPARE(streamDoc.fixtures().size(), 4);
+    QCOMPARE(streamDoc.functions().size(), 4);
+    QCOMPARE(streamDoc.fixtureGroups().size(), 1);
+    QCOMPARE(streamDoc.fixture(1)->name(), QString("Fixture <1> & co"));
+    QCOMPARE(streamDoc.function(s->id())->name(), QString("Scene \"1\""));
+    QCOMPARE(engineXML(&streamDoc), engineXML(&domDoc));
+}
+
+void Doc_Test::saveFragments()
+{
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setChannels(4);
+    m_doc->addFixture(fxi);
+
+    Scene* s = new Scene(m_doc);
+    s->setValue(fxi->id(), 0, 128);
+    m_doc->addFunction(s);
+
+    Scene* s2 = new Scene(m_doc);
+    m_doc->addFunction(s2);
+
+    EFX* e = new EFX(m_doc);
+    m_doc->addFunction(e);
+
+    QList <QByteArray> first;
+    m_doc->saveXMLFragments(first);
+    QCOMPARE(first.size(), 6);
+    QVERIFY(first.first().contains("<Engine>") == true);
+    QVERIFY(first.last().contains("</Engine>") == true);
+
+    /* The fragments must make up a loadable Engine element */
+    QByteArray joined;
+    foreach (QByteArray fragment, first)
+        joined.append(fragment);
+    QDomDocument parsed;
+    QVERIFY(parsed.setContent(joined) == true);
+    Doc loaded(this);
+    QVERIFY(loaded.loadXML(parsed.documentElement()) == true);
+    QCOMPARE(engineXML(&loaded), engineXML(m_doc));
+
+    /* Unchanged fixtures & scenes reuse their XML, EFX is saved anew */
+    QList <QByteArray> second;
+    m_doc->saveXMLFragments(second);
+    QCOMPARE(second, first);
+    QVERIFY(m_doc->m_fixtureXMLCache.contains(fxi->id()) == true);
+    QVERIFY(m_doc->m_functionXMLCache.contains(s->id()) == true);
+    QVERIFY(m_doc->m_functionXMLCache.contains(s2->id()) == true);
+    QVERIFY(m_doc->m_functionXMLCache.contains(e->id()) == false);
+    QByteArray cached(m_doc->m_functionXMLCache[s2->id()]);
+    QVERIFY(cached.constData() == m_doc->m_functionXMLCache[s2->id()].constData());
+
+    /* Changing an object drops only its own fragment */
+    s->setName("Changed");
+    QVERIFY(m_doc->m_functionXMLCache.contains(s->id()) == false);
+    QVERIFY(m_doc->m_functionXMLCache.contains(s2->id()) == true);
+    fxi->setName("Changed too");
+    QVERIFY(m_doc->m_fixtureXMLCache.contains(fxi->id()) == false);
+
+    QList <QByteArray> third;
+    m_doc->saveXMLFragments(third);
+    QCOMPARE(third.size(), 6);
+    QVERIFY(third != first);
+    QVERIFY(m_doc->m_functionXMLCache[s->id()].contains("Changed") == true);
+    QVERIFY(m_doc->m_fixtureXMLCache[fxi->id()].contains("Changed too") == true);
+    QVERIFY(m_doc->m_functionXMLCache[s2->id()].constData() == cached.constData());
+
+    /* Deleted objects are dropped from the cache */
+    QVERIFY(m_doc->deleteFunction(s2->id()) == true);
+    QVERIFY(m_doc->m_functionXMLCache.size() == 1);
+    m_doc->clearContents();
+    QVERIFY(m_doc->m_functionXMLCache.isEmpty() == true);
+    QVERIFY(m_doc->m_fixtureXMLCache.isEmpty() == true);
+}
+
+void Doc_Test::saveChangedChannels()
+{
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setChannels(4);
+    fxi->setAddress(10);
+    m_doc->addFixture(fxi);
+
+    QList <QByteArray> first;
+    m_doc->saveXMLFragments(first);
+    QVERIFY(m_doc->m_fixtureXMLCache[fxi->id()].contains("<Channels>4</Channels>") == true);
+
+    /* Same sequence as FixtureManager's generic dimmer edit */
+    fxi->setFixtureDefinition(NULL, NULL);
+    fxi->setChannels(6);
+    QVERIFY(m_doc->m_fixtureXMLCache.contains(fxi->id()) == false);
+    QCOMPARE(m_doc->addressInfo(15).fixture, fxi->id());
+    QCOMPARE(m_doc->addressInfo(15).channel, quint32(5));
+
+    QList <QByteArray> second;
+    m_doc->saveXMLFragments(second);
+    QVERIFY(second != first);
+    QVERIFY(m_doc->m_fixtureXMLCache[fxi->id()].contains("<Channels>6</Channels>") == true);
+    QVERIFY(m_doc->m_fixtureXMLCache[fxi->id()].contains("<Channels>4</Channels>") == false);
+
+    m_doc->clearContents();
+}
+
+QString Doc_Test::engineXML(Doc* doc)
+{
+    QDomDocument document;
+    QDomElement root = document.createElement("Workspace");
+    document.appendChild(root);
+    doc->saveXML(&document, &root);
+
+    QString str;
+    QTextStream stream(&str);
+    root.firstChildElement("Engine").save(stream, 1);
+    return str;
+}
+
 QDomElement Doc_Test::createFixtureNode(QDomDocument& doc, quint32 id)
 {
     QDomElement root = doc.createElement("Fixture");
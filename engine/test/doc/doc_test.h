@@ -42,6 +42,10 @@ private slots:
     void addFixture();
     void deleteFixture();
     void fixture();
+    void addressInfo();
+    void addressInfoOverlap();
+    void denseIds();
+    void patchSnapshot();
     void totalPowerConsumption();
 
     void addFixtureGroup();
@@ -51,11 +55,23 @@ private slots:
     void deleteFunction();
     void function();
 
+    void batch();
+    void batchNested();
+    void batchDeferred();
+
     void load();
     void loadWrongRoot();
+    void loadStream();
+    void loadStreamIdentical();
     void save();
+    void saveStream();
+    void saveFragments();
+    void saveChangedChannels();
 
 private:
+    /** Save $doc's Engine element thru DOM into a string */
+    QString engineXML(Doc* doc);
+
     QDomElement createFixtureNode(QDomDocument& doc, quint32 id);
     QDomElement createFixtureGroupNode(QDomDocument& doc, quint32 id);
     QDomElement createCollectionNode(QDomDocument& doc, quint32 id);
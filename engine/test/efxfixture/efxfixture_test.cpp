@@ -554,6 +554,40 @@ void EFXFixture_Test::start()
     e.postRun(&mts, &array);
 }
 
+void EFXFixture_Test::startDimmer()
+{
+    UniverseArray array(512 * 4);
+    MasterTimerStub mts(m_doc, array);
+
+    /* Generic dimmers have heads but no master intensity channel */
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setChannels(6);
+    fxi->setAddress(100);
+    m_doc->addFixture(fxi);
+    QCOMPARE(fxi->masterIntensityChannel(), QLCChannel::invalid());
+
+    EFX e(m_doc);
+    EFXFixture* ef = new EFXFixture(&e);
+    ef->setFixture(fxi->id());
+    e.addFixture(ef);
+
+    e.preRun(&mts);
+
+    ef->setFadeIntensity(255);
+    ef->start(&mts, &array);
+    QCOMPARE(e.m_fader->m_channels.size(), 0);
+
+    ef->stop(&mts, &array);
+    QCOMPARE(mts.fader()->m_channels.size(), 0);
+
+    /* Nothing gets written to the dimmer's channels */
+    ef->setPoint(&array, 100, 100);
+    for (quint32 i = 0; i < fxi->channels(); i++)
+        QCOMPARE(array.preGMValues().at(fxi->universeAddress() + i), char(0));
+
+    e.postRun(&mts, &array);
+}
+
 void EFXFixture_Test::stop()
 {
     UniverseArray array(512 * 4);
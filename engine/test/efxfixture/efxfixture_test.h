@@ -56,6 +56,7 @@ private slots:
     void nextStepSingleShot();
 
     void start();
+    void startDimmer();
     void stop();
 
 private:
@@ -399,6 +399,8 @@ void FixtureGroup_Test::resignFixture()
     QCOMPARE(grp.headList().size(), 15);
     QVERIFY(grp.headList().contains(13) == false);
     QVERIFY(grp.headHash().contains(QLCPoint(1, 3)) == false);
+    QVERIFY(grp.hasHead(QLCPoint(1, 3)) == false);
+    QVERIFY(grp.hasHead(QLCPoint(0, 3)) == true);
 
     // Remove a nonexistent fixture
     grp.resignFixture(42);
@@ -414,6 +416,7 @@ void FixtureGroup_Test::resignFixture()
     QCOMPARE(grp.headList().size(), 16);
     QVERIFY(grp.headList().contains(GroupHead(42, 0)) == true);
     QVERIFY(grp.headHash().contains(QLCPoint(1, 3)) == true);
+    QVERIFY(grp.hasHead(QLCPoint(1, 3)) == true);
     QCOMPARE(grp.headHash()[QLCPoint(1, 3)], GroupHead(42, 0));
 }
 
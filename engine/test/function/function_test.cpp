@@ -227,6 +227,58 @@ void Function_Test::adjustIntensity()
     QCOMPARE(stub->intensity(), qreal(1.0));
 }
 
+void Function_Test::publishedState()
+{
+    Doc doc(this);
+
+    Function_Stub* stub = new Function_Stub(&doc);
+    int state = stub->publishedState();
+    QCOMPARE(Function::stateRunning(state), false);
+    QCOMPARE(Function::stateFlashing(state), false);
+    QCOMPARE(Function::stateIntensity(state), uchar(255));
+    QCOMPARE(Function::stateRunCount(state), 0);
+
+    int serial = doc.functionStateSerial();
+    stub->adjustIntensity(0.5);
+    state = stub->publishedState();
+    QCOMPARE(Function::stateIntensity(state), uchar(128));
+    QVERIFY(doc.functionStateSerial() != serial);
+
+    // Publishing the same state again doesn't change the serial
+    serial = doc.functionStateSerial();
+    stub->adjustIntensity(0.5);
+    QCOMPARE(stub->publishedState(), state);
+    QCOMPARE(doc.functionStateSerial(), serial);
+
+    stub->flash(NULL);
+    state = stub->publishedState();
+    QCOMPARE(Function::stateFlashing(state), true);
+    QCOMPARE(Function::stateIntensity(state), uchar(128));
+    stub->unFlash(NULL);
+    QCOMPARE(Function::stateFlashing(stub->publishedState()), false);
+
+    stub->preRun(NULL);
+    state = stub->publishedState();
+    QCOMPARE(Function::stateRunning(state), true);
+    QCOMPARE(Function::stateRunCount(state), 1);
+
+    // postRun() resets intensity
+    stub->postRun(NULL, NULL);
+    state = stub->publishedState();
+    QCOMPARE(Function::stateRunning(state), false);
+    QCOMPARE(Function::stateIntensity(state), uchar(255));
+    QCOMPARE(Function::stateRunCount(state), 1);
+
+    // A stop & start between two reads is visible from the run count
+    int before = stub->publishedState();
+    stub->preRun(NULL);
+    stub->postRun(NULL, NULL);
+    state = stub->publishedState();
+    QVERIFY(state != before);
+    QCOMPARE(Function::stateRunning(state), false);
+    QCOMPARE(Function::stateRunCount(state), 2);
+}
+
 void Function_Test::slotFixtureRemoved()
 {
     Doc doc(this);
@@ -39,6 +39,7 @@ private slots:
     void stopAndWait();
     void stopAndWaitFail();
     void adjustIntensity();
+    void publishedState();
     void slotFixtureRemoved();
     void invalidId();
     void typeString();
@@ -0,0 +1,19 @@
+include(../../../variables.pri)
+include(../../../coverage.pri)
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = inputlatency_test
+
+QT      += testlib xml script
+CONFIG  -= app_bundle
+
+DEPENDPATH   += ../../src
+INCLUDEPATH  += ../../../plugins/interfaces
+INCLUDEPATH  += ../../src
+INCLUDEPATH  += ../inputpluginstub
+INCLUDEPATH  += ../outputpluginstub
+QMAKE_LIBDIR += ../../src
+LIBS         += -lqlcengine
+
+SOURCES += inputlatency_test.cpp
+HEADERS += inputlatency_test.h
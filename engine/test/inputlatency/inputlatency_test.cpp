@@ -0,0 +1,222 @@
+/*
+  Q Light Controller - Unit test
+  inputlatency_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QMutexLocker>
+#include <QMutex>
+#include <QtTest>
+
+#include "inputlatency_test.h"
+#include "outputpluginstub.h"
+#include "inputpluginstub.h"
+#include "universearray.h"
+#include "inputlistener.h"
+#include "latencyprobe.h"
+#include "mastertimer.h"
+#include "dmxsource.h"
+#include "qlcfile.h"
+
+#define protected public
+#include "outputmap.h"
+#include "inputmap.h"
+#include "doc.h"
+#undef protected
+
+#define INPUT_TESTPLUGINDIR "../inputpluginstub"
+#define OUTPUT_TESTPLUGINDIR "../outputpluginstub"
+
+/** Number of input values injected in inputToOutput() */
+#define KSampleCount 100
+
+/** Maximum time to wait for a single value to reach the output */
+#define KValueTimeout 1000
+
+static QDir pluginDir(const QString& path)
+{
+    QDir dir(path);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtPlugin));
+    return dir;
+}
+
+/****************************************************************************
+ * Fader stub
+ ****************************************************************************/
+
+/**
+ * Does what a VC slider does: listens to an input channel and writes the
+ * latest value to a DMX channel on each MasterTimer tick.
+ */
+class FaderStub : public InputListener, public DMXSource
+{
+public:
+    FaderStub() : m_value(0) { }
+
+    void inputValueChanged(quint32 universe, quint32 channel, uchar value)
+    {
+        Q_UNUSED(universe);
+        Q_UNUSED(channel);
+        QMutexLocker locker(&m_mutex);
+        m_value = value;
+    }
+
+    void writeDMX(MasterTimer* timer, UniverseArray* universes)
+    {
+        Q_UNUSED(timer);
+        QMutexLocker locker(&m_mutex);
+        universes->write(0, m_value, QLCChannel::Intensity);
+    }
+
+private:
+    QMutex m_mutex;
+    uchar m_value;
+};
+
+/****************************************************************************
+ * Tests
+ ****************************************************************************/
+
+void InputLatency_Test::initTestCase()
+{
+    m_doc = NULL;
+    m_inputStub = NULL;
+    m_outputStub = NULL;
+}
+
+void InputLatency_Test::init()
+{
+    m_doc = new Doc(this);
+    m_doc->setKiosk(true);
+
+    m_doc->inputMap()->loadPlugins(pluginDir(INPUT_TESTPLUGINDIR));
+    QVERIFY(m_doc->inputMap()->pluginNames().size() == 1);
+    m_inputStub = static_cast<InputPluginStub*> (m_doc->inputMap()->m_plugins.at(0));
+    QVERIFY(m_doc->inputMap()->setPatch(0, m_inputStub->name(), 0, false) == true);
+
+    m_doc->outputMap()->loadPlugins(pluginDir(OUTPUT_TESTPLUGINDIR));
+    QVERIFY(m_doc->outputMap()->pluginNames().size() == 1);
+    m_outputStub = static_cast<OutputPluginStub*> (m_doc->outputMap()->m_plugins.at(0));
+    QVERIFY(m_doc->outputMap()->setPatch(0, m_outputStub->name(), 0) == true);
+}
+
+void InputLatency_Test::cleanup()
+{
+    LatencyProbe::setEnabled(false);
+
+    delete m_doc;
+    m_doc = NULL;
+    m_inputStub = NULL;
+    m_outputStub = NULL;
+}
+
+void InputLatency_Test::probeDisabled()
+{
+    QVERIFY(LatencyProbe::isEnabled() == false);
+
+    LatencyProbe::mark(LatencyProbe::InputReceived);
+    LatencyProbe::mark(LatencyProbe::InputHandled);
+    LatencyProbe::mark(LatencyProbe::SourceWritten);
+    LatencyProbe::mark(LatencyProbe::OutputDispatched);
+    QCOMPARE(LatencyProbe::samples().size(), 0);
+    QCOMPARE(LatencyProbe::percentile(LatencyProbe::OutputDispatched, 50), qint64(-1));
+}
+
+void InputLatency_Test::probeStageOrder()
+{
+    LatencyProbe::setEnabled(true);
+
+    /* Stages without a preceding stage are ignored */
+    LatencyProbe::mark(LatencyProbe::OutputDispatched);
+    LatencyProbe::mark(LatencyProbe::InputHandled);
+    QCOMPARE(LatencyProbe::samples().size(), 0);
+
+    LatencyProbe::mark(LatencyProbe::InputReceived);
+    LatencyProbe::mark(LatencyProbe::SourceWritten);
+    LatencyProbe::mark(LatencyProbe::OutputDispatched);
+    QCOMPARE(LatencyProbe::samples().size(), 0);
+
+    /* A second input while one is in flight doesn't restart the sample */
+    LatencyProbe::mark(LatencyProbe::InputReceived);
+    LatencyProbe::mark(LatencyProbe::InputHandled);
+    LatencyProbe::mark(LatencyProbe::SourceWritten);
+    LatencyProbe::mark(LatencyProbe::OutputDispatched);
+    QCOMPARE(LatencyProbe::samples().size(), 1);
+
+    LatencyProbe::Sample sample = LatencyProbe::samples().at(0);
+    QCOMPARE(sample.msecs[LatencyProbe::InputReceived], qint64(0));
+    QVERIFY(sample.msecs[LatencyProbe::InputHandled] >= 0);
+    QVERIFY(sample.msecs[LatencyProbe::SourceWritten] >= sample.msecs[LatencyProbe::InputHandled]);
+    QVERIFY(sample.msecs[LatencyProbe::OutputDispatched] >= sample.msecs[LatencyProbe::SourceWritten]);
+
+    LatencyProbe::clear();
+    QCOMPARE(LatencyProbe::samples().size(), 0);
+}
+
+void InputLatency_Test::inputToOutput()
+{
+    FaderStub fader;
+    m_doc->inputMap()->registerListener(&fader, 0, 0);
+    m_doc->masterTimer()->registerDMXSource(&fader);
+    m_doc->masterTimer()->start();
+
+    LatencyProbe::setEnabled(true);
+
+    for (int i = 0; i < KSampleCount; i++)
+    {
+        uchar value = (i % UCHAR_MAX) + 1;
+
+        /* Inject the value and let the event loop run until it has
+           reached the output plugin */
+        m_inputStub->emitValueChanged(0, 0, value);
+
+        QTime time;
+        time.start();
+        while (LatencyProbe::samples().size() <= i && time.elapsed() < KValueTimeout)
+            QTest::qWait(0);
+        while (uchar(m_outputStub->m_array.at(0)) != value && time.elapsed() < KValueTimeout)
+            QTest::qWait(0);
+
+        QCOMPARE(uchar(m_outputStub->m_array.at(0)), value);
+    }
+
+    m_doc->masterTimer()->unregisterDMXSource(&fader);
+    m_doc->inputMap()->unregisterListener(&fader, 0, 0);
+
+    QList <LatencyProbe::Sample> samples(LatencyProbe::samples());
+    QCOMPARE(samples.size(), KSampleCount);
+    foreach (const LatencyProbe::Sample& sample, samples)
+    {
+        QCOMPARE(sample.msecs[LatencyProbe::InputReceived], qint64(0));
+        for (int i = LatencyProbe::InputHandled; i < LatencyProbe::StageCount; i++)
+            QVERIFY(sample.msecs[i] >= sample.msecs[i - 1]);
+    }
+
+    /* Print the distribution so that the test can be used to catch
+       latency regressions. The figures depend on the machine's load, so
+       they're only reported, not asserted. */
+    foreach (QString line, LatencyProbe::summary().split("\n", QString::SkipEmptyParts))
+        qDebug() << "LATENCY" << qPrintable(line);
+
+    QVERIFY(LatencyProbe::percentile(LatencyProbe::OutputDispatched, 0) >= 0);
+    QVERIFY(LatencyProbe::percentile(LatencyProbe::OutputDispatched, 50) <=
+            LatencyProbe::percentile(LatencyProbe::OutputDispatched, 100));
+}
+
+QTEST_MAIN(InputLatency_Test)
@@ -24,6 +24,7 @@
 
 #include "inputpluginstub.h"
 #include "inputmap_test.h"
+#include "inputlistener.h"
 #include "qlcinputsource.h"
 #include "qlcconfig.h"
 #include "qlcfile.h"
@@ -386,6 +387,10 @@ void InputMap_Test::slotValueChanged()
 
     QSignalSpy spy(&im, SIGNAL(inputValueChanged(quint32, quint32, uchar)));
     stub->emitValueChanged(0, 15, UCHAR_MAX);
+    QVERIFY(spy.size() == 0);
+    QVERIFY(im.m_flushScheduled == true);
+    im.flushValues();
+    QVERIFY(im.m_flushScheduled == false);
     QVERIFY(spy.size() == 1);
     QVERIFY(spy.at(0).at(0) == 0);
     QVERIFY(spy.at(0).at(1) == 15);
@@ -393,6 +398,7 @@ void InputMap_Test::slotValueChanged()
 
     /* Invalid mapping for this plugin -> no signal */
     stub->emitValueChanged(3, 15, UCHAR_MAX);
+    im.flushValues();
     QVERIFY(spy.size() == 1);
     QVERIFY(spy.at(0).at(0) == 0);
     QVERIFY(spy.at(0).at(1) == 15);
@@ -400,12 +406,14 @@ void InputMap_Test::slotValueChanged()
 
     /* Invalid mapping for this plugin -> no signal */
     stub->emitValueChanged(1, 15, UCHAR_MAX);
+    im.flushValues();
     QVERIFY(spy.size() == 1);
     QVERIFY(spy.at(0).at(0) == 0);
     QVERIFY(spy.at(0).at(1) == 15);
     QVERIFY(spy.at(0).at(2) == UCHAR_MAX);
 
     stub->emitValueChanged(0, 5, 127);
+    im.flushValues();
     QVERIFY(spy.size() == 2);
     QVERIFY(spy.at(0).at(0) == 0);
     QVERIFY(spy.at(0).at(1) == 15);
@@ -415,6 +423,107 @@ void InputMap_Test::slotValueChanged()
     QVERIFY(spy.at(1).at(2) == 127);
 }
 
+void InputMap_Test::coalesceValues()
+{
+    InputMap im(this, 4);
+
+    im.loadPlugins(testPluginDir());
+    QVERIFY(im.m_plugins.size() > 0);
+    InputPluginStub* stub = static_cast<InputPluginStub*> (im.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    QVERIFY(im.setPatch(1, stub->name(), 0, false) == true);
+
+    QSignalSpy spy(&im, SIGNAL(inputValueChanged(quint32, quint32, uchar)));
+
+    /* Only the latest non-zero value is delivered per channel, in the
+       order the channels first changed */
+    stub->emitValueChanged(0, 7, 10);
+    stub->emitValueChanged(0, 3, 1);
+    stub->emitValueChanged(0, 7, 20);
+    stub->emitValueChanged(0, 7, 30);
+    QCOMPARE(im.m_queuedValues.size(), 2);
+    im.flushValues();
+    QCOMPARE(spy.size(), 2);
+    QVERIFY(spy.at(0).at(0) == 1);
+    QVERIFY(spy.at(0).at(1) == 7);
+    QVERIFY(spy.at(0).at(2) == 30);
+    QVERIFY(spy.at(1).at(0) == 1);
+    QVERIFY(spy.at(1).at(1) == 3);
+    QVERIFY(spy.at(1).at(2) == 1);
+    QCOMPARE(im.m_queuedValues.size(), 0);
+
+    /* Zero transitions (button press & release) are never coalesced */
+    spy.clear();
+    stub->emitValueChanged(0, 9, UCHAR_MAX);
+    stub->emitValueChanged(0, 9, 0);
+    stub->emitValueChanged(0, 9, UCHAR_MAX);
+    im.flushValues();
+    QCOMPARE(spy.size(), 3);
+    QVERIFY(spy.at(0).at(2) == UCHAR_MAX);
+    QVERIFY(spy.at(1).at(2) == 0);
+    QVERIFY(spy.at(2).at(2) == UCHAR_MAX);
+}
+
+class InputListenerStub : public InputListener
+{
+public:
+    void inputValueChanged(quint32 universe, quint32 channel, uchar value)
+    {
+        m_values << QLCInputSource(universe, channel);
+        m_lastValue = value;
+    }
+
+    QList <QLCInputSource> m_values;
+    uchar m_lastValue;
+};
+
+void InputMap_Test::listeners()
+{
+    InputMap im(this, 4);
+
+    im.loadPlugins(testPluginDir());
+    QVERIFY(im.m_plugins.size() > 0);
+    InputPluginStub* stub = static_cast<InputPluginStub*> (im.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    QVERIFY(im.setPatch(2, stub->name(), 0, false) == true);
+
+    InputListenerStub l1, l2;
+    im.registerListener(&l1, 2, 5);
+    im.registerListener(&l2, 2, 5);
+    im.registerListener(&l2, 2, 6);
+    QCOMPARE(im.m_listeners.size(), 2);
+
+    stub->emitValueChanged(0, 5, 42);
+    stub->emitValueChanged(0, 6, 43);
+    stub->emitValueChanged(0, 7, 44);
+    im.flushValues();
+
+    QCOMPARE(l1.m_values.size(), 1);
+    QVERIFY(l1.m_values.at(0) == QLCInputSource(2, 5));
+    QCOMPARE(l1.m_lastValue, uchar(42));
+    QCOMPARE(l2.m_values.size(), 2);
+    QVERIFY(l2.m_values.at(0) == QLCInputSource(2, 5));
+    QVERIFY(l2.m_values.at(1) == QLCInputSource(2, 6));
+    QCOMPARE(l2.m_lastValue, uchar(43));
+
+    im.unregisterListener(&l2, 2, 5);
+    im.unregisterListener(&l2, 2, 6);
+    QCOMPARE(im.m_listeners.size(), 1);
+    im.unregisterListener(&l2, 3, 3); // Not registered, just a crash test
+
+    stub->emitValueChanged(0, 5, 1);
+    stub->emitValueChanged(0, 6, 2);
+    im.flushValues();
+    QCOMPARE(l1.m_values.size(), 2);
+    QCOMPARE(l1.m_lastValue, uchar(1));
+    QCOMPARE(l2.m_values.size(), 2);
+
+    im.unregisterListener(&l1, 2, 5);
+    QCOMPARE(im.m_listeners.size(), 0);
+}
+
 void InputMap_Test::slotConfigurationChanged()
 {
     InputMap im(this, 4);
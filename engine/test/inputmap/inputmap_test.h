@@ -41,6 +41,8 @@ private slots:
     void setPatch();
     void feedBack();
     void slotValueChanged();
+    void coalesceValues();
+    void listeners();
     void slotConfigurationChanged();
     void loadInputProfiles();
     void inputSourceNames();
@@ -0,0 +1,203 @@
+/*
+  Q Light Controller - Unit test
+  ioreactor_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QByteArray>
+#include <QMutex>
+#include <QtTest>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "ioreactor_test.h"
+#include "ioreactor.h"
+
+/****************************************************************************
+ * Handler stub
+ ****************************************************************************/
+
+class IOHandlerStub : public QLCIOHandler
+{
+public:
+    IOHandlerStub(bool drain, bool alive = true)
+        : m_drain(drain), m_alive(alive), m_calls(0) { }
+
+    bool readyRead(int fd)
+    {
+        char buf[64];
+        int r;
+
+        QMutexLocker locker(&m_mutex);
+        m_calls++;
+
+        do
+        {
+            r = ::read(fd, buf, m_drain ? sizeof(buf) : 1);
+            if (r > 0)
+                m_data.append(buf, r);
+        } while (m_drain == true && r > 0);
+
+        return m_alive;
+    }
+
+    int calls()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_calls;
+    }
+
+    QByteArray data()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_data;
+    }
+
+    /** Wait until at least $count bytes have been read or $ms passes */
+    bool waitData(int count, int ms = 2000)
+    {
+        QTime time;
+        time.start();
+        while (data().size() < count && time.elapsed() < ms)
+            QTest::qSleep(5);
+        return (data().size() >= count);
+    }
+
+private:
+    bool m_drain;
+    bool m_alive;
+    int m_calls;
+    QByteArray m_data;
+    QMutex m_mutex;
+};
+
+/****************************************************************************
+ * IOReactor tests
+ ****************************************************************************/
+
+void IOReactor_Test::init()
+{
+    QVERIFY(pipe(m_pipe) == 0);
+    fcntl(m_pipe[0], F_SETFL, fcntl(m_pipe[0], F_GETFL) | O_NONBLOCK);
+}
+
+void IOReactor_Test::cleanup()
+{
+    ::close(m_pipe[0]);
+    ::close(m_pipe[1]);
+}
+
+void IOReactor_Test::addRemove()
+{
+    IOHandlerStub handler(true);
+    IOReactor reactor(this);
+
+    QCOMPARE(reactor.handleCount(), 0);
+    QVERIFY(reactor.isRunning() == false);
+
+    QVERIFY(reactor.addHandle(-1, &handler) == false);
+    QCOMPARE(reactor.handleCount(), 0);
+
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler) == true);
+    QCOMPARE(reactor.handleCount(), 1);
+    QVERIFY(reactor.isRunning() == true);
+
+    /* Same fd can't be watched twice */
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler) == false);
+    QCOMPARE(reactor.handleCount(), 1);
+
+    QVERIFY(reactor.removeHandle(m_pipe[0]) == true);
+    QCOMPARE(reactor.handleCount(), 0);
+    QVERIFY(reactor.removeHandle(m_pipe[0]) == false);
+
+    reactor.stop();
+    QVERIFY(reactor.isRunning() == false);
+
+    /* The thread is restarted when needed */
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler) == true);
+    QVERIFY(reactor.isRunning() == true);
+}
+
+void IOReactor_Test::readEdgeTriggered()
+{
+    IOHandlerStub handler(true);
+    IOReactor reactor(this);
+
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler, true) == true);
+
+    QCOMPARE(::write(m_pipe[1], "abc", 3), ssize_t(3));
+    QVERIFY(handler.waitData(3) == true);
+    QCOMPARE(handler.data(), QByteArray("abc"));
+
+    QCOMPARE(::write(m_pipe[1], "de", 2), ssize_t(2));
+    QVERIFY(handler.waitData(5) == true);
+    QCOMPARE(handler.data(), QByteArray("abcde"));
+}
+
+void IOReactor_Test::readLevelTriggered()
+{
+    /* A handler that reads only one byte per call gets called until
+       everything has been read */
+    IOHandlerStub handler(false);
+    IOReactor reactor(this);
+
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler, false) == true);
+
+    QCOMPARE(::write(m_pipe[1], "abcd", 4), ssize_t(4));
+    QVERIFY(handler.waitData(4) == true);
+    QCOMPARE(handler.data(), QByteArray("abcd"));
+    QVERIFY(handler.calls() >= 4);
+}
+
+void IOReactor_Test::removedNotCalled()
+{
+    IOHandlerStub handler(true);
+    IOReactor reactor(this);
+
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler) == true);
+    QCOMPARE(::write(m_pipe[1], "a", 1), ssize_t(1));
+    QVERIFY(handler.waitData(1) == true);
+    int calls = handler.calls();
+
+    QVERIFY(reactor.removeHandle(m_pipe[0]) == true);
+    QCOMPARE(::write(m_pipe[1], "b", 1), ssize_t(1));
+    QVERIFY(handler.waitData(2, 100) == false);
+    QCOMPARE(handler.calls(), calls);
+}
+
+void IOReactor_Test::deadHandle()
+{
+    IOHandlerStub handler(true, false);
+    IOReactor reactor(this);
+
+    QVERIFY(reactor.addHandle(m_pipe[0], &handler) == true);
+    QCOMPARE(::write(m_pipe[1], "a", 1), ssize_t(1));
+    QVERIFY(handler.waitData(1) == true);
+
+    /* Handler returned false so the reactor has dropped the fd */
+    QTime time;
+    time.start();
+    while (reactor.handleCount() != 0 && time.elapsed() < 2000)
+        QTest::qSleep(5);
+    QCOMPARE(reactor.handleCount(), 0);
+    QVERIFY(reactor.removeHandle(m_pipe[0]) == false);
+}
+
+QTEST_APPLESS_MAIN(IOReactor_Test)
@@ -1,6 +1,6 @@
 /*
-  Q Light Controller
-  rgbitem.h
+  Q Light Controller - Unit test
+  ioreactor_test.h
 
   Copyright (c) Heikki Junnila
 
@@ -19,27 +19,27 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#ifndef RGBITEM_H
-#define RGBITEM_H
+#ifndef IOREACTOR_TEST_H
+#define IOREACTOR_TEST_H
 
-#include <QGraphicsEllipseItem>
-#include <QColor>
+#include <QObject>
 
-class RGBItem : public QGraphicsEllipseItem
+class IOReactor_Test : public QObject
 {
-public:
-    RGBItem(QGraphicsItem* parent = 0);
-    ~RGBItem();
+    Q_OBJECT
 
-    void setColor(QRgb rgb);
-    QRgb color() const;
+private slots:
+    void init();
+    void cleanup();
 
-    void draw(uint ms);
+    void addRemove();
+    void readEdgeTriggered();
+    void readLevelTriggered();
+    void removedNotCalled();
+    void deadHandle();
 
 private:
-    QColor m_color;
-    QColor m_oldColor;
-    uint m_elapsed;
+    int m_pipe[2];
 };
 
 #endif
@@ -0,0 +1,10 @@
+#!/bin/sh
+
+# IOReactor is built only on Linux
+if [ `uname` = "Darwin" ]; then
+    exit 0
+fi
+
+export LD_LIBRARY_PATH=../../src
+export DYLD_FALLBACK_LIBRARY_PATH=../../src
+./ioreactor_test
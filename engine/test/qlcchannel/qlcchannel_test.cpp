@@ -189,6 +189,49 @@ void QLCChannel_Test::searchCapabilityByName()
     delete channel;
 }
 
+void QLCChannel_Test::capabilityIndex()
+{
+    QLCChannel* channel = new QLCChannel();
+    QVERIFY(channel->searchCapability(0) == NULL);
+    QVERIFY(channel->searchCapability(255) == NULL);
+
+    /* Adding invalidates the index that was built above */
+    QLCCapability* cap1 = new QLCCapability(0, 127, "Low");
+    QVERIFY(channel->addCapability(cap1) == true);
+    QVERIFY(channel->searchCapability(0) == cap1);
+    QVERIFY(channel->searchCapability(127) == cap1);
+    QVERIFY(channel->searchCapability(128) == NULL);
+    QVERIFY(channel->searchCapability("Low") == cap1);
+
+    QLCCapability* cap2 = new QLCCapability(128, 255, "High");
+    QVERIFY(channel->addCapability(cap2) == true);
+    QVERIFY(channel->searchCapability(128) == cap2);
+    QVERIFY(channel->searchCapability(255) == cap2);
+    QVERIFY(channel->searchCapability("High") == cap2);
+    QVERIFY(channel->searchCapability("Hi", false) == cap2);
+    QVERIFY(channel->searchCapability("Hi") == NULL);
+
+    /* Modifying a capability directly needs an explicit invalidation */
+    cap1->setName("Lower");
+    channel->invalidateCapabilityIndex();
+    QVERIFY(channel->searchCapability("Low") == NULL);
+    QVERIFY(channel->searchCapability("Lower") == cap1);
+
+    /* Removing invalidates the index */
+    QVERIFY(channel->removeCapability(cap2) == true);
+    QVERIFY(channel->searchCapability(200) == NULL);
+    QVERIFY(channel->searchCapability("High") == NULL);
+    QVERIFY(channel->searchCapability(100) == cap1);
+
+    /* A copy has an index of its own */
+    QLCChannel copy(channel);
+    QVERIFY(copy.searchCapability(100) != NULL);
+    QVERIFY(copy.searchCapability(100) != cap1);
+    QCOMPARE(copy.searchCapability(100)->name(), QString("Lower"));
+
+    delete channel;
+}
+
 void QLCChannel_Test::addCapability()
 {
     QLCChannel* channel = new QLCChannel();
@@ -37,6 +37,7 @@ private slots:
     void colour();
     void searchCapabilityByValue();
     void searchCapabilityByName();
+    void capabilityIndex();
     void addCapability();
     void removeCapability();
     void sortCapabilities();
@@ -0,0 +1,133 @@
+/*
+  Q Light Controller - Unit tests
+  qlcfilewriter_test.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QSignalSpy>
+#include <QtTest>
+#include <QFile>
+
+#include "qlcfilewriter_test.h"
+#include "qlcfilewriter.h"
+
+#define TEST_FILE "qlcfilewriter_test.txt"
+#define TEMP_FILE "qlcfilewriter_test.txt.tmp"
+
+void QLCFileWriter_Test::init()
+{
+    QFile::remove(TEST_FILE);
+    QFile::remove(TEMP_FILE);
+}
+
+void QLCFileWriter_Test::cleanup()
+{
+    QFile::remove(TEST_FILE);
+    QFile::remove(TEMP_FILE);
+}
+
+void QLCFileWriter_Test::writeFile()
+{
+    QList <QByteArray> data;
+    data << QByteArray("<Foo>") << QByteArray() << QByteArray("<Bar/></Foo>\n");
+
+    QCOMPARE(QLCFileWriter::writeFile(TEST_FILE, data), QFile::NoError);
+    QCOMPARE(readFile(TEST_FILE), QString("<Foo><Bar/></Foo>\n"));
+    QVERIFY(QFile::exists(TEMP_FILE) == false);
+
+    /* Empty data makes an empty file */
+    QCOMPARE(QLCFileWriter::writeFile(TEST_FILE, QList <QByteArray> ()), QFile::NoError);
+    QVERIFY(QFile::exists(TEST_FILE) == true);
+    QCOMPARE(readFile(TEST_FILE), QString());
+}
+
+void QLCFileWriter_Test::replaceFile()
+{
+    QFile file(TEST_FILE);
+    QVERIFY(file.open(QIODevice::WriteOnly) == true);
+    file.write("This is a much longer original content that must be gone");
+    file.close();
+
+    QList <QByteArray> data;
+    data << QByteArray("New");
+    QCOMPARE(QLCFileWriter::writeFile(TEST_FILE, data), QFile::NoError);
+    QCOMPARE(readFile(TEST_FILE), QString("New"));
+    QVERIFY(QFile::exists(TEMP_FILE) == false);
+}
+
+void QLCFileWriter_Test::writeFileError()
+{
+    QList <QByteArray> data;
+    data << QByteArray("Foo");
+
+    QString path("no/such/directory/" TEST_FILE);
+    QVERIFY(QLCFileWriter::writeFile(path, data) != QFile::NoError);
+    QVERIFY(QFile::exists(path) == false);
+    QVERIFY(QFile::exists(path + ".tmp") == false);
+}
+
+void QLCFileWriter_Test::write()
+{
+    QLCFileWriter writer;
+    QSignalSpy spy(&writer, SIGNAL(written(const QString&,QFile::FileError)));
+
+    /* Files are written in the order they were queued */
+    for (int i = 0; i < 10; i++)
+    {
+        QList <QByteArray> data;
+        data << QByteArray::number(i);
+        writer.write(TEST_FILE, data);
+    }
+
+    writer.waitForWritten();
+    QCOMPARE(readFile(TEST_FILE), QString("9"));
+
+    /* written() is delivered thru the event loop */
+    QTest::qWait(100);
+    QCOMPARE(spy.size(), 10);
+    QCOMPARE(spy.at(0).at(0).toString(), QString(TEST_FILE));
+
+    /* Writing after the thread has finished starts it again */
+    QList <QByteArray> data;
+    data << QByteArray("Again");
+    writer.write(TEST_FILE, data);
+    writer.waitForWritten();
+    QCOMPARE(readFile(TEST_FILE), QString("Again"));
+    QCOMPARE(writer.lastError(TEST_FILE), QFile::NoError);
+
+    /* The result is available without the event loop */
+    writer.write("no/such/directory/" TEST_FILE, data);
+    writer.waitForWritten();
+    QVERIFY(writer.lastError("no/such/directory/" TEST_FILE) != QFile::NoError);
+    QCOMPARE(writer.lastError(TEST_FILE), QFile::NoError);
+    QCOMPARE(writer.lastError("never/written"), QFile::NoError);
+    QTest::qWait(100);
+    QCOMPARE(spy.size(), 12);
+    QVERIFY(spy.last().at(1).value <QFile::FileError> () != QFile::NoError);
+}
+
+QString QLCFileWriter_Test::readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly) == false)
+        return QString("File not found");
+    else
+        return QString(file.readAll());
+}
+
+QTEST_MAIN(QLCFileWriter_Test)
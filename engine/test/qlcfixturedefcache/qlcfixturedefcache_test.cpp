@@ -32,6 +32,7 @@
 #include "qlcfile.h"
 
 #define INTERNAL_FIXTUREDIR "../../../fixtures/"
+#define INDEX_FILE "qlcfixturedefcache_test.index"
 
 void QLCFixtureDefCache_Test::init()
 {
@@ -50,12 +51,12 @@ void QLCFixtureDefCache_Test::cleanup()
 void QLCFixtureDefCache_Test::duplicates()
 {
     // Check that duplicates are discarded
-    int num = cache.m_defs.size();
+    int num = count();
     QDir dir(INTERNAL_FIXTUREDIR);
     dir.setFilter(QDir::Files);
     dir.setNameFilters(QStringList() << QString("*%1").arg(KExtFixture));
     cache.load(dir);
-    QCOMPARE(cache.m_defs.size(), num);
+    QCOMPARE(count(), num);
 }
 
 void QLCFixtureDefCache_Test::add()
@@ -181,6 +182,98 @@ void QLCFixtureDefCache_Test::load()
     QVERIFY(cache.manufacturers().contains("SGM") == true);
 }
 
+void QLCFixtureDefCache_Test::lazy()
+{
+    /* Nothing is parsed before it's used */
+    QVERIFY(cache.m_models.contains("Martin") == true);
+    QVERIFY(cache.m_models["Martin"].contains("MAC300") == true);
+    QVERIFY(cache.m_models["Martin"]["MAC300"].def == NULL);
+    QVERIFY(cache.m_models["Martin"]["MAC300"].path.isEmpty() == false);
+
+    const QLCFixtureDef* def = cache.fixtureDef("Martin", "MAC300");
+    QVERIFY(def != NULL);
+    QCOMPARE(def->manufacturer(), QString("Martin"));
+    QCOMPARE(def->model(), QString("MAC300"));
+    QVERIFY(def->channels().size() > 0);
+    QVERIFY(cache.m_models["Martin"]["MAC300"].path.isEmpty() == true);
+    QVERIFY(cache.fixtureDef("Martin", "MAC300") == def);
+
+    /* Others are still unparsed */
+    QVERIFY(cache.m_models["Martin"]["MAC500"].def == NULL);
+}
+
+void QLCFixtureDefCache_Test::index()
+{
+    QDir dir(INTERNAL_FIXTUREDIR);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtFixture));
+
+    QFile::remove(INDEX_FILE);
+    QVERIFY(cache.loadIndex(INDEX_FILE) == false);
+    QVERIFY(cache.m_dirIndex.contains(dir.absolutePath()) == true);
+    QVERIFY(cache.m_indexModified == true);
+    QVERIFY(cache.saveIndex(INDEX_FILE) == true);
+    QVERIFY(cache.m_indexModified == false);
+
+    /* A fresh cache gets the same models from the index */
+    QLCFixtureDefCache other;
+    QVERIFY(other.loadIndex(INDEX_FILE) == true);
+    QCOMPARE(other.m_dirIndex.size(), cache.m_dirIndex.size());
+    QVERIFY(other.load(dir) == true);
+    QCOMPARE(other.manufacturers().size(), cache.manufacturers().size());
+    QCOMPARE(other.models("Martin").size(), cache.models("Martin").size());
+    QVERIFY(other.fixtureDef("Martin", "MAC300") != NULL);
+
+    /* Different name filters make the directory to be read again */
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtFixture) << "*.d4");
+    other.m_indexModified = false;
+    QVERIFY(other.load(dir) == true);
+    QVERIFY(other.m_indexModified == true);
+
+    /* A definition that has changed since indexing invalidates the index,
+       which is saved again right away */
+    QVERIFY(cache.m_indexPath == QString(INDEX_FILE));
+    cache.invalidateIndex(dir.absoluteFilePath("Martin-MAC300.qxf"));
+    QVERIFY(cache.m_indexModified == false);
+    QLCFixtureDefCache stale;
+    QVERIFY(stale.loadIndex(INDEX_FILE) == true);
+    QCOMPARE(stale.m_dirIndex[dir.absolutePath()].modified, uint(0));
+
+    /* Garbage isn't accepted as an index */
+    QFile file(INDEX_FILE);
+    QVERIFY(file.open(QIODevice::WriteOnly) == true);
+    file.write("<FixtureDefinition/>");
+    file.close();
+    QVERIFY(other.loadIndex(INDEX_FILE) == false);
+    QVERIFY(other.m_dirIndex.isEmpty() == false);
+
+    QFile::remove(INDEX_FILE);
+}
+
+void QLCFixtureDefCache_Test::scanFile()
+{
+    QString manufacturer;
+    QString model;
+    QVERIFY(QLCFixtureDefCache::scanFile(INTERNAL_FIXTUREDIR "Martin-MAC300.qxf",
+                                         &manufacturer, &model) == true);
+    QCOMPARE(manufacturer, QString("Martin"));
+    QCOMPARE(model, QString("MAC300"));
+
+    QVERIFY(QLCFixtureDefCache::scanFile(INTERNAL_FIXTUREDIR "foobar.qxf",
+                                         &manufacturer, &model) == false);
+    QVERIFY(QLCFixtureDefCache::scanFile("qlcfixturedefcache_test.cpp",
+                                         &manufacturer, &model) == false);
+}
+
+int QLCFixtureDefCache_Test::count() const
+{
+    int num = 0;
+    QStringListIterator it(cache.manufacturers());
+    while (it.hasNext() == true)
+        num += cache.models(it.next()).size();
+    return num;
+}
+
 void QLCFixtureDefCache_Test::defDirectories()
 {
     QDir dir = QLCFixtureDefCache::systemDefinitionDirectory();
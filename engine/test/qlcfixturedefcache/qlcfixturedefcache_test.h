@@ -37,8 +37,14 @@ private slots:
     void add();
     void fixtureDef();
 	void load();
+    void lazy();
+    void index();
+    void scanFile();
     void defDirectories();
 
+private:
+    int count() const;
+
 private:
     QLCFixtureDefCache cache;
 };
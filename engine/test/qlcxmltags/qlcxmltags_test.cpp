@@ -0,0 +1,87 @@
+/*
+  Q Light Controller - Unit tests
+  qlcxmltags_test.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QXmlStreamReader>
+#include <QtTest>
+
+#include "qlcxmltags_test.h"
+#include "qlcxmltags.h"
+
+void QLCXMLTags_Test::ids()
+{
+    QStringList names;
+    for (int i = 0; i < 50; i++)
+        names << QString("Tag%1").arg(i);
+
+    QLCXMLTags tags(names);
+    QCOMPARE(tags.count(), 50);
+
+    for (int i = 0; i < names.size(); i++)
+    {
+        QString name(names.at(i));
+        QCOMPARE(tags.id(QStringRef(&name)), i);
+    }
+}
+
+void QLCXMLTags_Test::unknown()
+{
+    QLCXMLTags tags(QStringList() << "Function" << "Speed" << "Step");
+
+    QString name("Fixture");
+    QCOMPARE(tags.id(QStringRef(&name)), -1);
+
+    name = QString();
+    QCOMPARE(tags.id(QStringRef(&name)), -1);
+
+    name = "step";
+    QCOMPARE(tags.id(QStringRef(&name)), -1);
+
+    QLCXMLTags empty((QStringList()));
+    QCOMPARE(empty.count(), 0);
+    name = "Function";
+    QCOMPARE(empty.id(QStringRef(&name)), -1);
+}
+
+void QLCXMLTags_Test::stringRef()
+{
+    QLCXMLTags tags(QStringList() << "Function" << "Speed" << "Step");
+
+    /* References into a longer string must match only their own range */
+    QString str("FunctionSpeedStep");
+    QCOMPARE(tags.id(QStringRef(&str, 0, 8)), 0);
+    QCOMPARE(tags.id(QStringRef(&str, 8, 5)), 1);
+    QCOMPARE(tags.id(QStringRef(&str, 13, 4)), 2);
+    QCOMPARE(tags.id(QStringRef(&str, 0, 9)), -1);
+
+    QXmlStreamReader xml("<Function><Speed/><Step/><Bus/></Function>");
+    QVERIFY(xml.readNextStartElement() == true);
+    QCOMPARE(tags.id(xml.name()), 0);
+    QVERIFY(xml.readNextStartElement() == true);
+    QCOMPARE(tags.id(xml.name()), 1);
+    xml.skipCurrentElement();
+    QVERIFY(xml.readNextStartElement() == true);
+    QCOMPARE(tags.id(xml.name()), 2);
+    xml.skipCurrentElement();
+    QVERIFY(xml.readNextStartElement() == true);
+    QCOMPARE(tags.id(xml.name()), -1);
+}
+
+QTEST_APPLESS_MAIN(QLCXMLTags_Test)
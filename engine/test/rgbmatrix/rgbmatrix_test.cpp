@@ -155,6 +155,14 @@ void RGBMatrix_Test::previewMaps()
             }
         }
     }
+
+    QCOMPARE(mtx.previewStepCount(), 5);
+    for (int z = 0; z < 5; z++)
+        QCOMPARE(mtx.previewMap(z), maps[z]);
+
+    mtx.setFixtureGroup(FixtureGroup::invalidId());
+    QCOMPARE(mtx.previewStepCount(), 0);
+    QCOMPARE(mtx.previewMap(0).size(), 0);
 }
 
 void RGBMatrix_Test::loadSave()
@@ -15,8 +15,10 @@ SUBDIRS += fixture
 SUBDIRS += fixturegroup
 SUBDIRS += function
 SUBDIRS += genericfader
+SUBDIRS += inputlatency
 SUBDIRS += inputmap
 SUBDIRS += inputpatch
+unix:!macx:SUBDIRS += ioreactor
 SUBDIRS += intensitygenerator
 SUBDIRS += mastertimer
 SUBDIRS += outputmap
@@ -25,6 +27,7 @@ SUBDIRS += palettegenerator
 SUBDIRS += qlccapability
 SUBDIRS += qlcchannel
 SUBDIRS += qlcfile
+SUBDIRS += qlcfilewriter
 SUBDIRS += qlcfixturedef
 SUBDIRS += qlcfixturedefcache
 SUBDIRS += qlcfixturehead
@@ -35,6 +38,7 @@ SUBDIRS += qlcinputprofile
 SUBDIRS += qlcmacros
 SUBDIRS += qlcphysical
 SUBDIRS += qlcpoint
+SUBDIRS += qlcxmltags
 SUBDIRS += rgbalgorithm
 SUBDIRS += rgbmatrix
 SUBDIRS += rgbscript
@@ -43,6 +47,8 @@ SUBDIRS += scene
 SUBDIRS += scenevalue
 SUBDIRS += script
 SUBDIRS += universearray
+SUBDIRS += universemonitor
+SUBDIRS += workspacecache
 
 # Stubs
 SUBDIRS += inputpluginstub
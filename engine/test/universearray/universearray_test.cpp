@@ -212,6 +212,115 @@ void UniverseArray_Test::write()
     QCOMPARE(ua.postGMValues()->at(0), char(127));
 }
 
+void UniverseArray_Test::fill()
+{
+    UniverseArray ua(10);
+    ua.setGMValue(127);
+
+    QVector <int> channels;
+    channels << 0 << 4 << 9 << 10 << -1;
+
+    /* Out of range channels are skipped */
+    ua.fill(channels, 200, QLCChannel::Intensity);
+    QCOMPARE(ua.preGMValues().at(0), char(200));
+    QCOMPARE(ua.preGMValues().at(4), char(200));
+    QCOMPARE(ua.preGMValues().at(9), char(200));
+    QCOMPARE(ua.postGMValues()->at(0), char(100));
+    QCOMPARE(ua.postGMValues()->at(4), char(100));
+    QCOMPARE(ua.postGMValues()->at(9), char(100));
+    QCOMPARE(ua.postGMValues()->at(1), char(0));
+
+    /* HTP keeps the higher intensity value */
+    ua.write(4, 255, QLCChannel::Intensity);
+    ua.fill(channels, 210, QLCChannel::Intensity);
+    QCOMPARE(ua.preGMValues().at(0), char(210));
+    QCOMPARE(ua.preGMValues().at(4), char(255));
+    QCOMPARE(ua.postGMValues()->at(4), char(127));
+
+    /* Grand Master changes apply to filled channels too */
+    ua.setGMValue(255);
+    QCOMPARE(ua.postGMValues()->at(0), char(210));
+    QCOMPARE(ua.postGMValues()->at(9), char(210));
+
+    /* LTP channels take the latest value */
+    channels.clear();
+    channels << 1 << 2;
+    ua.fill(channels, 50, QLCChannel::Pan);
+    ua.fill(channels, 20, QLCChannel::Pan);
+    QCOMPARE(ua.postGMValues()->at(1), char(20));
+    QCOMPARE(ua.postGMValues()->at(2), char(20));
+}
+
+void UniverseArray_Test::writeChannels()
+{
+    UniverseArray ua(10);
+    ua.setGMValue(127);
+
+    QVector <int> channels;
+    QVector <uchar> values;
+    QVector <QLCChannel::Group> groups;
+    channels << 0 << 3 << 10 << 5 << -1;
+    values << 200 << 50 << 1 << 0 << 1;
+    groups << QLCChannel::Intensity << QLCChannel::Pan << QLCChannel::Pan
+           << QLCChannel::Intensity << QLCChannel::Pan;
+
+    /* Out of range channels are skipped, GM applies only to intensity */
+    ua.write(channels, values, groups);
+    QCOMPARE(ua.preGMValues().at(0), char(200));
+    QCOMPARE(ua.postGMValues()->at(0), char(100));
+    QCOMPARE(ua.preGMValues().at(3), char(50));
+    QCOMPARE(ua.postGMValues()->at(3), char(50));
+    QCOMPARE(ua.postGMValues()->at(5), char(0));
+
+    /* HTP keeps the higher intensity value, LTP takes the latest value */
+    values[0] = 100;
+    values[1] = 20;
+    ua.write(channels, values, groups);
+    QCOMPARE(ua.preGMValues().at(0), char(200));
+    QCOMPARE(ua.postGMValues()->at(3), char(20));
+
+    /* Grand Master changes apply to written channels too */
+    ua.setGMValue(255);
+    QCOMPARE(ua.postGMValues()->at(0), char(200));
+}
+
+void UniverseArray_Test::writeRange()
+{
+    UniverseArray ua(10);
+    ua.setGMValue(127);
+
+    uchar values[] = { 200, 100, 0, 50 };
+
+    /* Out of range channels are skipped, GM applies only to intensity */
+    ua.writeRange(8, values, 4, QLCChannel::Pan);
+    QCOMPARE(ua.preGMValues().at(8), char(200));
+    QCOMPARE(ua.postGMValues()->at(8), char(200));
+    QCOMPARE(ua.postGMValues()->at(9), char(100));
+    QCOMPARE(ua.m_gMNonIntensityChannels.size(), 2);
+
+    /* An intensity layer is merged in HTP fashion */
+    ua.write(1, 150, QLCChannel::Intensity);
+    ua.writeRange(0, values, 4, QLCChannel::Intensity);
+    QCOMPARE(ua.preGMValues().at(0), char(200));
+    QCOMPARE(ua.postGMValues()->at(0), char(100));
+    QCOMPARE(ua.preGMValues().at(1), char(150));
+    QCOMPARE(ua.postGMValues()->at(1), char(75));
+    QCOMPARE(ua.postGMValues()->at(2), char(0));
+    QCOMPARE(ua.postGMValues()->at(3), char(25));
+    QCOMPARE(ua.m_gMIntensityChannels.size(), 3);
+
+    /* Grand Master changes apply to written channels too */
+    ua.setGMValueMode(UniverseArray::GMLimit);
+    QCOMPARE(ua.postGMValues()->at(0), char(127));
+    QCOMPARE(ua.postGMValues()->at(1), char(127));
+    QCOMPARE(ua.postGMValues()->at(3), char(50));
+
+    /* Channels that drop to zero are no longer tracked */
+    ua.writeRange(8, values + 2, 2, QLCChannel::Pan);
+    QCOMPARE(ua.m_gMNonIntensityChannels.size(), 1);
+    QCOMPARE(ua.postGMValues()->at(9), char(50));
+}
+
 void UniverseArray_Test::reset()
 {
     UniverseArray ua(128);
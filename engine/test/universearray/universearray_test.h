@@ -36,6 +36,9 @@ private slots:
     void applyGM();
     void setGMValue();
     void write();
+    void fill();
+    void writeChannels();
+    void writeRange();
     void reset();
     void setGMValueEfficiency();
     void writeEfficiency();
@@ -0,0 +1,197 @@
+/*
+  Q Light Controller - Unit test
+  universemonitor_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "universemonitor_test.h"
+#include "universemonitor.h"
+#include "universearray.h"
+#include "outputmap.h"
+
+void UniverseMonitor_Test::init()
+{
+    m_outputMap = new OutputMap(this, 4);
+    m_updates = 0;
+    m_values.clear();
+    m_channels.clear();
+}
+
+void UniverseMonitor_Test::cleanup()
+{
+    delete m_outputMap;
+    m_outputMap = NULL;
+}
+
+void UniverseMonitor_Test::slotValuesChanged(const QByteArray& values,
+                                             const QList <quint32>& channels)
+{
+    m_updates++;
+    m_values = values;
+    m_channels = channels;
+}
+
+void UniverseMonitor_Test::write(int channel, uchar value)
+{
+    UniverseArray* ua = m_outputMap->claimUniverses();
+    ua->write(channel, value);
+    m_outputMap->releaseUniverses(true);
+    m_outputMap->dumpUniverses();
+}
+
+void UniverseMonitor_Test::rate()
+{
+    UniverseMonitor um(m_outputMap);
+    QCOMPARE(um.rate(), UniverseMonitor::defaultRate());
+    QVERIFY(um.isRunning() == false);
+
+    um.setRate(50);
+    QCOMPARE(um.rate(), 50);
+    um.setRate(0);
+    QCOMPARE(um.rate(), 1);
+    um.setRate(1000);
+    QCOMPARE(um.rate(), 100);
+
+    um.start();
+    QVERIFY(um.isRunning() == true);
+    um.stop();
+    QVERIFY(um.isRunning() == false);
+}
+
+void UniverseMonitor_Test::snapshot()
+{
+    /* Serial 0 always gets the values */
+    quint32 serial = 0;
+    QByteArray ba(m_outputMap->universeSnapshot(serial));
+    QCOMPARE(ba.size(), 4 * 512);
+    QVERIFY(serial != 0);
+
+    /* Nothing written since */
+    QVERIFY(m_outputMap->universeSnapshot(serial).isEmpty() == true);
+
+    /* Dumping without changes doesn't make new values */
+    m_outputMap->dumpUniverses();
+    QVERIFY(m_outputMap->universeSnapshot(serial).isEmpty() == true);
+
+    quint32 old = serial;
+    write(5, 100);
+    ba = m_outputMap->universeSnapshot(serial);
+    QCOMPARE(ba.size(), 4 * 512);
+    QCOMPARE(uchar(ba.at(5)), uchar(100));
+    QVERIFY(serial != old);
+}
+
+void UniverseMonitor_Test::firstUpdate()
+{
+    UniverseMonitor um(m_outputMap);
+    connect(&um, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+
+    /* The first update reports all channels */
+    um.update();
+    QCOMPARE(m_updates, 1);
+    QCOMPARE(m_values.size(), 4 * 512);
+    QCOMPARE(m_channels.size(), 4 * 512);
+    QCOMPARE(m_channels.first(), quint32(0));
+    QCOMPARE(m_channels.last(), quint32(4 * 512 - 1));
+    QCOMPARE(um.values(), m_values);
+}
+
+void UniverseMonitor_Test::noChanges()
+{
+    UniverseMonitor um(m_outputMap);
+    connect(&um, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+
+    um.update();
+    QCOMPARE(m_updates, 1);
+
+    /* Nothing written */
+    um.update();
+    QCOMPARE(m_updates, 1);
+
+    /* Written, but with the same value */
+    write(10, 0);
+    um.update();
+    QCOMPARE(m_updates, 1);
+}
+
+void UniverseMonitor_Test::changedChannels()
+{
+    UniverseMonitor um(m_outputMap);
+    connect(&um, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+    um.update();
+
+    write(0, 1);
+    write(511, 2);
+    write(1500, 3);
+    um.update();
+    QCOMPARE(m_updates, 2);
+    QCOMPARE(m_channels, QList <quint32> () << 0 << 511 << 1500);
+    QCOMPARE(uchar(m_values.at(0)), uchar(1));
+    QCOMPARE(uchar(m_values.at(511)), uchar(2));
+    QCOMPARE(uchar(m_values.at(1500)), uchar(3));
+
+    write(511, 4);
+    um.update();
+    QCOMPARE(m_updates, 3);
+    QCOMPARE(m_channels, QList <quint32> () << 511);
+    QCOMPARE(uchar(m_values.at(511)), uchar(4));
+}
+
+void UniverseMonitor_Test::latestOnly()
+{
+    UniverseMonitor um(m_outputMap);
+    connect(&um, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+    um.update();
+
+    /* Many ticks between two updates make only one update with the
+       latest values */
+    for (int i = 1; i <= 100; i++)
+        write(42, uchar(i));
+    um.update();
+    QCOMPARE(m_updates, 2);
+    QCOMPARE(m_channels, QList <quint32> () << 42);
+    QCOMPARE(uchar(m_values.at(42)), uchar(100));
+
+    /* A value that changes back and forth between updates isn't reported */
+    write(42, 50);
+    write(42, 100);
+    um.update();
+    QCOMPARE(m_updates, 2);
+}
+
+void UniverseMonitor_Test::reset()
+{
+    UniverseMonitor um(m_outputMap);
+    connect(&um, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+    um.update();
+
+    um.reset();
+    QVERIFY(um.values().isEmpty() == true);
+    um.update();
+    QCOMPARE(m_updates, 2);
+    QCOMPARE(m_channels.size(), 4 * 512);
+}
+
+QTEST_MAIN(UniverseMonitor_Test)
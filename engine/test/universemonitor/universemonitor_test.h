@@ -0,0 +1,61 @@
+/*
+  Q Light Controller - Unit test
+  universemonitor_test.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef UNIVERSEMONITOR_TEST_H
+#define UNIVERSEMONITOR_TEST_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QList>
+
+class OutputMap;
+
+class UniverseMonitor_Test : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void rate();
+    void snapshot();
+    void firstUpdate();
+    void noChanges();
+    void changedChannels();
+    void latestOnly();
+    void reset();
+
+public slots:
+    void slotValuesChanged(const QByteArray& values, const QList <quint32>& channels);
+
+private:
+    /** Write $value to $channel and dump universes like MasterTimer does */
+    void write(int channel, uchar value);
+
+private:
+    OutputMap* m_outputMap;
+    int m_updates;
+    QByteArray m_values;
+    QList <quint32> m_channels;
+};
+
+#endif
@@ -0,0 +1,208 @@
+/*
+  Q Light Controller - Unit tests
+  workspacecache_test.h
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QTextStream>
+#include <QtTest>
+#include <QtXml>
+#include <QFile>
+
+#include "workspacecache_test.h"
+#include "workspacecache.h"
+#include "fixturegroup.h"
+#include "collection.h"
+#include "chaser.h"
+#include "fixture.h"
+#include "scene.h"
+#include "doc.h"
+#include "efx.h"
+
+#define TEST_FILE "workspacecache_test.qxw.bin"
+
+void WorkspaceCache_Test::init()
+{
+    m_doc = new Doc(this);
+    QFile::remove(TEST_FILE);
+}
+
+void WorkspaceCache_Test::cleanup()
+{
+    delete m_doc;
+    m_doc = NULL;
+    QFile::remove(TEST_FILE);
+}
+
+void WorkspaceCache_Test::fileName()
+{
+    QCOMPARE(WorkspaceCache::fileName("foo.qxw"), QString("foo.qxw.bin"));
+}
+
+void WorkspaceCache_Test::hash()
+{
+    QByteArray whole("<Workspace><Engine/></Workspace>");
+    QList <QByteArray> parts;
+    parts << QByteArray("<Workspace>") << QByteArray("<Engine/>")
+          << QByteArray() << QByteArray("</Workspace>");
+
+    QCOMPARE(WorkspaceCache::hash(parts), WorkspaceCache::hash(whole));
+    QVERIFY(WorkspaceCache::hash(whole) != WorkspaceCache::hash(QByteArray("<Workspace/>")));
+}
+
+void WorkspaceCache_Test::roundTrip()
+{
+    fillDoc(m_doc);
+    QByteArray hash(WorkspaceCache::hash(QByteArray("foo")));
+    writeFile(WorkspaceCache::save(hash, m_doc, QByteArray("<Workspace/>")));
+
+    Doc doc(this);
+    QByteArray appData;
+    QVERIFY(WorkspaceCache::load(TEST_FILE, hash, &doc, &appData) == true);
+    QCOMPARE(appData, QByteArray("<Workspace/>"));
+    QCOMPARE(doc.fixtures().size(), m_doc->fixtures().size());
+    QCOMPARE(doc.functions().size(), m_doc->functions().size());
+    QCOMPARE(doc.fixtureGroups().size(), m_doc->fixtureGroups().size());
+    QCOMPARE(engineXML(&doc), engineXML(m_doc));
+}
+
+void WorkspaceCache_Test::outOfDate()
+{
+    fillDoc(m_doc);
+    writeFile(WorkspaceCache::save(WorkspaceCache::hash(QByteArray("foo")),
+                                   m_doc, QByteArray()));
+
+    Doc doc(this);
+    QByteArray appData("bar");
+    QVERIFY(WorkspaceCache::load(TEST_FILE, WorkspaceCache::hash(QByteArray("bar")),
+                                 &doc, &appData) == false);
+    QCOMPARE(doc.fixtures().size(), 0);
+    QCOMPARE(doc.functions().size(), 0);
+
+    /* Missing cache */
+    QFile::remove(TEST_FILE);
+    QVERIFY(WorkspaceCache::load(TEST_FILE, WorkspaceCache::hash(QByteArray("foo")),
+                                 &doc, &appData) == false);
+}
+
+void WorkspaceCache_Test::badMagic()
+{
+    fillDoc(m_doc);
+    QByteArray hash(WorkspaceCache::hash(QByteArray("foo")));
+    QByteArray cache(WorkspaceCache::save(hash, m_doc, QByteArray()));
+    cache[0] = 'X';
+    writeFile(cache);
+
+    Doc doc(this);
+    QByteArray appData;
+    QVERIFY(WorkspaceCache::load(TEST_FILE, hash, &doc, &appData) == false);
+    QCOMPARE(doc.fixtures().size(), 0);
+
+    /* Some other text file */
+    writeFile(QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"));
+    QVERIFY(WorkspaceCache::load(TEST_FILE, hash, &doc, &appData) == false);
+}
+
+void WorkspaceCache_Test::truncated()
+{
+    fillDoc(m_doc);
+    QByteArray hash(WorkspaceCache::hash(QByteArray("foo")));
+    QByteArray cache(WorkspaceCache::save(hash, m_doc, QByteArray("<Workspace/>")));
+    writeFile(cache.left(cache.size() / 2));
+
+    /* Whatever was loaded before the end of data must be cleared */
+    Doc doc(this);
+    QByteArray appData;
+    QVERIFY(WorkspaceCache::load(TEST_FILE, hash, &doc, &appData) == false);
+    QCOMPARE(doc.fixtures().size(), 0);
+    QCOMPARE(doc.functions().size(), 0);
+    QCOMPARE(doc.fixtureGroups().size(), 0);
+    QVERIFY(appData.isEmpty() == true);
+}
+
+void WorkspaceCache_Test::fillDoc(Doc* doc)
+{
+    Fixture* fxi = new Fixture(doc);
+    fxi->setName("Dimmers");
+    fxi->setChannels(6);
+    fxi->setAddress(10);
+    doc->addFixture(fxi);
+
+    Fixture* fxi2 = new Fixture(doc);
+    fxi2->setChannels(2);
+    fxi2->setUniverse(1);
+    doc->addFixture(fxi2);
+
+    FixtureGroup* grp = new FixtureGroup(doc);
+    grp->setName("Group");
+    grp->setSize(QSize(4, 4));
+    grp->assignFixture(fxi->id(), QLCPoint(0, 0));
+    doc->addFixtureGroup(grp);
+
+    Scene* s1 = new Scene(doc);
+    s1->setName("Scene 1");
+    s1->setValue(fxi->id(), 0, 255);
+    s1->setValue(fxi->id(), 5, 10);
+    s1->setValue(fxi2->id(), 1, 128);
+    s1->setFadeInSpeed(500);
+    doc->addFunction(s1);
+
+    Scene* s2 = new Scene(doc);
+    s2->setValue(fxi2->id(), 0, 1);
+    doc->addFunction(s2);
+
+    Chaser* c = new Chaser(doc);
+    c->setName("Chaser");
+    c->setDirection(Function::Backward);
+    c->addStep(ChaserStep(s1->id(), 100, 200, 300));
+    c->addStep(ChaserStep(s2->id()));
+    doc->addFunction(c);
+
+    Collection* col = new Collection(doc);
+    col->addFunction(s2->id());
+    col->addFunction(c->id());
+    doc->addFunction(col);
+
+    /* EFX has no binary format of its own */
+    EFX* e = new EFX(doc);
+    e->setName("EFX");
+    doc->addFunction(e);
+}
+
+void WorkspaceCache_Test::writeFile(const QByteArray& data)
+{
+    QFile file(TEST_FILE);
+    QVERIFY(file.open(QIODevice::WriteOnly) == true);
+    QCOMPARE(file.write(data), qint64(data.size()));
+    file.close();
+}
+
+QString WorkspaceCache_Test::engineXML(Doc* doc)
+{
+    QDomDocument document;
+    QDomElement root = document.createElement("Workspace");
+    document.appendChild(root);
+    doc->saveXML(&document, &root);
+
+    QString str;
+    QTextStream stream(&str);
+    root.firstChildElement("Engine").save(stream, 1);
+    return str;
+}
+
+QTEST_MAIN(WorkspaceCache_Test)
@@ -308,6 +308,7 @@ void EditChannel::slotEditCapabilityClicked()
             else
             {
                 *real = *ec->capability();
+                m_channel->invalidateCapabilityIndex();
                 refreshCapabilities();
                 ok = true;
             }
@@ -0,0 +1,5 @@
+include(../variables.pri)
+
+TEMPLATE = subdirs
+SUBDIRS += src
+SUBDIRS += test
@@ -0,0 +1,190 @@
+/*
+  Q Light Controller
+  controlserver.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStringList>
+#include <QDebug>
+
+#include "controlserver.h"
+#include "mastertimer.h"
+#include "function.h"
+#include "chaser.h"
+#include "doc.h"
+
+ControlServer::ControlServer(Doc* doc, QObject* parent)
+    : QObject(parent)
+    , m_doc(doc)
+    , m_server(new QLocalServer(this))
+{
+    Q_ASSERT(doc != NULL);
+
+    connect(m_server, SIGNAL(newConnection()),
+            this, SLOT(slotNewConnection()));
+}
+
+ControlServer::~ControlServer()
+{
+    m_server->close();
+}
+
+bool ControlServer::listen(const QString& name)
+{
+    QLocalServer::removeServer(name);
+    if (m_server->listen(name) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to listen to" << name << ":"
+                   << m_server->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString ControlServer::serverName() const
+{
+    return m_server->fullServerName();
+}
+
+/*****************************************************************************
+ * Commands
+ *****************************************************************************/
+
+static QString functionLine(const Function* function)
+{
+    return QString("%1 %2 %3\n").arg(function->id())
+                                .arg(Function::typeToString(function->type()))
+                                .arg(function->name());
+}
+
+static QString error(const QString& reason)
+{
+    return QString("ERROR %1\n").arg(reason);
+}
+
+QString ControlServer::command(const QString& line)
+{
+    QStringList args(line.simplified().split(" ", QString::SkipEmptyParts));
+    if (args.isEmpty() == true)
+        return error("Empty command");
+
+    QString cmd(args.takeFirst().toLower());
+    QString reply;
+
+    if (cmd == "list" || cmd == "running")
+    {
+        QListIterator <Function*> it(m_doc->functions());
+        while (it.hasNext() == true)
+        {
+            Function* function = it.next();
+            if (cmd == "list" || function->isRunning() == true)
+                reply += functionLine(function);
+        }
+        return reply + "OK\n";
+    }
+    else if (cmd == "stopall")
+    {
+        m_doc->masterTimer()->stopAllFunctions();
+        return "OK\n";
+    }
+    else if (cmd == "help")
+    {
+        reply += "list\nrunning\nstart <id>\nstop <id>\nstopall\n";
+        reply += "next <id>\nprevious <id>\nhelp\nquit\n";
+        return reply + "OK\n";
+    }
+    else if (cmd == "quit")
+    {
+        emit quitRequested();
+        return "OK\n";
+    }
+    else if (cmd != "start" && cmd != "stop" && cmd != "next" && cmd != "previous")
+    {
+        return error(QString("Unknown command: %1").arg(cmd));
+    }
+
+    /* The rest of the commands take a function ID */
+    bool ok = false;
+    quint32 id = (args.size() == 1) ? args.first().toUInt(&ok) : 0;
+    if (ok == false)
+        return error(QString("Usage: %1 <id>").arg(cmd));
+
+    Function* function = m_doc->function(id);
+    if (function == NULL)
+        return error(QString("No such function: %1").arg(id));
+
+    if (cmd == "start")
+    {
+        function->start(m_doc->masterTimer());
+    }
+    else if (cmd == "stop")
+    {
+        function->stop();
+    }
+    else
+    {
+        Chaser* chaser = qobject_cast<Chaser*> (function);
+        if (chaser == NULL)
+            return error(QString("Not a chaser: %1").arg(id));
+        if (chaser->isRunning() == false)
+            return error(QString("Not running: %1").arg(id));
+
+        if (cmd == "next")
+            chaser->next();
+        else
+            chaser->previous();
+    }
+
+    return "OK\n";
+}
+
+/*****************************************************************************
+ * Clients
+ *****************************************************************************/
+
+void ControlServer::slotNewConnection()
+{
+    QLocalSocket* socket;
+    while ((socket = m_server->nextPendingConnection()) != NULL)
+    {
+        connect(socket, SIGNAL(readyRead()), this, SLOT(slotReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(slotDisconnected()));
+    }
+}
+
+void ControlServer::slotReadyRead()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*> (sender());
+    Q_ASSERT(socket != NULL);
+
+    while (socket->canReadLine() == true)
+    {
+        QString line(QString::fromUtf8(socket->readLine()).trimmed());
+        socket->write(command(line).toUtf8());
+    }
+}
+
+void ControlServer::slotDisconnected()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*> (sender());
+    Q_ASSERT(socket != NULL);
+    socket->deleteLater();
+}
@@ -0,0 +1,92 @@
+/*
+  Q Light Controller
+  controlserver.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QObject>
+#include <QString>
+
+class QLocalServer;
+class QLocalSocket;
+class Doc;
+
+/**
+ * ControlServer exposes function playback of a Doc thru a local socket
+ * (a UNIX domain socket or a Windows named pipe). Clients send one command
+ * per line and get back zero or more lines of data, terminated by a line
+ * that contains either "OK" or "ERROR <reason>":
+ *
+ * @code
+ * list              # "<id> <type> <name>" for each function
+ * running           # "<id> <type> <name>" for each running function
+ * start <id>        # Start a function
+ * stop <id>         # Stop a function
+ * stopall           # Stop all functions
+ * next <id>         # Skip a running chaser to its next step
+ * previous <id>     # Skip a running chaser to its previous step
+ * help              # List the commands
+ * quit              # Stop the engine
+ * @endcode
+ */
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    ControlServer(Doc* doc, QObject* parent = 0);
+    ~ControlServer();
+
+    /**
+     * Start listening to the given socket name. A stale socket with the same
+     * name is removed first.
+     *
+     * @param name The name (or path) of the local socket
+     * @return true if successful, otherwise false
+     */
+    bool listen(const QString& name);
+
+    /** Get the full name of the socket that is being listened to */
+    QString serverName() const;
+
+    /**
+     * Execute one command line
+     *
+     * @param line A command (without the line terminator)
+     * @return The command's reply, each line terminated with "\n"
+     */
+    QString command(const QString& line);
+
+signals:
+    /** Emitted when a client has sent the "quit" command */
+    void quitRequested();
+
+private slots:
+    void slotNewConnection();
+    void slotReadyRead();
+    void slotDisconnected();
+
+private:
+    Doc* m_doc;
+    QLocalServer* m_server;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+  Q Light Controller
+  headlessengine.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QXmlStreamReader>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "qlcfixturedefcache.h"
+#include "headlessengine.h"
+#include "workspacecache.h"
+#include "mastertimer.h"
+#include "qlcconfig.h"
+#include "outputmap.h"
+#include "inputmap.h"
+#include "function.h"
+#include "fixture.h"
+#include "doc.h"
+
+#define KXMLQLCWorkspace "Workspace"
+
+HeadlessEngine::HeadlessEngine(QObject* parent)
+    : QObject(parent)
+    , m_doc(new Doc(this))
+    , m_running(false)
+{
+}
+
+HeadlessEngine::~HeadlessEngine()
+{
+    stop();
+
+    delete m_doc;
+    m_doc = NULL;
+}
+
+Doc* HeadlessEngine::doc() const
+{
+    return m_doc;
+}
+
+void HeadlessEngine::setApplicationNames()
+{
+    QCoreApplication::setOrganizationName("qlc");
+    QCoreApplication::setOrganizationDomain("sf.net");
+    QCoreApplication::setApplicationName(APPNAME);
+}
+
+void HeadlessEngine::loadDefinitions(const QList <QDir>& fixtureDirs,
+                                     const QString& fixtureIndex,
+                                     const QList <QDir>& profileDirs)
+{
+    QLCFixtureDefCache* cache = m_doc->fixtureDefCache();
+    if (fixtureIndex.isEmpty() == false)
+        cache->loadIndex(fixtureIndex);
+
+    QListIterator <QDir> it(fixtureDirs);
+    while (it.hasNext() == true)
+        cache->load(it.next());
+
+    if (fixtureIndex.isEmpty() == false)
+        cache->saveIndex(fixtureIndex);
+
+    m_doc->inputMap()->addProfiles(InputMap::parseProfiles(profileDirs));
+}
+
+void HeadlessEngine::loadPlugins(const QDir& outputPluginDir, const QDir& inputPluginDir)
+{
+    m_doc->outputMap()->loadPlugins(outputPluginDir);
+    m_doc->outputMap()->loadDefaults();
+
+    m_doc->inputMap()->loadPlugins(inputPluginDir);
+    m_doc->inputMap()->loadDefaults();
+}
+
+QFile::FileError HeadlessEngine::loadWorkspace(const QString& fileName)
+{
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to open file:" << fileName;
+        return file.error();
+    }
+
+    QByteArray contents(file.readAll());
+    file.close();
+
+    m_doc->clearContents();
+
+    /* The binary cache is written by QLC when it saves the workspace */
+    QByteArray appData;
+    if (WorkspaceCache::load(WorkspaceCache::fileName(fileName),
+                             WorkspaceCache::hash(contents), m_doc, &appData) == true)
+    {
+        m_doc->resetModified();
+        return QFile::NoError;
+    }
+
+    QXmlStreamReader xml(contents);
+    QString docType;
+    while (xml.atEnd() == false && xml.isStartElement() == false)
+    {
+        xml.readNext();
+        if (xml.isDTD() == true)
+            docType = xml.dtdName().toString();
+    }
+
+    if (docType != KXMLQLCWorkspace || xml.isStartElement() == false ||
+        loadWorkspace(xml) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to load workspace" << fileName
+                   << ":" << xml.errorString();
+        m_doc->clearContents();
+        return QFile::ReadError;
+    }
+
+    m_doc->resetModified();
+    return QFile::NoError;
+}
+
+bool HeadlessEngine::loadWorkspace(QXmlStreamReader& xml)
+{
+    if (xml.name() != QLatin1String(KXMLQLCWorkspace))
+    {
+        qWarning() << Q_FUNC_INFO << "Workspace node not found";
+        return false;
+    }
+
+    while (xml.readNextStartElement() == true)
+    {
+        if (xml.name() == QLatin1String(KXMLQLCEngine))
+        {
+            m_doc->loadXML(xml);
+        }
+        else if (xml.name() == QLatin1String(KXMLFixture))
+        {
+            /* Legacy support code, nowadays in Doc */
+            Fixture::loader(xml, m_doc);
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCFunction))
+        {
+            /* Legacy support code, nowadays in Doc */
+            Function::loader(xml, m_doc);
+        }
+        else
+        {
+            /* Virtual Console, Simple Desk etc. */
+            xml.skipCurrentElement();
+        }
+    }
+
+    return (xml.hasError() == false);
+}
+
+void HeadlessEngine::start()
+{
+    if (m_running == true)
+        return;
+
+    m_doc->setMode(Doc::Operate);
+    m_doc->masterTimer()->start();
+    m_running = true;
+}
+
+void HeadlessEngine::stop()
+{
+    if (m_running == false)
+        return;
+
+    m_doc->masterTimer()->stop();
+    m_doc->setMode(Doc::Design);
+    m_running = false;
+}
@@ -0,0 +1,100 @@
+/*
+  Q Light Controller
+  headlessengine.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef HEADLESSENGINE_H
+#define HEADLESSENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QFile>
+#include <QDir>
+
+class QXmlStreamReader;
+class Doc;
+
+/**
+ * HeadlessEngine runs workspace playback without any user interface: it
+ * owns a Doc, loads fixture definitions, input profiles and I/O plugins,
+ * restores the I/O patches saved by QLC and loads the engine contents of a
+ * workspace file. The Virtual Console and the Simple Desk of the workspace
+ * are skipped, since there's nothing to show them on.
+ */
+class HeadlessEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    HeadlessEngine(QObject* parent = 0);
+    ~HeadlessEngine();
+
+    /** Get the engine's document */
+    Doc* doc() const;
+
+    /**
+     * Set the same organization & application names as QLC's UI, so that
+     * QSettings finds the I/O patches saved by QLC. Must be called before
+     * creating a HeadlessEngine.
+     */
+    static void setApplicationNames();
+
+    /**
+     * Load fixture definitions and input profiles. Earlier directories
+     * override later ones.
+     *
+     * @param fixtureDirs Fixture definition directories
+     * @param fixtureIndex Fixture definition index file, or empty for none
+     * @param profileDirs Input profile directories
+     */
+    void loadDefinitions(const QList <QDir>& fixtureDirs, const QString& fixtureIndex,
+                         const QList <QDir>& profileDirs);
+
+    /**
+     * Load output & input plugins and restore the I/O patches that QLC
+     * has saved into its settings.
+     */
+    void loadPlugins(const QDir& outputPluginDir, const QDir& inputPluginDir);
+
+    /**
+     * Load the engine contents of a workspace file, from its binary cache
+     * if the cache is up to date.
+     *
+     * @param fileName The workspace file to load
+     * @return QFile::NoError if successful
+     */
+    QFile::FileError loadWorkspace(const QString& fileName);
+
+    /** Switch to operate mode and start running MasterTimer */
+    void start();
+
+    /** Stop all functions and MasterTimer */
+    void stop();
+
+private:
+    /** Load the engine contents from a Workspace element */
+    bool loadWorkspace(QXmlStreamReader& xml);
+
+private:
+    Doc* m_doc;
+    bool m_running;
+};
+
+#endif
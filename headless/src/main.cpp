@@ -0,0 +1,205 @@
+/*
+  Q Light Controller
+  main.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QApplication>
+#include <QTextStream>
+#include <QString>
+#include <QDebug>
+#include <QDir>
+
+#include "qlcfixturedefcache.h"
+#include "headlessengine.h"
+#include "controlserver.h"
+#include "qlcconfig.h"
+#include "outputmap.h"
+#include "inputmap.h"
+#include "doc.h"
+
+/* Use this namespace for command-line arguments so that we don't pollute
+   the global namespace. */
+namespace QLCArgs
+{
+    /** The workspace file to play back */
+    QString workspace;
+
+    /** The name of the local control socket */
+    QString socket("qlc-engine");
+
+    /** Debug output level */
+    QtMsgType debugLevel = QtSystemMsg;
+}
+
+/**
+ * Suppresses debug messages
+ */
+void qlcMessageHandler(QtMsgType type, const char* msg)
+{
+    if (type >= QLCArgs::debugLevel)
+    {
+        fprintf(stderr, "%s", msg);
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
+}
+
+/**
+ * Prints the application version
+ */
+void printVersion()
+{
+    QTextStream cout(stdout, QIODevice::WriteOnly);
+
+    cout << endl;
+    cout << APPNAME << " engine " << "version " << APPVERSION << endl;
+    cout << "This program is licensed under the terms of the GNU ";
+    cout << "General Public License v2." << endl;
+    cout << "Copyright (c) Heikki Junnila (hjunnila@users.sf.net)." << endl;
+    cout << endl;
+}
+
+/**
+ * Prints possible command-line options
+ */
+void printUsage()
+{
+    QTextStream cout(stdout, QIODevice::WriteOnly);
+
+    cout << "Usage:";
+    cout << "  qlc-engine [options] -o <file>" << endl;
+    cout << "Options:" << endl;
+    cout << "  -d or --debug <level>\t\tSet debug output level (0-3, see QtMsgType)" << endl;
+    cout << "  -h or --help\t\t\tPrint this help" << endl;
+    cout << "  -o or --open <file>\t\tPlay back the specified workspace file" << endl;
+    cout << "  -s or --socket <name>\t\tListen to commands in the given local socket (default: qlc-engine)" << endl;
+    cout << "  -v or --version\t\tPrint version information" << endl;
+    cout << endl;
+}
+
+/**
+ * Parse command line arguments
+ *
+ * @return true to continue with application launch; otherwise false
+ */
+bool parseArgs()
+{
+    QStringListIterator it(QCoreApplication::arguments());
+    while (it.hasNext() == true)
+    {
+        QString arg(it.next());
+
+        if (arg == "-d" || arg == "--debug")
+        {
+            if (it.hasNext() == true)
+                QLCArgs::debugLevel = QtMsgType(it.peekNext().toInt());
+            else
+                QLCArgs::debugLevel = QtMsgType(0);
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        else if (arg == "-o" || arg == "--open")
+        {
+            if (it.hasNext() == true)
+                QLCArgs::workspace = it.next();
+        }
+        else if (arg == "-s" || arg == "--socket")
+        {
+            if (it.hasNext() == true)
+                QLCArgs::socket = it.next();
+        }
+        else if (arg == "-v" || arg == "--version")
+        {
+            /* Version has already been printed */
+            return false;
+        }
+    }
+
+    if (QLCArgs::workspace.isEmpty() == true)
+    {
+        printUsage();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * THE entry point for the headless engine
+ *
+ * @param argc Number of arguments in array argv
+ * @param argv Arguments array
+ */
+int main(int argc, char** argv)
+{
+    /* The engine library uses QtGui for RGB text rendering, but no
+       widgets are ever created, so a display is not needed. */
+    QApplication qapp(argc, argv, false);
+
+    /* Let the world know... */
+    printVersion();
+
+    /* Parse command-line arguments */
+    if (parseArgs() == false)
+        return 0;
+
+    /* Handle debug messages */
+    qInstallMsgHandler(qlcMessageHandler);
+
+    /* Use QLC's settings, including its saved I/O patches */
+    HeadlessEngine::setApplicationNames();
+
+    HeadlessEngine engine;
+
+    /* User definitions override system definitions */
+    QList <QDir> fixtureDirs;
+    fixtureDirs << QLCFixtureDefCache::userDefinitionDirectory();
+    fixtureDirs << QLCFixtureDefCache::systemDefinitionDirectory();
+    QList <QDir> profileDirs;
+    profileDirs << InputMap::userProfileDirectory();
+    profileDirs << InputMap::systemProfileDirectory();
+    engine.loadDefinitions(fixtureDirs,
+                           QLCFixtureDefCache::defaultIndexPath(),
+                           profileDirs);
+
+    engine.loadPlugins(OutputMap::systemPluginDirectory(),
+                       InputMap::systemPluginDirectory());
+
+    if (engine.loadWorkspace(QLCArgs::workspace) != QFile::NoError)
+    {
+        qWarning() << "Unable to load workspace" << QLCArgs::workspace;
+        return 1;
+    }
+
+    ControlServer server(engine.doc());
+    if (server.listen(QLCArgs::socket) == false)
+        return 1;
+    QObject::connect(&server, SIGNAL(quitRequested()), &qapp, SLOT(quit()));
+
+    qDebug() << "Listening to commands in" << server.serverName();
+
+    engine.start();
+    int result = qapp.exec();
+    engine.stop();
+
+    return result;
+}
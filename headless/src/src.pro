@@ -0,0 +1,30 @@
+include(../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = qlc-engine
+
+CONFIG  -= app_bundle
+QT      += core xml script gui network
+
+INCLUDEPATH  += ../../plugins/interfaces
+INCLUDEPATH  += ../../engine/src
+QMAKE_LIBDIR += ../../engine/src
+LIBS         += -lqlcengine
+
+HEADERS += controlserver.h \
+           headlessengine.h
+
+SOURCES += controlserver.cpp \
+           headlessengine.cpp \
+           main.cpp
+
+macx {
+    # This must be after "TARGET = " and before target installation so that
+    # install_name_tool can be run before target installation
+    include(../../macx/nametool.pri)
+}
+
+# Installation
+target.path = $$INSTALLROOT/$$BINDIR
+INSTALLS   += target
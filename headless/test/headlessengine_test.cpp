@@ -0,0 +1,318 @@
+/*
+  Q Light Controller - Unit tests
+  workspacecache_test.h
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307,$
+*/
+
+#include <QXmlStreamWriter>
+#include <QLocalSocket>
+#include <QSettings>
+#include <QtTest>
+#include <QFile>
+
+#include "headlessengine_test.h"
+#include "outputpluginstub.h"
+#include "outputpatch.h"
+#include "workspacecache.h"
+#include "headlessengine.h"
+#include "qlcfilewriter.h"
+#include "controlserver.h"
+#include "chaserstep.h"
+#include "qlcfile.h"
+#include "fixture.h"
+#include "chaser.h"
+#include "scene.h"
+#include "doc.h"
+
+/* Expose protected members to unit test */
+#define protected public
+#include "outputmap.h"
+#undef protected
+
+#define OUTPUT_TESTPLUGINDIR "../../engine/test/outputpluginstub"
+#define INPUT_TESTPLUGINDIR "../../engine/test/inputpluginstub"
+#define TEST_FILE "headlessengine_test.qxw"
+#define TEST_SOCKET "headlessengine_test"
+
+static QDir testPluginDir(const QString& path)
+{
+    QDir dir(path);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtPlugin));
+    return dir;
+}
+
+/** Wait at most 2s for $condition to become true while processing events */
+#define WAIT_FOR(condition) \
+    for (int i = 0; i < 200 && (condition) == false; i++) \
+        QTest::qWait(10)
+
+void HeadlessEngine_Test::initTestCase()
+{
+    /* Keep the test's settings away from the user's real QLC settings */
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, QDir::currentPath());
+    HeadlessEngine::setApplicationNames();
+
+    /* A generic dimmer, two scenes and a chaser that runs both of them,
+       followed by a Virtual Console that the engine should skip */
+    Doc doc(this);
+
+    Fixture* fxi = new Fixture(&doc);
+    fxi->setName("Dimmer");
+    fxi->setChannels(4);
+    QVERIFY(doc.addFixture(fxi) == true);
+
+    Scene* s1 = new Scene(&doc);
+    s1->setName("Full");
+    s1->setValue(fxi->id(), 0, 255);
+    QVERIFY(doc.addFunction(s1) == true);
+
+    Scene* s2 = new Scene(&doc);
+    s2->setName("Half");
+    s2->setValue(fxi->id(), 0, 127);
+    QVERIFY(doc.addFunction(s2) == true);
+
+    Chaser* chaser = new Chaser(&doc);
+    chaser->setName("Show");
+    chaser->addStep(ChaserStep(s1->id()));
+    chaser->addStep(ChaserStep(s2->id()));
+    QVERIFY(doc.addFunction(chaser) == true);
+
+    QByteArray data;
+    QXmlStreamWriter xml(&data);
+    QLCFile::writeXMLHeader(xml, "Workspace");
+    QLCFile::writeXMLCreator(xml);
+    QVERIFY(doc.saveXML(xml) == true);
+    xml.writeStartElement("VirtualConsole");
+    xml.writeEmptyElement("Frame");
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+
+    QVERIFY(QLCFileWriter::writeFile(TEST_FILE, data) == QFile::NoError);
+}
+
+void HeadlessEngine_Test::init()
+{
+    m_engine = new HeadlessEngine(this);
+    m_engine->loadPlugins(testPluginDir(OUTPUT_TESTPLUGINDIR),
+                          testPluginDir(INPUT_TESTPLUGINDIR));
+    QVERIFY(outputStub() != NULL);
+    QVERIFY(m_engine->doc()->outputMap()->setPatch(0, outputStub()->name(), 0) == true);
+}
+
+void HeadlessEngine_Test::cleanup()
+{
+    delete m_engine;
+    m_engine = NULL;
+
+    QFile::remove(WorkspaceCache::fileName(TEST_FILE));
+}
+
+void HeadlessEngine_Test::cleanupTestCase()
+{
+    QFile::remove(TEST_FILE);
+    QFile::remove(QSettings().fileName());
+}
+
+OutputPluginStub* HeadlessEngine_Test::outputStub() const
+{
+    OutputMap* om = m_engine->doc()->outputMap();
+    if (om->m_plugins.isEmpty() == true)
+        return NULL;
+    else
+        return static_cast<OutputPluginStub*> (om->m_plugins.at(0));
+}
+
+void HeadlessEngine_Test::restorePatch()
+{
+    /* The engine's Doc saves its patch into QLC's settings on destruction */
+    delete m_engine;
+
+    m_engine = new HeadlessEngine(this);
+    QVERIFY(m_engine->doc()->outputMap()->patch(0)->pluginName() == KOutputNone);
+    m_engine->loadPlugins(testPluginDir(OUTPUT_TESTPLUGINDIR),
+                          testPluginDir(INPUT_TESTPLUGINDIR));
+    QVERIFY(outputStub() != NULL);
+    QVERIFY(m_engine->doc()->outputMap()->patch(0)->plugin() != NULL);
+    QCOMPARE(m_engine->doc()->outputMap()->patch(0)->pluginName(), outputStub()->name());
+    QCOMPARE(m_engine->doc()->outputMap()->patch(0)->output(), quint32(0));
+}
+
+void HeadlessEngine_Test::loadWorkspace()
+{
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+
+    Doc* doc = m_engine->doc();
+    QCOMPARE(doc->fixtures().size(), 1);
+    QCOMPARE(doc->functions().size(), 3);
+    QVERIFY(doc->isModified() == false);
+    QVERIFY(doc->function(2) != NULL);
+    QCOMPARE(doc->function(2)->type(), Function::Chaser);
+}
+
+void HeadlessEngine_Test::loadCache()
+{
+    QFile file(TEST_FILE);
+    QVERIFY(file.open(QIODevice::ReadOnly) == true);
+    QByteArray hash(WorkspaceCache::hash(file.readAll()));
+    file.close();
+
+    /* A cache that is up to date is preferred over the XML */
+    Doc doc(this);
+    Fixture* fxi = new Fixture(&doc);
+    fxi->setChannels(1);
+    QVERIFY(doc.addFixture(fxi) == true);
+    QByteArray cache(WorkspaceCache::save(hash, &doc, QByteArray()));
+    QVERIFY(QLCFileWriter::writeFile(WorkspaceCache::fileName(TEST_FILE), cache) == QFile::NoError);
+
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    QCOMPARE(m_engine->doc()->fixtures().size(), 1);
+    QCOMPARE(m_engine->doc()->functions().size(), 0);
+
+    /* An out-of-date cache is ignored */
+    cache = WorkspaceCache::save(WorkspaceCache::hash(QByteArray("foo")), &doc, QByteArray());
+    QVERIFY(QLCFileWriter::writeFile(WorkspaceCache::fileName(TEST_FILE), cache) == QFile::NoError);
+
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    QCOMPARE(m_engine->doc()->fixtures().size(), 1);
+    QCOMPARE(m_engine->doc()->functions().size(), 3);
+}
+
+void HeadlessEngine_Test::loadMissing()
+{
+    QVERIFY(m_engine->loadWorkspace("no such file.qxw") != QFile::NoError);
+    QCOMPARE(m_engine->doc()->functions().size(), 0);
+}
+
+void HeadlessEngine_Test::loadInvalid()
+{
+    QByteArray data("<!DOCTYPE FixtureDefinition><FixtureDefinition/>");
+    QVERIFY(QLCFileWriter::writeFile("headlessengine_invalid.qxw", data) == QFile::NoError);
+
+    QVERIFY(m_engine->loadWorkspace("headlessengine_invalid.qxw") == QFile::ReadError);
+    QCOMPARE(m_engine->doc()->functions().size(), 0);
+
+    QFile::remove("headlessengine_invalid.qxw");
+}
+
+void HeadlessEngine_Test::commands()
+{
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    ControlServer server(m_engine->doc());
+
+    QCOMPARE(server.command("list"),
+             QString("0 Scene Full\n1 Scene Half\n2 Chaser Show\nOK\n"));
+    QCOMPARE(server.command("running"), QString("OK\n"));
+    QVERIFY(server.command("help").endsWith("\nOK\n") == true);
+
+    QVERIFY(server.command("").startsWith("ERROR ") == true);
+    QVERIFY(server.command("foo").startsWith("ERROR ") == true);
+    QVERIFY(server.command("start").startsWith("ERROR ") == true);
+    QVERIFY(server.command("start foo").startsWith("ERROR ") == true);
+    QVERIFY(server.command("start 0 1").startsWith("ERROR ") == true);
+    QVERIFY(server.command("start 42").startsWith("ERROR ") == true);
+    QVERIFY(server.command("stop 42").startsWith("ERROR ") == true);
+    QVERIFY(server.command("next 0").startsWith("ERROR ") == true);
+    QVERIFY(server.command("previous 2").startsWith("ERROR ") == true);
+
+    /* Commands are case-insensitive and surrounding whitespace is ignored */
+    QCOMPARE(server.command("  LIST  "), server.command("list"));
+}
+
+void HeadlessEngine_Test::chaserCommands()
+{
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    ControlServer server(m_engine->doc());
+    m_engine->start();
+
+    Function* chaser = m_engine->doc()->function(2);
+    QCOMPARE(server.command("start 2"), QString("OK\n"));
+    WAIT_FOR(chaser->isRunning() == true);
+    QVERIFY(chaser->isRunning() == true);
+    QVERIFY(server.command("running").contains("2 Chaser Show\n") == true);
+
+    QCOMPARE(server.command("next 2"), QString("OK\n"));
+    QCOMPARE(server.command("previous 2"), QString("OK\n"));
+
+    QCOMPARE(server.command("stopall"), QString("OK\n"));
+    WAIT_FOR(chaser->isRunning() == false);
+    QVERIFY(chaser->isRunning() == false);
+
+    m_engine->stop();
+}
+
+void HeadlessEngine_Test::quit()
+{
+    ControlServer server(m_engine->doc());
+    QSignalSpy spy(&server, SIGNAL(quitRequested()));
+    QCOMPARE(server.command("quit"), QString("OK\n"));
+    QCOMPARE(spy.size(), 1);
+}
+
+void HeadlessEngine_Test::playback()
+{
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    ControlServer server(m_engine->doc());
+    m_engine->start();
+    QCOMPARE(m_engine->doc()->mode(), Doc::Operate);
+
+    OutputPluginStub* stub = outputStub();
+    QCOMPARE(server.command("start 0"), QString("OK\n"));
+    WAIT_FOR(stub->m_array[0] == char(255));
+    QCOMPARE(stub->m_array[0], char(255));
+
+    QCOMPARE(server.command("stop 0"), QString("OK\n"));
+    WAIT_FOR(m_engine->doc()->function(0)->isRunning() == false);
+    QCOMPARE(server.command("start 1"), QString("OK\n"));
+    WAIT_FOR(stub->m_array[0] == char(127));
+    QCOMPARE(stub->m_array[0], char(127));
+
+    m_engine->stop();
+    QCOMPARE(m_engine->doc()->mode(), Doc::Design);
+}
+
+void HeadlessEngine_Test::socket()
+{
+    QVERIFY(m_engine->loadWorkspace(TEST_FILE) == QFile::NoError);
+    ControlServer server(m_engine->doc());
+    QVERIFY(server.listen(TEST_SOCKET) == true);
+
+    QLocalSocket client;
+    client.connectToServer(TEST_SOCKET);
+    QVERIFY(client.waitForConnected(2000) == true);
+
+    /* Two commands in one write get two replies */
+    client.write("list\nstart 42\n");
+    client.flush();
+
+    QByteArray reply;
+    for (int i = 0; i < 200 && reply.count('\n') < 5; i++)
+    {
+        QTest::qWait(10);
+        reply += client.readAll();
+    }
+
+    QCOMPARE(reply, QByteArray("0 Scene Full\n1 Scene Half\n2 Chaser Show\nOK\n"
+                               "ERROR No such function: 42\n"));
+
+    client.disconnectFromServer();
+}
+
+QTEST_MAIN(HeadlessEngine_Test)
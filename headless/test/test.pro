@@ -0,0 +1,24 @@
+include(../../variables.pri)
+include(../../coverage.pri)
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = headlessengine_test
+
+QT      += testlib xml script network
+CONFIG  -= app_bundle
+
+DEPENDPATH   += ../src
+INCLUDEPATH  += ../../plugins/interfaces
+INCLUDEPATH  += ../../engine/src
+INCLUDEPATH  += ../../engine/test/outputpluginstub
+INCLUDEPATH  += ../src
+QMAKE_LIBDIR += ../../engine/src
+LIBS         += -lqlcengine
+
+HEADERS += headlessengine_test.h \
+           ../src/headlessengine.h \
+           ../src/controlserver.h
+
+SOURCES += headlessengine_test.cpp \
+           ../src/headlessengine.cpp \
+           ../src/controlserver.cpp
@@ -59,6 +59,12 @@ int HIDDevice::handle() const
     return m_file.handle();
 }
 
+bool HIDDevice::readyRead(int fd)
+{
+    Q_UNUSED(fd);
+    return readEvent();
+}
+
 /*****************************************************************************
  * Device info
  *****************************************************************************/
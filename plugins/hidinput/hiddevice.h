@@ -25,6 +25,7 @@
 #include <QObject>
 #include <QFile>
 
+#include "qlcioreactor.h"
 
 class HIDInput;
 
@@ -32,7 +33,7 @@ class HIDInput;
  * HIDDevice
  *****************************************************************************/
 
-class HIDDevice : public QObject
+class HIDDevice : public QObject, public QLCIOHandler
 {
     Q_OBJECT
 
@@ -68,10 +69,16 @@ public:
     virtual int handle() const;
 
     /**
-     * Read one event and emit it.
+     * Read all pending events from the (non-blocking) device and post
+     * them to the plugin.
+     *
+     * @return false if the device is dead, otherwise true
      */
     virtual bool readEvent() = 0;
 
+    /** @reimp */
+    bool readyRead(int fd);
+
 protected:
     QFile m_file;
 
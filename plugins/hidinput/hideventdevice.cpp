@@ -20,6 +20,7 @@
 */
 
 #include <linux/input.h>
+#include <unistd.h>
 #include <errno.h>
 
 #include <QApplication>
@@ -39,6 +40,9 @@
  */
 #define test_bit(bit, array)    (array[bit / 8] & (1 << (bit % 8)))
 
+/** Number of events read from the device with one read() call */
+#define KEventBatchSize 64
+
 HIDEventDevice::HIDEventDevice(HIDInput* parent, quint32 line,
                                const QString& path)
         : HIDDevice(parent, line, path)
@@ -238,63 +242,81 @@ QString HIDEventDevice::path() const
 
 bool HIDEventDevice::readEvent()
 {
-    struct input_event ev;
+    struct input_event ev[KEventBatchSize];
     HIDInputEvent* e;
     int r;
 
-    r = read(m_file.handle(), &ev, sizeof(struct input_event));
-    if (r > 0)
+    /* The device is non-blocking and watched in edge-triggered mode, so
+       read everything there is, several events at a time. */
+    while (true)
     {
-        uchar val;
-
-        /* Accept only these kinds of events */
-        if (ev.type != EV_ABS && ev.type != EV_REL &&
-                ev.type != EV_KEY && ev.type != EV_SW)
+        r = read(m_file.handle(), ev, sizeof(ev));
+        if (r > 0)
         {
-            return true;
+            int count = r / sizeof(struct input_event);
+            for (int i = 0; i < count; i++)
+                handleEvent(ev[i]);
         }
-
-        /* Find scaling data */
-        if (m_scales.contains(ev.code) == true)
+        else if (r < 0 && errno == EINTR)
         {
-            /* Scaling data found, this is an abs/rel channel */
-            struct input_absinfo sc;
-
-            sc = m_scales[ev.code];
-
-            /* Scale the device's native value range to
-               0 - UCHAR_MAX:
-               y = (x - from_min) * (to_max / from_range)
-            */
-            val = (ev.value - sc.minimum);
-            val *= (UCHAR_MAX / (sc.maximum - sc.minimum));
+            continue;
+        }
+        else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            /* All pending events have been read */
+            return true;
         }
         else
         {
-            /* Buttons are either fully on or fully off */
-            if (ev.value != 0)
-                val = UCHAR_MAX;
-            else
-                val = 0;
+            e = new HIDInputEvent(this, 0, 0, 0, false);
+            QApplication::postEvent(parent(), e);
+
+            return false;
         }
+    }
+}
 
-        /* Post the event to the global event loop so
-           that we can switch context away from the
-           poller thread and into the main application
-           thread. This is caught in
-           HIDInput::customEvent(). */
-        e = new HIDInputEvent(this, m_line, ev.code, val, true);
-        QApplication::postEvent(parent(), e);
+void HIDEventDevice::handleEvent(const struct input_event& ev)
+{
+    uchar val;
 
-        return true;
+    /* Accept only these kinds of events */
+    if (ev.type != EV_ABS && ev.type != EV_REL &&
+            ev.type != EV_KEY && ev.type != EV_SW)
+    {
+        return;
+    }
+
+    /* Find scaling data */
+    QHash <int, struct input_absinfo>::const_iterator it = m_scales.find(ev.code);
+    if (it != m_scales.end())
+    {
+        /* Scaling data found, this is an abs/rel channel */
+        const struct input_absinfo& sc(it.value());
+
+        /* Scale the device's native value range to
+           0 - UCHAR_MAX:
+           y = (x - from_min) * (to_max / from_range)
+        */
+        val = (ev.value - sc.minimum);
+        val *= (UCHAR_MAX / (sc.maximum - sc.minimum));
     }
     else
     {
-        e = new HIDInputEvent(this, 0, 0, 0, false);
-        QApplication::postEvent(parent(), e);
-
-        return false;
+        /* Buttons are either fully on or fully off */
+        if (ev.value != 0)
+            val = UCHAR_MAX;
+        else
+            val = 0;
     }
+
+    /* Post the event to the global event loop so
+       that we can switch context away from the
+       reactor thread and into the main application
+       thread. This is caught in
+       HIDInput::customEvent(). */
+    HIDInputEvent* e = new HIDInputEvent(this, m_line, ev.code, val, true);
+    QApplication::postEvent(parent(), e);
 }
 
 /*****************************************************************************
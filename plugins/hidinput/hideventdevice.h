@@ -79,6 +79,9 @@ public:
     bool readEvent();
 
 protected:
+    /** Scale a single input event and post it to the plugin */
+    void handleEvent(const struct input_event& ev);
+
     /** Scaling values for absolute/relative axes */
     QHash <int, struct input_absinfo> m_scales;
 
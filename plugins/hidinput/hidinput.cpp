@@ -25,9 +25,10 @@
 #include <QDebug>
 #include <QDir>
 
+#include <fcntl.h>
+
 #include "configurehidinput.h"
 #include "hidjsdevice.h"
-#include "hidpoller.h"
 #include "hidinput.h"
 
 /*****************************************************************************
@@ -56,19 +57,29 @@ HIDInputEvent::~HIDInputEvent()
  * HIDInput Initialization
  *****************************************************************************/
 
+HIDInput::HIDInput()
+    : m_reactor(NULL)
+{
+}
+
 void HIDInput::init()
 {
-    m_poller = new HIDPoller(this);
     rescanDevices();
 }
 
 HIDInput::~HIDInput()
 {
     while (m_devices.isEmpty() == false)
-        delete m_devices.takeFirst();
+    {
+        HIDDevice* dev = m_devices.takeFirst();
+        removePollDevice(dev);
+        delete dev;
+    }
+}
 
-    m_poller->stop();
-    delete m_poller;
+void HIDInput::setIOReactor(QLCIOReactor* reactor)
+{
+    m_reactor = reactor;
 }
 
 QString HIDInput::name()
@@ -289,13 +300,39 @@ void HIDInput::removeDevice(HIDDevice* device)
 void HIDInput::addPollDevice(HIDDevice* device)
 {
     Q_ASSERT(device != NULL);
-    m_poller->addDevice(device);
+
+    if (m_reactor == NULL)
+    {
+        qWarning() << Q_FUNC_INFO << "No I/O reactor. Unable to read"
+                   << device->path();
+        return;
+    }
+
+    /* Already being watched */
+    if (device->handle() != -1)
+        return;
+
+    if (device->open() == false)
+        return;
+
+    /* Devices are watched in edge-triggered mode, so they must not block
+       when HIDDevice::readEvent() drains them */
+    int flags = fcntl(device->handle(), F_GETFL);
+    fcntl(device->handle(), F_SETFL, flags | O_NONBLOCK);
+
+    if (m_reactor->addHandle(device->handle(), device) == false)
+        device->close();
 }
 
 void HIDInput::removePollDevice(HIDDevice* device)
 {
     Q_ASSERT(device != NULL);
-    m_poller->removeDevice(device);
+
+    if (m_reactor != NULL && device->handle() != -1)
+    {
+        m_reactor->removeHandle(device->handle());
+        device->close();
+    }
 }
 
 /*****************************************************************************
@@ -28,7 +28,6 @@
 #include "qlcinplugin.h"
 
 #include "hiddevice.h"
-#include "hidpoller.h"
 
 /*****************************************************************************
  * HIDInputEvent
@@ -58,12 +57,13 @@ class HIDInput : public QLCInPlugin
     Q_INTERFACES(QLCInPlugin)
 
     friend class ConfigureHIDInput;
-    friend class HIDPoller;
 
     /*********************************************************************
      * Initialization
      *********************************************************************/
 public:
+    HIDInput();
+
     /** @reimp */
     void init();
 
@@ -73,6 +73,9 @@ public:
     /** @reimp */
     QString name();
 
+    /** @reimp */
+    void setIOReactor(QLCIOReactor* reactor);
+
     /*********************************************************************
      * Inputs
      *********************************************************************/
@@ -141,11 +144,15 @@ protected:
      * Device poller
      *********************************************************************/
 public:
+    /** Open the device and start watching it for input events */
     void addPollDevice(HIDDevice* device);
+
+    /** Stop watching the device for input events and close it */
     void removePollDevice(HIDDevice* device);
 
 protected:
-    HIDPoller* m_poller;
+    /** Shared I/O reactor that watches the opened devices */
+    QLCIOReactor* m_reactor;
 };
 
 #endif
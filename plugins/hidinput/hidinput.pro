@@ -12,8 +12,7 @@ HEADERS += configurehidinput.h \
            hiddevice.h \
            hideventdevice.h \
            hidinput.h \
-           hidjsdevice.h \
-           hidpoller.h
+           hidjsdevice.h
 
 FORMS += configurehidinput.ui
 
@@ -21,8 +20,7 @@ SOURCES += configurehidinput.cpp \
            hiddevice.cpp \
            hideventdevice.cpp \
            hidinput.cpp \
-           hidjsdevice.cpp \
-           hidpoller.cpp
+           hidjsdevice.cpp
 
 TRANSLATIONS += HID_Input_fi_FI.ts
 TRANSLATIONS += HID_Input_de_DE.ts
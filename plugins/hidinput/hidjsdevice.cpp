@@ -21,6 +21,7 @@
 
 #include <linux/joystick.h>
 #include <linux/input.h>
+#include <unistd.h>
 #include <errno.h>
 
 #include <QApplication>
@@ -33,6 +34,9 @@
 #include "qlcmacros.h"
 #include "hidinput.h"
 
+/** Number of events read from the device with one read() call */
+#define KEventBatchSize 64
+
 HIDJsDevice::HIDJsDevice(HIDInput* parent, quint32 line, const QString& path)
         : HIDDevice(parent, line, path)
 {
@@ -122,54 +126,74 @@ QString HIDJsDevice::path() const
 
 bool HIDJsDevice::readEvent()
 {
-    struct js_event ev;
+    struct js_event ev[KEventBatchSize];
     HIDInputEvent* e;
     int r;
 
-    r = read(m_file.handle(), &ev, sizeof(struct js_event));
-    if (r > 0)
+    /* The device is non-blocking and watched in edge-triggered mode, so
+       read everything there is, several events at a time. */
+    while (true)
     {
-        quint32 ch;
-        uchar val;
-
-        /* Get the event type */
-        if ((ev.type & ~JS_EVENT_INIT) == JS_EVENT_BUTTON)
+        r = read(m_file.handle(), ev, sizeof(ev));
+        if (r > 0)
         {
-            if (ev.value != 0)
-                val = UCHAR_MAX;
-            else
-                val = 0;
-
-            /* Map button channels to start after axes */
-            ch = quint32(m_axes + ev.number);
-
-            /* Generate and post an event */
-            e = new HIDInputEvent(this, m_line, ch, val, true);
-            QApplication::postEvent(parent(), e);
+            int count = r / sizeof(struct js_event);
+            for (int i = 0; i < count; i++)
+                handleEvent(ev[i]);
         }
-        else if ((ev.type & ~JS_EVENT_INIT) == JS_EVENT_AXIS)
+        else if (r < 0 && errno == EINTR)
         {
-            val = SCALE(double(ev.value), double(SHRT_MIN), double(SHRT_MAX),
-                        double(0), double(UCHAR_MAX));
-            ch = quint32(ev.number);
-
-            e = new HIDInputEvent(this, m_line, ch, val, true);
-            QApplication::postEvent(parent(), e);
+            continue;
         }
-        else
+        else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
         {
-            /* Unknown event type */
+            /* All pending events have been read */
+            return true;
         }
+        else
+        {
+            /* This device seems to be dead */
+            e = new HIDInputEvent(this, 0, 0, 0, false);
+            QApplication::postEvent(parent(), e);
 
-        return true;
+            return false;
+        }
     }
-    else
+}
+
+void HIDJsDevice::handleEvent(const struct js_event& ev)
+{
+    HIDInputEvent* e;
+    quint32 ch;
+    uchar val;
+
+    /* Get the event type */
+    if ((ev.type & ~JS_EVENT_INIT) == JS_EVENT_BUTTON)
     {
-        /* This device seems to be dead */
-        e = new HIDInputEvent(this, 0, 0, 0, false);
+        if (ev.value != 0)
+            val = UCHAR_MAX;
+        else
+            val = 0;
+
+        /* Map button channels to start after axes */
+        ch = quint32(m_axes + ev.number);
+
+        /* Generate and post an event */
+        e = new HIDInputEvent(this, m_line, ch, val, true);
         QApplication::postEvent(parent(), e);
+    }
+    else if ((ev.type & ~JS_EVENT_INIT) == JS_EVENT_AXIS)
+    {
+        val = SCALE(double(ev.value), double(SHRT_MIN), double(SHRT_MAX),
+                    double(0), double(UCHAR_MAX));
+        ch = quint32(ev.number);
 
-        return false;
+        e = new HIDInputEvent(this, m_line, ch, val, true);
+        QApplication::postEvent(parent(), e);
+    }
+    else
+    {
+        /* Unknown event type */
     }
 }
 
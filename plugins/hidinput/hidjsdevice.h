@@ -34,6 +34,7 @@
 
 class HIDEventDevice;
 class HIDInput;
+struct js_event;
 
 /*****************************************************************************
  * HIDEventDevice
@@ -71,6 +72,10 @@ public:
     /** @reimp */
     bool readEvent();
 
+protected:
+    /** Scale a single joystick event and post it to the plugin */
+    void handleEvent(const struct js_event& ev);
+
     /*********************************************************************
      * Device info
      *********************************************************************/
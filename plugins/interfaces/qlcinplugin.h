@@ -28,6 +28,8 @@
 #include <QObject>
 #include <climits>
 
+class QLCIOReactor;
+
 /*****************************************************************************
  * InputPlugin
  *****************************************************************************/
@@ -113,6 +115,17 @@ public:
      */
     virtual QString name() = 0;
 
+    /**
+     * Give the plugin access to QLC's shared I/O reactor thread. Plugins
+     * that read their input from file descriptors should register them to
+     * the reactor instead of running their own poller threads. InputMap
+     * calls this method before init() on platforms that have a reactor.
+     * The default implementation does nothing.
+     *
+     * @param reactor The shared reactor (owned by QLC, may be NULL)
+     */
+    virtual void setIOReactor(QLCIOReactor* reactor) { Q_UNUSED(reactor); }
+
     /*************************************************************************
      * Inputs
      *************************************************************************/
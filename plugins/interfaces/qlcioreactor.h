@@ -0,0 +1,98 @@
+/*
+  Q Light Controller
+  qlcioreactor.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCIOREACTOR_H
+#define QLCIOREACTOR_H
+
+/*****************************************************************************
+ * QLCIOHandler
+ *****************************************************************************/
+
+/**
+ * QLCIOHandler should be implemented by such plugin objects that wish to be
+ * notified when a file descriptor registered to QLCIOReactor becomes
+ * readable.
+ */
+class QLCIOHandler
+{
+public:
+    virtual ~QLCIOHandler() {}
+
+    /**
+     * Read all currently available data from the given file descriptor.
+     * This is called from the reactor's thread, so implementations must
+     * not touch the GUI directly; post events to the main thread instead.
+     * Implementations must not call QLCIOReactor::addHandle() or
+     * QLCIOReactor::removeHandle() from within this method.
+     *
+     * For edge-triggered descriptors, the handler MUST read until the
+     * descriptor reports EAGAIN, since it will not be notified again
+     * about data that was already pending.
+     *
+     * @param fd The file descriptor that has become readable
+     * @return false if the descriptor is dead and should not be watched
+     *         anymore, otherwise true
+     */
+    virtual bool readyRead(int fd) = 0;
+};
+
+/*****************************************************************************
+ * QLCIOReactor
+ *****************************************************************************/
+
+/**
+ * QLCIOReactor is a single shared thread that watches file descriptors on
+ * behalf of all input plugins. Instead of running one poller thread per
+ * plugin, plugins register their descriptors with the reactor provided by
+ * QLC thru QLCInPlugin::setIOReactor() and get called back from the
+ * reactor's thread when there is something to read.
+ */
+class QLCIOReactor
+{
+public:
+    virtual ~QLCIOReactor() {}
+
+    /**
+     * Start watching the given file descriptor for input.
+     *
+     * @param fd The file descriptor to watch
+     * @param handler The handler to call when fd becomes readable
+     * @param edgeTriggered If true, handler is notified only when new data
+     *                      arrives (fd must be non-blocking). If false,
+     *                      handler is notified as long as there is unread
+     *                      data in fd.
+     * @return true if successful, otherwise false
+     */
+    virtual bool addHandle(int fd, QLCIOHandler* handler,
+                           bool edgeTriggered = true) = 0;
+
+    /**
+     * Stop watching the given file descriptor. When this method returns,
+     * the handler associated with fd is guaranteed not to be called
+     * anymore, so it can be safely deleted.
+     *
+     * @param fd The file descriptor to stop watching
+     * @return true if fd was being watched, otherwise false
+     */
+    virtual bool removeHandle(int fd) = 0;
+};
+
+#endif
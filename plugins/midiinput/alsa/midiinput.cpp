@@ -37,6 +37,11 @@
  * MIDIInput Initialization
  *****************************************************************************/
 
+MIDIInput::MIDIInput()
+    : m_reactor(NULL)
+{
+}
+
 MIDIInput::~MIDIInput()
 {
     /* Delete the poller. Removes the devices also from the hash table. */
@@ -57,8 +62,8 @@ void MIDIInput::init()
     m_alsa = NULL;
     m_address = NULL;
 
-    /* Create the poller thread */
-    m_poller = new MIDIPoller(this);
+    /* Create the poller that reads events in the shared reactor thread */
+    m_poller = new MIDIPoller(this, m_reactor);
 
     /* Initialize ALSA stuff */
     initALSA();
@@ -84,6 +89,11 @@ QString MIDIInput::name()
     return QString("MIDI Input");
 }
 
+void MIDIInput::setIOReactor(QLCIOReactor* reactor)
+{
+    m_reactor = reactor;
+}
+
 void MIDIInput::slotDeviceAddedRemoved(const QString& name)
 {
     QRegExp re("/org/freedesktop/Hal/devices*_alsa_midi_*");
@@ -53,6 +53,8 @@ class MIDIInput : public QLCInPlugin
      * Initialization
      *********************************************************************/
 public:
+    MIDIInput();
+
     /** @reimp */
     void init();
 
@@ -62,6 +64,9 @@ public:
     /** @reimp */
     QString name();
 
+    /** @reimp */
+    void setIOReactor(QLCIOReactor* reactor);
+
 protected slots:
     /** Listen to HAL device additions/removals */
     void slotDeviceAddedRemoved(const QString& name);
@@ -160,6 +165,9 @@ public:
 
 protected:
     MIDIPoller* m_poller;
+
+    /** Shared I/O reactor that watches the sequencer interface */
+    QLCIOReactor* m_reactor;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include <QEvent>
 #include <QDebug>
 #include <poll.h>
+#include <errno.h>
 
 #include "midiinputevent.h"
 #include "midiprotocol.h"
@@ -30,23 +31,21 @@
 #include "mididevice.h"
 #include "midiinput.h"
 
-#define KPollTimeout 1000
-
 /****************************************************************************
  * Initialization
  ****************************************************************************/
 
-MIDIPoller::MIDIPoller(MIDIInput* parent) : QThread(parent)
+MIDIPoller::MIDIPoller(MIDIInput* parent, QLCIOReactor* reactor)
+    : QObject(parent)
+    , m_reactor(reactor)
 {
     Q_ASSERT(parent != NULL);
-    m_running = false;
-    m_changed = false;
 }
 
 MIDIPoller::~MIDIPoller()
 {
+    unwatch();
     m_devices.clear();
-    stop();
 }
 
 /****************************************************************************
@@ -89,17 +88,14 @@ bool MIDIPoller::addDevice(MIDIDevice* device)
 
     /* Insert the device into the hash map for later retrieval */
     m_devices.insert(hash, device);
-    m_changed = true;
-
-    /* Start the poller thread in case it's not running */
-    if (m_running == false && isRunning() == false)
-    {
-        m_running = true;
-        start();
-    }
 
     m_mutex.unlock();
 
+    /* Start watching the sequencer in case it's not watched yet. This must
+       be done without m_mutex, since the reactor thread might be waiting
+       for it inside readyRead(). */
+    watch();
+
     return true;
 }
 
@@ -113,15 +109,12 @@ bool MIDIPoller::removeDevice(MIDIDevice* device)
 
     hash = addressHash(device->address());
     if (m_devices.remove(hash) > 0)
-    {
         unsubscribeDevice(device);
-        m_changed = true;
-    }
 
     if (m_devices.count() == 0)
     {
         m_mutex.unlock();
-        stop();
+        unwatch();
     }
     else
     {
@@ -181,55 +174,54 @@ void MIDIPoller::unsubscribeDevice(MIDIDevice* device)
 }
 
 /*****************************************************************************
- * Poller thread
+ * Sequencer watching
  *****************************************************************************/
 
-void MIDIPoller::stop()
+void MIDIPoller::watch()
 {
-    m_mutex.lock();
-    m_running = false;
-    m_mutex.unlock();
-
-    wait();
-}
+    MIDIInput* plugin;
 
-void MIDIPoller::run()
-{
-    MIDIInput* plugin = NULL;
-    struct pollfd *pfd = 0;
-    int npfd = 0;
+    if (m_reactor == NULL || m_fds.isEmpty() == false)
+        return;
 
     /* Get the parent plugin pointer */
     plugin = static_cast<MIDIInput*> (parent());
     Q_ASSERT(plugin != NULL);
+    Q_ASSERT(plugin->alsa() != NULL);
 
-    m_mutex.lock();
-
-    while (m_running == true)
+    /* The sequencer's descriptors don't depend on the subscribed devices,
+       so they need to be registered only once. The sequencer is read in
+       blocking mode, so watch it level-triggered. */
+    int npfd = snd_seq_poll_descriptors_count(plugin->alsa(), POLLIN);
+    struct pollfd* pfd = (struct pollfd*) alloca(npfd * sizeof(struct pollfd));
+    npfd = snd_seq_poll_descriptors(plugin->alsa(), pfd, npfd, POLLIN);
+    for (int i = 0; i < npfd; i++)
     {
-        Q_ASSERT(plugin->alsa() != NULL);
+        if (m_reactor->addHandle(pfd[i].fd, this, false) == true)
+            m_fds << pfd[i].fd;
+    }
+}
 
-        if (m_changed == true)
-        {
-            /* Poll descriptors must be re-evaluated When the
-               polled devices hash contents change */
-            npfd = snd_seq_poll_descriptors_count(plugin->alsa(),
-                                                  POLLIN);
-            pfd = (struct pollfd*)
-                  alloca(npfd * sizeof(struct pollfd));
-            snd_seq_poll_descriptors(plugin->alsa(), pfd, npfd,
-                                     POLLIN);
-            m_changed = false;
-        }
+void MIDIPoller::unwatch()
+{
+    if (m_reactor == NULL)
+        return;
 
-        m_mutex.unlock();
-        /* Poll for MIDI events from the polled descriptors */
-        if (poll(pfd, npfd, KPollTimeout) > 0)
-            readEvent(plugin->alsa());
-        m_mutex.lock();
-    }
+    while (m_fds.isEmpty() == false)
+        m_reactor->removeHandle(m_fds.takeFirst());
+}
 
-    m_mutex.unlock();
+bool MIDIPoller::readyRead(int fd)
+{
+    Q_UNUSED(fd);
+
+    MIDIInput* plugin = static_cast<MIDIInput*> (parent());
+    Q_ASSERT(plugin != NULL);
+    Q_ASSERT(plugin->alsa() != NULL);
+
+    readEvent(plugin->alsa());
+
+    return true;
 }
 
 void MIDIPoller::readEvent(snd_seq_t* alsa)
@@ -243,7 +235,17 @@ void MIDIPoller::readEvent(snd_seq_t* alsa)
         MIDIDevice* device = NULL;
 
         /* Receive an event */
-        snd_seq_event_input(alsa, &ev);
+        int r = snd_seq_event_input(alsa, &ev);
+        if (r == -ENOSPC)
+        {
+            /* Input buffer overrun; some events were lost */
+            qWarning() << "ALSA sequencer input overrun";
+            continue;
+        }
+        else if (r < 0 || ev == NULL)
+        {
+            break;
+        }
 
         /* Find a device matching the event's address. If one isn't
            found, skip this event, since we're not interested in it */
@@ -22,25 +22,31 @@
 #ifndef MIDIPOLLER_H
 #define MIDIPOLLER_H
 
-#include <QThread>
+#include <QObject>
 #include <QMutex>
 #include <QHash>
+#include <QList>
 
 #include <alsa/asoundlib.h>
 
+#include "qlcioreactor.h"
+
 class MIDIDevice;
 class MIDIInput;
 
-class MIDIPoller : public QThread
+class MIDIPoller : public QObject, public QLCIOHandler
 {
     Q_OBJECT
 
 public:
     /**
-     * Construct a new MIDIReader thread. The parent object will receive
+     * Construct a new MIDIPoller. The parent object will receive
      * all input events, so it must not be NULL.
+     *
+     * @param parent The plugin that owns the sequencer interface
+     * @param reactor The shared I/O reactor used to watch the sequencer
      */
-    MIDIPoller(MIDIInput* parent);
+    MIDIPoller(MIDIInput* parent, QLCIOReactor* reactor);
 
     /** Destructor */
     virtual ~MIDIPoller();
@@ -69,21 +75,29 @@ protected:
     QHash <quint64, MIDIDevice*> m_devices;
 
     /*********************************************************************
-     * Poller thread
+     * Sequencer watching
      *********************************************************************/
 public:
-    void stop();
+    /** @reimp */
+    bool readyRead(int fd);
 
 protected:
-    /** Poller thread method */
-    void run();
+    /** Start watching the sequencer's poll descriptors in the reactor */
+    void watch();
+
+    /** Stop watching the sequencer's poll descriptors */
+    void unwatch();
 
     /** Read events from the sequencer interface */
     void readEvent(snd_seq_t* alsa);
 
 protected:
-    bool m_running;
-    bool m_changed;
+    QLCIOReactor* m_reactor;
+
+    /** The sequencer's descriptors currently registered to m_reactor */
+    QList <int> m_fds;
+
+    /** Protects m_devices against the reactor thread */
     QMutex m_mutex;
 };
 
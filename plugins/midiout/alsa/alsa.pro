@@ -16,11 +16,13 @@ FORMS += ../common/configuremididevice.ui \
 
 HEADERS += ../common/configuremididevice.h \
            ../common/configuremidiout.h \
+           ../common/midioutscheduler.h \
            mididevice.h \
            midiout.h
 
 SOURCES += ../common/configuremididevice.cpp \
            ../common/configuremidiout.cpp \
+           ../common/midioutscheduler.cpp \
            mididevice.cpp \
            midiout.cpp
 
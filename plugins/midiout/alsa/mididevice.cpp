@@ -19,6 +19,7 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QMutexLocker>
 #include <QSettings>
 #include <QObject>
 #include <QString>
@@ -40,8 +41,6 @@ MIDIDevice::MIDIDevice(MIDIOut* parent, const snd_seq_addr_t* address)
     m_mode = ControlChange;
     m_midiChannel = 0;
 
-    std::fill(m_values, m_values + MAX_MIDI_DMX_CHANNELS, 0);
-
     setAddress(address);
     extractName();
     loadSettings();
@@ -75,6 +74,14 @@ void MIDIDevice::loadSettings()
         setMode(stringToMode(value.toString()));
     else
         setMode(ControlChange);
+
+    /* Attempt to get the bandwidth from settings */
+    key = QString("/midiout/%1/bandwidth").arg(m_name);
+    value = settings.value(key);
+    if (value.isValid() == true)
+        setBandwidth(value.toInt());
+    else
+        setBandwidth(MIDI_DEFAULT_BANDWIDTH);
 }
 
 void MIDIDevice::saveSettings()
@@ -89,6 +96,10 @@ void MIDIDevice::saveSettings()
     /* Store mode to settings */
     key = QString("/midiout/%1/mode").arg(m_name);
     settings.setValue(key, MIDIDevice::modeToString(m_mode));
+
+    /* Store bandwidth to settings */
+    key = QString("/midiout/%1/bandwidth").arg(m_name);
+    settings.setValue(key, bandwidth());
 }
 
 /*****************************************************************************
@@ -134,7 +145,23 @@ QString MIDIDevice::infoText()
         info += tr("MIDI Channel: %1").arg(m_midiChannel + 1);
         info += QString("</B><BR><B>");
         info += tr("Mode: %1").arg(modeToString(m_mode));
-        info += QString("</B>");
+        info += QString("</B><BR>");
+        if (bandwidth() > 0)
+            info += tr("Bandwidth: %1 bytes/s").arg(bandwidth());
+        else
+            info += tr("Bandwidth: Unlimited");
+        info += QString("</P>");
+        info += QString("<P>");
+        m_schedulerMutex.lock();
+        info += tr("Queued values: %1").arg(m_scheduler.queueDepth());
+        info += QString("<BR>");
+        info += tr("Coalesced values: %1").arg(m_scheduler.coalescedCount());
+        info += QString("<BR>");
+        info += tr("Sent messages: %1 (%2 bytes)").arg(m_scheduler.messageCount())
+                                                  .arg(m_scheduler.byteCount());
+        info += QString("<BR>");
+        info += tr("Deferred ticks: %1").arg(m_scheduler.deferredCount());
+        m_schedulerMutex.unlock();
         info += QString("</P>");
     }
     else
@@ -189,6 +216,12 @@ QString MIDIDevice::modeToString(Mode mode)
     case Note:
         return QString("Note Velocity");
         break;
+    case ControlChange14:
+        return QString("Control Change 14-bit");
+        break;
+    case NRPN:
+        return QString("NRPN");
+        break;
     }
 }
 
@@ -196,10 +229,66 @@ MIDIDevice::Mode MIDIDevice::stringToMode(const QString& mode)
 {
     if (mode == QString("Note Velocity"))
         return Note;
+    else if (mode == QString("Control Change 14-bit"))
+        return ControlChange14;
+    else if (mode == QString("NRPN"))
+        return NRPN;
     else
         return ControlChange;
 }
 
+void MIDIDevice::setMode(Mode m)
+{
+    m_mode = m;
+
+    QMutexLocker locker(&m_schedulerMutex);
+
+    switch (m)
+    {
+    default:
+    case ControlChange:
+        m_scheduler.setMode(MIDIOutScheduler::ControlChange);
+        break;
+    case Note:
+        m_scheduler.setMode(MIDIOutScheduler::Note);
+        break;
+    case ControlChange14:
+        m_scheduler.setMode(MIDIOutScheduler::ControlChange14);
+        break;
+    case NRPN:
+        m_scheduler.setMode(MIDIOutScheduler::NRPN);
+        break;
+    }
+}
+
+/*****************************************************************************
+ * MIDI channel
+ *****************************************************************************/
+
+void MIDIDevice::setMidiChannel(quint32 channel)
+{
+    m_midiChannel = channel;
+
+    QMutexLocker locker(&m_schedulerMutex);
+    m_scheduler.setMidiChannel(channel);
+}
+
+/*****************************************************************************
+ * Bandwidth
+ *****************************************************************************/
+
+int MIDIDevice::bandwidth() const
+{
+    QMutexLocker locker(&m_schedulerMutex);
+    return m_scheduler.bandwidth();
+}
+
+void MIDIDevice::setBandwidth(int bytesPerSecond)
+{
+    QMutexLocker locker(&m_schedulerMutex);
+    m_scheduler.setBandwidth(bytesPerSecond);
+}
+
 /****************************************************************************
  * Write
  ****************************************************************************/
@@ -211,6 +300,22 @@ void MIDIDevice::outputDMX(const QByteArray& universe)
     Q_ASSERT(plugin->alsa() != NULL);
     Q_ASSERT(m_address != NULL);
 
+    int elapsed = -1;
+    if (m_tickTime.isValid() == true)
+        elapsed = m_tickTime.restart();
+    else
+        m_tickTime.start();
+
+    /* Queue changed values and take as many as the link can carry
+       during the time that has passed since the previous tick */
+    m_messages.resize(0);
+    m_schedulerMutex.lock();
+    m_scheduler.feed(universe);
+    m_scheduler.takeMessages(elapsed, m_messages);
+    m_schedulerMutex.unlock();
+    if (m_messages.isEmpty() == true)
+        return;
+
     /* Setup a common event structure for all values */
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);
@@ -218,49 +323,29 @@ void MIDIDevice::outputDMX(const QByteArray& universe)
     snd_seq_ev_set_subs(&ev);
     snd_seq_ev_set_direct(&ev);
 
-    /* Since MIDI devices can have only 128 real channels, we don't
-       attempt to write more than that */
-
-    for (unsigned char channel = 0; channel < MAX_MIDI_DMX_CHANNELS;
-            channel++)
+    QVectorIterator <MIDIOutScheduler::Message> it(m_messages);
+    while (it.hasNext() == true)
     {
-        /* Scale 0-255 to 0-127 */
-        char scaled = DMX2MIDI(universe[channel]);
+        const MIDIOutScheduler::Message& msg(it.next());
+        const uchar channel = msg.status & 0x0F;
 
-        /* Since MIDI is so slow, we only send values that are
-           	   actually changed. */
-        if (m_values[channel] == scaled)
-            continue;
-
-        /* Store the changed MIDI value */
-        m_values[channel] = scaled;
-
-        if (mode() == Note)
-        {
-            if (scaled == 0)
-            {
-                /* 0 is sent as a note off command */
-                snd_seq_ev_set_noteoff(&ev, midiChannel(),
-                                       channel, scaled);
-            }
-            else
-            {
-                /* 1-127 is sent as note on command */
-                snd_seq_ev_set_noteon(&ev, midiChannel(),
-                                      channel, scaled);
-            }
-
-            snd_seq_event_output(plugin->alsa(), &ev);
-        }
-        else
+        switch (msg.status & 0xF0)
         {
-            /* Control change */
-            snd_seq_ev_set_controller(&ev, midiChannel(),
-                                      channel, scaled);
-            snd_seq_event_output_buffer(plugin->alsa(), &ev);
+        case MIDI_NOTE_ON:
+            snd_seq_ev_set_noteon(&ev, channel, msg.data1, msg.data2);
+            break;
+        case MIDI_NOTE_OFF:
+            snd_seq_ev_set_noteoff(&ev, channel, msg.data1, msg.data2);
+            break;
+        default:
+        case MIDI_CONTROL_CHANGE:
+            snd_seq_ev_set_controller(&ev, channel, msg.data1, msg.data2);
+            break;
         }
+
+        snd_seq_event_output_buffer(plugin->alsa(), &ev);
     }
 
-    /* Make sure that all values go to the MIDI endpoint */
+    /* Send the whole batch to the MIDI endpoint at once */
     snd_seq_drain_output(plugin->alsa());
 }
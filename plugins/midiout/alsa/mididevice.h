@@ -23,17 +23,20 @@
 #define MIDIDEVICE_H
 
 #include <QObject>
+#include <QVector>
+#include <QMutex>
 #include <QFile>
+#include <QTime>
 
 #include <alsa/asoundlib.h>
 
+#include "midioutscheduler.h"
+
 
 class MIDIDevice;
 class MIDIOut;
 class QString;
 
-#define MAX_MIDI_DMX_CHANNELS 128
-
 /*****************************************************************************
  * MIDIDevice
  *****************************************************************************/
@@ -95,11 +98,16 @@ public:
      *
      * @ControlChange: Use MIDI ControlChange ID's as DMX channels
      * @Note: Use MIDI Note ON/OFF commands as DMX channels
+     * @ControlChange14: Use 14-bit MIDI ControlChange pairs as 16-bit
+     *                   DMX channel pairs (coarse & fine)
+     * @NRPN: Use 14-bit NRPN parameters as 16-bit DMX channel pairs
      */
     enum Mode
     {
         ControlChange,
-        Note
+        Note,
+        ControlChange14,
+        NRPN
     };
 
     /** Get this device's operational mode */
@@ -108,9 +116,7 @@ public:
     }
 
     /** Set this device's operational mode */
-    void setMode(Mode m) {
-        m_mode = m;
-    }
+    void setMode(Mode m);
 
     static QString modeToString(Mode mode);
     static Mode stringToMode(const QString& mode);
@@ -128,13 +134,21 @@ public:
     }
 
     /** Set this device's MIDI channel */
-    void setMidiChannel(quint32 channel) {
-        m_midiChannel = channel;
-    }
+    void setMidiChannel(quint32 channel);
 
 protected:
     quint32 m_midiChannel;
 
+    /*********************************************************************
+     * Bandwidth
+     *********************************************************************/
+public:
+    /** Get the maximum number of bytes per second sent to this device */
+    int bandwidth() const;
+
+    /** Set the maximum number of bytes per second (0 == unlimited) */
+    void setBandwidth(int bytesPerSecond);
+
     /********************************************************************
      * Write
      ********************************************************************/
@@ -144,10 +158,24 @@ public:
 
 protected:
     /**
-     * Cache values since MIDI is so slow that we need to send only those
-     * channels that have actually changed.
+     * MIDI is so slow that only changed values are sent and only as many
+     * of them as the link can carry during one tick. The rest are
+     * coalesced and sent during the following ticks.
      */
-    uchar m_values[MAX_MIDI_DMX_CHANNELS];
+    MIDIOutScheduler m_scheduler;
+
+    /**
+     * Guards m_scheduler. outputDMX() runs in the MasterTimer thread while
+     * the configuration dialog changes the mode, channel and bandwidth and
+     * reads the metrics in the UI thread.
+     */
+    mutable QMutex m_schedulerMutex;
+
+    /** Measures the time between outputDMX() calls for the scheduler */
+    QTime m_tickTime;
+
+    /** Messages taken from the scheduler during a tick (kept allocated) */
+    QVector <MIDIOutScheduler::Message> m_messages;
 };
 
 #endif
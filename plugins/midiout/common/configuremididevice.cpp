@@ -37,6 +37,11 @@ ConfigureMIDIDevice::ConfigureMIDIDevice(QWidget* parent, MIDIDevice* device)
 
     m_modeCombo->addItem(MIDIDevice::modeToString(MIDIDevice::ControlChange));
     m_modeCombo->addItem(MIDIDevice::modeToString(MIDIDevice::Note));
+#if !defined(__APPLE__) && !defined(WIN32)
+    /* High resolution modes are supported only by the ALSA device */
+    m_modeCombo->addItem(MIDIDevice::modeToString(MIDIDevice::ControlChange14));
+    m_modeCombo->addItem(MIDIDevice::modeToString(MIDIDevice::NRPN));
+#endif
 
     m_midiChannelSpin->setValue(device->midiChannel() + 1);
     m_modeCombo->setCurrentIndex(device->mode());
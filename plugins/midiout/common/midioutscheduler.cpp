@@ -0,0 +1,293 @@
+/*
+  Q Light Controller
+  midioutscheduler.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <algorithm>
+#include <climits>
+
+#include "midioutscheduler.h"
+#include "midiprotocol.h"
+#include "qlcmacros.h"
+
+/* Controller numbers used for NRPN parameter selection & data entry */
+#define MIDI_CC_DATA_ENTRY_MSB 6
+#define MIDI_CC_DATA_ENTRY_LSB 38
+#define MIDI_CC_NRPN_LSB       98
+#define MIDI_CC_NRPN_MSB       99
+
+/* LSB controller offset for 14-bit control changes */
+#define MIDI_CC_LSB_OFFSET     32
+
+/*****************************************************************************
+ * Initialization
+ *****************************************************************************/
+
+MIDIOutScheduler::MIDIOutScheduler()
+    : m_mode(ControlChange)
+    , m_midiChannel(0)
+    , m_bandwidth(MIDI_DEFAULT_BANDWIDTH)
+{
+    reset();
+}
+
+MIDIOutScheduler::~MIDIOutScheduler()
+{
+}
+
+void MIDIOutScheduler::reset()
+{
+    std::fill(m_sent, m_sent + MIDI_SCHEDULER_SLOTS, 0);
+    std::fill(m_pending, m_pending + MIDI_SCHEDULER_SLOTS, -1);
+    m_order.clear();
+
+    m_credit = 0;
+    m_lastStatus = -1;
+    m_lastParameter = -1;
+
+    m_coalesced = 0;
+    m_messages = 0;
+    m_bytes = 0;
+    m_deferred = 0;
+}
+
+/*****************************************************************************
+ * Mode
+ *****************************************************************************/
+
+void MIDIOutScheduler::setMode(Mode mode)
+{
+    m_mode = mode;
+    reset();
+}
+
+MIDIOutScheduler::Mode MIDIOutScheduler::mode() const
+{
+    return m_mode;
+}
+
+void MIDIOutScheduler::setMidiChannel(uchar channel)
+{
+    m_midiChannel = channel & 0x0F;
+    reset();
+}
+
+uchar MIDIOutScheduler::midiChannel() const
+{
+    return m_midiChannel;
+}
+
+int MIDIOutScheduler::slotCount() const
+{
+    if (m_mode == ControlChange14)
+        return MIDI_CC_LSB_OFFSET;
+    else
+        return MIDI_SCHEDULER_SLOTS;
+}
+
+/*****************************************************************************
+ * Bandwidth
+ *****************************************************************************/
+
+void MIDIOutScheduler::setBandwidth(int bytesPerSecond)
+{
+    m_bandwidth = MAX(bytesPerSecond, 0);
+    m_credit = 0;
+}
+
+int MIDIOutScheduler::bandwidth() const
+{
+    return m_bandwidth;
+}
+
+/*****************************************************************************
+ * Scheduling
+ *****************************************************************************/
+
+void MIDIOutScheduler::feed(const QByteArray& universe)
+{
+    const uchar* data = reinterpret_cast<const uchar*> (universe.constData());
+    const int size = universe.size();
+    const int slots = slotCount();
+
+    if (m_mode == ControlChange || m_mode == Note)
+    {
+        /* One DMX channel per slot, scaled to 0-127 */
+        for (int slot = 0; slot < slots && slot < size; slot++)
+            setSlotValue(slot, static_cast<uchar> (DMX2MIDI(data[slot])));
+    }
+    else
+    {
+        /* Two DMX channels (coarse & fine) per slot, scaled to 0-16383 */
+        for (int slot = 0; slot < slots && (slot * 2) < size; slot++)
+        {
+            int coarse = data[slot * 2];
+            int fine = ((slot * 2) + 1 < size) ? data[(slot * 2) + 1] : 0;
+            setSlotValue(slot, ((coarse << 8) | fine) >> 2);
+        }
+    }
+}
+
+void MIDIOutScheduler::takeMessages(int elapsed, QVector <Message>& messages)
+{
+    if (m_bandwidth > 0)
+    {
+        /* Credit is kept in byte-milliseconds to avoid rounding errors */
+        const qint64 maxCredit = qint64(m_bandwidth) * MIDI_MAX_BURST_MS;
+        if (elapsed < 0)
+            m_credit = maxCredit;
+        else
+            m_credit = MIN(m_credit + qint64(m_bandwidth) * elapsed, maxCredit);
+    }
+
+    while (m_order.isEmpty() == false)
+    {
+        if (m_bandwidth > 0 && m_credit <= 0)
+        {
+            /* Out of budget, the rest are sent during the next tick(s) */
+            m_deferred++;
+            break;
+        }
+
+        const int slot = m_order.takeFirst();
+        const int value = m_pending[slot];
+        Q_ASSERT(value >= 0);
+
+        m_pending[slot] = -1;
+        m_sent[slot] = value;
+
+        const int cost = encodeSlot(slot, value, messages);
+        m_credit -= qint64(cost) * 1000;
+        m_bytes += cost;
+    }
+}
+
+void MIDIOutScheduler::setSlotValue(int slot, int value)
+{
+    Q_ASSERT(slot >= 0 && slot < MIDI_SCHEDULER_SLOTS);
+
+    if (m_pending[slot] != -1)
+    {
+        if (m_pending[slot] == value)
+            return;
+
+        /* The pending value is never sent */
+        m_coalesced++;
+
+        if (m_sent[slot] == value)
+        {
+            /* Changed back to what the device already has */
+            m_pending[slot] = -1;
+            m_order.removeOne(slot);
+        }
+        else
+        {
+            m_pending[slot] = value;
+        }
+    }
+    else if (m_sent[slot] != value)
+    {
+        m_pending[slot] = value;
+        m_order.append(slot);
+    }
+}
+
+int MIDIOutScheduler::encodeSlot(int slot, int value, QVector <Message>& messages)
+{
+    const uchar cc = MIDI_CONTROL_CHANGE | m_midiChannel;
+    int cost = 0;
+
+    switch (m_mode)
+    {
+    default:
+    case ControlChange:
+        cost += appendMessage(cc, slot, value, messages);
+        break;
+    case Note:
+        /* 0 is sent as note off, 1-127 as note on */
+        if (value == 0)
+            cost += appendMessage(MIDI_NOTE_OFF | m_midiChannel, slot, 0, messages);
+        else
+            cost += appendMessage(MIDI_NOTE_ON | m_midiChannel, slot, value, messages);
+        break;
+    case ControlChange14:
+        cost += appendMessage(cc, slot, (value >> 7) & 0x7F, messages);
+        cost += appendMessage(cc, slot + MIDI_CC_LSB_OFFSET, value & 0x7F, messages);
+        break;
+    case NRPN:
+        /* Parameter number needs to be selected only when it changes */
+        if (m_lastParameter != slot)
+        {
+            cost += appendMessage(cc, MIDI_CC_NRPN_MSB, (slot >> 7) & 0x7F, messages);
+            cost += appendMessage(cc, MIDI_CC_NRPN_LSB, slot & 0x7F, messages);
+            m_lastParameter = slot;
+        }
+
+        cost += appendMessage(cc, MIDI_CC_DATA_ENTRY_MSB, (value >> 7) & 0x7F, messages);
+        cost += appendMessage(cc, MIDI_CC_DATA_ENTRY_LSB, value & 0x7F, messages);
+        break;
+    }
+
+    return cost;
+}
+
+int MIDIOutScheduler::appendMessage(uchar status, uchar data1, uchar data2,
+                                    QVector <Message>& messages)
+{
+    Message msg;
+    msg.status = status;
+    msg.data1 = data1;
+    msg.data2 = data2;
+    messages.append(msg);
+    m_messages++;
+
+    /* Running status: repeated status bytes are omitted on the wire */
+    int cost = (m_lastStatus == int(status)) ? 2 : 3;
+    m_lastStatus = status;
+    return cost;
+}
+
+/*****************************************************************************
+ * Metrics
+ *****************************************************************************/
+
+int MIDIOutScheduler::queueDepth() const
+{
+    return m_order.size();
+}
+
+quint64 MIDIOutScheduler::coalescedCount() const
+{
+    return m_coalesced;
+}
+
+quint64 MIDIOutScheduler::messageCount() const
+{
+    return m_messages;
+}
+
+quint64 MIDIOutScheduler::byteCount() const
+{
+    return m_bytes;
+}
+
+quint64 MIDIOutScheduler::deferredCount() const
+{
+    return m_deferred;
+}
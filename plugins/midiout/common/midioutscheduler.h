@@ -0,0 +1,200 @@
+/*
+  Q Light Controller
+  midioutscheduler.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef MIDIOUTSCHEDULER_H
+#define MIDIOUTSCHEDULER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+
+/** Number of MIDI controls (CC, note or NRPN parameter) that can be mapped */
+#define MIDI_SCHEDULER_SLOTS 128
+
+/** Default bandwidth: 31250 baud, 10 bits per byte */
+#define MIDI_DEFAULT_BANDWIDTH 3125
+
+/** Maximum amount of unused bandwidth (in ms) that can be saved for a burst */
+#define MIDI_MAX_BURST_MS 40
+
+/**
+ * MIDIOutScheduler converts DMX universes into MIDI channel messages without
+ * exceeding the bandwidth of the MIDI link.
+ *
+ * Every MIDI control is a "slot" that holds at most one pending value. When
+ * a slot's value changes again before it has been sent, the pending value
+ * is simply replaced (latest value wins) and the overwritten value is counted
+ * as coalesced. Pending slots are sent in the order they became pending, as
+ * long as the tick's byte budget allows. Byte cost is calculated with MIDI
+ * running status in mind, i.e. consecutive messages with the same status
+ * byte cost only two bytes each.
+ */
+class MIDIOutScheduler
+{
+    /*********************************************************************
+     * Initialization
+     *********************************************************************/
+public:
+    MIDIOutScheduler();
+    ~MIDIOutScheduler();
+
+    /** Forget all pending and sent values and reset metrics */
+    void reset();
+
+    /*********************************************************************
+     * Mode
+     *********************************************************************/
+public:
+    /**
+     * @ControlChange: DMX channels 1-128 are sent as 7-bit CC 0-127
+     * @Note: DMX channels 1-128 are sent as note velocities 0-127
+     * @ControlChange14: DMX channel pairs 1-64 (coarse, fine) are sent as
+     *                   14-bit CC pairs 0-31 (MSB) & 32-63 (LSB)
+     * @NRPN: DMX channel pairs 1-256 (coarse, fine) are sent as 14-bit
+     *        NRPN parameters 0-127
+     */
+    enum Mode
+    {
+        ControlChange,
+        Note,
+        ControlChange14,
+        NRPN
+    };
+
+    /** Set the scheduler's mode. Resets all pending and sent values. */
+    void setMode(Mode mode);
+
+    /** Get the scheduler's mode */
+    Mode mode() const;
+
+    /** Set the MIDI channel (0-15) that all messages are sent to */
+    void setMidiChannel(uchar channel);
+
+    /** Get the MIDI channel (0-15) that all messages are sent to */
+    uchar midiChannel() const;
+
+    /** Get the number of slots that are used in the current mode */
+    int slotCount() const;
+
+private:
+    Mode m_mode;
+    uchar m_midiChannel;
+
+    /*********************************************************************
+     * Bandwidth
+     *********************************************************************/
+public:
+    /** Set the link bandwidth in bytes per second. 0 means unlimited. */
+    void setBandwidth(int bytesPerSecond);
+
+    /** Get the link bandwidth in bytes per second (0 == unlimited) */
+    int bandwidth() const;
+
+private:
+    int m_bandwidth;
+
+    /** Unused byte budget carried over from previous ticks */
+    qint64 m_credit;
+
+    /*********************************************************************
+     * Scheduling
+     *********************************************************************/
+public:
+    /** A single three-byte MIDI channel message */
+    struct Message
+    {
+        uchar status;
+        uchar data1;
+        uchar data2;
+    };
+
+    /**
+     * Queue the values of the given DMX universe. Values that equal what
+     * has already been sent are not queued; values that replace a pending
+     * value are coalesced.
+     */
+    void feed(const QByteArray& universe);
+
+    /**
+     * Take as many pending messages as the budget for $elapsed
+     * milliseconds allows. Slots that don't fit stay pending for the next
+     * tick. Negative $elapsed means the time is unknown and a full burst
+     * is allowed.
+     *
+     * @param elapsed Milliseconds since the previous call
+     * @param messages Receives the messages to send, in order
+     */
+    void takeMessages(int elapsed, QVector <Message>& messages);
+
+private:
+    /** Set a new value for the given slot */
+    void setSlotValue(int slot, int value);
+
+    /** Append the messages for a slot and return their cost in bytes */
+    int encodeSlot(int slot, int value, QVector <Message>& messages);
+
+    /** Append a single message and return its cost in bytes */
+    int appendMessage(uchar status, uchar data1, uchar data2,
+                      QVector <Message>& messages);
+
+private:
+    /** Values last handed out by takeMessages() */
+    int m_sent[MIDI_SCHEDULER_SLOTS];
+
+    /** Pending values, -1 if a slot has nothing pending */
+    int m_pending[MIDI_SCHEDULER_SLOTS];
+
+    /** Pending slots in the order they became pending */
+    QList <int> m_order;
+
+    /** Status byte of the last message, for running status calculation */
+    int m_lastStatus;
+
+    /** The last NRPN parameter that was selected, -1 if unknown */
+    int m_lastParameter;
+
+    /*********************************************************************
+     * Metrics
+     *********************************************************************/
+public:
+    /** Number of slots currently waiting for bandwidth */
+    int queueDepth() const;
+
+    /** Number of values that were replaced by a newer one before sending */
+    quint64 coalescedCount() const;
+
+    /** Number of MIDI messages handed out by takeMessages() */
+    quint64 messageCount() const;
+
+    /** Number of bytes (with running status) handed out so far */
+    quint64 byteCount() const;
+
+    /** Number of ticks that left something pending due to the budget */
+    quint64 deferredCount() const;
+
+private:
+    quint64 m_coalesced;
+    quint64 m_messages;
+    quint64 m_bytes;
+    quint64 m_deferred;
+};
+
+#endif
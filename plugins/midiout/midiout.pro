@@ -2,3 +2,4 @@ TEMPLATE            = subdirs
 unix:!macx:SUBDIRS += alsa
 macx:SUBDIRS       += macx
 win32:SUBDIRS      += win32
+SUBDIRS            += test
@@ -0,0 +1,268 @@
+/*
+  Q Light Controller
+  midioutscheduler_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "midioutscheduler_test.h"
+#include "midioutscheduler.h"
+#include "midiprotocol.h"
+
+typedef QVector <MIDIOutScheduler::Message> MessageVector;
+
+static void compareMessage(const MIDIOutScheduler::Message& msg,
+                           uchar status, uchar data1, uchar data2)
+{
+    QCOMPARE(msg.status, status);
+    QCOMPARE(msg.data1, data1);
+    QCOMPARE(msg.data2, data2);
+}
+
+void MIDIOutScheduler_Test::initial()
+{
+    MIDIOutScheduler sch;
+    QCOMPARE(sch.mode(), MIDIOutScheduler::ControlChange);
+    QCOMPARE(sch.midiChannel(), uchar(0));
+    QCOMPARE(sch.bandwidth(), MIDI_DEFAULT_BANDWIDTH);
+    QCOMPARE(sch.slotCount(), MIDI_SCHEDULER_SLOTS);
+    QCOMPARE(sch.queueDepth(), 0);
+    QCOMPARE(sch.coalescedCount(), quint64(0));
+    QCOMPARE(sch.messageCount(), quint64(0));
+    QCOMPARE(sch.byteCount(), quint64(0));
+    QCOMPARE(sch.deferredCount(), quint64(0));
+
+    MessageVector msgs;
+    sch.takeMessages(-1, msgs);
+    QCOMPARE(msgs.size(), 0);
+}
+
+void MIDIOutScheduler_Test::controlChange()
+{
+    MIDIOutScheduler sch;
+    sch.setMidiChannel(3);
+    sch.setBandwidth(0);
+
+    QByteArray uni(512, 0);
+    uni[0] = (char) 255;
+    uni[5] = (char) 128;
+    uni[200] = (char) 255; // Beyond slots
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 2);
+
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 2);
+    compareMessage(msgs[0], MIDI_CONTROL_CHANGE | 3, 0, 127);
+    compareMessage(msgs[1], MIDI_CONTROL_CHANGE | 3, 5, 63);
+
+    /* Running status: 3 + 2 bytes */
+    QCOMPARE(sch.byteCount(), quint64(5));
+    QCOMPARE(sch.messageCount(), quint64(2));
+    QCOMPARE(sch.queueDepth(), 0);
+}
+
+void MIDIOutScheduler_Test::note()
+{
+    MIDIOutScheduler sch;
+    sch.setMode(MIDIOutScheduler::Note);
+    sch.setBandwidth(0);
+
+    QByteArray uni(128, 0);
+    uni[10] = (char) 255;
+    sch.feed(uni);
+
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 1);
+    compareMessage(msgs[0], MIDI_NOTE_ON, 10, 127);
+
+    uni[10] = 0;
+    sch.feed(uni);
+    msgs.clear();
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 1);
+    compareMessage(msgs[0], MIDI_NOTE_OFF, 10, 0);
+}
+
+void MIDIOutScheduler_Test::controlChange14()
+{
+    MIDIOutScheduler sch;
+    sch.setMode(MIDIOutScheduler::ControlChange14);
+    sch.setBandwidth(0);
+    QCOMPARE(sch.slotCount(), 32);
+
+    QByteArray uni(512, 0);
+    uni[2] = (char) 0xFF; // Slot 1 coarse
+    uni[3] = (char) 0xFF; // Slot 1 fine
+    uni[62] = (char) 0x80; // Slot 31 coarse
+    uni[64] = (char) 0xFF; // Beyond slots
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 2);
+
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 4);
+    compareMessage(msgs[0], MIDI_CONTROL_CHANGE, 1, 0x7F);
+    compareMessage(msgs[1], MIDI_CONTROL_CHANGE, 33, 0x7F);
+    compareMessage(msgs[2], MIDI_CONTROL_CHANGE, 31, 0x40);
+    compareMessage(msgs[3], MIDI_CONTROL_CHANGE, 63, 0x00);
+}
+
+void MIDIOutScheduler_Test::nrpn()
+{
+    MIDIOutScheduler sch;
+    sch.setMode(MIDIOutScheduler::NRPN);
+    sch.setMidiChannel(1);
+    sch.setBandwidth(0);
+
+    QByteArray uni(512, 0);
+    uni[20] = (char) 0x12; // Parameter 10 coarse
+    uni[21] = (char) 0x34; // Parameter 10 fine
+    sch.feed(uni);
+
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 4);
+    int value = 0x1234 >> 2;
+    compareMessage(msgs[0], MIDI_CONTROL_CHANGE | 1, 99, 0);
+    compareMessage(msgs[1], MIDI_CONTROL_CHANGE | 1, 98, 10);
+    compareMessage(msgs[2], MIDI_CONTROL_CHANGE | 1, 6, value >> 7);
+    compareMessage(msgs[3], MIDI_CONTROL_CHANGE | 1, 38, value & 0x7F);
+
+    /* The same parameter is not selected again */
+    uni[20] = (char) 0xFF;
+    sch.feed(uni);
+    msgs.clear();
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 2);
+    QCOMPARE(msgs[0].data1, uchar(6));
+    QCOMPARE(msgs[1].data1, uchar(38));
+}
+
+void MIDIOutScheduler_Test::unchangedNotQueued()
+{
+    MIDIOutScheduler sch;
+    sch.setBandwidth(0);
+
+    QByteArray uni(512, 0);
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 0);
+
+    uni[1] = 100;
+    sch.feed(uni);
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 1);
+
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 0);
+    msgs.clear();
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 0);
+}
+
+void MIDIOutScheduler_Test::coalesce()
+{
+    MIDIOutScheduler sch;
+    sch.setBandwidth(0);
+
+    QByteArray uni(512, 0);
+    uni[1] = 100;
+    sch.feed(uni);
+    uni[1] = 50;
+    sch.feed(uni);
+    uni[1] = (char) 255;
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 1);
+    QCOMPARE(sch.coalescedCount(), quint64(2));
+
+    /* Only the latest value is sent */
+    MessageVector msgs;
+    sch.takeMessages(20, msgs);
+    QCOMPARE(msgs.size(), 1);
+    compareMessage(msgs[0], MIDI_CONTROL_CHANGE, 1, 127);
+
+    /* Changing back to the sent value cancels the pending value */
+    uni[1] = 0;
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 1);
+    uni[1] = (char) 255;
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 0);
+    QCOMPARE(sch.coalescedCount(), quint64(3));
+}
+
+void MIDIOutScheduler_Test::bandwidth()
+{
+    MIDIOutScheduler sch;
+    sch.setBandwidth(1000); // 1 byte per ms
+    QCOMPARE(sch.bandwidth(), 1000);
+
+    QByteArray uni(512, 0);
+    for (int i = 0; i < 128; i++)
+        uni[i] = (char) 255;
+    sch.feed(uni);
+    QCOMPARE(sch.queueDepth(), 128);
+
+    /* 10ms == 10 bytes: 3 + 2 + 2 + 2 + 2 */
+    MessageVector msgs;
+    sch.takeMessages(10, msgs);
+    QCOMPARE(msgs.size(), 5);
+    QCOMPARE(sch.queueDepth(), 123);
+    QCOMPARE(sch.deferredCount(), quint64(1));
+    QCOMPARE(msgs[0].data1, uchar(0));
+    QCOMPARE(msgs[4].data1, uchar(4));
+
+    /* The one byte overdraft is paid back first; slots are sent in order */
+    msgs.clear();
+    sch.takeMessages(10, msgs);
+    QCOMPARE(msgs.size(), 5);
+    QCOMPARE(msgs[0].data1, uchar(5));
+
+    /* Unused time can only be saved up to MIDI_MAX_BURST_MS */
+    msgs.clear();
+    sch.takeMessages(100000, msgs);
+    QCOMPARE(msgs.size(), MIDI_MAX_BURST_MS / 2);
+
+    /* Unknown elapsed time allows a full burst */
+    msgs.clear();
+    sch.takeMessages(-1, msgs);
+    QCOMPARE(msgs.size(), MIDI_MAX_BURST_MS / 2);
+}
+
+void MIDIOutScheduler_Test::unlimited()
+{
+    MIDIOutScheduler sch;
+    sch.setBandwidth(0);
+    QCOMPARE(sch.bandwidth(), 0);
+    sch.setBandwidth(-5);
+    QCOMPARE(sch.bandwidth(), 0);
+
+    QByteArray uni(512, (char) 255);
+    sch.feed(uni);
+
+    MessageVector msgs;
+    sch.takeMessages(0, msgs);
+    QCOMPARE(msgs.size(), 128);
+    QCOMPARE(sch.queueDepth(), 0);
+    QCOMPARE(sch.deferredCount(), quint64(0));
+}
+
+QTEST_MAIN(MIDIOutScheduler_Test)
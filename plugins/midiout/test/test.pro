@@ -0,0 +1,20 @@
+include(../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = midiout_test
+
+QT      += core testlib
+QT      -= gui
+
+INCLUDEPATH += ../common
+INCLUDEPATH += ../../interfaces
+DEPENDPATH  += ../common
+
+# Test sources
+HEADERS += midioutscheduler_test.h
+SOURCES += midioutscheduler_test.cpp
+
+# Tested sources
+HEADERS += ../common/midioutscheduler.h
+SOURCES += ../common/midioutscheduler.cpp
@@ -19,7 +19,9 @@ win32: {
 }
 
 HEADERS += vellemanout.h
+HEADERS += vellemanoutthread.h
 SOURCES += vellemanout.cpp
+SOURCES += vellemanoutthread.cpp
 HEADERS += ../../interfaces/qlcoutplugin.h
 
 TRANSLATIONS += Velleman_Output_fi_FI.ts
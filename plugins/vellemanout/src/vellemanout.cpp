@@ -24,14 +24,22 @@
 #include <QString>
 #include <QDebug>
 #include <QFile>
+#include <cstring>
 
 #ifdef WIN32
 #   include <windows.h>
 #endif
 
+#include "vellemanoutthread.h"
 #include "vellemanout.h"
 #include "qlcmacros.h"
 
+/** Maximum number of channels supported by the K8062D */
+#define VELLEMAN_CHANNELS 512
+
+/** Number of channels compared (and widened) at a time in writeFrame() */
+#define VELLEMAN_BLOCK 16
+
 /*****************************************************************************
  * The Velleman interface for k8062d.dll
  *****************************************************************************/
@@ -59,8 +67,13 @@ VellemanOut::~VellemanOut()
 
 void VellemanOut::init()
 {
-    m_values = new qint32[512];
+    m_values = new qint32[VELLEMAN_CHANNELS];
+    std::memset(m_values, 0, VELLEMAN_CHANNELS * sizeof(qint32));
     m_currentlyOpen = false;
+    m_thread = NULL;
+    m_pendingChanged = false;
+    m_abortWait = false;
+    m_channelCount = -1;
 }
 
 QString VellemanOut::name()
@@ -81,6 +94,16 @@ void VellemanOut::open(quint32 output)
     {
         StartDevice();
         m_currentlyOpen = true;
+
+        /* Force the first frame through to the device */
+        m_pending.clear();
+        m_pendingChanged = false;
+        m_abortWait = false;
+        m_frame.clear();
+        m_channelCount = -1;
+
+        m_thread = new VellemanOutThread(this);
+        m_thread->start(QThread::TimeCriticalPriority);
     }
 }
 
@@ -92,6 +115,11 @@ void VellemanOut::close(quint32 output)
     if (m_currentlyOpen == true)
     {
         m_currentlyOpen = false;
+
+        /* Let the writer thread finish before stopping the device */
+        delete m_thread;
+        m_thread = NULL;
+
         StopDevice();
     }
 }
@@ -137,10 +165,72 @@ void VellemanOut::outputDMX(quint32 output, const QByteArray& universe)
     if (output != 0 || m_currentlyOpen == false)
         return;
 
-    SetChannelCount((int32_t) universe.size());
-    for (int i = 0; i < universe.size(); i++)
-        m_values[i] = (qint32) universe[i];
+    QMutexLocker locker(&m_pendingMutex);
+
+    /* Nothing to do if the frame is identical to the previous one */
+    if (m_pending == universe)
+        return;
+
+    m_pending = universe;
+    m_pendingChanged = true;
+    m_pendingCondition.wakeOne();
+}
+
+/*****************************************************************************
+ * Writer thread
+ *****************************************************************************/
+
+bool VellemanOut::waitFrame(QByteArray& frame)
+{
+    QMutexLocker locker(&m_pendingMutex);
+
+    while (m_pendingChanged == false && m_abortWait == false)
+        m_pendingCondition.wait(&m_pendingMutex);
+
+    if (m_abortWait == true)
+        return false;
+
+    frame = m_pending;
+    m_pendingChanged = false;
+    return true;
+}
+
+void VellemanOut::abortFrameWait()
+{
+    QMutexLocker locker(&m_pendingMutex);
+    m_abortWait = true;
+    m_pendingCondition.wakeAll();
+}
+
+void VellemanOut::writeFrame(const QByteArray& frame)
+{
+    const qint32 count = MIN(frame.size(), VELLEMAN_CHANNELS);
+    const uchar* data = reinterpret_cast<const uchar*> (frame.constData());
+
+    /* Channel count changes practically never, so don't repeat it */
+    if (count != m_channelCount)
+    {
+        SetChannelCount((int32_t) count);
+        m_channelCount = count;
+        m_frame.clear();
+    }
+
+    /* Widen only those blocks that have changed since the previous frame.
+       The inner loop has no dependencies so the compiler can unpack it
+       with vector instructions. */
+    const uchar* prev = reinterpret_cast<const uchar*> (m_frame.constData());
+    const bool full = (m_frame.size() != count);
+    for (qint32 i = 0; i < count; i += VELLEMAN_BLOCK)
+    {
+        const qint32 len = MIN(VELLEMAN_BLOCK, count - i);
+        if (full == true || std::memcmp(data + i, prev + i, len) != 0)
+        {
+            for (qint32 j = i; j < i + len; j++)
+                m_values[j] = (qint32) data[j];
+        }
+    }
 
+    m_frame = frame.left(count);
     SetAllData((int32_t*) m_values);
 }
 
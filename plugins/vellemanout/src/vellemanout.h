@@ -22,11 +22,16 @@
 #ifndef VELLEMANOUT_H
 #define VELLEMANOUT_H
 
+#include <QWaitCondition>
+#include <QByteArray>
 #include <QString>
+#include <QMutex>
 
 #include "qlcoutplugin.h"
 #include "qlcmacros.h"
 
+class VellemanOutThread;
+
 class QLC_DECLSPEC VellemanOut : public QLCOutPlugin
 {
     Q_OBJECT
@@ -68,6 +73,48 @@ protected:
     bool m_currentlyOpen;
     qint32* m_values;
 
+    /*************************************************************************
+     * Writer thread
+     *************************************************************************/
+public:
+    /**
+     * Wait until outputDMX() queues a new frame and copy it to $frame.
+     * Called only from VellemanOutThread.
+     *
+     * @param frame Receives the latest queued frame
+     * @return true if a frame was received, false if the thread should quit
+     */
+    bool waitFrame(QByteArray& frame);
+
+    /** Wake up and terminate a pending waitFrame() call */
+    void abortFrameWait();
+
+    /**
+     * Write the given frame to the device. Channel count is set only when
+     * it changes and only those channel blocks that differ from the
+     * previously written frame are widened into m_values.
+     * Called only from VellemanOutThread.
+     */
+    void writeFrame(const QByteArray& frame);
+
+protected:
+    VellemanOutThread* m_thread;
+
+    /** Protects m_pending, m_pendingChanged & m_abortWait */
+    QMutex m_pendingMutex;
+    QWaitCondition m_pendingCondition;
+
+    /** The latest frame given to outputDMX() */
+    QByteArray m_pending;
+    bool m_pendingChanged;
+    bool m_abortWait;
+
+    /** The frame that was last written to the device (writer thread only) */
+    QByteArray m_frame;
+
+    /** The channel count last given to SetChannelCount(), -1 if none */
+    qint32 m_channelCount;
+
     /*************************************************************************
      * Configuration
      *************************************************************************/
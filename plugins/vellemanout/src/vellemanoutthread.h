@@ -0,0 +1,53 @@
+/*
+  Q Light Controller
+  vellemanoutthread.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef VELLEMANOUTTHREAD_H
+#define VELLEMANOUTTHREAD_H
+
+#include <QThread>
+
+class VellemanOut;
+
+/**
+ * Writer thread that feeds frames queued by VellemanOut::outputDMX() to the
+ * K8062D library so that the latency of the vendor calls never stalls the
+ * MasterTimer.
+ */
+class VellemanOutThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    VellemanOutThread(VellemanOut* plugin);
+    virtual ~VellemanOutThread();
+
+    /** Stop the writer thread and wait until it has finished */
+    void stop();
+
+protected:
+    /** DMX writer thread worker method */
+    void run();
+
+protected:
+    VellemanOut* m_plugin;
+};
+
+#endif
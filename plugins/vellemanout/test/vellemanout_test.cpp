@@ -45,18 +45,32 @@ extern "C"
     }
 
     static int _ChannelCount = 0;
+    static int _SetChannelCountCalled = 0;
     void SetChannelCount(int32_t Count)
     {
         _ChannelCount = Count;
+        _SetChannelCountCalled++;
     }
 
     static int* _SetAllData = NULL;
+    static int _SetAllDataCalled = 0;
     void SetAllData(int32_t Data[])
     {
         _SetAllData = Data;
+        _SetAllDataCalled++;
     }
 }
 
+/** Wait until the writer thread has called SetAllData() $calls times */
+static bool waitSetAllData(int calls)
+{
+    QTime time;
+    time.start();
+    while (_SetAllDataCalled < calls && time.elapsed() < 2000)
+        QTest::qWait(5);
+    return (_SetAllDataCalled == calls);
+}
+
 /****************************************************************************
  * VellemanOut tests
  ****************************************************************************/
@@ -67,6 +81,8 @@ void VellemanOut_Test::initial()
     vo.init();
     QVERIFY(vo.m_currentlyOpen == false);
     QVERIFY(vo.m_values != NULL);
+    QVERIFY(vo.m_thread == NULL);
+    QCOMPARE(vo.m_channelCount, -1);
     QCOMPARE(vo.name(), QString("Velleman Output"));
     QCOMPARE(vo.outputs(), QStringList() << "1: Velleman Device");
     QVERIFY(vo.canConfigure() == false);
@@ -87,6 +103,8 @@ void VellemanOut_Test::openClose()
 
     vo.open(0);
     QVERIFY(vo.m_currentlyOpen == true);
+    QVERIFY(vo.m_thread != NULL);
+    QVERIFY(vo.m_thread->isRunning() == true);
     QCOMPARE(_StartDeviceCalled, 1);
     QCOMPARE(_StopDeviceCalled, 0);
 
@@ -104,6 +122,7 @@ void VellemanOut_Test::openClose()
 
     vo.close(0);
     QVERIFY(vo.m_currentlyOpen == false);
+    QVERIFY(vo.m_thread == NULL);
     QCOMPARE(_StartDeviceCalled, 1);
     QCOMPARE(_StopDeviceCalled, 1);
 
@@ -143,6 +162,8 @@ void VellemanOut_Test::outputDMX()
 
     _StartDeviceCalled = 0;
     _StopDeviceCalled = 0;
+    _SetChannelCountCalled = 0;
+    _SetAllDataCalled = 0;
 
     QByteArray data(512, (char) 0);
     data[1] = 63;
@@ -160,6 +181,7 @@ void VellemanOut_Test::outputDMX()
     QVERIFY(_SetAllData == NULL);
 
     vo.outputDMX(0, data);
+    QVERIFY(waitSetAllData(1) == true);
     QVERIFY(_ChannelCount == data.size());
     QVERIFY(_SetAllData != NULL);
     QCOMPARE(_SetAllData[0], 0);
@@ -175,4 +197,56 @@ void VellemanOut_Test::outputDMX()
     QCOMPARE(_SetAllData[511], 96);
 }
 
+void VellemanOut_Test::outputUnchanged()
+{
+    VellemanOut vo;
+    vo.init();
+
+    _SetChannelCountCalled = 0;
+    _SetAllDataCalled = 0;
+
+    QByteArray data(512, (char) 0);
+    data[0] = 1;
+    data[300] = (char) 255;
+
+    vo.open(0);
+    vo.outputDMX(0, data);
+    QVERIFY(waitSetAllData(1) == true);
+    QCOMPARE(_SetChannelCountCalled, 1);
+    QCOMPARE(_SetAllData[0], 1);
+    QCOMPARE(_SetAllData[300], 255);
+
+    // Identical frames must not reach the device at all
+    vo.outputDMX(0, data);
+    vo.outputDMX(0, data);
+    QTest::qWait(50);
+    QCOMPARE(_SetAllDataCalled, 1);
+
+    // Only changed values are updated, channel count is not set again
+    data[300] = (char) 128;
+    data[511] = 7;
+    vo.outputDMX(0, data);
+    QVERIFY(waitSetAllData(2) == true);
+    QCOMPARE(_SetChannelCountCalled, 1);
+    QCOMPARE(_SetAllData[0], 1);
+    QCOMPARE(_SetAllData[300], 128);
+    QCOMPARE(_SetAllData[510], 0);
+    QCOMPARE(_SetAllData[511], 7);
+
+    // A different size forces a new channel count
+    vo.outputDMX(0, data.left(24));
+    QVERIFY(waitSetAllData(3) == true);
+    QCOMPARE(_SetChannelCountCalled, 2);
+    QCOMPARE(_ChannelCount, 24);
+    QCOMPARE(_SetAllData[0], 1);
+
+    // Reopening forces the next frame through even if it is the same
+    vo.close(0);
+    vo.open(0);
+    vo.outputDMX(0, data.left(24));
+    QVERIFY(waitSetAllData(4) == true);
+    QCOMPARE(_SetChannelCountCalled, 3);
+    vo.close(0);
+}
+
 QTEST_MAIN(VellemanOut_Test)
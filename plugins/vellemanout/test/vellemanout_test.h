@@ -33,6 +33,7 @@ private slots:
     void openClose();
     void infoText();
     void outputDMX();
+    void outputUnchanged();
 };
 
 #endif
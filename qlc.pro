@@ -6,6 +6,7 @@ SUBDIRS      += hotplugmonitor
 SUBDIRS      += engine
 SUBDIRS      += ui
 SUBDIRS      += main
+SUBDIRS      += headless
 SUBDIRS      += fixtures
 SUBDIRS      += inputprofiles
 SUBDIRS      += rgbscripts
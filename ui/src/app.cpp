@@ -45,11 +45,14 @@
 #endif
 
 #include "qlcfixturedefcache.h"
+#include "workspacecache.h"
 #include "qlcfixturedef.h"
+#include "qlcfilewriter.h"
 #include "qlcconfig.h"
 #include "qlcfile.h"
 
 #define SETTINGS_GEOMETRY "workspace/geometry"
+#define SETTINGS_WORKSPACE_CACHE "workspace/binarycache"
 #define KXMLQLCWorkspaceWindow "CurrentWindow"
 
 #define KModeTextOperate QObject::tr("Operate")
@@ -82,6 +85,8 @@ App::App()
     , m_helpAboutAction(NULL)
 
     , m_toolbar(NULL)
+
+    , m_fileWriter(NULL)
 {
     QCoreApplication::setOrganizationName("qlc");
     QCoreApplication::setOrganizationDomain("sf.net");
@@ -107,6 +112,10 @@ App::~App()
 {
     QSettings settings;
 
+    /* Let a pending save finish before the application goes away */
+    delete m_fileWriter;
+    m_fileWriter = NULL;
+
     // Don't save kiosk-mode window geometry because that will screw things up
     if (m_doc->isKiosk() == false)
         settings.setValue(SETTINGS_GEOMETRY, saveGeometry());
@@ -173,6 +182,11 @@ void App::init()
 
     // The engine object
     initDoc();
+
+    // Workspace files are written in the background
+    m_fileWriter = new QLCFileWriter(this);
+    connect(m_fileWriter, SIGNAL(written(const QString&,QFile::FileError)),
+            this, SLOT(slotFileWritten(const QString&,QFile::FileError)));
     // Main view actions
     initActions();
     // Main tool bar
@@ -244,8 +258,13 @@ void App::closeEvent(QCloseEvent* e)
 
         if (result == QMessageBox::Yes)
         {
+            /* Keep the window open if saving failed. slotFileWritten()
+               tells the user why. */
             slotFileSave();
-            e->accept();
+            if (waitForSaved() == true)
+                e->accept();
+            else
+                e->ignore();
         }
         else if (result == QMessageBox::No)
         {
@@ -322,6 +341,35 @@ void App::clearDocument()
     m_doc->resetModified();
 }
 
+/**
+ * Load the fixture definitions of the given directories, using and
+ * updating the directory index. Run in a worker thread during startup.
+ */
+static qint64 loadFixtureDefs(QLCFixtureDefCache* cache, const QList <QDir>& dirs,
+                              const QString& index)
+{
+    QTime timer;
+    timer.start();
+
+    cache->loadIndex(index);
+    QListIterator <QDir> it(dirs);
+    while (it.hasNext() == true)
+        cache->load(it.next());
+    cache->saveIndex(index);
+
+    return timer.elapsed();
+}
+
+/** Parse input profiles in a worker thread during startup */
+static QPair <QList <QLCInputProfile*>,qint64> parseInputProfiles(const QList <QDir>& dirs)
+{
+    QTime timer;
+    timer.start();
+
+    QList <QLCInputProfile*> profiles(InputMap::parseProfiles(dirs));
+    return qMakePair(profiles, timer.elapsed());
+}
+
 void App::initDoc()
 {
     Q_ASSERT(m_doc == NULL);
@@ -330,9 +378,31 @@ void App::initDoc()
     connect(m_doc, SIGNAL(modified(bool)), this, SLOT(slotDocModified(bool)));
     connect(m_doc, SIGNAL(modeChanged(Doc::Mode)), this, SLOT(slotModeChanged(Doc::Mode)));
 
-    /* Load user fixtures first so that they override system fixtures */
-    m_doc->fixtureDefCache()->load(QLCFixtureDefCache::userDefinitionDirectory());
-    m_doc->fixtureDefCache()->load(QLCFixtureDefCache::systemDefinitionDirectory());
+    QTime timer;
+    timer.start();
+
+    /* Fixture definitions and input profiles are plain files that can be
+       read in worker threads while plugins are loaded here. Plugins have to
+       stay in this thread since they create QObjects of their own. Nothing
+       touches the fixture definition cache until it's waited for below. */
+
+    /* Load user fixtures first so that they override system fixtures. Only
+       directories that have changed since the last start are actually read
+       and definitions get parsed only when they're used. */
+    QList <QDir> fixtureDirs;
+    fixtureDirs << QLCFixtureDefCache::userDefinitionDirectory();
+    fixtureDirs << QLCFixtureDefCache::systemDefinitionDirectory();
+    QString index(QLCFixtureDefCache::defaultIndexPath());
+    QFuture <qint64> fixtureDefs = QtConcurrent::run(loadFixtureDefs,
+                                                     m_doc->fixtureDefCache(),
+                                                     fixtureDirs, index);
+
+    /* Likewise, user profiles override system profiles */
+    QList <QDir> profileDirs;
+    profileDirs << InputMap::userProfileDirectory();
+    profileDirs << InputMap::systemProfileDirectory();
+    QFuture <QPair <QList <QLCInputProfile*>,qint64> > profiles =
+        QtConcurrent::run(parseInputProfiles, profileDirs);
 
     /* Load output plugins */
     Q_ASSERT(m_doc->outputMap() != NULL);
@@ -340,15 +410,29 @@ void App::initDoc()
             this, SLOT(slotSetProgressText(const QString&)));
     m_doc->outputMap()->loadPlugins(OutputMap::systemPluginDirectory());
     m_doc->outputMap()->loadDefaults();
+    qint64 outputTime = timer.restart();
 
-    /* Load input plugins & profiles */
+    /* Load input plugins */
     Q_ASSERT(m_doc->inputMap() != NULL);
     connect(m_doc->inputMap(), SIGNAL(pluginAdded(const QString&)),
             this, SLOT(slotSetProgressText(const QString&)));
     m_doc->inputMap()->loadPlugins(InputMap::systemPluginDirectory());
-    m_doc->inputMap()->loadProfiles(InputMap::userProfileDirectory());
-    m_doc->inputMap()->loadProfiles(InputMap::systemProfileDirectory());
+    qint64 inputTime = timer.restart();
+
+    /* Merge the profiles in order before the defaults refer to them */
+    fixtureDefs.waitForFinished();
+    profiles.waitForFinished();
+    qint64 waitTime = timer.restart();
+    m_doc->inputMap()->addProfiles(profiles.result().first);
     m_doc->inputMap()->loadDefaults();
+    inputTime += timer.elapsed();
+
+    qDebug() << "Startup times (ms):"
+             << "fixture definitions" << fixtureDefs.result() << "(parallel),"
+             << "input profiles" << profiles.result().second << "(parallel),"
+             << "output plugins" << outputTime << ","
+             << "input plugins" << inputTime << ","
+             << "waiting for parallel loading" << waitTime;
 
     m_doc->masterTimer()->start();
 }
@@ -617,7 +701,10 @@ bool App::slotFileNew()
                                           QMessageBox::Cancel);
         if (result == QMessageBox::Yes)
         {
+            /* Don't throw the workspace away unless it was saved */
             slotFileSave();
+            if (waitForSaved() == false)
+                return false;
             clearDocument();
             result = true;
         }
@@ -660,6 +747,8 @@ QFile::FileError App::slotFileOpen()
             QFile::FileError error = slotFileSaveAs();
             if (handleFileError(error) == false)
                 return error;
+            if (waitForSaved() == false)
+                return m_fileWriter->lastError(fileName());
         }
         else if (result == QMessageBox::Cancel)
         {
@@ -877,28 +966,66 @@ QString App::fileName() const
 
 QFile::FileError App::loadXML(const QString& fileName)
 {
-    QFile::FileError retval = QFile::NoError;
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to open file:" << fileName;
+        return file.error();
+    }
+
+    /* The whole file is needed for its hash anyway, so parse it from
+       memory. This is still much less than a DOM tree of it would take. */
+    QByteArray contents(file.readAll());
+    file.close();
+
+    /* Use the binary cache if it was made from these very contents */
+    const bool useCache = workspaceCacheEnabled();
+    QByteArray hash;
+    if (useCache == true)
+        hash = WorkspaceCache::hash(contents);
+    if (useCache == true && loadCache(fileName, hash) == true)
+    {
+        setFileName(fileName);
+        m_doc->resetModified();
+        return QFile::NoError;
+    }
+
+    /* Stream the workspace instead of building a DOM tree of it first;
+       large workspaces would otherwise need hundreds of megabytes. */
+    QXmlStreamReader xml(contents);
+    QString docType;
+    while (xml.atEnd() == false && xml.isStartElement() == false)
+    {
+        xml.readNext();
+        if (xml.isDTD() == true)
+            docType = xml.dtdName().toString();
+    }
 
-    QDomDocument doc(QLCFile::readXML(fileName));
-    if (doc.isNull() == false)
+    QFile::FileError retval = QFile::ReadError;
+    if (docType == KXMLQLCWorkspace && xml.isStartElement() == true)
     {
-        if (doc.doctype().name() == KXMLQLCWorkspace)
+        if (loadXML(xml) == true)
         {
-            if (loadXML(doc) == false)
-            {
-                retval = QFile::ReadError;
-            }
-            else
+            setFileName(fileName);
+            m_doc->resetModified();
+            retval = QFile::NoError;
+
+            /* Let the next start use the binary cache */
+            if (useCache == true)
             {
-                setFileName(fileName);
-                m_doc->resetModified();
-                retval = QFile::NoError;
+                QByteArray head;
+                QByteArray tail;
+                saveXMLParts(head, tail);
+                saveCache(fileName, hash, head + tail);
             }
         }
-        else
-        {
-            retval = QFile::ReadError;
-        }
+    }
+
+    if (xml.hasError() == true)
+    {
+        qWarning() << Q_FUNC_INFO << "Error loading file" << fileName
+                   << ":" << xml.errorString() << ", line:" << xml.lineNumber()
+                   << ", col:" << xml.columnNumber();
     }
 
     return retval;
@@ -965,57 +1092,208 @@ bool App::loadXML(const QDomDocument& doc)
     return true;
 }
 
-QFile::FileError App::saveXML(const QString& fileName)
+bool App::loadXML(QXmlStreamReader& xml)
 {
-    QFile::FileError retval;
+    Q_ASSERT(m_doc != NULL);
 
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly) == false)
-        return file.error();
+    if (xml.name() != QLatin1String(KXMLQLCWorkspace))
+    {
+        qWarning() << Q_FUNC_INFO << "Workspace node not found";
+        return false;
+    }
 
-    QDomDocument doc(QLCFile::getXMLHeader(KXMLQLCWorkspace));
-    if (doc.isNull() == false)
+    QString activeWindowName = xml.attributes().value(KXMLQLCWorkspaceWindow).toString();
+
+    while (xml.readNextStartElement() == true)
     {
-        QDomElement root;
-        QDomElement tag;
-        QDomText text;
+        if (xml.name() == QLatin1String(KXMLQLCEngine))
+        {
+            m_doc->loadXML(xml);
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCVirtualConsole))
+        {
+            /* VC is small compared to the engine, so let it load itself
+               from a DOM tree of just its own contents */
+            QDomDocument doc;
+            QDomElement tag = QLCFile::readXMLElement(xml, doc);
+            if (tag.isNull() == false)
+                VirtualConsole::instance()->loadXML(tag);
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCSimpleDesk))
+        {
+            QDomDocument doc;
+            QDomElement tag = QLCFile::readXMLElement(xml, doc);
+            if (tag.isNull() == false)
+                SimpleDesk::instance()->loadXML(tag);
+        }
+        else if (xml.name() == QLatin1String(KXMLFixture))
+        {
+            /* Legacy support code, nowadays in Doc */
+            Fixture::loader(xml, m_doc);
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCFunction))
+        {
+            /* Legacy support code, nowadays in Doc */
+            Function::loader(xml, m_doc);
+        }
+        else if (xml.name() == QLatin1String(KXMLQLCCreator))
+        {
+            /* Ignore creator information */
+            xml.skipCurrentElement();
+        }
+        else
+        {
+            qWarning() << Q_FUNC_INFO << "Unknown Workspace tag:" << xml.name().toString();
+            xml.skipCurrentElement();
+        }
+    }
 
-        /* Create a text stream for the file */
-        QTextStream stream(&file);
+    if (xml.hasError() == true)
+        return false;
 
-        /* THE MASTER XML ROOT NODE */
-        root = doc.documentElement();
+    // Perform post-load operations
+    VirtualConsole::instance()->postLoad();
 
-        /* Currently active window */
-        QMdiSubWindow* sub = m_area->activeSubWindow();
-        if (sub != NULL && sub->widget() != NULL)
-            root.setAttribute(KXMLQLCWorkspaceWindow, sub->widget()->metaObject()->className());
+    // Set the active window to what was saved in the workspace file
+    setActiveWindow(activeWindowName);
 
-        /* Write engine components to the XML document */
-        m_doc->saveXML(&doc, &root);
+    return true;
+}
 
-        /* Write virtual console to the XML document */
-        VirtualConsole::instance()->saveXML(&doc, &root);
+QFile::FileError App::saveXML(const QString& fileName)
+{
+    Q_ASSERT(m_fileWriter != NULL);
+
+    /* Serialize the workspace into plain data in this thread and let
+       m_fileWriter write it out, so that a large workspace doesn't freeze
+       the UI. Unchanged engine objects reuse their previously serialized
+       XML (see Doc::saveXMLFragments()). */
+    QByteArray head;
+    QByteArray tail;
+    saveXMLParts(head, tail);
+
+    QList <QByteArray> data;
+    data << head;
+    m_doc->saveXMLFragments(data);
+    data << tail;
+    m_fileWriter->write(fileName, data);
+
+    /* Write a binary cache of the same contents for faster loading */
+    if (workspaceCacheEnabled() == true)
+        saveCache(fileName, WorkspaceCache::hash(data), head + tail);
+
+    /* Set the file name for the current Doc instance and
+       set it also in an unmodified state. */
+    setFileName(fileName);
+    m_doc->resetModified();
 
-        /* Write Simple Desk to the XML document */
-        SimpleDesk::instance()->saveXML(&doc, &root);
+    return QFile::NoError;
+}
 
-        /* Write the XML document to the stream (=file) */
-        stream << doc.toString() << "\n";
+bool App::waitForSaved()
+{
+    Q_ASSERT(m_fileWriter != NULL);
 
-        /* Set the file name for the current Doc instance and
-           set it also in an unmodified state. */
-        setFileName(fileName);
-        m_doc->resetModified();
+    m_fileWriter->waitForWritten();
+    if (m_doc->isModified() == true)
+        return false;
+    else
+        return (m_fileWriter->lastError(fileName()) == QFile::NoError);
+}
 
-        retval = QFile::NoError;
+void App::saveXMLParts(QByteArray& head, QByteArray& tail)
+{
+    QBuffer headBuffer(&head);
+    headBuffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter xml(&headBuffer);
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(1);
+
+    /* THE MASTER XML ROOT NODE */
+    QLCFile::writeXMLHeader(xml, KXMLQLCWorkspace);
+
+    /* Currently active window */
+    QMdiSubWindow* sub = m_area->activeSubWindow();
+    if (sub != NULL && sub->widget() != NULL)
+        xml.writeAttribute(KXMLQLCWorkspaceWindow, sub->widget()->metaObject()->className());
+
+    QLCFile::writeXMLCreator(xml);
+
+    /* Virtual console and Simple Desk can only save themselves into a DOM
+       document, so save them into one of their own and stream it out */
+    QDomDocument doc;
+    QDomElement root = doc.createElement(KXMLQLCWorkspace);
+    doc.appendChild(root);
+    VirtualConsole::instance()->saveXML(&doc, &root);
+    SimpleDesk::instance()->saveXML(&doc, &root);
+
+    QBuffer tailBuffer(&tail);
+    tailBuffer.open(QIODevice::WriteOnly);
+    xml.setDevice(&tailBuffer);
+    QDomElement tag = root.firstChildElement();
+    while (tag.isNull() == false)
+    {
+        QLCFile::writeXMLElement(xml, tag);
+        tag = tag.nextSiblingElement();
     }
-    else
+
+    tail.append("\n</" KXMLQLCWorkspace ">\n");
+}
+
+bool App::workspaceCacheEnabled()
+{
+    QSettings settings;
+    return settings.value(SETTINGS_WORKSPACE_CACHE, false).toBool();
+}
+
+bool App::loadCache(const QString& fileName, const QByteArray& hash)
+{
+    /* Everything but the engine is stored as workspace XML */
+    QByteArray appData;
+    if (WorkspaceCache::load(WorkspaceCache::fileName(fileName), hash,
+                             m_doc, &appData) == false)
     {
-        retval = QFile::ReadError;
+        return false;
     }
 
-    file.close();
+    QXmlStreamReader xml(appData);
+    if (xml.readNextStartElement() == false || loadXML(xml) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to load workspace cache of" << fileName;
+        clearDocument();
+        return false;
+    }
 
-    return retval;
+    return true;
+}
+
+void App::saveCache(const QString& fileName, const QByteArray& hash,
+                    const QByteArray& appData)
+{
+    Q_ASSERT(m_fileWriter != NULL);
+
+    QByteArray cache(WorkspaceCache::save(hash, m_doc, appData));
+    if (cache.isEmpty() == false)
+    {
+        m_fileWriter->write(WorkspaceCache::fileName(fileName),
+                            QList <QByteArray> () << cache);
+    }
+}
+
+void App::slotFileWritten(const QString& fileName, QFile::FileError error)
+{
+    if (error == QFile::NoError)
+        return;
+
+    qWarning() << Q_FUNC_INFO << "Unable to write" << fileName;
+
+    /* A missing cache only makes the next start slower */
+    if (fileName == WorkspaceCache::fileName(this->fileName()))
+        return;
+
+    /* The workspace didn't make it to the disk after all */
+    if (fileName == this->fileName())
+        m_doc->setModified();
+
+    handleFileError(error);
 }
@@ -30,6 +30,8 @@
 #include "qlcfixturedefcache.h"
 #include "doc.h"
 
+class QXmlStreamReader;
+class QLCFileWriter;
 class QProgressDialog;
 class QDomDocument;
 class QDomElement;
@@ -180,17 +182,80 @@ public:
      */
     bool loadXML(const QDomDocument& doc);
 
+    /**
+     * Load workspace contents from the current element of the given XML
+     * stream.
+     *
+     * @param xml A reader positioned at the Workspace StartElement
+     */
+    bool loadXML(QXmlStreamReader& xml);
+
     /**
      * Save workspace contents to a file with the given name. Changes the
      * current workspace file name to the given fileName.
      *
+     * The workspace is serialized immediately, but the file is written in
+     * a background thread. Errors that occur while writing are reported
+     * from slotFileWritten().
+     *
      * @param fileName The name of the file to save to.
      * @return QFile::NoError if successful.
      */
     QFile::FileError saveXML(const QString& fileName);
 
+private:
+    /**
+     * Serialize everything but the engine contents of the workspace: $head
+     * gets the XML header and the Workspace start tag and $tail gets the
+     * Virtual Console, the Simple Desk and the Workspace end tag.
+     */
+    void saveXMLParts(QByteArray& head, QByteArray& tail);
+
+    /**
+     * Block until the workspace saved by saveXML() is on the disk. Used
+     * before the workspace is thrown away, since slotFileWritten() would
+     * report a failure only later, if at all.
+     *
+     * @return true if the workspace was saved, false if it wasn't saved at
+     *         all (e.g. Save As was cancelled) or if writing it failed
+     */
+    bool waitForSaved();
+
+    /**
+     * Check, whether workspaces should be loaded from and saved with a
+     * binary cache file (see WorkspaceCache). The cache is written next to
+     * each workspace file, so it is off unless the "workspace/binarycache"
+     * setting is true.
+     */
+    static bool workspaceCacheEnabled();
+
+    /**
+     * Load the binary cache of the given workspace file (see WorkspaceCache)
+     * if it was made from the file's current contents.
+     *
+     * @param fileName The name of the workspace file
+     * @param hash The hash of the workspace file's current contents
+     * @return true if the cache was loaded, otherwise false
+     */
+    bool loadCache(const QString& fileName, const QByteArray& hash);
+
+    /**
+     * Write the binary cache of the given workspace file in the background.
+     *
+     * @param fileName The name of the workspace file
+     * @param hash The hash of the workspace file's contents
+     * @param appData The workspace XML without the engine contents
+     */
+    void saveCache(const QString& fileName, const QByteArray& hash,
+                   const QByteArray& appData);
+
+private slots:
+    /** Report an error if writing a saved workspace failed */
+    void slotFileWritten(const QString& fileName, QFile::FileError error);
+
 private:
     QString m_fileName;
+    QLCFileWriter* m_fileWriter;
 };
 
 #endif
@@ -0,0 +1,533 @@
+/*
+  Q Light Controller
+  doctreemodel.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#include <QtAlgorithms>
+#include <climits>
+#include <QSet>
+
+#include "doctreemodel.h"
+
+/****************************************************************************
+ * Sorting helpers
+ ****************************************************************************/
+
+class DocTreeModel::ItemLessThan
+{
+public:
+    ItemLessThan(const DocTreeModel* model) : m_model(model) { }
+
+    bool operator()(quint32 a, quint32 b) const
+    {
+        if (m_model->m_sortOrder == Qt::AscendingOrder)
+            return m_model->itemLessThan(a, b, m_model->m_sortColumn);
+        else
+            return m_model->itemLessThan(b, a, m_model->m_sortColumn);
+    }
+
+private:
+    const DocTreeModel* m_model;
+};
+
+class DocTreeModel::CategoryLessThan
+{
+public:
+    CategoryLessThan(const DocTreeModel* model) : m_model(model) { }
+
+    bool operator()(const Category* a, const Category* b) const
+    {
+        return m_model->categoryLessThan(a->key, b->key);
+    }
+
+private:
+    const DocTreeModel* m_model;
+};
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+DocTreeModel::DocTreeModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_sortColumn(0)
+    , m_sortOrder(Qt::AscendingOrder)
+{
+}
+
+DocTreeModel::~DocTreeModel()
+{
+    qDeleteAll(m_categories);
+    m_categories.clear();
+}
+
+quint32 DocTreeModel::invalidId()
+{
+    return UINT_MAX;
+}
+
+/****************************************************************************
+ * Indices
+ ****************************************************************************/
+
+bool DocTreeModel::isCategory(const QModelIndex& index) const
+{
+    return (index.isValid() == true && index.internalPointer() == NULL);
+}
+
+quint32 DocTreeModel::categoryKey(const QModelIndex& index) const
+{
+    if (index.isValid() == false)
+        return invalidId();
+
+    if (isCategory(index) == true)
+    {
+        if (index.row() < m_categories.size())
+            return m_categories.at(index.row())->key;
+        else
+            return invalidId();
+    }
+
+    return static_cast<Category*> (index.internalPointer())->key;
+}
+
+quint32 DocTreeModel::itemId(const QModelIndex& index) const
+{
+    if (index.isValid() == false || isCategory(index) == true)
+        return invalidId();
+
+    Category* cat = static_cast<Category*> (index.internalPointer());
+    if (index.row() < cat->items.size())
+        return cat->items.at(index.row());
+    else
+        return invalidId();
+}
+
+QModelIndex DocTreeModel::categoryIndex(quint32 key, int column) const
+{
+    int row = categoryRow(key);
+    if (row < 0)
+        return QModelIndex();
+    else
+        return createIndex(row, column, (void*) NULL);
+}
+
+QModelIndex DocTreeModel::itemIndex(quint32 key, quint32 id, int column)
+{
+    QModelIndex parent = categoryIndex(key);
+    if (parent.isValid() == false)
+        return QModelIndex();
+
+    if (canFetchMore(parent) == true)
+        fetchMore(parent);
+
+    Category* cat = m_categories.at(parent.row());
+    int row = cat->items.indexOf(id);
+    if (row < 0)
+        return QModelIndex();
+    else
+        return createIndex(row, column, cat);
+}
+
+QList <quint32> DocTreeModel::categoryKeys() const
+{
+    QList <quint32> keys;
+    foreach (const Category* cat, m_categories)
+        keys << cat->key;
+    return keys;
+}
+
+int DocTreeModel::sortColumn() const
+{
+    return m_sortColumn;
+}
+
+Qt::SortOrder DocTreeModel::sortOrder() const
+{
+    return m_sortOrder;
+}
+
+/****************************************************************************
+ * Contents
+ ****************************************************************************/
+
+void DocTreeModel::setContents(const QHash <quint32,QList <quint32> >& contents)
+{
+    beginResetModel();
+
+    qDeleteAll(m_categories);
+    m_categories.clear();
+
+    QHashIterator <quint32,QList <quint32> > it(contents);
+    while (it.hasNext() == true)
+    {
+        it.next();
+
+        /* Items are sorted only when they're fetched */
+        Category* cat = new Category;
+        cat->key = it.key();
+        cat->items = it.value();
+        cat->fetched = cat->items.isEmpty();
+        m_categories << cat;
+    }
+
+    qSort(m_categories.begin(), m_categories.end(), CategoryLessThan(this));
+
+    endResetModel();
+}
+
+void DocTreeModel::addCategory(quint32 key)
+{
+    if (categoryRow(key) != -1)
+        return;
+
+    int row = 0;
+    while (row < m_categories.size() && categoryLessThan(m_categories.at(row)->key, key) == true)
+        row++;
+
+    beginInsertRows(QModelIndex(), row, row);
+    Category* cat = new Category;
+    cat->key = key;
+    cat->fetched = true;
+    m_categories.insert(row, cat);
+    endInsertRows();
+}
+
+void DocTreeModel::removeCategory(quint32 key)
+{
+    int row = categoryRow(key);
+    if (row != -1)
+        removeCategoryAt(row);
+}
+
+void DocTreeModel::updateCategory(quint32 key)
+{
+    int row = categoryRow(key);
+    if (row == -1)
+        return;
+
+    /* Count the categories that go before this one */
+    int pos = 0;
+    for (int i = 0; i < m_categories.size(); i++)
+    {
+        if (i != row && categoryLessThan(m_categories.at(i)->key, key) == true)
+            pos++;
+    }
+
+    if (pos != row)
+    {
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), (pos > row) ? pos + 1 : pos);
+        m_categories.move(row, pos);
+        endMoveRows();
+    }
+
+    int last = columnCount(QModelIndex()) - 1;
+    emit dataChanged(createIndex(pos, 0, (void*) NULL), createIndex(pos, last, (void*) NULL));
+}
+
+void DocTreeModel::setItems(quint32 key, const QList <quint32>& ids)
+{
+    int row = categoryRow(key);
+    if (row == -1)
+        return;
+
+    Category* cat = m_categories.at(row);
+    if (cat->items.toSet() == ids.toSet())
+        return;
+
+    if (cat->fetched == false)
+    {
+        cat->items = ids;
+        cat->fetched = ids.isEmpty();
+        return;
+    }
+
+    QModelIndex parent = createIndex(row, 0, (void*) NULL);
+    if (cat->items.isEmpty() == false)
+    {
+        beginRemoveRows(parent, 0, cat->items.size() - 1);
+        cat->items.clear();
+        endRemoveRows();
+    }
+
+    if (ids.isEmpty() == false)
+    {
+        QList <quint32> sorted(ids);
+        sortItems(sorted);
+        beginInsertRows(parent, 0, sorted.size() - 1);
+        cat->items = sorted;
+        endInsertRows();
+    }
+}
+
+void DocTreeModel::addItem(quint32 key, quint32 id)
+{
+    int row = categoryRow(key);
+    if (row == -1)
+    {
+        addCategory(key);
+        row = categoryRow(key);
+    }
+
+    Category* cat = m_categories.at(row);
+    if (cat->items.contains(id) == true)
+        return;
+
+    if (cat->fetched == false)
+    {
+        cat->items << id;
+    }
+    else
+    {
+        int pos = insertionRow(cat->items, id);
+        beginInsertRows(createIndex(row, 0, (void*) NULL), pos, pos);
+        cat->items.insert(pos, id);
+        endInsertRows();
+    }
+}
+
+void DocTreeModel::removeItem(quint32 id, bool removeEmpty)
+{
+    for (int row = m_categories.size() - 1; row >= 0; row--)
+    {
+        Category* cat = m_categories.at(row);
+        int pos = cat->items.indexOf(id);
+        if (pos == -1)
+            continue;
+
+        if (cat->fetched == true)
+        {
+            beginRemoveRows(createIndex(row, 0, (void*) NULL), pos, pos);
+            cat->items.removeAt(pos);
+            endRemoveRows();
+        }
+        else
+        {
+            cat->items.removeAt(pos);
+        }
+
+        if (cat->items.isEmpty() == true)
+        {
+            cat->fetched = true;
+            if (removeEmpty == true)
+                removeCategoryAt(row);
+        }
+    }
+}
+
+void DocTreeModel::updateItem(quint32 id)
+{
+    for (int row = 0; row < m_categories.size(); row++)
+    {
+        Category* cat = m_categories.at(row);
+        if (cat->fetched == false)
+            continue;
+
+        int pos = cat->items.indexOf(id);
+        if (pos != -1)
+            moveItem(cat, row, pos);
+    }
+}
+
+/****************************************************************************
+ * Helpers
+ ****************************************************************************/
+
+int DocTreeModel::categoryRow(quint32 key) const
+{
+    for (int i = 0; i < m_categories.size(); i++)
+    {
+        if (m_categories.at(i)->key == key)
+            return i;
+    }
+
+    return -1;
+}
+
+void DocTreeModel::sortItems(QList <quint32>& items) const
+{
+    qSort(items.begin(), items.end(), ItemLessThan(this));
+}
+
+void DocTreeModel::removeCategoryAt(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+    delete m_categories.takeAt(row);
+    endRemoveRows();
+}
+
+int DocTreeModel::insertionRow(const QList <quint32>& items, quint32 id) const
+{
+    return qLowerBound(items.begin(), items.end(), id, ItemLessThan(this)) - items.begin();
+}
+
+void DocTreeModel::moveItem(Category* cat, int categoryRow, int row)
+{
+    /* Find the item's place among the other items */
+    quint32 id = cat->items.takeAt(row);
+    int pos = insertionRow(cat->items, id);
+    cat->items.insert(row, id);
+
+    QModelIndex parent = createIndex(categoryRow, 0, (void*) NULL);
+    if (pos != row)
+    {
+        beginMoveRows(parent, row, row, parent, (pos > row) ? pos + 1 : pos);
+        cat->items.move(row, pos);
+        endMoveRows();
+    }
+
+    int last = columnCount(parent) - 1;
+    emit dataChanged(createIndex(pos, 0, cat), createIndex(pos, last, cat));
+}
+
+/****************************************************************************
+ * QAbstractItemModel
+ ****************************************************************************/
+
+QModelIndex DocTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (row < 0 || column < 0)
+        return QModelIndex();
+
+    if (parent.isValid() == false)
+    {
+        if (row < m_categories.size())
+            return createIndex(row, column, (void*) NULL);
+        else
+            return QModelIndex();
+    }
+
+    if (isCategory(parent) == false || parent.row() >= m_categories.size())
+        return QModelIndex();
+
+    Category* cat = m_categories.at(parent.row());
+    if (cat->fetched == true && row < cat->items.size())
+        return createIndex(row, column, cat);
+    else
+        return QModelIndex();
+}
+
+QModelIndex DocTreeModel::parent(const QModelIndex& index) const
+{
+    if (index.isValid() == false || isCategory(index) == true)
+        return QModelIndex();
+
+    int row = m_categories.indexOf(static_cast<Category*> (index.internalPointer()));
+    if (row == -1)
+        return QModelIndex();
+    else
+        return createIndex(row, 0, (void*) NULL);
+}
+
+int DocTreeModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() == false)
+        return m_categories.size();
+
+    /* Only categories have children, and only in their first column */
+    if (isCategory(parent) == false || parent.column() != 0)
+        return 0;
+
+    const Category* cat = m_categories.at(parent.row());
+    if (cat->fetched == true)
+        return cat->items.size();
+    else
+        return 0;
+}
+
+bool DocTreeModel::hasChildren(const QModelIndex& parent) const
+{
+    if (parent.isValid() == false)
+        return (m_categories.isEmpty() == false);
+
+    if (isCategory(parent) == false || parent.column() != 0)
+        return false;
+
+    return (m_categories.at(parent.row())->items.isEmpty() == false);
+}
+
+bool DocTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (isCategory(parent) == false || parent.column() != 0)
+        return false;
+
+    return (m_categories.at(parent.row())->fetched == false);
+}
+
+void DocTreeModel::fetchMore(const QModelIndex& parent)
+{
+    if (canFetchMore(parent) == false)
+        return;
+
+    Category* cat = m_categories.at(parent.row());
+    sortItems(cat->items);
+
+    if (cat->items.isEmpty() == true)
+    {
+        cat->fetched = true;
+    }
+    else
+    {
+        beginInsertRows(parent, 0, cat->items.size() - 1);
+        cat->fetched = true;
+        endInsertRows();
+    }
+}
+
+void DocTreeModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || (column == m_sortColumn && order == m_sortOrder))
+        return;
+
+    emit layoutAboutToBeChanged();
+
+    /* Remember which item each persistent index (e.g. selection) refers to */
+    QModelIndexList from = persistentIndexList();
+    QList <quint32> ids;
+    foreach (const QModelIndex& index, from)
+        ids << itemId(index);
+
+    m_sortColumn = column;
+    m_sortOrder = order;
+    foreach (Category* cat, m_categories)
+    {
+        if (cat->fetched == true)
+            sortItems(cat->items);
+    }
+
+    QModelIndexList to;
+    for (int i = 0; i < from.size(); i++)
+    {
+        const QModelIndex& index(from.at(i));
+        if (isCategory(index) == true)
+        {
+            to << index;
+        }
+        else
+        {
+            Category* cat = static_cast<Category*> (index.internalPointer());
+            to << createIndex(cat->items.indexOf(ids.at(i)), index.column(), cat);
+        }
+    }
+
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged();
+}
@@ -0,0 +1,173 @@
+/*
+  Q Light Controller
+  doctreemodel.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#ifndef DOCTREEMODEL_H
+#define DOCTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QList>
+#include <QHash>
+
+/**
+ * DocTreeModel is a base for two-level tree models that list Doc objects
+ * (fixtures, functions...) by their IDs under a number of top-level
+ * categories. The model stores only IDs; subclasses look up everything
+ * else from Doc in data(), so views (which ask only for the rows that are
+ * visible) never touch more objects than they show.
+ *
+ * The children of each category are kept sorted with itemLessThan(). They
+ * are fetched lazily thru canFetchMore() & fetchMore(), so a category's
+ * items are sorted only when the category is expanded for the first time.
+ *
+ * Subclasses tell about changes in Doc thru the protected methods. Single
+ * changes are applied incrementally, keeping selections & expanded
+ * categories intact, while big bunches of changes should be applied with
+ * setContents(), which resets the whole model at once.
+ */
+class DocTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(DocTreeModel)
+
+public:
+    DocTreeModel(QObject* parent = 0);
+    virtual ~DocTreeModel();
+
+    /** An ID that doesn't refer to any item */
+    static quint32 invalidId();
+
+    /** Check, whether the given index refers to a category */
+    bool isCategory(const QModelIndex& index) const;
+
+    /**
+     * Get the category key of $index. For items, this is the key of the
+     * category they are in.
+     */
+    quint32 categoryKey(const QModelIndex& index) const;
+
+    /** Get the item ID of $index or invalidId() for categories */
+    quint32 itemId(const QModelIndex& index) const;
+
+    /** Get the index of a category or an invalid index if not found */
+    QModelIndex categoryIndex(quint32 key, int column = 0) const;
+
+    /**
+     * Get the index of an item in the given category. Fetches the
+     * category's items first if they haven't been fetched yet.
+     *
+     * @return The item's index or an invalid index if not found
+     */
+    QModelIndex itemIndex(quint32 key, quint32 id, int column = 0);
+
+    /** Get the keys of all categories, in the order they are shown */
+    QList <quint32> categoryKeys() const;
+
+    /** Get the current sort column */
+    int sortColumn() const;
+
+    /** Get the current sort order */
+    Qt::SortOrder sortOrder() const;
+
+protected:
+    /**
+     * Check, whether item $a should be shown before item $b when items are
+     * sorted by $column in ascending order. Must give a strict ordering,
+     * i.e. break ties by ID.
+     */
+    virtual bool itemLessThan(quint32 a, quint32 b, int column) const = 0;
+
+    /** Check, whether category $a should be shown before category $b */
+    virtual bool categoryLessThan(quint32 a, quint32 b) const = 0;
+
+    /** Replace the whole contents of the model with the given categories */
+    void setContents(const QHash <quint32,QList <quint32> >& contents);
+
+    /** Add an empty category, unless it exists already */
+    void addCategory(quint32 key);
+
+    /** Remove a category and its items */
+    void removeCategory(quint32 key);
+
+    /** Move a category to its new place after its sort key has changed */
+    void updateCategory(quint32 key);
+
+    /** Replace the items of a category, unless they are the same already */
+    void setItems(quint32 key, const QList <quint32>& ids);
+
+    /** Add an item to a category, creating the category if necessary */
+    void addItem(quint32 key, quint32 id);
+
+    /**
+     * Remove an item from all categories
+     *
+     * @param removeEmpty If true, remove the categories that become empty
+     */
+    void removeItem(quint32 id, bool removeEmpty);
+
+    /** Move an item to its new place & repaint it in all categories */
+    void updateItem(quint32 id);
+
+private:
+    struct Category
+    {
+        quint32 key;
+        QList <quint32> items;
+        bool fetched;
+    };
+
+    /** Sorts item IDs with itemLessThan(), in the current sort order */
+    class ItemLessThan;
+
+    /** Sorts category pointers with categoryLessThan() */
+    class CategoryLessThan;
+
+    int categoryRow(quint32 key) const;
+    void sortItems(QList <quint32>& items) const;
+    void removeCategoryAt(int row);
+
+    /** Get the row where $id would be placed in $items */
+    int insertionRow(const QList <quint32>& items, quint32 id) const;
+
+    /** Move items[row] to its sorted place, signalling the move */
+    void moveItem(Category* cat, int categoryRow, int row);
+
+private:
+    QList <Category*> m_categories;
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+
+    /************************************************************************
+     * QAbstractItemModel
+     ************************************************************************/
+public:
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex& index) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+
+    bool canFetchMore(const QModelIndex& parent) const;
+    void fetchMore(const QModelIndex& parent);
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+};
+
+#endif
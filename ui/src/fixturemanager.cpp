@@ -19,14 +19,14 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#include <QTreeWidgetItem>
 #include <QMdiSubWindow>
 #include <QTextBrowser>
+#include <QHeaderView>
 #include <QVBoxLayout>
-#include <QTreeWidget>
 #include <QScrollArea>
 #include <QMessageBox>
 #include <QToolButton>
+#include <QTreeView>
 #include <QSplitter>
 #include <QMdiArea>
 #include <QToolBar>
@@ -45,6 +45,7 @@
 
 #include "createfixturegroup.h"
 #include "fixturegroupeditor.h"
+#include "fixturetreemodel.h"
 #include "fixturemanager.h"
 #include "universearray.h"
 #include "mastertimer.h"
@@ -59,14 +60,6 @@
 
 #define SETTINGS_SPLITTER "fixturemanager/splitterstate"
 
-#define PROP_FIXTURE Qt::UserRole
-#define PROP_GROUP   Qt::UserRole + 1
-
-// List view column numbers
-#define KColumnName     0
-#define KColumnUniverse 1
-#define KColumnAddress  2
-
 FixtureManager* FixtureManager::s_instance = NULL;
 
 /*****************************************************************************
@@ -78,6 +71,9 @@ FixtureManager::FixtureManager(QWidget* parent, Doc* doc, Qt::WindowFlags flags)
     , m_doc(doc)
     , m_splitter(NULL)
     , m_tree(NULL)
+    , m_model(NULL)
+    , m_resetCurrentFixture(Fixture::invalidId())
+    , m_resetCurrentGroup(FixtureGroup::invalidId())
     , m_info(NULL)
     , m_groupEditor(NULL)
     , m_addAction(NULL)
@@ -97,11 +93,7 @@ FixtureManager::FixtureManager(QWidget* parent, Doc* doc, Qt::WindowFlags flags)
     initActions();
     initToolBar();
     initDataView();
-    updateView();
-
-    /* Connect fixture list change signals from the new document object */
-    connect(m_doc, SIGNAL(fixtureRemoved(quint32)),
-            this, SLOT(slotFixtureRemoved(quint32)));
+    updateGroupMenu();
 
     connect(m_doc, SIGNAL(modeChanged(Doc::Mode)),
             this, SLOT(slotModeChanged(Doc::Mode)));
@@ -159,31 +151,14 @@ void FixtureManager::createAndShow(QWidget* parent, Doc* doc)
  * Doc signal handlers
  *****************************************************************************/
 
-void FixtureManager::slotFixtureRemoved(quint32 id)
-{
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
-    {
-        QTreeWidgetItem* grpItem = m_tree->topLevelItem(i);
-        Q_ASSERT(grpItem != NULL);
-        for (int j = 0; j < grpItem->childCount(); j++)
-        {
-            QTreeWidgetItem* fxiItem = grpItem->child(j);
-            Q_ASSERT(fxiItem != NULL);
-            QVariant var = fxiItem->data(KColumnName, PROP_FIXTURE);
-            if (var.isValid() == true && var.toUInt() == id)
-                delete fxiItem;
-        }
-    }
-}
-
 void FixtureManager::slotModeChanged(Doc::Mode mode)
 {
     if (mode == Doc::Design)
     {
-        int selected = m_tree->selectedItems().size();
+        int selected = m_tree->selectionModel()->selectedRows().size();
 
-        QTreeWidgetItem* item = m_tree->currentItem();
-        if (item == NULL)
+        QModelIndex current = m_tree->currentIndex();
+        if (current.isValid() == false)
         {
             m_addAction->setEnabled(true);
             m_removeAction->setEnabled(false);
@@ -191,7 +166,7 @@ void FixtureManager::slotModeChanged(Doc::Mode mode)
             m_groupAction->setEnabled(false);
             m_unGroupAction->setEnabled(false);
         }
-        else if (item->data(KColumnName, PROP_FIXTURE).isValid() == true)
+        else if (m_model->fixtureId(current) != Fixture::invalidId())
         {
             // Fixture selected
             m_addAction->setEnabled(true);
@@ -203,12 +178,12 @@ void FixtureManager::slotModeChanged(Doc::Mode mode)
             m_groupAction->setEnabled(true);
 
             // Don't allow ungrouping from the "All fixtures" group
-            if (item->parent()->data(KColumnName, PROP_GROUP).isValid() == true)
+            if (m_model->groupId(current) != FixtureGroup::invalidId())
                 m_unGroupAction->setEnabled(true);
             else
                 m_unGroupAction->setEnabled(false);
         }
-        else if (item->data(KColumnName, PROP_GROUP).isValid() == true)
+        else if (m_model->isGroup(current) == true)
         {
             // Group selected
             m_addAction->setEnabled(true);
@@ -239,27 +214,14 @@ void FixtureManager::slotModeChanged(Doc::Mode mode)
 
 void FixtureManager::slotFixtureGroupRemoved(quint32 id)
 {
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
-    {
-        QTreeWidgetItem* item = m_tree->topLevelItem(i);
-        Q_ASSERT(item != NULL);
-        QVariant var = item->data(KColumnName, PROP_GROUP);
-        if (var.isValid() && var.toUInt() == id)
-            delete item;
-    }
-
+    Q_UNUSED(id);
     updateGroupMenu();
 }
 
 void FixtureManager::slotFixtureGroupChanged(quint32 id)
 {
-    QTreeWidgetItem* item = groupItem(id);
-    if (item == NULL)
-        return;
-
-    FixtureGroup* grp = m_doc->fixtureGroup(id);
-    Q_ASSERT(grp != NULL);
-    updateGroupItem(item, grp);
+    Q_UNUSED(id);
+    updateGroupMenu();
 }
 
 /*****************************************************************************
@@ -274,30 +236,35 @@ void FixtureManager::initDataView()
     m_splitter->setSizePolicy(QSizePolicy::Expanding,
                               QSizePolicy::Expanding);
 
-    /* Create a tree widget to the left part of the splitter */
-    m_tree = new QTreeWidget(this);
+    /* Create a tree view to the left part of the splitter */
+    m_model = new FixtureTreeModel(m_doc, this);
+    m_tree = new QTreeView(this);
     m_splitter->addWidget(m_tree);
 
-    QStringList labels;
-    labels << tr("Name") << tr("Universe") << tr("Address");
-    m_tree->setHeaderLabels(labels);
+    m_tree->setModel(m_model);
     m_tree->setRootIsDecorated(true);
+    m_tree->setUniformRowHeights(true);
     m_tree->setSortingEnabled(true);
     m_tree->setAllColumnsShowFocus(true);
-    m_tree->sortByColumn(KColumnAddress, Qt::AscendingOrder);
+    m_tree->sortByColumn(FixtureTreeModel::AddressColumn, Qt::AscendingOrder);
     m_tree->setContextMenuPolicy(Qt::CustomContextMenu);
     m_tree->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_tree->header()->setResizeMode(QHeaderView::ResizeToContents);
 
-    connect(m_tree, SIGNAL(itemSelectionChanged()),
+    connect(m_tree->selectionModel(), SIGNAL(selectionChanged(const QItemSelection&,const QItemSelection&)),
             this, SLOT(slotSelectionChanged()));
 
-    connect(m_tree, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)),
-            this, SLOT(slotDoubleClicked(QTreeWidgetItem*)));
+    connect(m_tree, SIGNAL(doubleClicked(const QModelIndex&)),
+            this, SLOT(slotDoubleClicked(const QModelIndex&)));
 
     connect(m_tree, SIGNAL(customContextMenuRequested(const QPoint&)),
             this, SLOT(slotContextMenuRequested(const QPoint&)));
 
+    connect(m_model, SIGNAL(modelAboutToBeReset()),
+            this, SLOT(slotModelAboutToBeReset()));
+    connect(m_model, SIGNAL(modelReset()),
+            this, SLOT(slotModelReset()));
+
     /* Create the text view */
     createInfo();
 
@@ -306,128 +273,24 @@ void FixtureManager::initDataView()
 
 void FixtureManager::updateView()
 {
-    // Record which groups are open
-    QList <QVariant> openGroups;
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
-    {
-        QTreeWidgetItem* item = m_tree->topLevelItem(i);
-        if (item->isExpanded() == true)
-            openGroups << item->data(KColumnName, PROP_GROUP);
-    }
-
-    // Clear the view
-    m_tree->clear();
-
-    // Insert known fixture groups and their children
-    foreach (FixtureGroup* grp, m_doc->fixtureGroups())
-    {
-        QTreeWidgetItem* grpItem = new QTreeWidgetItem(m_tree);
-        updateGroupItem(grpItem, grp);
-    }
-
-    // Insert the "All fixtures group"
-    QTreeWidgetItem* grpItem = new QTreeWidgetItem(m_tree);
-    grpItem->setText(KColumnName, tr("All fixtures"));
-
-    // Add all fixtures under "All fixture group"
-    foreach (Fixture* fixture, m_doc->fixtures())
-    {
-        Q_ASSERT(fixture != NULL);
-        QTreeWidgetItem* item = new QTreeWidgetItem(grpItem);
-        updateFixtureItem(item, fixture);
-    }
-
-    // Reopen groups that were open before update
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
-    {
-        QTreeWidgetItem* item = m_tree->topLevelItem(i);
-        QVariant var = item->data(KColumnName, PROP_GROUP);
-        if (openGroups.contains(var) == true)
-        {
-            item->setExpanded(true);
-            openGroups.removeAll(var);
-        }
-    }
+    // The model keeps itself up to date, but a full refresh can be forced
+    m_model->refresh();
 
     updateGroupMenu();
     slotModeChanged(m_doc->mode());
 }
 
-QTreeWidgetItem* FixtureManager::fixtureItem(quint32 id) const
-{
-    QTreeWidgetItemIterator it(m_tree);
-    while (*it != NULL)
-    {
-        QTreeWidgetItem* item(*it);
-        QVariant var = item->data(KColumnName, PROP_FIXTURE);
-        if (var.isValid() == true && var.toUInt() == id)
-            return item;
-        ++it;
-    }
-
-    return NULL;
-}
-
-QTreeWidgetItem* FixtureManager::groupItem(quint32 id) const
+QList <quint32> FixtureManager::selectedFixtures() const
 {
-    QTreeWidgetItemIterator it(m_tree);
-    while (*it != NULL)
+    QList <quint32> list;
+    foreach (QModelIndex index, m_tree->selectionModel()->selectedRows())
     {
-        QTreeWidgetItem* item(*it);
-        QVariant var = item->data(KColumnName, PROP_GROUP);
-        if (var.isValid() == true && var.toUInt() == id)
-            return item;
-        ++it;
+        quint32 id = m_model->fixtureId(index);
+        if (id != Fixture::invalidId() && list.contains(id) == false)
+            list << id;
     }
 
-    return NULL;
-}
-
-void FixtureManager::updateFixtureItem(QTreeWidgetItem* item, const Fixture* fxi)
-{
-    QString s;
-
-    Q_ASSERT(item != NULL);
-    Q_ASSERT(fxi != NULL);
-
-    // Universe column
-    item->setText(KColumnUniverse, QString("%1").arg(fxi->universe() + 1));
-
-    // Address column
-    s.sprintf("%.3d - %.3d", fxi->address() + 1, fxi->address() + fxi->channels());
-
-    item->setText(KColumnAddress, s);
-
-    // Name column
-    item->setText(KColumnName, fxi->name());
-
-    // ID column
-    item->setData(KColumnName, PROP_FIXTURE, fxi->id());
-}
-
-void FixtureManager::updateGroupItem(QTreeWidgetItem* item, const FixtureGroup* grp)
-{
-    Q_ASSERT(item != NULL);
-    Q_ASSERT(grp != NULL);
-
-    item->setText(KColumnName, grp->name());
-    item->setData(KColumnName, PROP_GROUP, grp->id());
-
-    // This should be a safe check because simultaneous add/removal is not possible,
-    // which could result in changes in fixtures but with the same fixture count.
-    if (item->childCount() != grp->fixtureList().size())
-    {
-        // Remove existing children
-        while (item->childCount() > 0)
-            delete item->child(0);
-
-        // Add group's children
-        foreach (quint32 id, grp->fixtureList())
-        {
-            QTreeWidgetItem* grpItem = new QTreeWidgetItem(item);
-            updateFixtureItem(grpItem, m_doc->fixture(id));
-        }
-    }
+    return list;
 }
 
 void FixtureManager::fixtureSelected(quint32 id)
@@ -493,23 +356,21 @@ void FixtureManager::createInfo()
 
 void FixtureManager::slotSelectionChanged()
 {
-    int selectedCount = m_tree->selectedItems().size();
+    QModelIndexList selected(m_tree->selectionModel()->selectedRows());
+    int selectedCount = selected.size();
     if (selectedCount == 1)
     {
-        QTreeWidgetItem* item = m_tree->selectedItems().first();
-        Q_ASSERT(item != NULL);
+        QModelIndex index(selected.first());
 
         // Set the text view's contents
-        QVariant fxivar = item->data(KColumnName, PROP_FIXTURE);
-        QVariant grpvar = item->data(KColumnName, PROP_GROUP);
-        if (fxivar.isValid() == true)
+        if (m_model->fixtureId(index) != Fixture::invalidId())
         {
             // Selected a fixture
-            fixtureSelected(fxivar.toUInt());
+            fixtureSelected(m_model->fixtureId(index));
         }
-        else if (grpvar.isValid() == true)
+        else if (m_model->isGroup(index) == true)
         {
-            FixtureGroup* grp = m_doc->fixtureGroup(grpvar.toUInt());
+            FixtureGroup* grp = m_doc->fixtureGroup(m_model->groupId(index));
             Q_ASSERT(grp != NULL);
             fixtureGroupSelected(grp);
         }
@@ -543,7 +404,7 @@ void FixtureManager::slotSelectionChanged()
         }
         else
         {
-            if (m_tree->topLevelItemCount() <= 0)
+            if (m_doc->fixtures().isEmpty() == true)
             {
                 info = tr("<HTML><BODY><H1>No fixtures</H1>" \
                           "<P>Click <IMG SRC=\"" ":/edit_add.png\">" \
@@ -567,28 +428,64 @@ void FixtureManager::slotSelectionChanged()
     slotModeChanged(m_doc->mode());
 }
 
-void FixtureManager::slotDoubleClicked(QTreeWidgetItem* item)
+void FixtureManager::slotDoubleClicked(const QModelIndex& index)
 {
-    if (item != NULL && m_doc->mode() != Doc::Operate)
+    if (index.isValid() == true && m_doc->mode() != Doc::Operate)
         slotProperties();
 }
 
-void FixtureManager::selectGroup(quint32 id)
+void FixtureManager::slotModelAboutToBeReset()
 {
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
+    m_expandedGroups.clear();
+    foreach (quint32 group, m_model->categoryKeys())
     {
-        QTreeWidgetItem* item = m_tree->topLevelItem(i);
-        QVariant var = item->data(KColumnName, PROP_GROUP);
-        if (var.isValid() == false)
-            continue;
+        if (m_tree->isExpanded(m_model->categoryIndex(group)) == true)
+            m_expandedGroups << group;
+    }
 
-        if (var.toUInt() == id)
-        {
-            m_tree->setCurrentItem(item);
-            slotSelectionChanged();
-            break;
-        }
+    m_resetCurrentFixture = m_model->fixtureId(m_tree->currentIndex());
+    m_resetCurrentGroup = m_model->groupId(m_tree->currentIndex());
+}
+
+void FixtureManager::slotModelReset()
+{
+    // Reopen groups that were open before the reset
+    foreach (quint32 group, m_expandedGroups)
+    {
+        QModelIndex index = m_model->categoryIndex(group);
+        if (index.isValid() == true)
+            m_tree->expand(index);
     }
+
+    m_expandedGroups.clear();
+
+    if (m_resetCurrentFixture != Fixture::invalidId())
+        selectFixture(m_resetCurrentFixture, m_resetCurrentGroup);
+    else if (m_resetCurrentGroup != FixtureGroup::invalidId())
+        selectGroup(m_resetCurrentGroup);
+
+    m_resetCurrentFixture = Fixture::invalidId();
+    m_resetCurrentGroup = FixtureGroup::invalidId();
+}
+
+void FixtureManager::selectGroup(quint32 id)
+{
+    QModelIndex index = m_model->groupIndex(id);
+    if (index.isValid() == false)
+        return;
+
+    m_tree->setCurrentIndex(index);
+    slotSelectionChanged();
+}
+
+void FixtureManager::selectFixture(quint32 id, quint32 group)
+{
+    QModelIndex index = m_model->fixtureIndex(id, group);
+    if (index.isValid() == false)
+        return;
+
+    m_tree->scrollTo(index);
+    m_tree->setCurrentIndex(index);
 }
 
 QString FixtureManager::fixtureInfoStyleSheetHeader()
@@ -722,25 +619,8 @@ void FixtureManager::slotAdd()
     const QLCFixtureDef* fixtureDef = af.fixtureDef();
     const QLCFixtureMode* mode = af.mode();
 
-    FixtureGroup* addToGroup = NULL;
-    QTreeWidgetItem* current = m_tree->currentItem();
-    if (current != NULL)
-    {
-        if (current->parent() != NULL)
-        {
-            // Fixture selected
-            QVariant var = current->parent()->data(KColumnName, PROP_GROUP);
-            if (var.isValid() == true)
-                addToGroup = m_doc->fixtureGroup(var.toUInt());
-        }
-        else
-        {
-            // Group selected
-            QVariant var = current->data(KColumnName, PROP_GROUP);
-            if (var.isValid() == true)
-                addToGroup = m_doc->fixtureGroup(var.toUInt());
-        }
-    }
+    // Add the new fixtures also to the current group (or current fixture's group)
+    FixtureGroup* addToGroup = m_doc->fixtureGroup(m_model->groupId(m_tree->currentIndex()));
 
     QString modname;
 
@@ -760,6 +640,9 @@ void FixtureManager::slotAdd()
     else
         modname = name;
 
+    /* Let the views catch up only after all fixtures have been added */
+    m_doc->beginBatch();
+
     /* Create the fixture */
     Fixture* fxi = new Fixture(m_doc);
 
@@ -812,11 +695,12 @@ void FixtureManager::slotAdd()
             addToGroup->assignFixture(latestFxi);
     }
 
-    QTreeWidgetItem* selectItem = fixtureItem(latestFxi);
-    if (selectItem != NULL)
-        m_tree->setCurrentItem(selectItem);
+    m_doc->endBatch();
 
-    updateView();
+    if (addToGroup != NULL)
+        selectFixture(latestFxi, addToGroup->id());
+    else
+        selectFixture(latestFxi);
 }
 
 void FixtureManager::slotRemove()
@@ -829,49 +713,39 @@ void FixtureManager::slotRemove()
         return;
     }
 
-    QListIterator <QTreeWidgetItem*> it(m_tree->selectedItems());
-    while (it.hasNext() == true)
+    // Pick the IDs first since the selection changes as the items go away
+    QList <quint32> fixtures(selectedFixtures());
+    QList <quint32> groups;
+    foreach (QModelIndex index, m_tree->selectionModel()->selectedRows())
     {
-        QTreeWidgetItem* item(it.next());
-        Q_ASSERT(item != NULL);
+        if (m_model->isGroup(index) == true)
+            groups << m_model->groupId(index);
+    }
 
-        QVariant var = item->data(KColumnName, PROP_FIXTURE);
-        if (var.isValid() == true)
-        {
-            quint32 id = var.toUInt();
-
-            /** @todo This is REALLY bogus here, since Fixture or Doc should do
-                this. However, FixtureManager is the only place to destroy fixtures,
-                so it's rather safe to reset the fixture's address space here. */
-            Fixture* fxi = m_doc->fixture(id);
-            Q_ASSERT(fxi != NULL);
-            UniverseArray* ua = m_doc->outputMap()->claimUniverses();
-            ua->reset(fxi->address(), fxi->channels());
-            m_doc->outputMap()->releaseUniverses();
-
-            m_doc->deleteFixture(id);
-        }
-        else
-        {
-            var = item->data(KColumnName, PROP_GROUP);
-            if (var.isValid() == false)
-                continue;
+    m_doc->beginBatch();
 
-            quint32 id = var.toUInt();
-            m_doc->deleteFixtureGroup(id);
-        }
+    foreach (quint32 id, fixtures)
+    {
+        /** @todo This is REALLY bogus here, since Fixture or Doc should do
+            this. However, FixtureManager is the only place to destroy fixtures,
+            so it's rather safe to reset the fixture's address space here. */
+        Fixture* fxi = m_doc->fixture(id);
+        Q_ASSERT(fxi != NULL);
+        UniverseArray* ua = m_doc->outputMap()->claimUniverses();
+        ua->reset(fxi->address(), fxi->channels());
+        m_doc->outputMap()->releaseUniverses();
+
+        m_doc->deleteFixture(id);
     }
-}
 
-void FixtureManager::editFixtureProperties(QTreeWidgetItem* item)
-{
-    Q_ASSERT(item != NULL);
+    foreach (quint32 id, groups)
+        m_doc->deleteFixtureGroup(id);
 
-    QVariant var = item->data(KColumnName, PROP_FIXTURE);
-    if (var.isValid() == false)
-        return;
+    m_doc->endBatch();
+}
 
-    quint32 id = var.toUInt();
+void FixtureManager::editFixtureProperties(quint32 id)
+{
     Fixture* fxi = m_doc->fixture(id);
     if (fxi == NULL)
         return;
@@ -919,25 +793,17 @@ void FixtureManager::editFixtureProperties(QTreeWidgetItem* item)
             fxi->setChannels(af.channels());
         }
 
-        updateFixtureItem(item, fxi);
         slotSelectionChanged();
     }
 }
 
-int FixtureManager::headCount(const QList <QTreeWidgetItem*>& items) const
+int FixtureManager::headCount(const QList <quint32>& fixtures) const
 {
     int count = 0;
-    QListIterator <QTreeWidgetItem*> it(items);
-    while (it.hasNext() == true)
+    foreach (quint32 id, fixtures)
     {
-        QTreeWidgetItem* item = it.next();
-        Q_ASSERT(item != NULL);
-
-        QVariant var = item->data(KColumnName, PROP_FIXTURE);
-        if (var.isValid() == false)
-            continue;
-
-        Fixture* fxi = m_doc->fixture(var.toUInt());
+        Fixture* fxi = m_doc->fixture(id);
+        Q_ASSERT(fxi != NULL);
         count += fxi->heads();
     }
 
@@ -946,13 +812,9 @@ int FixtureManager::headCount(const QList <QTreeWidgetItem*>& items) const
 
 void FixtureManager::slotProperties()
 {
-    QTreeWidgetItem* item = m_tree->currentItem();
-    if (item == NULL)
-        return;
-
-    QVariant var = item->data(KColumnName, PROP_FIXTURE);
-    if (var.isValid() == true)
-        editFixtureProperties(item);
+    quint32 id = m_model->fixtureId(m_tree->currentIndex());
+    if (id != Fixture::invalidId())
+        editFixtureProperties(id);
 }
 
 void FixtureManager::slotUnGroup()
@@ -964,30 +826,23 @@ void FixtureManager::slotUnGroup()
         return;
     }
 
-    // Because FixtureGroup::resignFixture() emits changed(), which makes the tree
-    // update its contents in the middle, invalidating m_tree->selectedItems(),
-    // we must pick the list of fixtures and groups first and then resign them in
-    // one big bunch.
+    // Because FixtureGroup::resignFixture() removes rows from the model,
+    // invalidating the selection, we must pick the list of fixtures and
+    // groups first and then resign them in one big bunch.
     QList <QPair<quint32,quint32> > resignList;
 
-    foreach (QTreeWidgetItem* item, m_tree->selectedItems())
+    foreach (QModelIndex index, m_tree->selectionModel()->selectedRows())
     {
-        if (item->parent() == NULL)
-            continue;
-
-        QVariant var = item->parent()->data(KColumnName, PROP_GROUP);
-        if (var.isValid() == false)
-            continue;
-        quint32 grp = var.toUInt();
-
-        var = item->data(KColumnName, PROP_FIXTURE);
-        if (var.isValid() == false)
+        quint32 grp = m_model->groupId(index);
+        quint32 fxi = m_model->fixtureId(index);
+        if (grp == FixtureGroup::invalidId() || fxi == Fixture::invalidId())
             continue;
-        quint32 fxi = var.toUInt();
 
         resignList << QPair <quint32,quint32> (grp, fxi);
     }
 
+    m_doc->beginBatch();
+
     QListIterator <QPair<quint32,quint32> > it(resignList);
     while (it.hasNext() == true)
     {
@@ -996,11 +851,14 @@ void FixtureManager::slotUnGroup()
         Q_ASSERT(grp != NULL);
         grp->resignFixture(pair.second);
     }
+
+    m_doc->endBatch();
 }
 
 void FixtureManager::slotGroupSelected(QAction* action)
 {
     FixtureGroup* grp = NULL;
+    QList <quint32> fixtures(selectedFixtures());
 
     if (action->data().isValid() == true)
     {
@@ -1013,7 +871,7 @@ void FixtureManager::slotGroupSelected(QAction* action)
         // New Group selected.
 
         // Suggest an equilateral grid
-        qreal side = sqrt(headCount(m_tree->selectedItems()));
+        qreal side = sqrt(headCount(fixtures));
         if (side != floor(side))
             side += 1; // Fixture number doesn't provide a full square
 
@@ -1030,17 +888,11 @@ void FixtureManager::slotGroupSelected(QAction* action)
         updateGroupMenu();
     }
 
-    // Assign selected fixture items to the group
-    foreach (QTreeWidgetItem* item, m_tree->selectedItems())
-    {
-        QVariant var = item->data(KColumnName, PROP_FIXTURE);
-        if (var.isValid() == false)
-            continue;
-
-        grp->assignFixture(var.toUInt());
-    }
-
-    updateView();
+    // Assign selected fixtures to the group
+    m_doc->beginBatch();
+    foreach (quint32 id, fixtures)
+        grp->assignFixture(id);
+    m_doc->endBatch();
 }
 
 void FixtureManager::slotContextMenuRequested(const QPoint&)
@@ -23,6 +23,7 @@
 #define FIXTUREMANAGER_H
 
 #include <QWidget>
+#include <QList>
 
 #include "function.h"
 #include "fixture.h"
@@ -30,9 +31,10 @@
 
 class QLCFixtureDefCache;
 class FixtureGroupEditor;
-class QTreeWidgetItem;
+class FixtureTreeModel;
 class QTextBrowser;
-class QTreeWidget;
+class QModelIndex;
+class QTreeView;
 class QTabWidget;
 class OutputMap;
 class QSplitter;
@@ -70,9 +72,6 @@ private:
      * Doc signal handlers
      ********************************************************************/
 public slots:
-    /** Callback for Doc::fixtureRemoved() signals */
-    void slotFixtureRemoved(quint32 id);
-
     /** Callback that listens to mode change signals */
     void slotModeChanged(Doc::Mode mode);
 
@@ -93,20 +92,11 @@ public:
     void updateView();
 
 private:
-    /** Get a QTreeWidgetItem whose fixture ID is $id */
-    QTreeWidgetItem* fixtureItem(quint32 id) const;
-
-    /** Get a QTreeWidgetItem whose group ID is $id */
-    QTreeWidgetItem* groupItem(quint32 id) const;
-
     /** Construct the list view and data view */
     void initDataView();
 
-    /** Update a single fixture's data into a QTreeWidgetItem */
-    void updateFixtureItem(QTreeWidgetItem* item, const Fixture* fxi);
-
-    /** Update a group's data to and under $item */
-    void updateGroupItem(QTreeWidgetItem* item, const FixtureGroup* grp);
+    /** Get the IDs of all selected fixtures, without duplicates */
+    QList <quint32> selectedFixtures() const;
 
     /** Handle single fixture selection */
     void fixtureSelected(quint32 id);
@@ -122,18 +112,32 @@ private slots:
     void slotSelectionChanged();
 
     /** Callback for mouse double clicks */
-    void slotDoubleClicked(QTreeWidgetItem* item);
+    void slotDoubleClicked(const QModelIndex& index);
+
+    /** Remember expanded groups & the current item over a model reset */
+    void slotModelAboutToBeReset();
+
+    /** Restore expanded groups & the current item after a model reset */
+    void slotModelReset();
 
 private:
     /** Select a fixture group */
     void selectGroup(quint32 id);
 
+    /** Select a fixture under the given group ("All fixtures" by default) */
+    void selectFixture(quint32 id, quint32 group = FixtureGroup::invalidId());
+
     /** Get a CSS style sheet & HTML header for fixture info */
     QString fixtureInfoStyleSheetHeader();
 
 private:
     QSplitter* m_splitter;
-    QTreeWidget* m_tree;
+    QTreeView* m_tree;
+    FixtureTreeModel* m_model;
+
+    QList <quint32> m_expandedGroups;
+    quint32 m_resetCurrentFixture;
+    quint32 m_resetCurrentGroup;
 
     QTextBrowser* m_info;
     FixtureGroupEditor* m_groupEditor;
@@ -151,11 +155,11 @@ private:
     /** Construct the toolbar */
     void initToolBar();
 
-    /** Edit properties for the fixture represented by $item */
-    void editFixtureProperties(QTreeWidgetItem* item);
+    /** Edit properties for the fixture whose ID is $id */
+    void editFixtureProperties(quint32 id);
 
-    /** Count the number of heads in the list of fixture items */
-    int headCount(const QList <QTreeWidgetItem*>& items) const;
+    /** Count the number of heads in the list of fixtures */
+    int headCount(const QList <quint32>& fixtures) const;
 
 private slots:
     void slotAdd();
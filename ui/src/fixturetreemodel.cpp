@@ -0,0 +1,359 @@
+/*
+  Q Light Controller
+  fixturetreemodel.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#include <QSetIterator>
+
+#include "fixturetreemodel.h"
+#include "fixturegroup.h"
+#include "fixture.h"
+
+FixtureTreeModel::FixtureTreeModel(Doc* doc, QObject* parent)
+    : DocTreeModel(parent)
+    , m_doc(doc)
+    , m_clearing(false)
+{
+    Q_ASSERT(doc != NULL);
+
+    connect(m_doc, SIGNAL(clearing()), this, SLOT(slotClearing()));
+    connect(m_doc, SIGNAL(cleared()), this, SLOT(slotCleared()));
+    connect(m_doc, SIGNAL(fixtureAdded(quint32)), this, SLOT(slotFixtureAdded(quint32)));
+    connect(m_doc, SIGNAL(fixtureRemoved(quint32)), this, SLOT(slotFixtureRemoved(quint32)));
+    connect(m_doc, SIGNAL(fixtureChanged(quint32)), this, SLOT(slotFixtureChanged(quint32)));
+    connect(m_doc, SIGNAL(fixtureGroupAdded(quint32)), this, SLOT(slotFixtureGroupAdded(quint32)));
+    connect(m_doc, SIGNAL(fixtureGroupRemoved(quint32)), this, SLOT(slotFixtureGroupRemoved(quint32)));
+    connect(m_doc, SIGNAL(fixtureGroupChanged(quint32)), this, SLOT(slotFixtureGroupChanged(quint32)));
+    connect(m_doc, SIGNAL(batchFinished(const Doc::BatchChanges&)),
+            this, SLOT(slotBatchFinished(const Doc::BatchChanges&)));
+
+    sort(AddressColumn, Qt::AscendingOrder);
+    refresh();
+}
+
+FixtureTreeModel::~FixtureTreeModel()
+{
+}
+
+void FixtureTreeModel::refresh()
+{
+    QHash <quint32,QList <quint32> > contents;
+
+    QList <quint32>& all(contents[FixtureGroup::invalidId()]);
+    foreach (Fixture* fxi, m_doc->fixtures())
+        all << fxi->id();
+
+    foreach (FixtureGroup* grp, m_doc->fixtureGroups())
+        contents[grp->id()] = grp->fixtureList();
+
+    setContents(contents);
+}
+
+quint32 FixtureTreeModel::fixtureId(const QModelIndex& index) const
+{
+    quint32 id = itemId(index);
+    if (id == invalidId())
+        return Fixture::invalidId();
+    else
+        return id;
+}
+
+quint32 FixtureTreeModel::groupId(const QModelIndex& index) const
+{
+    if (index.isValid() == false)
+        return FixtureGroup::invalidId();
+    else
+        return categoryKey(index);
+}
+
+bool FixtureTreeModel::isGroup(const QModelIndex& index) const
+{
+    return (isCategory(index) == true && categoryKey(index) != FixtureGroup::invalidId());
+}
+
+bool FixtureTreeModel::isAllFixtures(const QModelIndex& index) const
+{
+    return (isCategory(index) == true && categoryKey(index) == FixtureGroup::invalidId());
+}
+
+QModelIndex FixtureTreeModel::groupIndex(quint32 id) const
+{
+    return categoryIndex(id);
+}
+
+QModelIndex FixtureTreeModel::fixtureIndex(quint32 id, quint32 group)
+{
+    return itemIndex(group, id);
+}
+
+int FixtureTreeModel::incrementalLimit()
+{
+    return 32;
+}
+
+QList <quint32> FixtureTreeModel::groupFixtures(quint32 id) const
+{
+    FixtureGroup* grp = m_doc->fixtureGroup(id);
+    if (grp == NULL)
+        return QList <quint32> ();
+    else
+        return grp->fixtureList();
+}
+
+/****************************************************************************
+ * Doc signals
+ ****************************************************************************/
+
+void FixtureTreeModel::slotClearing()
+{
+    /* Don't bother removing everything one by one */
+    m_clearing = true;
+}
+
+void FixtureTreeModel::slotCleared()
+{
+    m_clearing = false;
+    refresh();
+}
+
+void FixtureTreeModel::slotFixtureAdded(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    addItem(FixtureGroup::invalidId(), id);
+}
+
+void FixtureTreeModel::slotFixtureRemoved(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    removeItem(id, false);
+}
+
+void FixtureTreeModel::slotFixtureChanged(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    updateItem(id);
+}
+
+void FixtureTreeModel::slotFixtureGroupAdded(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    addCategory(id);
+    setItems(id, groupFixtures(id));
+}
+
+void FixtureTreeModel::slotFixtureGroupRemoved(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    removeCategory(id);
+}
+
+void FixtureTreeModel::slotFixtureGroupChanged(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    updateCategory(id);
+    setItems(id, groupFixtures(id));
+}
+
+void FixtureTreeModel::slotBatchFinished(const Doc::BatchChanges& changes)
+{
+    if (changes.fixtures.isEmpty() == true && changes.fixtureGroups.isEmpty() == true)
+        return;
+
+    if (changes.fixtures.size() + changes.fixtureGroups.size() > incrementalLimit())
+    {
+        refresh();
+        return;
+    }
+
+    QSetIterator <quint32> frit(changes.fixtures.removed);
+    while (frit.hasNext() == true)
+        removeItem(frit.next(), false);
+
+    QSetIterator <quint32> grit(changes.fixtureGroups.removed);
+    while (grit.hasNext() == true)
+        removeCategory(grit.next());
+
+    QSetIterator <quint32> fait(changes.fixtures.added);
+    while (fait.hasNext() == true)
+        addItem(FixtureGroup::invalidId(), fait.next());
+
+    QSetIterator <quint32> gait(changes.fixtureGroups.added);
+    while (gait.hasNext() == true)
+    {
+        quint32 id = gait.next();
+        addCategory(id);
+        setItems(id, groupFixtures(id));
+    }
+
+    QSetIterator <quint32> gcit(changes.fixtureGroups.changed);
+    while (gcit.hasNext() == true)
+    {
+        quint32 id = gcit.next();
+        updateCategory(id);
+        setItems(id, groupFixtures(id));
+    }
+
+    QSetIterator <quint32> fcit(changes.fixtures.changed);
+    while (fcit.hasNext() == true)
+        updateItem(fcit.next());
+}
+
+/****************************************************************************
+ * DocTreeModel
+ ****************************************************************************/
+
+bool FixtureTreeModel::itemLessThan(quint32 a, quint32 b, int column) const
+{
+    Fixture* fa = m_doc->fixture(a);
+    Fixture* fb = m_doc->fixture(b);
+    if (fa == NULL || fb == NULL)
+        return a < b;
+
+    switch (column)
+    {
+    case NameColumn:
+    {
+        int result = fa->name().compare(fb->name());
+        if (result != 0)
+            return result < 0;
+        break;
+    }
+    case UniverseColumn:
+        if (fa->universeAddress() != fb->universeAddress())
+            return fa->universeAddress() < fb->universeAddress();
+        break;
+    default:
+    case AddressColumn:
+        if (fa->address() != fb->address())
+            return fa->address() < fb->address();
+        if (fa->universe() != fb->universe())
+            return fa->universe() < fb->universe();
+        break;
+    }
+
+    return a < b;
+}
+
+bool FixtureTreeModel::categoryLessThan(quint32 a, quint32 b) const
+{
+    /* "All fixtures" goes last */
+    if (a == FixtureGroup::invalidId())
+        return false;
+    else if (b == FixtureGroup::invalidId())
+        return true;
+
+    FixtureGroup* ga = m_doc->fixtureGroup(a);
+    FixtureGroup* gb = m_doc->fixtureGroup(b);
+    if (ga == NULL || gb == NULL)
+        return a < b;
+
+    int result = ga->name().compare(gb->name());
+    if (result == 0)
+        return a < b;
+    else
+        return result < 0;
+}
+
+/****************************************************************************
+ * QAbstractItemModel
+ ****************************************************************************/
+
+int FixtureTreeModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QVariant FixtureTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QVariant();
+
+    switch (section)
+    {
+    case NameColumn:
+        return tr("Name");
+    case UniverseColumn:
+        return tr("Universe");
+    case AddressColumn:
+        return tr("Address");
+    default:
+        return QVariant();
+    }
+}
+
+QVariant FixtureTreeModel::data(const QModelIndex& index, int role) const
+{
+    if (index.isValid() == false || role != Qt::DisplayRole)
+        return QVariant();
+
+    if (isCategory(index) == true)
+    {
+        if (index.column() != NameColumn)
+            return QVariant();
+
+        quint32 key = categoryKey(index);
+        if (key == FixtureGroup::invalidId())
+            return tr("All fixtures");
+
+        FixtureGroup* grp = m_doc->fixtureGroup(key);
+        if (grp == NULL)
+            return QVariant();
+        else
+            return grp->name();
+    }
+
+    Fixture* fxi = m_doc->fixture(itemId(index));
+    if (fxi == NULL)
+        return QVariant();
+
+    switch (index.column())
+    {
+    case NameColumn:
+        return fxi->name();
+    case UniverseColumn:
+        return QString("%1").arg(fxi->universe() + 1);
+    case AddressColumn:
+        return QString().sprintf("%.3d - %.3d", fxi->address() + 1,
+                                 fxi->address() + fxi->channels());
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags FixtureTreeModel::flags(const QModelIndex& index) const
+{
+    if (index.isValid() == false)
+        return 0;
+    else
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
@@ -0,0 +1,127 @@
+/*
+  Q Light Controller
+  fixturetreemodel.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#ifndef FIXTURETREEMODEL_H
+#define FIXTURETREEMODEL_H
+
+#include "doctreemodel.h"
+#include "doc.h"
+
+/**
+ * FixtureTreeModel lists Doc's fixture groups with their fixtures, followed
+ * by an "All fixtures" category that contains every fixture. The model
+ * follows Doc's fixture & fixture group signals on its own, except during
+ * Doc batches, after which it applies all of the batch's changes at once.
+ */
+class FixtureTreeModel : public DocTreeModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(FixtureTreeModel)
+
+public:
+    enum Columns
+    {
+        NameColumn     = 0,
+        UniverseColumn = 1,
+        AddressColumn  = 2,
+        ColumnCount    = 3
+    };
+
+    FixtureTreeModel(Doc* doc, QObject* parent = 0);
+    ~FixtureTreeModel();
+
+    /** Rebuild the whole model from Doc's fixtures & fixture groups */
+    void refresh();
+
+    /** Get the ID of the fixture at $index or Fixture::invalidId() */
+    quint32 fixtureId(const QModelIndex& index) const;
+
+    /**
+     * Get the ID of the group at $index or the group of the fixture at
+     * $index. Returns FixtureGroup::invalidId() for "All fixtures" and the
+     * fixtures under it.
+     */
+    quint32 groupId(const QModelIndex& index) const;
+
+    /** Check, whether $index refers to a fixture group */
+    bool isGroup(const QModelIndex& index) const;
+
+    /** Check, whether $index refers to the "All fixtures" category */
+    bool isAllFixtures(const QModelIndex& index) const;
+
+    /** Get the index of a fixture group */
+    QModelIndex groupIndex(quint32 id) const;
+
+    /**
+     * Get the index of a fixture (fetching it if necessary)
+     *
+     * @param id The fixture's ID
+     * @param group The group to look from, "All fixtures" by default
+     */
+    QModelIndex fixtureIndex(quint32 id, quint32 group = FixtureGroup::invalidId());
+
+    /**
+     * Batches with more changes than this are applied by rebuilding the
+     * whole model instead of changing one row at a time.
+     */
+    static int incrementalLimit();
+
+private:
+    /** Get the contents of a group category */
+    QList <quint32> groupFixtures(quint32 id) const;
+
+private:
+    Doc* m_doc;
+    bool m_clearing;
+
+    /************************************************************************
+     * Doc signals
+     ************************************************************************/
+private slots:
+    void slotClearing();
+    void slotCleared();
+    void slotFixtureAdded(quint32 id);
+    void slotFixtureRemoved(quint32 id);
+    void slotFixtureChanged(quint32 id);
+    void slotFixtureGroupAdded(quint32 id);
+    void slotFixtureGroupRemoved(quint32 id);
+    void slotFixtureGroupChanged(quint32 id);
+    void slotBatchFinished(const Doc::BatchChanges& changes);
+
+    /************************************************************************
+     * DocTreeModel
+     ************************************************************************/
+protected:
+    bool itemLessThan(quint32 a, quint32 b, int column) const;
+    bool categoryLessThan(quint32 a, quint32 b) const;
+
+    /************************************************************************
+     * QAbstractItemModel
+     ************************************************************************/
+public:
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex& index) const;
+};
+
+#endif
@@ -19,15 +19,13 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#include <QTreeWidgetItemIterator>
-#include <QTreeWidgetItem>
 #include <QMdiSubWindow>
 #include <QInputDialog>
-#include <QTreeWidget>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QCheckBox>
+#include <QTreeView>
 #include <QSplitter>
 #include <QSettings>
 #include <QMdiArea>
@@ -38,6 +36,7 @@
 #include <QList>
 #include <QIcon>
 
+#include "functiontreemodel.h"
 #include "collectioneditor.h"
 #include "functionmanager.h"
 #include "rgbmatrixeditor.h"
@@ -56,7 +55,6 @@
 #include "doc.h"
 #include "efx.h"
 
-#define PROP_ID Qt::UserRole
 #define COL_NAME 0
 
 #define SETTINGS_SPLITTER "functionmanager/splitter"
@@ -72,6 +70,8 @@ FunctionManager::FunctionManager(QWidget* parent, Doc* doc, Qt::WindowFlags flag
     , m_doc(doc)
     , m_splitter(NULL)
     , m_tree(NULL)
+    , m_model(NULL)
+    , m_resetCurrentFunction(Function::invalidId())
     , m_toolbar(NULL)
     , m_addSceneAction(NULL)
     , m_addChaserAction(NULL)
@@ -96,13 +96,7 @@ FunctionManager::FunctionManager(QWidget* parent, Doc* doc, Qt::WindowFlags flag
     updateActionStatus();
 
     connect(m_doc, SIGNAL(modeChanged(Doc::Mode)), this, SLOT(slotModeChanged()));
-    updateTree();
-
-    m_tree->sortItems(COL_NAME, Qt::AscendingOrder);
-
     connect(m_doc, SIGNAL(clearing()), this, SLOT(slotDocClearing()));
-    connect(m_doc, SIGNAL(functionChanged(quint32)), this, SLOT(slotFunctionChanged(quint32)));
-    connect(m_doc, SIGNAL(functionAdded(quint32)), this, SLOT(slotFunctionAdded(quint32)));
 
     QSettings settings;
     QVariant var = settings.value(SETTINGS_SPLITTER);
@@ -157,30 +151,9 @@ void FunctionManager::slotModeChanged()
 
 void FunctionManager::slotDocClearing()
 {
+    /* The model empties itself when Doc has been cleared */
     if (currentEditor() != NULL)
         delete currentEditor();
-    m_tree->clear();
-}
-
-void FunctionManager::slotFunctionChanged(quint32 id)
-{
-    Function* function = m_doc->function(id);
-    if (function == NULL)
-        return;
-
-    QTreeWidgetItem* item = functionItem(function);
-    if (item != NULL)
-        updateFunctionItem(item, function);
-}
-
-void FunctionManager::slotFunctionAdded(quint32 id)
-{
-    Function* function = m_doc->function(id);
-    if (function == NULL)
-        return;
-
-    QTreeWidgetItem* item = new QTreeWidgetItem(parentItem(function));
-    updateFunctionItem(item, function);
 }
 
 void FunctionManager::slotSubWindowActivated(QMdiSubWindow* sub)
@@ -297,91 +270,62 @@ void FunctionManager::slotAddScene()
 {
     Function* f = new Scene(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotAddChaser()
 {
     Function* f = new Chaser(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotAddCollection()
 {
     Function* f = new Collection(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotAddEFX()
 {
     Function* f = new EFX(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotAddRGBMatrix()
 {
     Function* f = new RGBMatrix(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotAddScript()
 {
     Function* f = new Script(m_doc);
     if (m_doc->addFunction(f) == true)
-    {
-        QTreeWidgetItem* item = functionItem(f);
-        Q_ASSERT(item != NULL);
-        m_tree->scrollToItem(item);
-        m_tree->setCurrentItem(item);
-    }
+        selectFunction(f->id());
 }
 
 void FunctionManager::slotWizard()
 {
+    /* The tree follows the functions that the wizard creates */
     FunctionWizard fw(this, m_doc);
-    if (fw.exec() == QDialog::Accepted)
-        updateTree();
+    fw.exec();
 }
 
 void FunctionManager::slotClone()
 {
-    QListIterator <QTreeWidgetItem*> it(m_tree->selectedItems());
+    /* Cloning changes the tree, so pick the selected IDs first */
+    QListIterator <quint32> it(selectedFunctions());
     while (it.hasNext() == true)
-        copyFunction(itemFunctionId(it.next()));
+        copyFunction(it.next());
 }
 
 void FunctionManager::slotDelete()
 {
-    QListIterator <QTreeWidgetItem*> it(m_tree->selectedItems());
+    QListIterator <quint32> it(selectedFunctions());
     if (it.hasNext() == false)
         return;
 
@@ -389,7 +333,11 @@ void FunctionManager::slotDelete()
 
     // Append functions' names to the message
     while (it.hasNext() == true)
-        msg += it.next()->text(COL_NAME) + QString(", ");
+    {
+        Function* function = m_doc->function(it.next());
+        if (function != NULL)
+            msg += function->name() + QString(", ");
+    }
 
     // Ask for user's confirmation
     if (QMessageBox::question(this, tr("Delete Functions"), msg,
@@ -413,7 +361,7 @@ void FunctionManager::slotSelectAll()
 
 void FunctionManager::updateActionStatus()
 {
-    if (m_tree->selectedItems().isEmpty() == false)
+    if (m_tree->selectionModel()->hasSelection() == true)
     {
         /* At least one function has been selected, so
            editing is possible. */
@@ -446,153 +394,85 @@ void FunctionManager::initSplitterView()
 
 void FunctionManager::initTree()
 {
-    m_tree = new QTreeWidget(this);
+    m_tree = new QTreeView(this);
     Q_ASSERT(m_splitter != NULL);
     m_splitter->addWidget(m_tree);
 
-    // Add two columns for function and type
-    QStringList labels;
-    labels << tr("Function");
-    m_tree->setHeaderLabels(labels);
+    m_model = new FunctionTreeModel(m_doc, this);
+    m_tree->setModel(m_model);
+
     m_tree->header()->setResizeMode(QHeaderView::ResizeToContents);
     m_tree->setRootIsDecorated(true);
     m_tree->setAllColumnsShowFocus(true);
+    m_tree->setUniformRowHeights(true);
     m_tree->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_tree->setContextMenuPolicy(Qt::CustomContextMenu);
     m_tree->setSortingEnabled(true);
     m_tree->sortByColumn(COL_NAME, Qt::AscendingOrder);
 
     // Catch selection changes
-    connect(m_tree, SIGNAL(itemSelectionChanged()),
+    connect(m_tree->selectionModel(),
+            SIGNAL(selectionChanged(const QItemSelection&,const QItemSelection&)),
             this, SLOT(slotTreeSelectionChanged()));
 
     // Catch right-mouse clicks
     connect(m_tree, SIGNAL(customContextMenuRequested(const QPoint&)),
             this, SLOT(slotTreeContextMenuRequested()));
+
+    // Keep the view's state over model resets
+    connect(m_model, SIGNAL(modelAboutToBeReset()),
+            this, SLOT(slotModelAboutToBeReset()));
+    connect(m_model, SIGNAL(modelReset()),
+            this, SLOT(slotModelReset()));
 }
 
 void FunctionManager::updateTree()
 {
-    m_tree->clear();
-    foreach (Function* function, m_doc->functions())
-        updateFunctionItem(new QTreeWidgetItem(parentItem(function)), function);
+    m_model->refresh();
 }
 
 void FunctionManager::selectFunction(quint32 id)
 {
-    Function* function = m_doc->function(id);
-    if (function == NULL)
+    QModelIndex index = m_model->functionIndex(id);
+    if (index.isValid() == false)
         return;
-    QTreeWidgetItem* item = functionItem(function);
-    if (item != NULL)
-        m_tree->setCurrentItem(item);
-}
-
-void FunctionManager::updateFunctionItem(QTreeWidgetItem* item, const Function* function)
-{
-    Q_ASSERT(item != NULL);
-    Q_ASSERT(function != NULL);
-    item->setText(COL_NAME, function->name());
-    item->setIcon(COL_NAME, functionIcon(function));
-    item->setData(COL_NAME, PROP_ID, function->id());
-}
-
-QTreeWidgetItem* FunctionManager::parentItem(const Function* function)
-{
-    Q_ASSERT(function != NULL);
-
-    // Search for a parent item for function->type()
-    for (int i = 0; i < m_tree->topLevelItemCount(); i++)
-    {
-        QTreeWidgetItem* item = m_tree->topLevelItem(i);
-        Q_ASSERT(item != NULL);
-        QVariant var = item->data(COL_NAME, Qt::UserRole);
-        if (var.isValid() == false)
-            continue;
-        Function::Type type = (Function::Type) var.toInt();
-        if (type == function->type())
-            return item;
-    }
-
-    // Parent item for the given type doesn't exist yet so create one
-    QTreeWidgetItem* item = new QTreeWidgetItem(m_tree);
-    item->setText(COL_NAME, Function::typeToString(function->type()));
-    item->setIcon(COL_NAME, functionIcon(function));
-    item->setData(COL_NAME, Qt::UserRole, function->type());
-    item->setFlags(Qt::ItemIsEnabled);
-    return item;
-}
 
-quint32 FunctionManager::itemFunctionId(const QTreeWidgetItem* item) const
-{
-    if (item == NULL || item->parent() == NULL)
-        return Function::invalidId();
-    else
-        return item->data(COL_NAME, PROP_ID).toUInt();
+    m_tree->scrollTo(index);
+    m_tree->setCurrentIndex(index);
 }
 
-QTreeWidgetItem* FunctionManager::functionItem(const Function* function)
+QList <quint32> FunctionManager::selectedFunctions() const
 {
-    Q_ASSERT(function != NULL);
-
-    QTreeWidgetItem* parent = parentItem(function);
-    Q_ASSERT(parent != NULL);
-
-    for (int i = 0; i < parent->childCount(); i++)
+    QList <quint32> ids;
+    foreach (const QModelIndex& index, m_tree->selectionModel()->selectedRows())
     {
-        QTreeWidgetItem* item = parent->child(i);
-        if (itemFunctionId(item) == function->id())
-            return item;
+        quint32 id = m_model->functionId(index);
+        if (id != Function::invalidId())
+            ids << id;
     }
 
-    return NULL;
-}
-
-QIcon FunctionManager::functionIcon(const Function* function) const
-{
-    switch (function->type())
-    {
-    case Function::Scene:
-        return QIcon(":/scene.png");
-    case Function::Chaser:
-        return QIcon(":/chaser.png");
-    case Function::EFX:
-        return QIcon(":/efx.png");
-    case Function::Collection:
-        return QIcon(":/collection.png");
-    case Function::RGBMatrix:
-        return QIcon(":/rgbmatrix.png");
-    case Function::Script:
-        return QIcon(":/script.png");
-    default:
-        return QIcon(":/function.png");
-    }
+    return ids;
 }
 
 void FunctionManager::deleteSelectedFunctions()
 {
-    QListIterator <QTreeWidgetItem*> it(m_tree->selectedItems());
+    /* Delete all functions in one batch so that the tree (and everything
+       else that follows Doc) is updated only once */
+    m_doc->beginBatch();
+    QListIterator <quint32> it(selectedFunctions());
     while (it.hasNext() == true)
-    {
-        QTreeWidgetItem* item(it.next());
-        quint32 fid = itemFunctionId(item);
-        m_doc->deleteFunction(fid);
-
-        QTreeWidgetItem* parent = item->parent();
-        delete item;
-        if (parent != NULL && parent->childCount() == 0)
-            delete parent;
-    }
+        m_doc->deleteFunction(it.next());
+    m_doc->endBatch();
 }
 
 void FunctionManager::slotTreeSelectionChanged()
 {
     updateActionStatus();
 
-    QList <QTreeWidgetItem*> selection(m_tree->selectedItems());
+    QList <quint32> selection(selectedFunctions());
     if (selection.size() == 1)
     {
-        Function* function = m_doc->function(itemFunctionId(selection.first()));
+        Function* function = m_doc->function(selection.first());
         if (function != NULL)
             editFunction(function);
     }
@@ -603,6 +483,34 @@ void FunctionManager::slotTreeSelectionChanged()
     }
 }
 
+void FunctionManager::slotModelAboutToBeReset()
+{
+    m_expandedTypes.clear();
+    foreach (quint32 type, m_model->categoryKeys())
+    {
+        if (m_tree->isExpanded(m_model->categoryIndex(type)) == true)
+            m_expandedTypes << type;
+    }
+
+    m_resetCurrentFunction = m_model->functionId(m_tree->currentIndex());
+}
+
+void FunctionManager::slotModelReset()
+{
+    foreach (quint32 type, m_expandedTypes)
+    {
+        QModelIndex index = m_model->categoryIndex(type);
+        if (index.isValid() == true)
+            m_tree->expand(index);
+    }
+
+    m_expandedTypes.clear();
+
+    if (m_resetCurrentFunction != Function::invalidId())
+        selectFunction(m_resetCurrentFunction);
+    m_resetCurrentFunction = Function::invalidId();
+}
+
 void FunctionManager::slotTreeContextMenuRequested()
 {
     QMenu menu(this);
@@ -639,8 +547,7 @@ void FunctionManager::copyFunction(quint32 fid)
     if (copy != NULL)
     {
         copy->setName(tr("Copy of %1").arg(function->name()));
-        QTreeWidgetItem* item = functionItem(copy);
-        m_tree->setCurrentItem(item);
+        selectFunction(copy->id());
     }
 }
 
@@ -28,9 +28,9 @@
 #include "function.h"
 #include "doc.h"
 
-class QTreeWidgetItem;
+class FunctionTreeModel;
 class QMdiSubWindow;
-class QTreeWidget;
+class QTreeView;
 class QSplitter;
 class QToolBar;
 class QAction;
@@ -67,8 +67,6 @@ protected:
 protected slots:
     void slotModeChanged();
     void slotDocClearing();
-    void slotFunctionChanged(quint32 id);
-    void slotFunctionAdded(quint32 id);
     void slotSubWindowActivated(QMdiSubWindow* sub);
 
 protected:
@@ -92,20 +90,8 @@ private:
     /** Init function tree view */
     void initTree();
 
-    /** Update $item's contents from the given $function */
-    void updateFunctionItem(QTreeWidgetItem* item, const Function* function);
-
-    /** Return a suitable parent item for the $function's type */
-    QTreeWidgetItem* parentItem(const Function* function);
-
-    /** Get the ID of the function represented by $item. */
-    quint32 itemFunctionId(const QTreeWidgetItem* item) const;
-
-    /** Get the item that represents the given function. */
-    QTreeWidgetItem* functionItem(const Function* function);
-
-    /** Get an icon that represents the given function's type */
-    QIcon functionIcon(const Function* function) const;
+    /** Get the IDs of the currently selected functions */
+    QList <quint32> selectedFunctions() const;
 
     /** Delete all currently selected functions */
     void deleteSelectedFunctions();
@@ -117,9 +103,20 @@ private slots:
     /** Right mouse button was clicked on function tree */
     void slotTreeContextMenuRequested();
 
+    /** Remember the expanded types & current function before a model reset */
+    void slotModelAboutToBeReset();
+
+    /** Restore the expanded types & current function after a model reset */
+    void slotModelReset();
+
 private:
     QSplitter* m_splitter;
-    QTreeWidget* m_tree;
+    QTreeView* m_tree;
+    FunctionTreeModel* m_model;
+
+    /** Expanded function types & the current function over a model reset */
+    QList <quint32> m_expandedTypes;
+    quint32 m_resetCurrentFunction;
 
     /*********************************************************************
      * Menus, toolbar & actions
@@ -0,0 +1,249 @@
+/*
+  Q Light Controller
+  functiontreemodel.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#include <QSetIterator>
+
+#include "functiontreemodel.h"
+
+FunctionTreeModel::FunctionTreeModel(Doc* doc, QObject* parent)
+    : DocTreeModel(parent)
+    , m_doc(doc)
+    , m_clearing(false)
+{
+    Q_ASSERT(doc != NULL);
+
+    m_icons[Function::Scene] = QIcon(":/scene.png");
+    m_icons[Function::Chaser] = QIcon(":/chaser.png");
+    m_icons[Function::EFX] = QIcon(":/efx.png");
+    m_icons[Function::Collection] = QIcon(":/collection.png");
+    m_icons[Function::RGBMatrix] = QIcon(":/rgbmatrix.png");
+    m_icons[Function::Script] = QIcon(":/script.png");
+    m_icons[Function::Undefined] = QIcon(":/function.png");
+
+    connect(m_doc, SIGNAL(clearing()), this, SLOT(slotClearing()));
+    connect(m_doc, SIGNAL(cleared()), this, SLOT(slotCleared()));
+    connect(m_doc, SIGNAL(functionAdded(quint32)), this, SLOT(slotFunctionAdded(quint32)));
+    connect(m_doc, SIGNAL(functionRemoved(quint32)), this, SLOT(slotFunctionRemoved(quint32)));
+    connect(m_doc, SIGNAL(functionChanged(quint32)), this, SLOT(slotFunctionChanged(quint32)));
+    connect(m_doc, SIGNAL(batchFinished(const Doc::BatchChanges&)),
+            this, SLOT(slotBatchFinished(const Doc::BatchChanges&)));
+
+    refresh();
+}
+
+FunctionTreeModel::~FunctionTreeModel()
+{
+}
+
+void FunctionTreeModel::refresh()
+{
+    /* Just sort the IDs into their categories here. Names are looked up
+       only when a category is expanded and its functions get sorted. */
+    QHash <quint32,QList <quint32> > contents;
+    foreach (Function* function, m_doc->functions())
+        contents[function->type()] << function->id();
+    setContents(contents);
+}
+
+quint32 FunctionTreeModel::functionId(const QModelIndex& index) const
+{
+    quint32 id = itemId(index);
+    if (id == invalidId())
+        return Function::invalidId();
+    else
+        return id;
+}
+
+QModelIndex FunctionTreeModel::functionIndex(quint32 id)
+{
+    Function* function = m_doc->function(id);
+    if (function == NULL)
+        return QModelIndex();
+    else
+        return itemIndex(function->type(), id);
+}
+
+QIcon FunctionTreeModel::typeIcon(Function::Type type) const
+{
+    if (m_icons.contains(type) == true)
+        return m_icons[type];
+    else
+        return m_icons[Function::Undefined];
+}
+
+int FunctionTreeModel::incrementalLimit()
+{
+    return 32;
+}
+
+/****************************************************************************
+ * Doc signals
+ ****************************************************************************/
+
+void FunctionTreeModel::slotClearing()
+{
+    /* Don't bother removing the functions one by one */
+    m_clearing = true;
+}
+
+void FunctionTreeModel::slotCleared()
+{
+    m_clearing = false;
+    refresh();
+}
+
+void FunctionTreeModel::slotFunctionAdded(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    Function* function = m_doc->function(id);
+    if (function != NULL)
+        addItem(function->type(), id);
+}
+
+void FunctionTreeModel::slotFunctionRemoved(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    removeItem(id, true);
+}
+
+void FunctionTreeModel::slotFunctionChanged(quint32 id)
+{
+    if (m_clearing == true || m_doc->isBatching() == true)
+        return;
+
+    updateItem(id);
+}
+
+void FunctionTreeModel::slotBatchFinished(const Doc::BatchChanges& changes)
+{
+    if (changes.functions.isEmpty() == true)
+        return;
+
+    if (changes.functions.size() > incrementalLimit())
+    {
+        refresh();
+        return;
+    }
+
+    QSetIterator <quint32> rit(changes.functions.removed);
+    while (rit.hasNext() == true)
+        removeItem(rit.next(), true);
+
+    QSetIterator <quint32> ait(changes.functions.added);
+    while (ait.hasNext() == true)
+    {
+        quint32 id = ait.next();
+        Function* function = m_doc->function(id);
+        if (function != NULL)
+            addItem(function->type(), id);
+    }
+
+    QSetIterator <quint32> cit(changes.functions.changed);
+    while (cit.hasNext() == true)
+        updateItem(cit.next());
+}
+
+/****************************************************************************
+ * DocTreeModel
+ ****************************************************************************/
+
+bool FunctionTreeModel::itemLessThan(quint32 a, quint32 b, int column) const
+{
+    Q_UNUSED(column);
+
+    Function* fa = m_doc->function(a);
+    Function* fb = m_doc->function(b);
+    if (fa == NULL || fb == NULL)
+        return a < b;
+
+    int result = fa->name().compare(fb->name());
+    if (result == 0)
+        return a < b;
+    else
+        return result < 0;
+}
+
+bool FunctionTreeModel::categoryLessThan(quint32 a, quint32 b) const
+{
+    return Function::typeToString(Function::Type(a)) <
+           Function::typeToString(Function::Type(b));
+}
+
+/****************************************************************************
+ * QAbstractItemModel
+ ****************************************************************************/
+
+int FunctionTreeModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant FunctionTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole)
+        return tr("Function");
+    else
+        return QVariant();
+}
+
+QVariant FunctionTreeModel::data(const QModelIndex& index, int role) const
+{
+    if (index.isValid() == false || index.column() != 0)
+        return QVariant();
+
+    if (isCategory(index) == true)
+    {
+        Function::Type type = Function::Type(categoryKey(index));
+        if (role == Qt::DisplayRole)
+            return Function::typeToString(type);
+        else if (role == Qt::DecorationRole)
+            return typeIcon(type);
+        else
+            return QVariant();
+    }
+
+    Function* function = m_doc->function(itemId(index));
+    if (function == NULL)
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return function->name();
+    else if (role == Qt::DecorationRole)
+        return typeIcon(function->type());
+    else
+        return QVariant();
+}
+
+Qt::ItemFlags FunctionTreeModel::flags(const QModelIndex& index) const
+{
+    if (index.isValid() == false)
+        return 0;
+    else if (isCategory(index) == true)
+        return Qt::ItemIsEnabled;
+    else
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
@@ -0,0 +1,99 @@
+/*
+  Q Light Controller
+  functiontreemodel.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#ifndef FUNCTIONTREEMODEL_H
+#define FUNCTIONTREEMODEL_H
+
+#include <QHash>
+#include <QIcon>
+
+#include "doctreemodel.h"
+#include "function.h"
+#include "doc.h"
+
+/**
+ * FunctionTreeModel lists Doc's functions under their function types.
+ * Functions are sorted by their names. The model follows Doc's function
+ * signals on its own, except during Doc batches, after which it applies
+ * all of the batch's changes at once.
+ */
+class FunctionTreeModel : public DocTreeModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(FunctionTreeModel)
+
+public:
+    FunctionTreeModel(Doc* doc, QObject* parent = 0);
+    ~FunctionTreeModel();
+
+    /** Rebuild the whole model from Doc's functions */
+    void refresh();
+
+    /** Get the ID of the function at $index or Function::invalidId() */
+    quint32 functionId(const QModelIndex& index) const;
+
+    /** Get the index of the given function (fetching it if necessary) */
+    QModelIndex functionIndex(quint32 id);
+
+    /** Get an icon that represents the given function type */
+    QIcon typeIcon(Function::Type type) const;
+
+    /**
+     * Batches with more changes than this are applied by rebuilding the
+     * whole model instead of changing one row at a time.
+     */
+    static int incrementalLimit();
+
+private:
+    Doc* m_doc;
+    bool m_clearing;
+    QHash <int,QIcon> m_icons;
+
+    /************************************************************************
+     * Doc signals
+     ************************************************************************/
+private slots:
+    void slotClearing();
+    void slotCleared();
+    void slotFunctionAdded(quint32 id);
+    void slotFunctionRemoved(quint32 id);
+    void slotFunctionChanged(quint32 id);
+    void slotBatchFinished(const Doc::BatchChanges& changes);
+
+    /************************************************************************
+     * DocTreeModel
+     ************************************************************************/
+protected:
+    bool itemLessThan(quint32 a, quint32 b, int column) const;
+    bool categoryLessThan(quint32 a, quint32 b) const;
+
+    /************************************************************************
+     * QAbstractItemModel
+     ************************************************************************/
+public:
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex& index) const;
+};
+
+#endif
@@ -84,12 +84,15 @@ void FunctionWizard::accept()
 {
     PaletteGenerator pal(m_doc, fixtures());
 
+    /* Report all of the new functions at once */
+    m_doc->beginBatch();
     if (m_coloursCheck->isChecked() == true)
         pal.createColours();
     if (m_goboCheck->isChecked() == true)
         pal.createGobos();
     if (m_shutterCheck->isChecked() == true)
         pal.createShutters();
+    m_doc->endBatch();
 
     QDialog::accept();
 }
@@ -22,10 +22,12 @@
 #include <QMdiSubWindow>
 #include <QApplication>
 #include <QActionGroup>
+#include <QKeySequence>
 #include <QFontDialog>
 #include <QScrollArea>
 #include <QSpacerItem>
 #include <QByteArray>
+#include <QSpinBox>
 #include <QMdiArea>
 #include <QToolBar>
 #include <QAction>
@@ -33,9 +35,10 @@
 #include <QIcon>
 #include <QtXml>
 
+#include "universemonitor.h"
 #include "monitorfixture.h"
+#include "monitorcanvas.h"
 #include "monitorlayout.h"
-#include "universearray.h"
 #include "outputmap.h"
 #include "monitor.h"
 #include "apputil.h"
@@ -47,6 +50,9 @@
 #define SETTINGS_FONT "monitor/font"
 #define SETTINGS_VALUESTYLE "monitor/valuestyle"
 #define SETTINGS_CHANNELSTYLE "monitor/channelstyle"
+#define SETTINGS_RATE "monitor/rate"
+#define SETTINGS_VIEWSTYLE "monitor/viewstyle"
+#define SETTINGS_ZOOM "monitor/zoom"
 
 Monitor* Monitor::s_instance = NULL;
 
@@ -57,41 +63,27 @@ Monitor* Monitor::s_instance = NULL;
 Monitor::Monitor(QWidget* parent, Doc* doc, Qt::WindowFlags f)
     : QWidget(parent, f)
     , m_doc(doc)
+    , m_scrollArea(NULL)
+    , m_monitorWidget(NULL)
+    , m_monitorLayout(NULL)
+    , m_canvas(NULL)
+    , m_zoomInAction(NULL)
+    , m_zoomOutAction(NULL)
+    , m_universeMonitor(new UniverseMonitor(doc->outputMap(), this))
 {
     Q_ASSERT(doc != NULL);
 
-    /* Master layout for toolbar and scroll area */
+    /* Master layout for toolbar and the view */
     new QVBoxLayout(this);
 
-    /* Scroll area that contains the monitor widget */
-    m_scrollArea = new QScrollArea(this);
-    m_scrollArea->setWidgetResizable(true);
-    layout()->addWidget(m_scrollArea);
-
-    /* Monitor widget that contains all MonitorFixtures */
-    m_monitorWidget = new QWidget(m_scrollArea);
-    m_monitorWidget->setBackgroundRole(QPalette::Dark);
-    m_monitorLayout = new MonitorLayout(m_monitorWidget);
-    m_monitorLayout->setSpacing(1);
-    m_monitorLayout->setMargin(1);
-
     /* Load global settings */
     loadSettings();
 
     /* Create toolbar */
     initToolBar();
 
-    /* Create a bunch of MonitorFixtures for each fixture */
-    foreach(Fixture* fxi, m_doc->fixtures())
-    {
-        Q_ASSERT(fxi != NULL);
-        createMonitorFixture(fxi);
-    }
-
-    /* Show the master container widgets */
-    m_scrollArea->setWidget(m_monitorWidget);
-    m_monitorWidget->show();
-    m_scrollArea->show();
+    /* Create the fixture view */
+    initView();
 
     /* Listen to fixture additions and changes from Doc */
     connect(m_doc, SIGNAL(fixtureAdded(quint32)),
@@ -100,19 +92,20 @@ Monitor::Monitor(QWidget* parent, Doc* doc, Qt::WindowFlags f)
             this, SLOT(slotFixtureChanged(quint32)));
     connect(m_doc, SIGNAL(fixtureRemoved(quint32)),
             this, SLOT(slotFixtureRemoved(quint32)));
+    connect(m_doc, SIGNAL(batchFinished(const Doc::BatchChanges&)),
+            this, SLOT(slotBatchFinished(const Doc::BatchChanges&)));
 
-    connect(m_doc->outputMap(), SIGNAL(universesWritten(const QByteArray&)),
-            this, SLOT(slotUniversesWritten(const QByteArray&)));
+    /* Get only changed values, at most at the monitor's own rate */
+    connect(m_universeMonitor, SIGNAL(valuesChanged(const QByteArray&, const QList <quint32>&)),
+            this, SLOT(slotValuesChanged(const QByteArray&, const QList <quint32>&)));
+    m_universeMonitor->start();
 }
 
 Monitor::~Monitor()
 {
-    disconnect(m_doc->outputMap(), SIGNAL(universesWritten(const QByteArray&)),
-               this, SLOT(slotUniversesWritten(const QByteArray&)));
-
-    while (m_monitorFixtures.isEmpty() == false)
-        delete m_monitorFixtures.takeFirst();
+    m_universeMonitor->stop();
 
+    clearView();
     saveSettings();
 
     /* Reset the singleton instance */
@@ -130,14 +123,10 @@ void Monitor::loadSettings()
     QVariant var;
 
     // Load font
+    m_font = QApplication::font();
     var = settings.value(SETTINGS_FONT);
     if (var.isValid() == true)
-    {
-        QFont fn;
-        fn.fromString(var.toString());
-        if (fn != QApplication::font())
-            m_monitorWidget->setFont(fn);
-    }
+        m_font.fromString(var.toString());
 
     // Load channel style
     var = settings.value(SETTINGS_CHANNELSTYLE);
@@ -152,15 +141,36 @@ void Monitor::loadSettings()
         m_valueStyle = ValueStyle(var.toInt());
     else
         m_valueStyle = DMXValues;
+
+    // Load update rate
+    var = settings.value(SETTINGS_RATE);
+    if (var.isValid() == true)
+        m_universeMonitor->setRate(var.toInt());
+
+    // Load view style & zoom
+    var = settings.value(SETTINGS_VIEWSTYLE);
+    if (var.isValid() == true)
+        m_viewStyle = ViewStyle(var.toInt());
+    else
+        m_viewStyle = LabelView;
+
+    var = settings.value(SETTINGS_ZOOM);
+    if (var.isValid() == true)
+        m_zoom = var.toDouble();
+    else
+        m_zoom = 1.0;
 }
 
 void Monitor::saveSettings()
 {
     QSettings settings;
     settings.setValue(SETTINGS_GEOMETRY, saveGeometry());
-    settings.setValue(SETTINGS_FONT, m_monitorWidget->font().toString());
+    settings.setValue(SETTINGS_FONT, m_font.toString());
     settings.setValue(SETTINGS_VALUESTYLE, valueStyle());
     settings.setValue(SETTINGS_CHANNELSTYLE, channelStyle());
+    settings.setValue(SETTINGS_RATE, m_universeMonitor->rate());
+    settings.setValue(SETTINGS_VIEWSTYLE, viewStyle());
+    settings.setValue(SETTINGS_ZOOM, m_zoom);
 }
 
 void Monitor::createAndShow(QWidget* parent, Doc* doc)
@@ -209,6 +219,11 @@ Monitor::ChannelStyle Monitor::channelStyle() const
     return m_channelStyle;
 }
 
+Monitor::ViewStyle Monitor::viewStyle() const
+{
+    return m_viewStyle;
+}
+
 /****************************************************************************
  * Menu
  ****************************************************************************/
@@ -283,14 +298,46 @@ void Monitor::initToolBar()
     group->addAction(action);
     if (valueStyle() == PercentageValues)
         action->setChecked(true);
+
+    toolBar->addSeparator();
+
+    /* Update rate */
+    QSpinBox* spin = new QSpinBox(toolBar);
+    spin->setToolTip(tr("Number of times per second that values are updated"));
+    spin->setRange(1, 100);
+    spin->setSuffix(tr(" Hz"));
+    spin->setValue(m_universeMonitor->rate());
+    connect(spin, SIGNAL(valueChanged(int)), this, SLOT(slotRateChanged(int)));
+    toolBar->addWidget(spin);
+
+    toolBar->addSeparator();
+
+    /* View style */
+    action = toolBar->addAction(tr("Compact View"));
+    action->setToolTip(tr("Paint all fixtures in a single view (faster for large rigs)"));
+    action->setCheckable(true);
+    action->setChecked(viewStyle() == CanvasView);
+    connect(action, SIGNAL(triggered(bool)),
+            this, SLOT(slotViewStyleTriggered(bool)));
+
+    m_zoomInAction = toolBar->addAction(tr("Zoom In"), this, SLOT(slotZoomIn()));
+    m_zoomInAction->setShortcut(QKeySequence::ZoomIn);
+    m_zoomOutAction = toolBar->addAction(tr("Zoom Out"), this, SLOT(slotZoomOut()));
+    m_zoomOutAction->setShortcut(QKeySequence::ZoomOut);
 }
 
 void Monitor::slotChooseFont()
 {
     bool ok = false;
-    QFont f = QFontDialog::getFont(&ok, m_monitorWidget->font(), this);
+    QFont f = QFontDialog::getFont(&ok, m_font, this);
     if (ok == true)
-        m_monitorWidget->setFont(f);
+    {
+        m_font = f;
+        if (m_canvas != NULL)
+            m_canvas->setFont(m_font);
+        else
+            m_monitorWidget->setFont(m_font);
+    }
 }
 
 void Monitor::slotChannelStyleTriggered()
@@ -313,10 +360,117 @@ void Monitor::slotValueStyleTriggered()
     emit valueStyleChanged(valueStyle());
 }
 
+void Monitor::slotRateChanged(int rate)
+{
+    m_universeMonitor->setRate(rate);
+}
+
+void Monitor::slotViewStyleTriggered(bool canvas)
+{
+    ViewStyle style = (canvas == true) ? CanvasView : LabelView;
+    if (style == m_viewStyle)
+        return;
+
+    clearView();
+    m_viewStyle = style;
+    initView();
+}
+
+void Monitor::slotZoomIn()
+{
+    if (m_canvas != NULL)
+    {
+        m_canvas->zoomIn();
+        m_zoom = m_canvas->zoom();
+    }
+}
+
+void Monitor::slotZoomOut()
+{
+    if (m_canvas != NULL)
+    {
+        m_canvas->zoomOut();
+        m_zoom = m_canvas->zoom();
+    }
+}
+
 /****************************************************************************
  * Fixture added/removed stuff
  ****************************************************************************/
 
+void Monitor::initView()
+{
+    if (m_viewStyle == CanvasView)
+    {
+        m_canvas = new MonitorCanvas(this, m_doc);
+        m_canvas->setFont(m_font);
+        m_canvas->setZoom(m_zoom);
+        m_canvas->slotChannelStyleChanged(channelStyle());
+        m_canvas->slotValueStyleChanged(valueStyle());
+        layout()->addWidget(m_canvas);
+
+        /* Make the canvas listen to value & channel style changes */
+        connect(this, SIGNAL(valueStyleChanged(Monitor::ValueStyle)),
+                m_canvas, SLOT(slotValueStyleChanged(Monitor::ValueStyle)));
+        connect(this, SIGNAL(channelStyleChanged(Monitor::ChannelStyle)),
+                m_canvas, SLOT(slotChannelStyleChanged(Monitor::ChannelStyle)));
+    }
+    else
+    {
+        /* Scroll area that contains the monitor widget */
+        m_scrollArea = new QScrollArea(this);
+        m_scrollArea->setWidgetResizable(true);
+        layout()->addWidget(m_scrollArea);
+
+        /* Monitor widget that contains all MonitorFixtures */
+        m_monitorWidget = new QWidget(m_scrollArea);
+        m_monitorWidget->setBackgroundRole(QPalette::Dark);
+        m_monitorWidget->setFont(m_font);
+        m_monitorLayout = new MonitorLayout(m_monitorWidget);
+        m_monitorLayout->setSpacing(1);
+        m_monitorLayout->setMargin(1);
+
+        /* Create a bunch of MonitorFixtures for each fixture */
+        foreach(Fixture* fxi, m_doc->fixtures())
+        {
+            Q_ASSERT(fxi != NULL);
+            createMonitorFixture(fxi);
+        }
+        rebuildAddressIndex();
+
+        /* Show the master container widgets */
+        m_scrollArea->setWidget(m_monitorWidget);
+        m_monitorWidget->show();
+        m_scrollArea->show();
+    }
+
+    m_zoomInAction->setEnabled(m_canvas != NULL);
+    m_zoomOutAction->setEnabled(m_canvas != NULL);
+
+    /* Fill the new view with all values on the next update */
+    m_universeMonitor->reset();
+}
+
+void Monitor::clearView()
+{
+    if (m_canvas != NULL)
+    {
+        m_zoom = m_canvas->zoom();
+        delete m_canvas;
+        m_canvas = NULL;
+    }
+
+    while (m_monitorFixtures.isEmpty() == false)
+        delete m_monitorFixtures.takeFirst();
+    m_addressIndex.clear();
+
+    /* The scroll area owns the monitor widget and its layout */
+    delete m_scrollArea;
+    m_scrollArea = NULL;
+    m_monitorWidget = NULL;
+    m_monitorLayout = NULL;
+}
+
 void Monitor::updateFixtureLabelStyles()
 {
     QListIterator <MonitorFixture*> it(m_monitorFixtures);
@@ -342,16 +496,55 @@ void Monitor::createMonitorFixture(Fixture* fxi)
     m_monitorFixtures.append(mof);
 }
 
+void Monitor::rebuildAddressIndex()
+{
+    m_addressIndex.clear();
+    m_addressIndex.resize(m_doc->outputMap()->universes() * 512);
+
+    QListIterator <MonitorFixture*> it(m_monitorFixtures);
+    while (it.hasNext() == true)
+    {
+        MonitorFixture* mof = it.next();
+        quint32 address = mof->universeAddress();
+        for (quint32 i = 0; i < mof->channels(); i++)
+        {
+            if (address + i < quint32(m_addressIndex.size()))
+                m_addressIndex[address + i] << mof;
+        }
+    }
+
+    m_universeMonitor->reset();
+}
+
 void Monitor::slotFixtureAdded(quint32 fxi_id)
 {
+    if (m_doc->isBatching() == true)
+        return;
+
+    if (m_canvas != NULL)
+    {
+        m_canvas->rebuild();
+        return;
+    }
+
     Fixture* fxi = m_doc->fixture(fxi_id);
     if (fxi != NULL)
+    {
         createMonitorFixture(fxi);
+        rebuildAddressIndex();
+    }
 }
 
 void Monitor::slotFixtureChanged(quint32 fxi_id)
 {
-    Q_UNUSED(fxi_id);
+    if (m_doc->isBatching() == true)
+        return;
+
+    if (m_canvas != NULL)
+    {
+        m_canvas->rebuild();
+        return;
+    }
 
     QListIterator <MonitorFixture*> it(m_monitorFixtures);
     while (it.hasNext() == true)
@@ -363,10 +556,20 @@ void Monitor::slotFixtureChanged(quint32 fxi_id)
 
     m_monitorLayout->sort();
     m_monitorWidget->updateGeometry();
+    rebuildAddressIndex();
 }
 
 void Monitor::slotFixtureRemoved(quint32 fxi_id)
 {
+    if (m_doc->isBatching() == true)
+        return;
+
+    if (m_canvas != NULL)
+    {
+        m_canvas->rebuild();
+        return;
+    }
+
     QMutableListIterator <MonitorFixture*> it(m_monitorFixtures);
     while (it.hasNext() == true)
     {
@@ -377,11 +580,65 @@ void Monitor::slotFixtureRemoved(quint32 fxi_id)
             delete mof;
         }
     }
+
+    rebuildAddressIndex();
 }
 
-void Monitor::slotUniversesWritten(const QByteArray& ua)
+void Monitor::slotBatchFinished(const Doc::BatchChanges& changes)
 {
-    QListIterator <MonitorFixture*> it(m_monitorFixtures);
+    if (changes.fixtures.isEmpty() == true)
+        return;
+
+    if (m_canvas != NULL)
+    {
+        m_canvas->rebuild();
+        return;
+    }
+
+    QMutableListIterator <MonitorFixture*> it(m_monitorFixtures);
+    while (it.hasNext() == true)
+    {
+        MonitorFixture* mof = it.next();
+        if (changes.fixtures.removed.contains(mof->fixture()) == true)
+        {
+            it.remove();
+            delete mof;
+        }
+        else if (changes.fixtures.changed.contains(mof->fixture()) == true)
+        {
+            mof->setFixture(mof->fixture());
+        }
+    }
+
+    foreach (quint32 id, changes.fixtures.added)
+    {
+        Fixture* fxi = m_doc->fixture(id);
+        if (fxi != NULL)
+            createMonitorFixture(fxi);
+    }
+
+    m_monitorLayout->sort();
+    m_monitorWidget->updateGeometry();
+    rebuildAddressIndex();
+}
+
+void Monitor::slotValuesChanged(const QByteArray& values, const QList <quint32>& channels)
+{
+    if (m_canvas != NULL)
+    {
+        m_canvas->setValues(values, channels);
+        return;
+    }
+
+    QListIterator <quint32> it(channels);
     while (it.hasNext() == true)
-        it.next()->updateValues(ua);
+    {
+        quint32 address = it.next();
+        if (address >= quint32(m_addressIndex.size()))
+            break;
+
+        QListIterator <MonitorFixture*> mofit(m_addressIndex.at(address));
+        while (mofit.hasNext() == true)
+            mofit.next()->updateValue(address, uchar(values.at(address)));
+    }
 }
@@ -23,10 +23,16 @@
 #define MONITOR_H
 
 #include <QWidget>
+#include <QVector>
+#include <QFont>
 #include <QHash>
 #include <QList>
 
+#include "doc.h"
+
+class UniverseMonitor;
 class MonitorFixture;
+class MonitorCanvas;
 class MonitorLayout;
 class QDomDocument;
 class QDomElement;
@@ -36,7 +42,6 @@ class QAction;
 class Fixture;
 class Monitor;
 class QTimer;
-class Doc;
 
 class Monitor : public QWidget
 {
@@ -74,6 +79,7 @@ protected:
 public:
     enum ChannelStyle { DMXChannels, RelativeChannels };
     enum ValueStyle { DMXValues, PercentageValues };
+    enum ViewStyle { LabelView, CanvasView };
 
     /** Get the style used to draw DMX values in monitor fixtures */
     ValueStyle valueStyle() const;
@@ -81,9 +87,18 @@ public:
     /** Get the style used to draw channel numbers in monitor fixtures */
     ChannelStyle channelStyle() const;
 
+    /**
+     * Get the style used to show fixtures: a set of labels for each fixture
+     * (MonitorFixture) or one view that paints everything (MonitorCanvas)
+     */
+    ViewStyle viewStyle() const;
+
 private:
     ValueStyle m_valueStyle;
     ChannelStyle m_channelStyle;
+    ViewStyle m_viewStyle;
+    QFont m_font;
+    qreal m_zoom;
 
     /*********************************************************************
      * Menu
@@ -102,6 +117,16 @@ protected slots:
     /** Menu action slot for value style selection */
     void slotValueStyleTriggered();
 
+    /** Menu action slot for switching between label & canvas views */
+    void slotViewStyleTriggered(bool canvas);
+
+    /** Menu action slots for canvas view zoom */
+    void slotZoomIn();
+    void slotZoomOut();
+
+    /** Tool bar slot for update rate selection */
+    void slotRateChanged(int rate);
+
     /********************************************************************
      * Monitor Fixtures
      ********************************************************************/
@@ -110,9 +135,21 @@ public:
     void updateFixtureLabelStyles();
 
 protected:
+    /** Create the widgets of the current view style */
+    void initView();
+
+    /** Destroy the widgets of the current view style */
+    void clearView();
+
     /** Create a new MonitorFixture* and append it to the layout */
     void createMonitorFixture(Fixture* fxi);
 
+    /**
+     * Rebuild the address-to-MonitorFixture index and make the next update
+     * report all channels so that new value labels get filled.
+     */
+    void rebuildAddressIndex();
+
 protected slots:
     /** Slot for fixture additions (to append the new fixture to layout) */
     void slotFixtureAdded(quint32 fxi_id);
@@ -123,8 +160,11 @@ protected slots:
     /** Slot for fixture removals (to remove the fixture from layout) */
     void slotFixtureRemoved(quint32 fxi_id);
 
-    /** Slot for getting the latest values from OutputMap */
-    void slotUniversesWritten(const QByteArray& ua);
+    /** Slot for applying all fixture changes of a Doc batch at once */
+    void slotBatchFinished(const Doc::BatchChanges& changes);
+
+    /** Slot for getting the changed values from UniverseMonitor */
+    void slotValuesChanged(const QByteArray& values, const QList <quint32>& channels);
 
 signals:
     void channelStyleChanged(Monitor::ChannelStyle style);
@@ -135,6 +175,17 @@ protected:
     QWidget* m_monitorWidget;
     MonitorLayout* m_monitorLayout;
     QList <MonitorFixture*> m_monitorFixtures;
+
+    /** The MonitorFixtures that show each universe address (patches may overlap) */
+    QVector <QList <MonitorFixture*> > m_addressIndex;
+
+    /** The view of CanvasView style, NULL in LabelView style */
+    MonitorCanvas* m_canvas;
+    QAction* m_zoomInAction;
+    QAction* m_zoomOutAction;
+
+    /** Delivers changed values at the monitor's own rate */
+    UniverseMonitor* m_universeMonitor;
 };
 
 #endif
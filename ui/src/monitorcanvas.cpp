@@ -0,0 +1,417 @@
+/*
+  Q Light Controller
+  monitorcanvas.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QFontMetrics>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QScrollBar>
+#include <QPainter>
+#include <QDebug>
+#include <cmath>
+
+#include "monitorcanvas.h"
+#include "outputmap.h"
+#include "qlcmacros.h"
+#include "fixture.h"
+#include "doc.h"
+
+#define KBoxSpacing 1
+#define KMinZoom 0.5
+#define KMaxZoom 4.0
+#define KZoomStep 1.25
+
+MonitorCanvas::MonitorCanvas(QWidget* parent, Doc* doc)
+    : QAbstractScrollArea(parent)
+    , m_doc(doc)
+    , m_channelStyle(Monitor::DMXChannels)
+    , m_valueStyle(Monitor::DMXValues)
+    , m_zoom(1.0)
+    , m_digitWidth(0)
+    , m_lineHeight(0)
+    , m_cellWidth(0)
+    , m_margin(0)
+{
+    Q_ASSERT(doc != NULL);
+
+    setBackgroundRole(QPalette::Dark);
+    viewport()->setBackgroundRole(QPalette::Dark);
+
+    /* Everything is painted in paintEvent(), no need to erase first */
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+
+    updateMetrics();
+    rebuild();
+}
+
+MonitorCanvas::~MonitorCanvas()
+{
+}
+
+/****************************************************************************
+ * Fixtures
+ ****************************************************************************/
+
+static bool fixtureLessThan(const Fixture* fxi1, const Fixture* fxi2)
+{
+    return (*fxi1) < (*fxi2);
+}
+
+void MonitorCanvas::rebuild()
+{
+    QList <Fixture*> fixtures(m_doc->fixtures());
+    qSort(fixtures.begin(), fixtures.end(), fixtureLessThan);
+
+    m_boxes.clear();
+    m_addressIndex.clear();
+    m_addressIndex.resize(m_doc->outputMap()->universes() * 512);
+
+    QListIterator <Fixture*> it(fixtures);
+    while (it.hasNext() == true)
+    {
+        Fixture* fxi = it.next();
+        Q_ASSERT(fxi != NULL);
+
+        Box box;
+        box.fixture = fxi->id();
+        box.name = fxi->name();
+        box.address = fxi->address();
+        box.universeAddress = fxi->universeAddress();
+        box.channels = fxi->channels();
+        m_boxes << box;
+
+        for (quint32 i = 0; i < box.channels; i++)
+        {
+            quint32 address = box.universeAddress + i;
+            if (address < quint32(m_addressIndex.size()))
+                m_addressIndex[address] << m_boxes.size() - 1;
+        }
+    }
+
+    doLayout();
+}
+
+void MonitorCanvas::doLayout()
+{
+    int width = viewport()->width();
+    int x = KBoxSpacing;
+    int y = KBoxSpacing;
+    int lineHeight = 0;
+    int contentWidth = 0;
+    int boxHeight = 3 * m_lineHeight + 2 * m_margin;
+
+    m_rows.clear();
+    for (int i = 0; i < m_boxes.size(); i++)
+    {
+        Box& box(m_boxes[i]);
+        int boxWidth = qMax(box.channels, quint32(1)) * m_cellWidth + 2 * m_margin;
+
+        /* Wrap to a new row if the box doesn't fit (like MonitorLayout) */
+        if (x + boxWidth > width && lineHeight > 0)
+        {
+            x = KBoxSpacing;
+            y += lineHeight + KBoxSpacing;
+            lineHeight = 0;
+        }
+
+        if (lineHeight == 0)
+        {
+            Row row = { y, y + boxHeight - 1, i, i };
+            m_rows << row;
+        }
+        else
+        {
+            m_rows.last().last = i;
+        }
+
+        box.rect = QRect(x, y, boxWidth, boxHeight);
+        x += boxWidth + KBoxSpacing;
+        lineHeight = boxHeight;
+        contentWidth = qMax(contentWidth, x);
+    }
+
+    m_contentSize = QSize(contentWidth, y + lineHeight + KBoxSpacing);
+
+    QSize view(viewport()->size());
+    horizontalScrollBar()->setRange(0, qMax(0, m_contentSize.width() - view.width()));
+    horizontalScrollBar()->setPageStep(view.width());
+    horizontalScrollBar()->setSingleStep(m_cellWidth);
+    verticalScrollBar()->setRange(0, qMax(0, m_contentSize.height() - view.height()));
+    verticalScrollBar()->setPageStep(view.height());
+    verticalScrollBar()->setSingleStep(boxHeight + KBoxSpacing);
+
+    viewport()->update();
+}
+
+QRect MonitorCanvas::cellRect(const Box& box, quint32 channel, bool value) const
+{
+    return QRect(box.rect.x() + m_margin + channel * m_cellWidth,
+                 box.rect.y() + m_margin + m_lineHeight * (value ? 2 : 1),
+                 m_cellWidth, m_lineHeight);
+}
+
+/****************************************************************************
+ * Styles & zoom
+ ****************************************************************************/
+
+qreal MonitorCanvas::zoom() const
+{
+    return m_zoom;
+}
+
+void MonitorCanvas::setZoom(qreal zoom)
+{
+    zoom = CLAMP(zoom, KMinZoom, KMaxZoom);
+    if (zoom == m_zoom)
+        return;
+
+    m_zoom = zoom;
+    updateMetrics();
+    doLayout();
+}
+
+void MonitorCanvas::slotChannelStyleChanged(Monitor::ChannelStyle style)
+{
+    m_channelStyle = style;
+    viewport()->update();
+}
+
+void MonitorCanvas::slotValueStyleChanged(Monitor::ValueStyle style)
+{
+    m_valueStyle = style;
+    viewport()->update();
+}
+
+void MonitorCanvas::zoomIn()
+{
+    setZoom(m_zoom * KZoomStep);
+}
+
+void MonitorCanvas::zoomOut()
+{
+    setZoom(m_zoom / KZoomStep);
+}
+
+void MonitorCanvas::updateMetrics()
+{
+    m_font = font();
+    if (m_font.pointSizeF() > 0)
+        m_font.setPointSizeF(m_font.pointSizeF() * m_zoom);
+    else
+        m_font.setPixelSize(qMax(1, int(m_font.pixelSize() * m_zoom)));
+
+    m_boldFont = m_font;
+    m_boldFont.setBold(true);
+
+    /* Bold digits are the widest, so use them for both rows to keep the
+       regular and bold numbers aligned */
+    QFontMetrics fm(m_boldFont);
+    m_digitWidth = 0;
+    for (int i = 0; i < 10; i++)
+        m_digitWidth = qMax(m_digitWidth, fm.width(QChar('0' + i)));
+    m_lineHeight = fm.height();
+    m_margin = qMax(2, int(3 * m_zoom));
+
+    /* Channel numbers can have four digits */
+    m_cellWidth = 4 * m_digitWidth + m_margin;
+
+    m_digits = QPixmap(10 * m_digitWidth, 2 * m_lineHeight);
+    m_digits.fill(Qt::transparent);
+
+    QPainter painter(&m_digits);
+    painter.setPen(palette().color(QPalette::WindowText));
+    for (int i = 0; i < 10; i++)
+    {
+        painter.setFont(m_font);
+        painter.drawText(QRect(i * m_digitWidth, 0, m_digitWidth, m_lineHeight),
+                         Qt::AlignCenter, QString(QChar('0' + i)));
+        painter.setFont(m_boldFont);
+        painter.drawText(QRect(i * m_digitWidth, m_lineHeight, m_digitWidth, m_lineHeight),
+                         Qt::AlignCenter, QString(QChar('0' + i)));
+    }
+}
+
+void MonitorCanvas::drawNumber(QPainter* painter, const QRect& cell, int number, bool bold) const
+{
+    char digits[16];
+    int count = qsnprintf(digits, sizeof(digits), "%.3d", number);
+
+    int x = cell.x() + (cell.width() - count * m_digitWidth) / 2;
+    int sourceY = bold ? m_lineHeight : 0;
+    for (int i = 0; i < count; i++)
+    {
+        int digit = digits[i] - '0';
+        painter->drawPixmap(QPoint(x, cell.y()), m_digits,
+                            QRect(digit * m_digitWidth, sourceY, m_digitWidth, m_lineHeight));
+        x += m_digitWidth;
+    }
+}
+
+/****************************************************************************
+ * Values
+ ****************************************************************************/
+
+void MonitorCanvas::setValues(const QByteArray& values, const QList <quint32>& channels)
+{
+    m_values = values;
+
+    QRect view(QPoint(horizontalScrollBar()->value(), verticalScrollBar()->value()),
+               viewport()->size());
+
+    QListIterator <quint32> it(channels);
+    while (it.hasNext() == true)
+    {
+        quint32 address = it.next();
+        if (address >= quint32(m_addressIndex.size()))
+            continue;
+
+        /* Repaint only the visible cells of changed values */
+        QListIterator <int> boxit(m_addressIndex.at(address));
+        while (boxit.hasNext() == true)
+        {
+            const Box& box(m_boxes.at(boxit.next()));
+            QRect rect(cellRect(box, address - box.universeAddress, true));
+            if (rect.intersects(view) == true)
+                viewport()->update(rect.translated(-view.topLeft()));
+        }
+    }
+}
+
+int MonitorCanvas::displayValue(uchar value) const
+{
+    if (m_valueStyle == Monitor::DMXValues)
+    {
+        return value;
+    }
+    else
+    {
+        return int(ceil(SCALE(qreal(value), qreal(0), qreal(UCHAR_MAX),
+                              qreal(0), qreal(100))));
+    }
+}
+
+/****************************************************************************
+ * Events
+ ****************************************************************************/
+
+void MonitorCanvas::paintEvent(QPaintEvent* e)
+{
+    QPainter painter(viewport());
+    painter.fillRect(e->rect(), palette().color(QPalette::Dark));
+
+    QPoint offset(horizontalScrollBar()->value(), verticalScrollBar()->value());
+    QRect visible(e->rect().translated(offset));
+    painter.translate(-offset);
+
+    QFontMetrics fm(m_boldFont);
+    painter.setFont(m_boldFont);
+
+    QListIterator <Row> rit(m_rows);
+    while (rit.hasNext() == true)
+    {
+        const Row& row(rit.next());
+        if (row.bottom < visible.top())
+            continue;
+        if (row.top > visible.bottom())
+            break;
+
+        for (int i = row.first; i <= row.last; i++)
+        {
+            const Box& box(m_boxes.at(i));
+            if (box.rect.intersects(visible) == false)
+                continue;
+
+            painter.fillRect(box.rect, palette().color(QPalette::Window));
+            painter.setPen(palette().color(QPalette::Mid));
+            painter.drawRect(box.rect.adjusted(0, 0, -1, -1));
+
+            /* Fixture name */
+            QRect title(box.rect.x() + m_margin, box.rect.y() + m_margin,
+                        box.rect.width() - 2 * m_margin, m_lineHeight);
+            if (title.intersects(visible) == true)
+            {
+                painter.setPen(palette().color(QPalette::WindowText));
+                painter.drawText(title, Qt::AlignLeft | Qt::AlignVCenter,
+                                 fm.elidedText(box.name, Qt::ElideRight, title.width()));
+            }
+
+            if (box.channels == 0)
+                continue;
+
+            /* Only the visible channels */
+            int left = box.rect.x() + m_margin;
+            int first = qMax(0, (visible.left() - left) / m_cellWidth);
+            int last = qMin(int(box.channels) - 1, (visible.right() - left) / m_cellWidth);
+            for (int ch = first; ch <= last; ch++)
+            {
+                int number = ch + 1;
+                if (m_channelStyle == Monitor::DMXChannels)
+                    number += box.address;
+                drawNumber(&painter, cellRect(box, ch, false), number, true);
+
+                quint32 address = box.universeAddress + ch;
+                if (address < quint32(m_values.size()))
+                {
+                    drawNumber(&painter, cellRect(box, ch, true),
+                               displayValue(uchar(m_values.at(address))), false);
+                }
+            }
+        }
+    }
+}
+
+void MonitorCanvas::resizeEvent(QResizeEvent* e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    doLayout();
+}
+
+void MonitorCanvas::wheelEvent(QWheelEvent* e)
+{
+    if (e->modifiers() & Qt::ControlModifier)
+    {
+        if (e->delta() > 0)
+            zoomIn();
+        else
+            zoomOut();
+        e->accept();
+    }
+    else
+    {
+        QAbstractScrollArea::wheelEvent(e);
+    }
+}
+
+void MonitorCanvas::changeEvent(QEvent* e)
+{
+    if (e->type() == QEvent::FontChange || e->type() == QEvent::PaletteChange)
+    {
+        updateMetrics();
+        doLayout();
+    }
+
+    QAbstractScrollArea::changeEvent(e);
+}
+
+void MonitorCanvas::scrollContentsBy(int dx, int dy)
+{
+    /* Repaint only the area that scrolled into view */
+    viewport()->scroll(dx, dy);
+}
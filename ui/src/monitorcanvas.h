@@ -0,0 +1,171 @@
+/*
+  Q Light Controller
+  monitorcanvas.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef MONITORCANVAS_H
+#define MONITORCANVAS_H
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QPixmap>
+#include <QVector>
+#include <QList>
+#include <QRect>
+
+#include "monitor.h"
+
+class QPainter;
+class Doc;
+
+/**
+ * MonitorCanvas shows the values of all fixtures in a single widget that
+ * paints everything by itself, instead of using a set of labels for each
+ * fixture like MonitorFixture does. It is meant for large rigs where
+ * thousands of labels would make the monitor slow to open and heavy to run.
+ *
+ * Fixtures are laid out like in MonitorLayout. Only the fixtures within the
+ * visible area are painted, and a value change repaints only the cell of the
+ * changed value. Digits are drawn from a pre-rendered glyph atlas so that
+ * painting a value doesn't involve any text layout. The view can be zoomed
+ * with Ctrl + mouse wheel or zoomIn() & zoomOut().
+ */
+class MonitorCanvas : public QAbstractScrollArea
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(MonitorCanvas)
+
+public:
+    MonitorCanvas(QWidget* parent, Doc* doc);
+    ~MonitorCanvas();
+
+private:
+    Doc* m_doc;
+
+    /********************************************************************
+     * Fixtures
+     ********************************************************************/
+public:
+    /** Re-read all fixtures from Doc and lay them out again */
+    void rebuild();
+
+private:
+    /** A fixture's box on the canvas */
+    struct Box
+    {
+        quint32 fixture;
+        QString name;
+        quint32 address;           //! DMX address within the universe
+        quint32 universeAddress;   //! Address of the first channel in all universes
+        quint32 channels;
+        QRect rect;                //! Position in canvas coordinates
+    };
+
+    /** A horizontal row of boxes, for quickly finding the visible boxes */
+    struct Row
+    {
+        int top;
+        int bottom;
+        int first;                 //! Index of the first box in m_boxes
+        int last;                  //! Index of the last box in m_boxes
+    };
+
+    /** Calculate box positions and scroll bar ranges */
+    void doLayout();
+
+    /** Get the rectangle of a box's channel number or value cell */
+    QRect cellRect(const Box& box, quint32 channel, bool value) const;
+
+private:
+    QList <Box> m_boxes;
+    QList <Row> m_rows;
+    QSize m_contentSize;
+
+    /** Indices of the boxes that show each universe address */
+    QVector <QList <int> > m_addressIndex;
+
+    /********************************************************************
+     * Styles & zoom
+     ********************************************************************/
+public:
+    /** Get the current zoom factor */
+    qreal zoom() const;
+
+    /** Set the zoom factor (0.5 - 4.0) */
+    void setZoom(qreal zoom);
+
+public slots:
+    void slotChannelStyleChanged(Monitor::ChannelStyle style);
+    void slotValueStyleChanged(Monitor::ValueStyle style);
+    void zoomIn();
+    void zoomOut();
+
+private:
+    /** Render the digit atlas and cell metrics for the current font & zoom */
+    void updateMetrics();
+
+    /** Draw a number of at least three digits from the digit atlas */
+    void drawNumber(QPainter* painter, const QRect& cell, int number, bool bold) const;
+
+private:
+    Monitor::ChannelStyle m_channelStyle;
+    Monitor::ValueStyle m_valueStyle;
+    qreal m_zoom;
+
+    QFont m_font;
+    QFont m_boldFont;
+
+    /** Digits 0-9 in regular (top row) and bold (bottom row) font */
+    QPixmap m_digits;
+    int m_digitWidth;
+    int m_lineHeight;
+    int m_cellWidth;
+    int m_margin;
+
+    /********************************************************************
+     * Values
+     ********************************************************************/
+public slots:
+    /**
+     * Show new values and repaint the cells of changed channels
+     *
+     * @param values The values of all universes
+     * @param channels The universe addresses of the changed channels
+     */
+    void setValues(const QByteArray& values, const QList <quint32>& channels);
+
+private:
+    /** Get the number shown for $value in the current value style */
+    int displayValue(uchar value) const;
+
+private:
+    QByteArray m_values;
+
+    /********************************************************************
+     * Events
+     ********************************************************************/
+protected:
+    void paintEvent(QPaintEvent* e);
+    void resizeEvent(QResizeEvent* e);
+    void wheelEvent(QWheelEvent* e);
+    void changeEvent(QEvent* e);
+    void scrollContentsBy(int dx, int dy);
+};
+
+#endif
@@ -43,6 +43,7 @@ MonitorFixture::MonitorFixture(QWidget* parent, Doc* doc)
 
     m_fixtureLabel = NULL;
     m_fixture = Fixture::invalidId();
+    m_universeAddress = 0;
     m_channelStyle = Monitor::DMXChannels;
     m_valueStyle = Monitor::DMXValues;
 
@@ -105,11 +106,14 @@ void MonitorFixture::setFixture(quint32 fxi_id)
         delete m_channelLabels.takeFirst();
     while (m_valueLabels.isEmpty() == false)
         delete m_valueLabels.takeFirst();
+    m_values.clear();
 
     m_fixture = fxi_id;
     fxi = m_doc->fixture(m_fixture);
     if (fxi != NULL)
     {
+        m_universeAddress = fxi->universeAddress();
+
         /* The grid layout uses columns and rows. The first row is for
            the fixture name, second row for channel numbers and the
            third row for channel values. Each channel is in its own
@@ -140,6 +144,8 @@ void MonitorFixture::setFixture(quint32 fxi_id)
             lay->addWidget(label, 2, i, Qt::AlignHCenter);
             m_valueLabels.append(label);
         }
+
+        m_values.fill(-1, m_valueLabels.size());
     }
 }
 
@@ -148,6 +154,16 @@ quint32 MonitorFixture::fixture() const
     return m_fixture;
 }
 
+quint32 MonitorFixture::universeAddress() const
+{
+    return m_universeAddress;
+}
+
+quint32 MonitorFixture::channels() const
+{
+    return m_valueLabels.size();
+}
+
 void MonitorFixture::slotChannelStyleChanged(Monitor::ChannelStyle style)
 {
     QString str;
@@ -177,43 +193,26 @@ void MonitorFixture::slotChannelStyleChanged(Monitor::ChannelStyle style)
  * Values
  ****************************************************************************/
 
-void MonitorFixture::updateValues(const QByteArray& ua)
+void MonitorFixture::updateValue(quint32 universeAddress, uchar value)
 {
-    QLabel* label;
-    uchar value;
-    Fixture* fxi;
-    QString str;
-    int i = 0;
-
-    /* Check that this MonitorFixture represents a fixture */
-    if (m_fixture == Fixture::invalidId())
+    quint32 index = universeAddress - m_universeAddress;
+    if (universeAddress < m_universeAddress || index >= quint32(m_values.size()))
         return;
 
-    /* Check that this MonitorFixture's fixture really exists */
-    fxi = m_doc->fixture(m_fixture);
-    if (fxi == NULL)
+    if (m_values[index] == int(value))
         return;
 
-    QListIterator <QLabel*> it(m_valueLabels);
-    while (it.hasNext() == true)
-    {
-        label = it.next();
-        Q_ASSERT(label != NULL);
-
-        value = uchar(ua.at(fxi->universeAddress() + i));
-        i++;
+    m_values[index] = value;
+    m_valueLabels.at(index)->setText(valueText(value));
+}
 
-        /* Set the label's text to reflect the changed value */
-        if (m_valueStyle == Monitor::DMXValues)
-        {
-            label->setText(str.sprintf("%.3d", value));
-        }
-        else
-        {
-            label->setText(str.sprintf("%.3d", int(ceil(SCALE(qreal(value),
-                                                              qreal(0), qreal(UCHAR_MAX),
-                                                              qreal(0), qreal(100))))));
-        }
+void MonitorFixture::updateValues(const QByteArray& ua)
+{
+    for (int i = 0; i < m_values.size(); i++)
+    {
+        quint32 address = m_universeAddress + i;
+        if (address < quint32(ua.size()))
+            updateValue(address, uchar(ua.at(address)));
     }
 }
 
@@ -221,18 +220,20 @@ void MonitorFixture::slotValueStyleChanged(Monitor::ValueStyle style)
 {
     m_valueStyle = style;
 
-    QListIterator <QLabel*> it(m_valueLabels);
-    while (it.hasNext() == true)
+    for (int i = 0; i < m_valueLabels.size(); i++)
     {
-        QLabel* label;
-        QString str;
-        int value;
-
-        label = it.next();
+        QLabel* label = m_valueLabels.at(i);
         Q_ASSERT(label != NULL);
 
-        value = label->text().toInt();
+        /* Values that have been received are shown exactly */
+        if (m_values.at(i) >= 0)
+        {
+            label->setText(valueText(uchar(m_values.at(i))));
+            continue;
+        }
 
+        /* Otherwise convert whatever the label shows */
+        int value = label->text().toInt();
         if (style == Monitor::DMXValues)
         {
             value = int(ceil(SCALE(qreal(value),
@@ -246,6 +247,22 @@ void MonitorFixture::slotValueStyleChanged(Monitor::ValueStyle style)
                                    qreal(0), qreal(100))));
         }
 
+        QString str;
         label->setText(str.sprintf("%.3d", value));
     }
 }
+
+QString MonitorFixture::valueText(uchar value) const
+{
+    QString str;
+    if (m_valueStyle == Monitor::DMXValues)
+    {
+        return str.sprintf("%.3d", value);
+    }
+    else
+    {
+        return str.sprintf("%.3d", int(ceil(SCALE(qreal(value),
+                                                  qreal(0), qreal(UCHAR_MAX),
+                                                  qreal(0), qreal(100)))));
+    }
+}
@@ -22,6 +22,7 @@
 #ifndef MONITORFIXTURE_H
 #define MONITORFIXTURE_H
 
+#include <QVector>
 #include <QFrame>
 #include <QList>
 #include <QFont>
@@ -61,8 +62,15 @@ public:
 public slots:
     void slotChannelStyleChanged(Monitor::ChannelStyle style);
 
+    /** Get the universe address of the fixture's first channel */
+    quint32 universeAddress() const;
+
+    /** Get the number of channels shown */
+    quint32 channels() const;
+
 protected:
     quint32 m_fixture;
+    quint32 m_universeAddress;
     Monitor::ChannelStyle m_channelStyle;
     QLabel* m_fixtureLabel;
     QList <QLabel*> m_channelLabels;
@@ -71,13 +79,30 @@ protected:
      * Values
      ********************************************************************/
 public:
+    /**
+     * Show a new channel value. The value label is touched only if the
+     * value differs from the one that is already shown.
+     *
+     * @param universeAddress The channel's universe address
+     * @param value The channel's new value
+     */
+    void updateValue(quint32 universeAddress, uchar value);
+
+    /** Show the values of all channels from the given universe array */
     void updateValues(const QByteArray& universes);
 
 public slots:
     void slotValueStyleChanged(Monitor::ValueStyle style);
 
+protected:
+    /** Get the text for $value in the current value style */
+    QString valueText(uchar value) const;
+
 protected:
     QList <QLabel*> m_valueLabels;
+
+    /** The value shown in each value label, -1 for none */
+    QVector <int> m_values;
     Monitor::ValueStyle m_valueStyle;
 };
 
@@ -19,14 +19,11 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#include <QGraphicsEllipseItem>
-#include <QGraphicsRectItem>
-#include <QGraphicsEffect>
+#include <QGraphicsTextItem>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QColorDialog>
 #include <QFontDialog>
-#include <QGradient>
 #include <QSettings>
 #include <QTimer>
 #include <QDebug>
@@ -34,8 +31,9 @@
 #include "fixtureselection.h"
 #include "speeddialwidget.h"
 #include "rgbmatrixeditor.h"
+#include "rgbpreviewitem.h"
+#include "fixturegroup.h"
 #include "rgbmatrix.h"
-#include "rgbitem.h"
 #include "rgbtext.h"
 #include "apputil.h"
 #include "doc.h"
@@ -56,22 +54,26 @@ RGBMatrixEditor::RGBMatrixEditor(QWidget* parent, RGBMatrix* mtx, Doc* doc)
     , m_mtx(mtx)
     , m_speedDials(NULL)
     , m_scene(new QGraphicsScene(this))
+    , m_previewItem(NULL)
     , m_previewTimer(new QTimer(this))
     , m_previewIterator(0)
     , m_previewStep(0)
+    , m_previewBuilder(new QTimer(this))
+    , m_previewBuildStep(0)
 {
     Q_ASSERT(doc != NULL);
     Q_ASSERT(mtx != NULL);
 
     setupUi(this);
 
-    // Set a nice gradient backdrop
+    // The preview's cell mask is painted with the same plain colour
     m_scene->setBackgroundBrush(Qt::darkGray);
-    QLinearGradient gradient(200, 200, 200, 2000);
-    gradient.setSpread(QGradient::ReflectSpread);
-    m_scene->setBackgroundBrush(gradient);
+
+    // Compute preview steps whenever there's nothing else to do
+    m_previewBuilder->setInterval(0);
 
     connect(m_previewTimer, SIGNAL(timeout()), this, SLOT(slotPreviewTimeout()));
+    connect(m_previewBuilder, SIGNAL(timeout()), this, SLOT(slotPreviewBuilderTimeout()));
     connect(m_doc, SIGNAL(modeChanged(Doc::Mode)), this, SLOT(slotModeChanged(Doc::Mode)));
     connect(m_doc, SIGNAL(fixtureGroupAdded(quint32)), this, SLOT(slotFixtureGroupAdded()));
     connect(m_doc, SIGNAL(fixtureGroupRemoved(quint32)), this, SLOT(slotFixtureGroupRemoved()));
@@ -88,6 +90,7 @@ RGBMatrixEditor::RGBMatrixEditor(QWidget* parent, RGBMatrix* mtx, Doc* doc)
 RGBMatrixEditor::~RGBMatrixEditor()
 {
     m_previewTimer->stop();
+    m_previewBuilder->stop();
 
     if (m_testButton->isChecked() == true)
         m_mtx->stopAndWait();
@@ -262,53 +265,89 @@ void RGBMatrixEditor::updateExtraOptions()
 
 void RGBMatrixEditor::createPreviewItems()
 {
-    m_previewHash.clear();
     m_scene->clear();
-
-    QPalette pal(this->palette());
+    m_previewItem = NULL;
 
     FixtureGroup* grp = m_doc->fixtureGroup(m_mtx->fixtureGroup());
     if (grp == NULL)
     {
         QGraphicsTextItem* text = new QGraphicsTextItem(tr("No fixture group to control"));
         m_scene->addItem(text);
+        invalidatePreview();
         return;
     }
 
-    m_previewMaps = m_mtx->previewMaps();
+    QRect hole(RECT_PADDING + ITEM_PADDING, RECT_PADDING + ITEM_PADDING,
+               ITEM_SIZE - (2 * ITEM_PADDING), ITEM_SIZE - (2 * ITEM_PADDING));
+    m_previewItem = new RGBPreviewItem(grp->size(), RECT_SIZE, hole,
+                                       m_scene->backgroundBrush().color());
+    m_scene->addItem(m_previewItem);
+    m_scene->setSceneRect(m_previewItem->boundingRect());
+
+    invalidatePreview();
+
+    if (m_mtx->direction() == Function::Forward)
+        m_previewStep = 0;
+    else
+        m_previewStep = m_previewSteps.size() - 1;
+}
+
+void RGBMatrixEditor::invalidatePreview()
+{
+    m_previewSteps.clear();
+    m_previewSteps.resize(m_mtx->previewStepCount());
+    m_previewBuildStep = 0;
+
+    if (m_previewSteps.isEmpty() == false)
+        m_previewBuilder->start();
+    else
+        m_previewBuilder->stop();
+
+    if (m_previewStep >= m_previewSteps.size())
+        m_previewStep = 0;
+}
+
+QImage RGBMatrixEditor::previewImage(int step)
+{
+    if (step < 0 || step >= m_previewSteps.size())
+        return QImage();
+
+    if (m_previewSteps[step].isNull() == false)
+        return m_previewSteps[step];
 
-    for (int x = 0; x < grp->size().width(); x++)
+    FixtureGroup* grp = m_doc->fixtureGroup(m_mtx->fixtureGroup());
+    if (grp == NULL)
+        return QImage();
+
+    /* One pixel per cell. Cells without a head get the background colour
+       so that they look empty thru the preview item's cell mask. */
+    RGBMap map = m_mtx->previewMap(step);
+    QRgb background = m_scene->backgroundBrush().color().rgb();
+    QImage image(grp->size(), QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); y++)
     {
-        for (int y = 0; y < grp->size().height(); y++)
+        QRgb* line = reinterpret_cast<QRgb*> (image.scanLine(y));
+        for (int x = 0; x < image.width(); x++)
         {
-            QLCPoint pt(x, y);
-
-            if (grp->headHash().contains(pt) == true)
+            if (y < map.size() && x < map[y].size() &&
+                grp->hasHead(QLCPoint(x, y)) == true)
+            {
+                line[x] = map[y][x] | 0xff000000;
+            }
+            else
             {
-                RGBItem* item = new RGBItem;
-                item->setRect(x * RECT_SIZE + RECT_PADDING + ITEM_PADDING,
-                              y * RECT_SIZE + RECT_PADDING + ITEM_PADDING,
-                              ITEM_SIZE - (2 * ITEM_PADDING),
-                              ITEM_SIZE - (2 * ITEM_PADDING));
-                item->setColor(Qt::black);
-                item->draw(0);
-                m_scene->addItem(item);
-                m_previewHash[pt] = item;
+                line[x] = background;
             }
         }
     }
 
-    if (m_mtx->direction() == Function::Forward)
-        m_previewStep = 0;
-    else
-        m_previewStep = m_previewMaps.size() - 1;
+    m_previewSteps[step] = image;
+    return image;
 }
 
 void RGBMatrixEditor::slotPreviewTimeout()
 {
-    RGBItem* shape = NULL;
-
-    if (m_mtx->duration() <= 0)
+    if (m_previewItem == NULL || m_mtx->duration() <= 0)
         return;
 
     m_previewIterator += MasterTimer::tick();
@@ -317,41 +356,43 @@ void RGBMatrixEditor::slotPreviewTimeout()
         if (m_mtx->direction() == Function::Forward)
         {
             m_previewStep++;
-            if (m_previewStep >= m_previewMaps.size())
+            if (m_previewStep >= m_previewSteps.size())
                 m_previewStep = 0;
         }
         else
         {
             m_previewStep--;
             if (m_previewStep < 0)
-                m_previewStep = m_previewMaps.size() - 1;
+                m_previewStep = m_previewSteps.size() - 1;
         }
 
         m_previewIterator = 0;
     }
 
-    RGBMap map;
-    if (m_previewStep < m_previewMaps.size())
-        map = m_previewMaps[m_previewStep];
+    m_previewItem->setImage(previewImage(m_previewStep));
+    m_previewItem->draw(m_mtx->fadeInSpeed());
+}
 
-    for (int y = 0; y < map.size(); y++)
+void RGBMatrixEditor::slotPreviewBuilderTimeout()
+{
+    /* Scripts share a single script engine with the running matrix, so
+       don't compute anything while the matrix is being tested. */
+    if (m_mtx->isRunning() == true)
     {
-        for (int x = 0; x < map[y].size(); x++)
-        {
-            QLCPoint pt(x, y);
-            if (m_previewHash.contains(pt) == true)
-            {
-                shape = static_cast<RGBItem*>(m_previewHash[pt]);
-                if (shape->color() != QColor(map[y][x]).rgb())
-                    shape->setColor(map[y][x]);
-
-                if (shape->color() == QColor(Qt::black).rgb())
-                    shape->draw(m_mtx->fadeOutSpeed());
-                else
-                    shape->draw(m_mtx->fadeInSpeed());
-            }
-        }
+        m_previewBuilder->stop();
+        return;
     }
+
+    while (m_previewBuildStep < m_previewSteps.size() &&
+           m_previewSteps[m_previewBuildStep].isNull() == false)
+    {
+        m_previewBuildStep++;
+    }
+
+    if (m_previewBuildStep < m_previewSteps.size())
+        previewImage(m_previewBuildStep);
+    else
+        m_previewBuilder->stop();
 }
 
 void RGBMatrixEditor::slotNameEdited(const QString& text)
@@ -502,12 +543,14 @@ void RGBMatrixEditor::slotTestClicked()
         m_mtx->stopAndWait();
         m_previewIterator = 0;
         m_previewTimer->start(MasterTimer::tick());
+        if (m_previewBuildStep < m_previewSteps.size())
+            m_previewBuilder->start();
     }
 }
 
 void RGBMatrixEditor::slotRestartTest()
 {
-    m_previewMaps = m_mtx->previewMaps();
+    invalidatePreview();
 
     if (m_testButton->isChecked() == true)
     {
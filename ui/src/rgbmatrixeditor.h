@@ -24,15 +24,16 @@
 
 #include <QPointer>
 #include <QWidget>
-#include <QHash>
+#include <QVector>
+#include <QImage>
 
 #include "ui_rgbmatrixeditor.h"
 #include "rgbmatrix.h"
-#include "qlcpoint.h"
 #include "doc.h"
 
 class SpeedDialWidget;
 class QGraphicsScene;
+class RGBPreviewItem;
 class RGBMatrix;
 class QTimer;
 class Doc;
@@ -63,8 +64,15 @@ private:
 
     void createPreviewItems();
 
+    /** Forget all computed preview steps and start computing them again */
+    void invalidatePreview();
+
+    /** Get the image of a preview step, computing it first if necessary */
+    QImage previewImage(int step);
+
 private slots:
     void slotPreviewTimeout();
+    void slotPreviewBuilderTimeout();
     void slotNameEdited(const QString& text);
     void slotPatternActivated(const QString& text);
     void slotFixtureGroupActivated(int index);
@@ -99,15 +107,21 @@ private:
     RGBMatrix* m_mtx; // The RGBMatrix being edited
 
     QList <RGBScript> m_scripts;
-    QList <RGBMap> m_previewMaps;
 
     QPointer<SpeedDialWidget> m_speedDials;
 
     QGraphicsScene* m_scene;
+    RGBPreviewItem* m_previewItem;
     QTimer* m_previewTimer;
     uint m_previewIterator;
     int m_previewStep;
-    QHash <QLCPoint,QGraphicsItem*> m_previewHash;
+
+    /** Preview step images, null for steps that are not computed yet */
+    QVector <QImage> m_previewSteps;
+
+    /** Computes the missing preview steps one at a time when idle */
+    QTimer* m_previewBuilder;
+    int m_previewBuildStep;
 };
 
 #endif
@@ -0,0 +1,116 @@
+/*
+  Q Light Controller
+  rgbpreviewitem.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#include <QPainter>
+#include <QBrush>
+
+#include "rgbpreviewitem.h"
+#include "mastertimer.h"
+
+RGBPreviewItem::RGBPreviewItem(const QSize& size, int cellSize, const QRect& hole,
+                               const QColor& background, QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+    , m_size(size)
+    , m_cellSize(cellSize)
+    , m_mask(cellSize, cellSize)
+    , m_opacity(1.0)
+    , m_elapsed(0)
+{
+    /* Start from a transparent pixmap so that clearing the hole really
+       punches through the background instead of painting it black */
+    m_mask.fill(Qt::transparent);
+
+    QPainter painter(&m_mask);
+    painter.fillRect(m_mask.rect(), background);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    painter.drawEllipse(hole);
+}
+
+RGBPreviewItem::~RGBPreviewItem()
+{
+}
+
+void RGBPreviewItem::setImage(const QImage& image)
+{
+    if (image.cacheKey() == m_image.cacheKey())
+        return;
+
+    m_oldImage = m_image;
+    m_image = image;
+    m_elapsed = 0;
+}
+
+QImage RGBPreviewItem::image() const
+{
+    return m_image;
+}
+
+void RGBPreviewItem::draw(uint ms)
+{
+    qreal opacity;
+    if (ms == 0 || m_elapsed >= ms || m_oldImage.isNull() == true)
+        opacity = 1.0;
+    else
+        opacity = qreal(m_elapsed) / qreal(ms);
+
+    if (opacity != m_opacity || m_elapsed == 0)
+    {
+        m_opacity = opacity;
+        update();
+    }
+
+    m_elapsed += MasterTimer::tick();
+}
+
+QRectF RGBPreviewItem::boundingRect() const
+{
+    return QRectF(0, 0, m_size.width() * m_cellSize, m_size.height() * m_cellSize);
+}
+
+void RGBPreviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+                           QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    QRectF rect(boundingRect());
+
+    /* Scale the cell pixels up without smoothing so that each one fills its
+       own cell exactly. Fading draws the new step over the old one. */
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    if (m_opacity < 1.0 && m_oldImage.isNull() == false)
+    {
+        painter->drawImage(rect, m_oldImage);
+        painter->setOpacity(m_opacity);
+    }
+
+    if (m_image.isNull() == false)
+        painter->drawImage(rect, m_image);
+    else
+        painter->fillRect(rect, Qt::black);
+
+    painter->setOpacity(1.0);
+    painter->fillRect(rect, QBrush(m_mask));
+}
@@ -0,0 +1,89 @@
+/*
+  Q Light Controller
+  rgbpreviewitem.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#ifndef RGBPREVIEWITEM_H
+#define RGBPREVIEWITEM_H
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QImage>
+#include <QColor>
+#include <QRect>
+#include <QSize>
+
+/**
+ * RGBPreviewItem draws a whole RGB matrix preview step in one go. Each step
+ * is an image with one pixel per matrix cell, which is scaled up to the
+ * item's size and then covered with a tiled mask that leaves a round hole
+ * for each cell. This way a preview costs one image blit and one texture
+ * fill per frame, regardless of the size of the matrix.
+ */
+class RGBPreviewItem : public QGraphicsItem
+{
+public:
+    /**
+     * Create a new preview item
+     *
+     * @param size The size of the matrix in cells
+     * @param cellSize The size of a single cell in pixels
+     * @param hole The bounding rect of the round hole inside a cell
+     * @param background The colour of the mask around the holes
+     */
+    RGBPreviewItem(const QSize& size, int cellSize, const QRect& hole,
+                   const QColor& background, QGraphicsItem* parent = 0);
+    ~RGBPreviewItem();
+
+    /** Set the current step image, fading from the previous one */
+    void setImage(const QImage& image);
+
+    /** Get the current step image */
+    QImage image() const;
+
+    /**
+     * Advance the fade from the previous image by one timer tick.
+     *
+     * @param ms The total fade time, 0 to show the current image at once
+     */
+    void draw(uint ms);
+
+    /** @reimp */
+    QRectF boundingRect() const;
+
+protected:
+    /** @reimp */
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+               QWidget* widget);
+
+private:
+    QSize m_size;
+    int m_cellSize;
+
+    /** A single cell of the mask, tiled over the whole item */
+    QPixmap m_mask;
+
+    QImage m_image;
+    QImage m_oldImage;
+    qreal m_opacity;
+    uint m_elapsed;
+};
+
+#endif
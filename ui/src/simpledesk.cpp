@@ -319,6 +319,8 @@ void SimpleDesk::initUniverseSliders()
     connect(m_doc, SIGNAL(fixtureAdded(quint32)), this, SLOT(slotUpdateUniverseSliders()));
     connect(m_doc, SIGNAL(fixtureRemoved(quint32)), this, SLOT(slotUpdateUniverseSliders()));
     connect(m_doc, SIGNAL(fixtureChanged(quint32)), this, SLOT(slotUpdateUniverseSliders()));
+    connect(m_doc, SIGNAL(batchFinished(const Doc::BatchChanges&)),
+            this, SLOT(slotBatchFinished(const Doc::BatchChanges&)));
 }
 
 void SimpleDesk::initUniversePager()
@@ -444,10 +446,20 @@ void SimpleDesk::slotUniverseSliderValueChanged(uchar value)
 
 void SimpleDesk::slotUpdateUniverseSliders()
 {
+    /* Wait for the end of the batch to update only once */
+    if (m_doc->isBatching() == true)
+        return;
+
     qDebug() << Q_FUNC_INFO;
     slotUniversePageChanged(m_universePageSpin->value());
 }
 
+void SimpleDesk::slotBatchFinished(const Doc::BatchChanges& changes)
+{
+    if (changes.fixtures.isEmpty() == false)
+        slotUniversePageChanged(m_universePageSpin->value());
+}
+
 /****************************************************************************
  * Playback Sliders
  ****************************************************************************/
@@ -28,6 +28,8 @@
 #include <QList>
 #include <QHash>
 
+#include "doc.h"
+
 #define KXMLQLCSimpleDesk "SimpleDesk"
 
 class GrandMasterSlider;
@@ -45,7 +47,6 @@ class QSplitter;
 class DMXSlider;
 class QSpinBox;
 class CueStack;
-class Doc;
 class Cue;
 
 class SimpleDesk : public QWidget
@@ -102,6 +103,7 @@ private slots:
     void slotUniverseResetClicked();
     void slotUniverseSliderValueChanged(uchar value);
     void slotUpdateUniverseSliders();
+    void slotBatchFinished(const Doc::BatchChanges& changes);
 
 private:
     QGroupBox* m_universeGroup;
@@ -19,6 +19,7 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QVarLengthArray>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QVariant>
@@ -250,28 +251,27 @@ bool SimpleDeskEngine::saveXML(QDomDocument* doc, QDomElement* wksp_root) const
 
 void SimpleDeskEngine::writeDMX(MasterTimer* timer, UniverseArray* ua)
 {
+    const PatchSnapshot* patch = doc()->patchSnapshot();
+
+    QVarLengthArray <int,512> channels(m_values.size());
+    QVarLengthArray <uchar,512> values(m_values.size());
+    QVarLengthArray <QLCChannel::Group,512> groups(m_values.size());
+    int count = 0;
+
     QHashIterator <uint,uchar> it(m_values);
-    while (it.hasNext() == true)
+    while (it.hasNext() == true && count < channels.size())
     {
         it.next();
 
-        Fixture* fxi = doc()->fixture(doc()->fixtureForAddress(it.key()));
-        if (fxi == NULL || fxi->isDimmer() == true)
-        {
-            ua->write(it.key(), it.value(), QLCChannel::Intensity);
-        }
-        else
-        {
-            uint ch = it.key() - fxi->universeAddress();
-            QLCChannel::Group grp = QLCChannel::NoGroup;
-            if (ch < fxi->channels())
-                grp = fxi->channel(ch)->group();
-            else
-                grp = QLCChannel::Intensity;
-            ua->write(it.key(), it.value(), grp);
-        }
+        /* Unpatched addresses and dimmer channels are Intensity */
+        channels[count] = int(it.key());
+        values[count] = it.value();
+        groups[count] = patch->addressInfo(it.key()).group;
+        count++;
     }
 
+    ua->write(channels.constData(), values.constData(), groups.constData(), count);
+
     m_mutex.lock();
     foreach (CueStack* cueStack, m_cueStacks)
     {
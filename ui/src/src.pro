@@ -37,6 +37,7 @@ HEADERS += aboutbox.h \
            createfixturegroup.h \
            cuestackmodel.h \
            docbrowser.h \
+           doctreemodel.h \
            dmxslider.h \
            efxeditor.h \
            efxpreviewarea.h \
@@ -44,8 +45,10 @@ HEADERS += aboutbox.h \
            fixturegroupeditor.h \
            fixturemanager.h \
            fixtureselection.h \
+           fixturetreemodel.h \
            functionmanager.h \
            functionselection.h \
+           functiontreemodel.h \
            functionwizard.h \
            grandmasterslider.h \
            inputchanneleditor.h \
@@ -53,13 +56,14 @@ HEADERS += aboutbox.h \
            inputmanager.h \
            inputpatcheditor.h \
            monitor.h \
+           monitorcanvas.h \
            monitorfixture.h \
            monitorlayout.h \
            outputmanager.h \
            outputpatcheditor.h \
            playbackslider.h \
            rgbmatrixeditor.h \
-           rgbitem.h \
+           rgbpreviewitem.h \
            sceneeditor.h \
            scripteditor.h \
            selectinputchannel.h \
@@ -77,6 +81,7 @@ HEADERS += aboutbox.h \
            vclabel.h \
            vcproperties.h \
            vcpropertieseditor.h \
+           vcrefreshscheduler.h \
            vcslider.h \
            vcsliderproperties.h \
            vcsoloframe.h \
@@ -134,6 +139,7 @@ SOURCES += aboutbox.cpp \
            createfixturegroup.cpp \
            cuestackmodel.cpp \
            docbrowser.cpp \
+           doctreemodel.cpp \
            dmxslider.cpp \
            efxeditor.cpp \
            efxpreviewarea.cpp \
@@ -141,8 +147,10 @@ SOURCES += aboutbox.cpp \
            fixturegroupeditor.cpp \
            fixturemanager.cpp \
            fixtureselection.cpp \
+           fixturetreemodel.cpp \
            functionmanager.cpp \
            functionselection.cpp \
+           functiontreemodel.cpp \
            functionwizard.cpp \
            grandmasterslider.cpp \
            inputchanneleditor.cpp \
@@ -150,13 +158,14 @@ SOURCES += aboutbox.cpp \
            inputmanager.cpp \
            inputpatcheditor.cpp \
            monitor.cpp \
+           monitorcanvas.cpp \
            monitorfixture.cpp \
            monitorlayout.cpp \
            outputmanager.cpp \
            outputpatcheditor.cpp \
            playbackslider.cpp \
            rgbmatrixeditor.cpp \
-           rgbitem.cpp \
+           rgbpreviewitem.cpp \
            sceneeditor.cpp \
            scripteditor.cpp \
            selectinputchannel.cpp \
@@ -174,6 +183,7 @@ SOURCES += aboutbox.cpp \
            vclabel.cpp \
            vcproperties.cpp \
            vcpropertieseditor.cpp \
+           vcrefreshscheduler.cpp \
            vcslider.cpp \
            vcsliderproperties.cpp \
            vcsoloframe.cpp \
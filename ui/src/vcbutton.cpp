@@ -44,6 +44,7 @@
 #include "qlcfile.h"
 
 #include "vcbuttonproperties.h"
+#include "vcrefreshscheduler.h"
 #include "functionselection.h"
 #include "vcsoloframe.h"
 #include "virtualconsole.h"
@@ -63,6 +64,7 @@ const QSize VCButton::defaultSize(QSize(50, 50));
  *****************************************************************************/
 
 VCButton::VCButton(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
+    , m_functionState(0)
     , m_adjustIntensity(false)
     , m_intensityAdjustment(1.0)
 {
@@ -98,10 +100,16 @@ VCButton::VCButton(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
     /* Listen to function removals */
     connect(m_doc, SIGNAL(functionRemoved(quint32)),
             this, SLOT(slotFunctionRemoved(quint32)));
+
+    /* Follow the function's state changes made in the MasterTimer thread */
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->registerWidget(this);
 }
 
 VCButton::~VCButton()
 {
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->unregisterWidget(this);
 }
 
 /*****************************************************************************
@@ -299,30 +307,13 @@ void VCButton::slotResetIcon()
 
 void VCButton::setFunction(quint32 fid)
 {
-    Function* old = m_doc->function(m_function);
-    if (old != NULL)
-    {
-        /* Get rid of old function connections */
-        disconnect(old, SIGNAL(running(quint32)),
-                   this, SLOT(slotFunctionRunning(quint32)));
-        disconnect(old, SIGNAL(stopped(quint32)),
-                   this, SLOT(slotFunctionStopped(quint32)));
-        disconnect(old, SIGNAL(flashing(quint32,bool)),
-                   this, SLOT(slotFunctionFlashing(quint32,bool)));
-    }
-
+    /* The button follows its function only through refreshState(), since
+       the function's signals are mostly emitted in the MasterTimer thread */
     Function* function = m_doc->function(fid);
     if (function != NULL)
     {
-        /* Connect to the new function */
-        connect(function, SIGNAL(running(quint32)),
-                this, SLOT(slotFunctionRunning(quint32)));
-        connect(function, SIGNAL(stopped(quint32)),
-                this, SLOT(slotFunctionStopped(quint32)));
-        connect(function, SIGNAL(flashing(quint32,bool)),
-                this, SLOT(slotFunctionFlashing(quint32,bool)));
-
         m_function = fid;
+        syncFunctionState();
 
         setToolTip(function->name());
     }
@@ -346,6 +337,53 @@ void VCButton::slotFunctionRemoved(quint32 fid)
         setFunction(Function::invalidId());
 }
 
+/*****************************************************************************
+ * State refresh
+ *****************************************************************************/
+
+bool VCButton::refreshState()
+{
+    /* The button's on state is never postponed, because it decides what
+       a press does and it is also sent as input feedback */
+    Function* function = m_doc->function(m_function);
+    if (function == NULL)
+        return true;
+
+    int state = function->publishedState();
+    if (state == m_functionState)
+        return true;
+
+    int previous = m_functionState;
+    m_functionState = state;
+
+    if (m_action == Flash)
+    {
+        setOn(Function::stateFlashing(state));
+    }
+    else if (Function::stateRunning(state) == true)
+    {
+        setOn(true);
+    }
+    else if (Function::stateRunning(previous) == true ||
+             Function::stateRunCount(state) != Function::stateRunCount(previous))
+    {
+        /* Stopped, possibly after a run that started and ended between
+           two refreshes */
+        setOn(false);
+        if (isOnScreen() == true)
+            blink(250);
+    }
+
+    return true;
+}
+
+void VCButton::syncFunctionState()
+{
+    Function* function = m_doc->function(m_function);
+    if (function != NULL)
+        m_functionState = function->publishedState();
+}
+
 /*****************************************************************************
  * Button state
  *****************************************************************************/
@@ -547,7 +585,10 @@ void VCButton::pressFunction()
     {
         f = m_doc->function(m_function);
         if (f != NULL)
+        {
             f->flash(m_doc->masterTimer());
+            refreshState();
+        }
     }
     else if (m_action == Blackout)
     {
@@ -569,31 +610,13 @@ void VCButton::releaseFunction()
     {
         Function* f = m_doc->function(m_function);
         if (f != NULL)
+        {
             f->unFlash(m_doc->masterTimer());
+            refreshState();
+        }
     }
 }
 
-void VCButton::slotFunctionRunning(quint32 fid)
-{
-    if (fid == m_function && m_action != Flash)
-        setOn(true);
-}
-
-void VCButton::slotFunctionStopped(quint32 fid)
-{
-    if (fid == m_function && m_action != Flash)
-    {
-        setOn(false);
-        blink(250);
-    }
-}
-
-void VCButton::slotFunctionFlashing(quint32 fid, bool state)
-{
-    if (fid == m_function)
-        setOn(state);
-}
-
 void VCButton::blink(int ms)
 {
     slotBlink();
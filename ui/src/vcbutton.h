@@ -164,6 +164,21 @@ protected:
     /** The function that this button is controlling */
     quint32 m_function;
 
+    /*********************************************************************
+     * State refresh
+     *********************************************************************/
+public:
+    /** @reimp */
+    bool refreshState();
+
+protected:
+    /** Remember the function's current state as already shown */
+    void syncFunctionState();
+
+protected:
+    /** The latest Function::publishedState() that the button has shown */
+    int m_functionState;
+
     /*********************************************************************
      * Button state
      *********************************************************************/
@@ -264,15 +279,6 @@ protected:
     void blink(int ms);
 
 protected slots:
-    /** Handler for function running signal */
-    void slotFunctionRunning(quint32 fid);
-
-    /** Handler for function stop signal */
-    void slotFunctionStopped(quint32 fid);
-
-    /** Basically the same as slotFunctionStopped() but for flash signal */
-    void slotFunctionFlashing(quint32 fid, bool state);
-
     /** Slot for brief widget blink when controlled function stops */
     void slotBlink();
 
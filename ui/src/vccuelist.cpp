@@ -28,6 +28,7 @@
 #include <QtXml>
 
 #include "vccuelistproperties.h"
+#include "vcrefreshscheduler.h"
 #include "virtualconsole.h"
 #include "chaserrunner.h"
 #include "mastertimer.h"
@@ -51,6 +52,8 @@ const quint8 VCCueList::stopInputSourceId = 2;
 VCCueList::VCCueList(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
     , m_chaser(Function::invalidId())
     , m_runner(NULL)
+    , m_publishedStep(-1)
+    , m_shownStep(-1)
     , m_stop(false)
 {
     /* Set the class name "VCCueList" as the object name as well */
@@ -95,10 +98,16 @@ VCCueList::VCCueList(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
     m_nextLatestValue = 0;
     m_previousLatestValue = 0;
     m_stopLatestValue = 0;
+
+    /* Follow step changes made in the MasterTimer thread */
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->registerWidget(this);
 }
 
 VCCueList::~VCCueList()
 {
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->unregisterWidget(this);
     m_doc->masterTimer()->unregisterDMXSource(this);
 }
 
@@ -238,15 +247,6 @@ void VCCueList::slotStop()
     m_tree->setCurrentItem(NULL);
 }
 
-void VCCueList::slotCurrentStepChanged(int stepNumber)
-{
-    Q_ASSERT(stepNumber < m_tree->topLevelItemCount() && stepNumber >= 0);
-    QTreeWidgetItem* item = m_tree->topLevelItem(stepNumber);
-    Q_ASSERT(item != NULL);
-    m_tree->scrollToItem(item, QAbstractItemView::PositionAtCenter);
-    m_tree->setCurrentItem(item);
-}
-
 void VCCueList::slotItemActivated(QTreeWidgetItem* item)
 {
     if (mode() != Doc::Operate)
@@ -269,8 +269,9 @@ void VCCueList::createRunner(int startIndex)
     {
         m_runner = Chaser::createRunner(chaser, m_doc);
         m_runner->setCurrentStep(startIndex);
-        connect(m_runner, SIGNAL(currentStepChanged(int)),
-                this, SLOT(slotCurrentStepChanged(int)));
+
+        /* The runner steps in the MasterTimer thread. Its current step
+           reaches the list through publishStep() and refreshState(). */
     }
 }
 
@@ -286,6 +287,7 @@ void VCCueList::writeDMX(MasterTimer* timer, UniverseArray* universes)
         if (m_stop == false)
         {
             m_runner->write(timer, universes);
+            publishStep(m_runner->currentStep());
         }
         else
         {
@@ -293,11 +295,44 @@ void VCCueList::writeDMX(MasterTimer* timer, UniverseArray* universes)
             delete m_runner;
             m_runner = NULL;
             m_stop = false;
+            publishStep(-1);
         }
     }
     m_mutex.unlock();
 }
 
+void VCCueList::publishStep(int step)
+{
+    if (m_publishedStep.fetchAndStoreOrdered(step) != step)
+        m_doc->notifyFunctionStateChanged();
+}
+
+/*****************************************************************************
+ * State refresh
+ *****************************************************************************/
+
+bool VCCueList::refreshState()
+{
+    int step = m_publishedStep;
+    if (step == m_shownStep)
+        return true;
+
+    /* The selection only shows the runner's step, so it can wait until
+       the list is seen again */
+    if (isOnScreen() == false)
+        return false;
+
+    m_shownStep = step;
+    if (step >= 0 && step < m_tree->topLevelItemCount())
+    {
+        QTreeWidgetItem* item = m_tree->topLevelItem(step);
+        m_tree->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+        m_tree->setCurrentItem(item);
+    }
+
+    return true;
+}
+
 /*****************************************************************************
  * Key Sequences
  *****************************************************************************/
@@ -437,7 +472,9 @@ void VCCueList::slotModeChanged(Doc::Mode mode)
         if (m_runner != NULL)
             delete m_runner;
         m_runner = NULL;
+        m_publishedStep = -1;
         m_mutex.unlock();
+        m_shownStep = -1;
         m_tree->setEnabled(false);
     }
 
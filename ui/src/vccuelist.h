@@ -23,6 +23,7 @@
 #define VCCUELIST_H
 
 #include <QKeySequence>
+#include <QAtomicInt>
 #include <QWidget>
 
 #include "dmxsource.h"
@@ -118,9 +119,6 @@ private slots:
     /** Stop the cue list and return to start */
     void slotStop();
 
-    /** Called when m_runner skips to another step */
-    void slotCurrentStepChanged(int stepNumber);
-
     /** Slot that is called whenever the current item changes (either by
         pressing the key binding or clicking an item with mouse) */
     void slotItemActivated(QTreeWidgetItem* item);
@@ -137,6 +135,12 @@ private:
     ChaserRunner* m_runner;
     QMutex m_mutex; // Guards m_runner
 
+    /** Current step of m_runner as seen by writeDMX(), -1 without a runner */
+    QAtomicInt m_publishedStep;
+
+    /** The step that the list has selected to match m_publishedStep */
+    int m_shownStep;
+
     /*************************************************************************
      * DMX Source
      *************************************************************************/
@@ -144,10 +148,21 @@ public:
     /** @reimp */
     void writeDMX(MasterTimer* timer, UniverseArray* universes);
 
+private:
+    /** Publish the runner's current step for refreshState() */
+    void publishStep(int step);
+
 private:
     /** Flag indicating, whether stop button has been pressed */
     bool m_stop;
 
+    /*************************************************************************
+     * State refresh
+     *************************************************************************/
+public:
+    /** @reimp */
+    bool refreshState();
+
     /*************************************************************************
      * Key sequences
      *************************************************************************/
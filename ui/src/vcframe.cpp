@@ -325,17 +325,14 @@ bool VCFrame::saveXML(QDomDocument* doc, QDomElement* vc_root)
 
 void VCFrame::postLoad()
 {
-    QListIterator <VCWidget*> it(findChildren<VCWidget*>());
+    /* Go through direct children only; child frames take care of their
+       own children. Using the recursive findChildren() here would walk
+       each nested widget once for every frame above it. */
+    QListIterator <QObject*> it(children());
     while (it.hasNext() == true)
     {
-        VCWidget* widget = it.next();
-
-        /* findChildren() is recursive, so the list contains all
-           possible child widgets below this frame. Each frame must
-           save only its direct children to preserve hierarchy, so
-           save only such widgets that have this widget as their
-           direct parent. */
-        if (widget->parentWidget() == this)
+        VCWidget* widget = qobject_cast<VCWidget*> (it.next());
+        if (widget != NULL)
             widget->postLoad();
     }
 }
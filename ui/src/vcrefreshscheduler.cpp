@@ -0,0 +1,129 @@
+/*
+  Q Light Controller
+  vcrefreshscheduler.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#include <QTimer>
+
+#include "vcrefreshscheduler.h"
+#include "vcwidget.h"
+
+/* About 30 refreshes per second is enough for any display */
+#define KRefreshInterval 33
+
+/* Retry postponed refreshes about three times per second */
+#define KRetryTicks 10
+
+VCRefreshScheduler::VCRefreshScheduler(Doc* doc, QObject* parent)
+    : QObject(parent)
+    , m_doc(doc)
+    , m_timer(new QTimer(this))
+    , m_serial(0)
+    , m_retryCountdown(KRetryTicks)
+{
+    Q_ASSERT(doc != NULL);
+
+    m_timer->setInterval(interval());
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(slotRefresh()));
+
+    connect(m_doc, SIGNAL(modeChanged(Doc::Mode)),
+            this, SLOT(slotModeChanged(Doc::Mode)));
+    slotModeChanged(m_doc->mode());
+}
+
+VCRefreshScheduler::~VCRefreshScheduler()
+{
+}
+
+int VCRefreshScheduler::interval()
+{
+    return KRefreshInterval;
+}
+
+void VCRefreshScheduler::registerWidget(VCWidget* widget)
+{
+    Q_ASSERT(widget != NULL);
+    if (m_widgets.contains(widget) == false)
+        m_widgets << widget;
+}
+
+void VCRefreshScheduler::unregisterWidget(VCWidget* widget)
+{
+    m_widgets.removeAll(widget);
+    m_postponed.removeAll(widget);
+}
+
+QList <VCWidget*> VCRefreshScheduler::widgets() const
+{
+    return m_widgets;
+}
+
+void VCRefreshScheduler::slotRefresh()
+{
+    QList <VCWidget*> widgets;
+
+    int serial = m_doc->functionStateSerial();
+    if (serial != m_serial)
+    {
+        /* Something has changed; any of the widgets may be affected */
+        m_serial = serial;
+        widgets = m_widgets;
+    }
+    else if (m_postponed.isEmpty() == false && --m_retryCountdown <= 0)
+    {
+        /* Nothing new but some widgets are still behind */
+        widgets = m_postponed;
+    }
+    else
+    {
+        return;
+    }
+
+    m_postponed.clear();
+    m_retryCountdown = KRetryTicks;
+
+    QListIterator <VCWidget*> it(widgets);
+    while (it.hasNext() == true)
+    {
+        VCWidget* widget = it.next();
+        if (widget->refreshState() == false)
+            m_postponed << widget;
+    }
+}
+
+void VCRefreshScheduler::slotViewChanged()
+{
+    m_retryCountdown = 0;
+}
+
+void VCRefreshScheduler::slotModeChanged(Doc::Mode mode)
+{
+    if (mode == Doc::Operate)
+    {
+        /* Catch up with anything that happened in Design mode */
+        m_serial = m_doc->functionStateSerial() - 1;
+        m_postponed.clear();
+        m_timer->start();
+    }
+    else
+    {
+        m_timer->stop();
+    }
+}
@@ -0,0 +1,105 @@
+/*
+  Q Light Controller
+  vcrefreshscheduler.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+
+#ifndef VCREFRESHSCHEDULER_H
+#define VCREFRESHSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+
+#include "doc.h"
+
+class VCWidget;
+class QTimer;
+
+/**
+ * VCRefreshScheduler keeps Virtual Console widgets in sync with the state
+ * of the functions they control. Widgets don't connect to function signals,
+ * which are mostly emitted in the MasterTimer thread and would each become a
+ * queued event for every widget. Instead, the engine publishes function
+ * state in atomic words (see Function::publishedState()) and this class
+ * polls it at display rate with a single timer. Widgets that change their
+ * function's state in the UI thread call their own refreshState() directly.
+ *
+ * On each tick the scheduler checks Doc::functionStateSerial() and, only if
+ * any function has published something new since the last tick, calls
+ * VCWidget::refreshState() for the registered widgets. Each widget then
+ * compares the state of its own function against the one it has already
+ * shown, so only the affected widgets actually update themselves.
+ *
+ * Widgets that are not on screen may postpone purely visual updates. The
+ * scheduler retries them when the view changes (see slotViewChanged()) and
+ * a few times per second in case they were revealed some other way.
+ *
+ * The scheduler runs only in Operate mode.
+ */
+class VCRefreshScheduler : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(VCRefreshScheduler)
+
+public:
+    VCRefreshScheduler(Doc* doc, QObject* parent);
+    ~VCRefreshScheduler();
+
+    /** Polling interval in milliseconds */
+    static int interval();
+
+    /** Start calling refreshState() for the given widget */
+    void registerWidget(VCWidget* widget);
+
+    /** Stop calling refreshState() for the given widget */
+    void unregisterWidget(VCWidget* widget);
+
+    /** Get the list of registered widgets */
+    QList <VCWidget*> widgets() const;
+
+public slots:
+    /** Refresh all registered widgets if any function state has changed */
+    void slotRefresh();
+
+    /**
+     * Tell the scheduler that different widgets may have come into view
+     * (e.g. the Virtual Console was scrolled) so postponed refreshes should
+     * be retried on the next tick.
+     */
+    void slotViewChanged();
+
+private slots:
+    void slotModeChanged(Doc::Mode mode);
+
+private:
+    Doc* m_doc;
+    QTimer* m_timer;
+    QList <VCWidget*> m_widgets;
+
+    /** Doc::functionStateSerial() at the time of the latest refresh */
+    int m_serial;
+
+    /** Widgets that postponed their latest refresh */
+    QList <VCWidget*> m_postponed;
+
+    /** Ticks until postponed refreshes are retried */
+    int m_retryCountdown;
+};
+
+#endif
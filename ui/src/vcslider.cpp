@@ -35,10 +35,12 @@
 #include <QPen>
 
 #include "vcsliderproperties.h"
+#include "vcrefreshscheduler.h"
 #include "qlcinputchannel.h"
 #include "virtualconsole.h"
 #include "qlcinputsource.h"
 #include "universearray.h"
+#include "patchsnapshot.h"
 #include "mastertimer.h"
 #include "collection.h"
 #include "inputpatch.h"
@@ -76,10 +78,13 @@ VCSlider::VCSlider(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
 
     m_levelValue = 0;
     m_levelValueChanged = false;
+    m_levelChannelsChanged = true;
+    m_levelPatchVersion = 0;
 
     m_playbackFunction = Function::invalidId();
     m_playbackValue = 0;
     m_playbackValueChanged = false;
+    m_playbackFunctionState = 0;
 
     m_time = NULL;
 
@@ -142,10 +147,18 @@ VCSlider::VCSlider(QWidget* parent, Doc* doc) : VCWidget(parent, doc)
        they no longer point to an existing fixture->channel */
     connect(m_doc, SIGNAL(fixtureRemoved(quint32)),
             this, SLOT(slotFixtureRemoved(quint32)));
+
+    /* Follow the playback function's state changes made in the MasterTimer
+       thread */
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->registerWidget(this);
 }
 
 VCSlider::~VCSlider()
 {
+    if (VirtualConsole::instance() != NULL)
+        VirtualConsole::instance()->refreshScheduler()->unregisterWidget(this);
+
     if (m_time != NULL)
         delete m_time;
     m_time = NULL;
@@ -183,7 +196,10 @@ bool VCSlider::copyFrom(VCWidget* widget)
     /* Copy level stuff */
     setLevelLowLimit(slider->levelLowLimit());
     setLevelHighLimit(slider->levelHighLimit());
+    m_levelValueMutex.lock();
     m_levelChannels = slider->m_levelChannels;
+    m_levelChannelsChanged = true;
+    m_levelValueMutex.unlock();
 
     /* Copy playback stuff */
     m_playbackFunction = slider->m_playbackFunction;
@@ -239,21 +255,11 @@ void VCSlider::slotModeChanged(Doc::Mode mode)
         m_bottomLabel->setEnabled(true);
         m_tapButton->setEnabled(true);
 
+        /* Follow playback function running/stopped status in case the
+           function is started from another control. refreshState() picks
+           up the changes from the state that the function publishes. */
         if (sliderMode() == Playback)
-        {
-            /* Follow playback function running/stopped status in case the
-               function is started from another control. */
-            Function* function = m_doc->function(playbackFunction());
-            if (function != NULL)
-            {
-                connect(function, SIGNAL(running(quint32)),
-                        this, SLOT(slotPlaybackFunctionRunning(quint32)));
-                connect(function, SIGNAL(stopped(quint32)),
-                        this, SLOT(slotPlaybackFunctionStopped(quint32)));
-                connect(function, SIGNAL(intensityChanged(qreal)),
-                        this, SLOT(slotPlaybackFunctionIntensityChanged(qreal)));
-            }
-        }
+            syncPlaybackFunctionState();
     }
     else
     {
@@ -261,22 +267,6 @@ void VCSlider::slotModeChanged(Doc::Mode mode)
         m_slider->setEnabled(false);
         m_bottomLabel->setEnabled(false);
         m_tapButton->setEnabled(false);
-
-        if (sliderMode() == Playback)
-        {
-            /* Stop following playback function running/stopped status in case
-               the function is changed in Design mode to another. */
-            Function* function = m_doc->function(playbackFunction());
-            if (function != NULL)
-            {
-                disconnect(function, SIGNAL(running(quint32)),
-                        this, SLOT(slotPlaybackFunctionRunning(quint32)));
-                disconnect(function, SIGNAL(stopped(quint32)),
-                        this, SLOT(slotPlaybackFunctionStopped(quint32)));
-                disconnect(function, SIGNAL(intensityChanged(qreal)),
-                        this, SLOT(slotPlaybackFunctionIntensityChanged(qreal)));
-            }
-        }
     }
 
     VCWidget::slotModeChanged(mode);
@@ -419,22 +409,32 @@ void VCSlider::addLevelChannel(quint32 fixture, quint32 channel)
 {
     LevelChannel lch(fixture, channel);
 
+    m_levelValueMutex.lock();
     if (m_levelChannels.contains(lch) == false)
     {
         m_levelChannels.append(lch);
         qSort(m_levelChannels.begin(), m_levelChannels.end());
+        m_levelChannelsChanged = true;
     }
+    m_levelValueMutex.unlock();
 }
 
 void VCSlider::removeLevelChannel(quint32 fixture, quint32 channel)
 {
     LevelChannel lch(fixture, channel);
-    m_levelChannels.removeAll(lch);
+
+    m_levelValueMutex.lock();
+    if (m_levelChannels.removeAll(lch) > 0)
+        m_levelChannelsChanged = true;
+    m_levelValueMutex.unlock();
 }
 
 void VCSlider::clearLevelChannels()
 {
+    m_levelValueMutex.lock();
     m_levelChannels.clear();
+    m_levelChannelsChanged = true;
+    m_levelValueMutex.unlock();
 }
 
 QList <VCSlider::LevelChannel> VCSlider::levelChannels()
@@ -477,13 +477,55 @@ uchar VCSlider::levelValue() const
 
 void VCSlider::slotFixtureRemoved(quint32 fxi_id)
 {
+    m_levelValueMutex.lock();
     QMutableListIterator <LevelChannel> it(m_levelChannels);
     while (it.hasNext() == true)
     {
         it.next();
         if (it.value().fixture == fxi_id)
+        {
             it.remove();
+            m_levelChannelsChanged = true;
+        }
     }
+    m_levelValueMutex.unlock();
+}
+
+/*****************************************************************************
+ * Compiled level channels
+ *****************************************************************************/
+
+void VCSlider::compileLevelChannels(const PatchSnapshot* patch)
+{
+    Q_ASSERT(patch != NULL);
+
+    m_levelIntensityAddresses.clear();
+    m_levelLTPAddresses.clear();
+    m_levelLTPGroups.clear();
+
+    QListIterator <LevelChannel> it(m_levelChannels);
+    while (it.hasNext() == true)
+    {
+        const LevelChannel& lch(it.next());
+        const PatchSnapshot::FixtureInfo* fxi = patch->fixture(lch.fixture);
+        if (fxi == NULL || lch.channel >= quint32(fxi->groups.size()))
+            continue;
+
+        QLCChannel::Group group = fxi->groups.at(lch.channel);
+        int address = int(fxi->address + lch.channel);
+        if (group == QLCChannel::Intensity)
+        {
+            m_levelIntensityAddresses << address;
+        }
+        else
+        {
+            m_levelLTPAddresses << address;
+            m_levelLTPGroups << group;
+        }
+    }
+
+    m_levelChannelsChanged = false;
+    m_levelPatchVersion = patch->version();
 }
 
 /*****************************************************************************
@@ -516,24 +558,55 @@ uchar VCSlider::playbackValue() const
     return m_playbackValue;
 }
 
-void VCSlider::slotPlaybackFunctionRunning(quint32 fid)
+void VCSlider::syncPlaybackFunctionState()
 {
-    Q_UNUSED(fid);
+    Function* function = m_doc->function(playbackFunction());
+    if (function != NULL)
+        m_playbackFunctionState = function->publishedState();
 }
 
-void VCSlider::slotPlaybackFunctionStopped(quint32 fid)
-{
-    m_externalMovement = true;
-    if (fid == playbackFunction())
-        m_slider->setValue(0);
-    m_externalMovement = false;
-}
+/*****************************************************************************
+ * State refresh
+ *****************************************************************************/
 
-void VCSlider::slotPlaybackFunctionIntensityChanged(qreal fraction)
+bool VCSlider::refreshState()
 {
+    if (sliderMode() != Playback || mode() != Doc::Operate)
+        return true;
+
+    Function* function = m_doc->function(playbackFunction());
+    if (function == NULL)
+        return true;
+
+    int state = function->publishedState();
+    if (state == m_playbackFunctionState)
+        return true;
+
+    /* The slider knob only follows the function, so moving it can wait
+       until the slider is seen again */
+    if (isOnScreen() == false)
+        return false;
+
+    int previous = m_playbackFunctionState;
+    m_playbackFunctionState = state;
+
     m_externalMovement = true;
-    m_slider->setValue(int(floor((qreal(m_slider->maximum()) * fraction) + 0.5)));
+    if (Function::stateRunning(state) == false)
+    {
+        if (Function::stateRunning(previous) == true ||
+            Function::stateRunCount(state) != Function::stateRunCount(previous))
+        {
+            m_slider->setValue(0);
+        }
+    }
+    else if (Function::stateIntensity(state) != Function::stateIntensity(previous))
+    {
+        qreal fraction = qreal(Function::stateIntensity(state)) / qreal(UCHAR_MAX);
+        m_slider->setValue(int(floor((qreal(m_slider->maximum()) * fraction) + 0.5)));
+    }
     m_externalMovement = false;
+
+    return true;
 }
 
 /*****************************************************************************
@@ -552,31 +625,25 @@ void VCSlider::writeDMXLevel(MasterTimer* timer, UniverseArray* universes)
 {
     Q_UNUSED(timer);
 
+    const PatchSnapshot* patch = m_doc->patchSnapshot();
+
     m_levelValueMutex.lock();
 
-    QListIterator <LevelChannel> it(m_levelChannels);
-    while (it.hasNext() == true)
-    {
-        LevelChannel lch(it.next());
-        Fixture* fxi = m_doc->fixture(lch.fixture);
-        if (fxi != NULL)
-        {
-            const QLCChannel* qlcch = fxi->channel(lch.channel);
-            if (qlcch == NULL)
-                continue;
+    if (m_levelChannelsChanged == true || m_levelPatchVersion != patch->version())
+        compileLevelChannels(patch);
 
-            if (qlcch->group() != QLCChannel::Intensity &&
-                m_levelValueChanged == false)
-            {
-                /* Value has not changed and this is not an intensity channel.
-                   LTP in effect. */
-                continue;
-            }
+    /* Intensity channels are HTP so they must be written on every tick */
+    universes->fill(m_levelIntensityAddresses, m_levelValue, QLCChannel::Intensity);
 
-            quint32 dmx_ch = fxi->channelAddress(lch.channel);
-            universes->write(dmx_ch, m_levelValue, qlcch->group());
-        }
+    /* Other channels are LTP; write them only when the value has changed */
+    if (m_levelValueChanged == true)
+    {
+        const int* address = m_levelLTPAddresses.constData();
+        const QLCChannel::Group* group = m_levelLTPGroups.constData();
+        for (int i = 0; i < m_levelLTPAddresses.size(); i++)
+            universes->write(address[i], m_levelValue, group[i]);
     }
+
     m_levelValueChanged = false;
     m_levelValueMutex.unlock();
 }
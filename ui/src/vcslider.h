@@ -22,9 +22,11 @@
 #ifndef VCSLIDER_H
 #define VCSLIDER_H
 
+#include <QVector>
 #include <QMutex>
 #include <QList>
 
+#include "qlcchannel.h"
 #include "dmxsource.h"
 #include "vcwidget.h"
 
@@ -37,6 +39,7 @@ class QLabel;
 class QTime;
 
 class VCSliderProperties;
+class PatchSnapshot;
 
 #define KXMLQLCVCSlider "Slider"
 #define KXMLQLCVCSliderMode "SliderMode"
@@ -291,10 +294,36 @@ protected:
     uchar m_levelLowLimit;
     uchar m_levelHighLimit;
 
-    QMutex m_levelValueMutex;
+    QMutex m_levelValueMutex; // Guards also m_levelChannels & compiled channels
     bool m_levelValueChanged;
     uchar m_levelValue;
 
+    /*********************************************************************
+     * Compiled level channels
+     *********************************************************************/
+protected:
+    /**
+     * Resolve m_levelChannels into DMX addresses using the given patch.
+     * writeDMXLevel() does this whenever the level channels or the patch
+     * have changed so that on every other tick it only has to write
+     * values to ready addresses. m_levelValueMutex must be locked.
+     */
+    void compileLevelChannels(const PatchSnapshot* patch);
+
+protected:
+    /** Addresses of intensity level channels */
+    QVector <int> m_levelIntensityAddresses;
+
+    /** Addresses and groups of other (LTP) level channels */
+    QVector <int> m_levelLTPAddresses;
+    QVector <QLCChannel::Group> m_levelLTPGroups;
+
+    /** True when m_levelChannels has changed since the latest compile */
+    bool m_levelChannelsChanged;
+
+    /** Version of the patch snapshot used for the latest compile */
+    quint32 m_levelPatchVersion;
+
     /*********************************************************************
      * Playback
      *********************************************************************/
@@ -329,10 +358,9 @@ public:
      */
     uchar playbackValue() const;
 
-protected slots:
-    void slotPlaybackFunctionRunning(quint32 fid);
-    void slotPlaybackFunctionStopped(quint32 fid);
-    void slotPlaybackFunctionIntensityChanged(qreal fraction);
+protected:
+    /** Remember the playback function's current state as already shown */
+    void syncPlaybackFunctionState();
 
 protected:
     quint32 m_playbackFunction;
@@ -340,6 +368,16 @@ protected:
     bool m_playbackValueChanged;
     QMutex m_playbackValueMutex;
 
+    /** The latest Function::publishedState() that the slider has shown */
+    int m_playbackFunctionState;
+
+    /*********************************************************************
+     * State refresh
+     *********************************************************************/
+public:
+    /** @reimp */
+    bool refreshState();
+
     /*********************************************************************
      * DMXSource
      *********************************************************************/
@@ -93,6 +93,14 @@ VCWidget::VCWidget(QWidget* parent, Doc* doc)
 
 VCWidget::~VCWidget()
 {
+    /* Stop listening to input sources */
+    QHashIterator <quint8,QLCInputSource> it(m_inputs);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        m_doc->inputMap()->unregisterListener(this, it.value().universe(),
+                                              it.value().channel());
+    }
 }
 
 /*****************************************************************************
@@ -123,7 +131,12 @@ bool VCWidget::copyFrom(const VCWidget* widget)
     setGeometry(widget->geometry());
     setCaption(widget->caption());
 
-    m_inputs = widget->m_inputs;
+    QHashIterator <quint8,QLCInputSource> it(widget->m_inputs);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        setInputSource(it.value(), it.key());
+    }
 
     return true;
 }
@@ -382,21 +395,24 @@ void VCWidget::editProperties()
 
 void VCWidget::setInputSource(const QLCInputSource& source, quint8 id)
 {
-    // Connect when the first valid input source is set
-    if (m_inputs.isEmpty() == true && source.isValid() == true)
-        connect(m_doc->inputMap(), SIGNAL(inputValueChanged(quint32,quint32,uchar)),
-                this, SLOT(slotInputValueChanged(quint32,quint32,uchar)));
+    InputMap* inputMap = m_doc->inputMap();
+    Q_ASSERT(inputMap != NULL);
 
-    // Assign or clear
+    // Stop listening to the previous source, unless another id uses it too
+    if (m_inputs.contains(id) == true)
+    {
+        QLCInputSource old = m_inputs.take(id);
+        if (hasInputSource(old) == false)
+            inputMap->unregisterListener(this, old.universe(), old.channel());
+    }
+
+    // Assign and listen to the new source only (not to every input value)
     if (source.isValid() == true)
+    {
+        if (hasInputSource(source) == false)
+            inputMap->registerListener(this, source.universe(), source.channel());
         m_inputs[id] = source;
-    else
-        m_inputs.remove(id);
-
-    // Disconnect when there are no more input sources present
-    if (m_inputs.isEmpty() == true)
-        disconnect(m_doc->inputMap(), SIGNAL(inputValueChanged(quint32,quint32,uchar)),
-                   this, SLOT(slotInputValueChanged(quint32,quint32,uchar)));
+    }
 }
 
 QLCInputSource VCWidget::inputSource(quint8 id) const
@@ -407,6 +423,23 @@ QLCInputSource VCWidget::inputSource(quint8 id) const
         return m_inputs[id];
 }
 
+void VCWidget::inputValueChanged(quint32 universe, quint32 channel, uchar value)
+{
+    slotInputValueChanged(universe, channel, value);
+}
+
+bool VCWidget::hasInputSource(const QLCInputSource& source) const
+{
+    QHashIterator <quint8,QLCInputSource> it(m_inputs);
+    while (it.hasNext() == true)
+    {
+        if (it.next().value() == source)
+            return true;
+    }
+
+    return false;
+}
+
 void VCWidget::slotInputValueChanged(quint32 universe, quint32 channel, uchar value)
 {
     Q_UNUSED(universe);
@@ -707,6 +740,23 @@ Doc::Mode VCWidget::mode() const
     return m_doc->mode();
 }
 
+/*****************************************************************************
+ * State refresh
+ *****************************************************************************/
+
+bool VCWidget::refreshState()
+{
+    return true;
+}
+
+bool VCWidget::isOnScreen() const
+{
+    if (isVisible() == false || window()->isMinimized() == true)
+        return false;
+    else
+        return visibleRegion().isEmpty() == false;
+}
+
 /*****************************************************************************
  * Widget menu
  *****************************************************************************/
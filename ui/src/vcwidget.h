@@ -24,6 +24,8 @@
 
 #include <QKeySequence>
 #include <QWidget>
+
+#include "inputlistener.h"
 #include "doc.h"
 
 class QLCInputSource;
@@ -65,7 +67,7 @@ class QFile;
 #define KXMLQLCWindowStateWidth "Width"
 #define KXMLQLCWindowStateHeight "Height"
 
-class VCWidget : public QWidget
+class VCWidget : public QWidget, public InputListener
 {
     Q_OBJECT
     Q_DISABLE_COPY(VCWidget)
@@ -261,6 +263,13 @@ public:
      */
     QLCInputSource inputSource(quint8 id = 0) const;
 
+    /** @reimp */
+    void inputValueChanged(quint32 universe, quint32 channel, uchar value);
+
+protected:
+    /** Check, whether any input source id has the given source */
+    bool hasInputSource(const QLCInputSource& source) const;
+
 protected slots:
     /**
      * Slot that receives external input data. Overwrite in subclasses to
@@ -358,6 +367,31 @@ protected:
     /** Shortcut for inheritors to check current mode */
     Doc::Mode mode() const;
 
+    /*********************************************************************
+     * State refresh
+     *********************************************************************/
+public:
+    /**
+     * Update the widget to match the state that its functions have
+     * published (see Function::publishedState()). Called periodically in
+     * the UI thread by VCRefreshScheduler for widgets that have registered
+     * to it. The default implementation does nothing.
+     *
+     * Widgets whose refresh is purely visual may postpone it while they
+     * are not on screen (see isOnScreen()). The scheduler calls them again
+     * when the view changes.
+     *
+     * @return false if the refresh was postponed, otherwise true
+     */
+    virtual bool refreshState();
+
+    /**
+     * Check, whether any part of the widget can currently be seen, i.e. it
+     * is not hidden, minimized or scrolled out of the Virtual Console's
+     * view.
+     */
+    bool isOnScreen() const;
+
     /*********************************************************************
      * Widget menu
      *********************************************************************/
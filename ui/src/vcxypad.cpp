@@ -19,10 +19,13 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <math.h>
+
 #include <QTreeWidgetItem>
 #include <QTreeWidget>
 #include <QMouseEvent>
 #include <QMessageBox>
+#include <QMutexLocker>
 #include <QGridLayout>
 #include <QByteArray>
 #include <QPainter>
@@ -214,9 +217,44 @@ void VCXYPad::writeDMX(MasterTimer* timer, UniverseArray* universes)
         qreal x = SCALE(qreal(pt.x()), qreal(0), qreal(m_area->width()), qreal(0), qreal(1));
         qreal y = SCALE(qreal(pt.y()), qreal(0), qreal(m_area->height()), qreal(0), qreal(1));
 
-        /* Write values outside of mutex lock to keep UI snappy */
-        foreach (VCXYPadFixture fixture, m_fixtures)
-            fixture.writeDMX(x, y, universes);
+        /* The UI thread may be recompiling or clearing the output arrays */
+        QMutexLocker locker(&m_outputMutex);
+
+        /* Compute all positions in one pass, same as VCXYPadFixture::writeDMX() */
+        const int fixtures = m_outX.min.size();
+        const qreal* xMin = m_outX.min.constData();
+        const qreal* xRange = m_outX.range.constData();
+        const qreal* xMax = m_outX.max.constData();
+        const bool* xReverse = m_outX.reverse.constData();
+        const qreal* yMin = m_outY.min.constData();
+        const qreal* yRange = m_outY.range.constData();
+        const qreal* yMax = m_outY.max.constData();
+        const bool* yReverse = m_outY.reverse.constData();
+        ushort* position = m_outPositions.data();
+
+        for (int i = 0; i < fixtures; i++)
+        {
+            qreal xmul = (xRange[i] * x) + xMin[i];
+            qreal ymul = (yRange[i] * y) + yMin[i];
+            if (xReverse[i] == true)
+                xmul = xMax[i] - xmul;
+            if (yReverse[i] == true)
+                ymul = yMax[i] - ymul;
+
+            position[i * 2] = ushort(floor((qreal(USHRT_MAX) * xmul) + 0.5));
+            position[(i * 2) + 1] = ushort(floor((qreal(USHRT_MAX) * ymul) + 0.5));
+        }
+
+        /* Split the positions into coarse & fine channel values */
+        const int channels = m_outChannels.size();
+        const int* source = m_outSources.constData();
+        const int* shift = m_outShifts.constData();
+        uchar* value = m_outValues.data();
+
+        for (int i = 0; i < channels; i++)
+            value[i] = uchar(position[source[i]] >> shift[i]);
+
+        universes->write(m_outChannels, m_outValues, m_outGroups);
     }
 }
 
@@ -264,6 +302,75 @@ void VCXYPad::slotSliderValueChanged()
     m_sliderInteraction = false;
 }
 
+/*****************************************************************************
+ * Output
+ *****************************************************************************/
+
+void VCXYPad::compileOutput()
+{
+    clearOutput();
+
+    QMutexLocker locker(&m_outputMutex);
+
+    QListIterator <VCXYPadFixture> it(m_fixtures);
+    while (it.hasNext() == true)
+    {
+        const VCXYPadFixture& fxi(it.next());
+        if (fxi.xMSB() == QLCChannel::invalid() || fxi.yMSB() == QLCChannel::invalid())
+            continue;
+
+        const int position = m_outPositions.size();
+        m_outPositions << 0 << 0;
+        m_outX.append(fxi.xMin(), fxi.xMax(), fxi.xReverse());
+        m_outY.append(fxi.yMin(), fxi.yMax(), fxi.yReverse());
+
+        m_outChannels << int(fxi.xMSB()) << int(fxi.yMSB());
+        m_outGroups << QLCChannel::Pan << QLCChannel::Tilt;
+        m_outSources << position << position + 1;
+        m_outShifts << 8 << 8;
+
+        if (fxi.xLSB() != QLCChannel::invalid() && fxi.yLSB() != QLCChannel::invalid())
+        {
+            m_outChannels << int(fxi.xLSB()) << int(fxi.yLSB());
+            m_outGroups << QLCChannel::Pan << QLCChannel::Tilt;
+            m_outSources << position << position + 1;
+            m_outShifts << 0 << 0;
+        }
+    }
+
+    m_outValues.resize(m_outChannels.size());
+}
+
+void VCXYPad::clearOutput()
+{
+    QMutexLocker locker(&m_outputMutex);
+
+    m_outX.clear();
+    m_outY.clear();
+    m_outPositions.clear();
+    m_outChannels.clear();
+    m_outGroups.clear();
+    m_outValues.clear();
+    m_outSources.clear();
+    m_outShifts.clear();
+}
+
+void VCXYPad::OutputAxis::append(qreal low, qreal high, bool reversed)
+{
+    min << low;
+    range << (high - low);
+    max << high;
+    reverse << reversed;
+}
+
+void VCXYPad::OutputAxis::clear()
+{
+    min.clear();
+    range.clear();
+    max.clear();
+    reverse.clear();
+}
+
 /*****************************************************************************
  * QLC mode
  *****************************************************************************/
@@ -283,6 +390,7 @@ void VCXYPad::slotModeChanged(Doc::Mode mode)
 
     if (mode == Doc::Operate)
     {
+        compileOutput();
         m_doc->masterTimer()->registerDMXSource(this);
         m_vSlider->setEnabled(true);
         m_hSlider->setEnabled(true);
@@ -290,6 +398,7 @@ void VCXYPad::slotModeChanged(Doc::Mode mode)
     else
     {
         m_doc->masterTimer()->unregisterDMXSource(this);
+        clearOutput();
         m_vSlider->setEnabled(false);
         m_hSlider->setEnabled(false);
     }
@@ -24,11 +24,13 @@
 
 #include <QWidget>
 #include <QPixmap>
+#include <QVector>
 #include <QString>
 #include <QMutex>
 #include <QList>
 
 #include "vcxypadfixture.h"
+#include "qlcchannel.h"
 #include "dmxsource.h"
 #include "vcwidget.h"
 
@@ -143,6 +145,56 @@ private:
     bool m_padInteraction;
     bool m_sliderInteraction;
 
+    /*************************************************************************
+     * Output
+     *************************************************************************/
+private:
+    /**
+     * Gather the ranges and channels of all armed fixtures into flat arrays
+     * that writeDMX() can go through without touching the fixture list.
+     * Must be called after the fixtures have been armed and before the pad
+     * is registered as a DMX source.
+     */
+    void compileOutput();
+
+    /** Forget everything gathered by compileOutput() */
+    void clearOutput();
+
+private:
+    /** One axis of all armed fixtures, each parameter in its own array */
+    struct OutputAxis
+    {
+        void append(qreal low, qreal high, bool reversed);
+        void clear();
+
+        QVector <qreal> min;
+        QVector <qreal> range;
+        QVector <qreal> max;
+        QVector <bool> reverse;
+    };
+
+    OutputAxis m_outX;
+    OutputAxis m_outY;
+
+    /** 16bit X & Y position of each armed fixture, interleaved */
+    QVector <ushort> m_outPositions;
+
+    /** Channels written on each change, with their groups & values */
+    QVector <int> m_outChannels;
+    QVector <QLCChannel::Group> m_outGroups;
+    QVector <uchar> m_outValues;
+
+    /** Index to m_outPositions & bit shift that make each channel's value */
+    QVector <int> m_outSources;
+    QVector <int> m_outShifts;
+
+    /**
+     * Guards all of the above. MasterTimer calls writeDMX() without holding
+     * its own lock, so unregisterDMXSource() doesn't guarantee that
+     * writeDMX() has finished.
+     */
+    QMutex m_outputMutex;
+
     /*************************************************************************
      * QLC mode
      *************************************************************************/
@@ -427,12 +427,33 @@ void VCXYPadFixture::writeDMX(qreal xmul, qreal ymul, UniverseArray* universes)
     ushort x = floor((qreal(USHRT_MAX) * xmul) + 0.5);
     ushort y = floor((qreal(USHRT_MAX) * ymul) + 0.5);
 
-    universes->write(m_xMSB, char(x >> 8), QLCChannel::Pan);
-    universes->write(m_yMSB, char(y >> 8), QLCChannel::Tilt);
+    const int channels[] = { int(m_xMSB), int(m_yMSB), int(m_xLSB), int(m_yLSB) };
+    const uchar values[] = { uchar(x >> 8), uchar(y >> 8), uchar(x & 0xFF), uchar(y & 0xFF) };
+    const QLCChannel::Group groups[] = { QLCChannel::Pan, QLCChannel::Tilt,
+                                         QLCChannel::Pan, QLCChannel::Tilt };
 
     if (m_xLSB != QLCChannel::invalid() && m_yLSB != QLCChannel::invalid())
-    {
-        universes->write(m_xLSB, char(x & 0xFF), QLCChannel::Pan);
-        universes->write(m_yLSB, char(y & 0xFF), QLCChannel::Tilt);
-    }
+        universes->write(channels, values, groups, 4);
+    else
+        universes->write(channels, values, groups, 2);
+}
+
+quint32 VCXYPadFixture::xMSB() const
+{
+    return m_xMSB;
+}
+
+quint32 VCXYPadFixture::xLSB() const
+{
+    return m_xLSB;
+}
+
+quint32 VCXYPadFixture::yMSB() const
+{
+    return m_yMSB;
+}
+
+quint32 VCXYPadFixture::yLSB() const
+{
+    return m_yLSB;
 }
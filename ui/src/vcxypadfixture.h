@@ -133,6 +133,18 @@ public:
 
     /** Write the value using x & y multipliers for the actual range */
     void writeDMX(qreal xmul, qreal ymul, UniverseArray* universes);
+
+    /** Get the armed X-axis coarse channel or QLCChannel::invalid() */
+    quint32 xMSB() const;
+
+    /** Get the armed X-axis fine channel or QLCChannel::invalid() */
+    quint32 xLSB() const;
+
+    /** Get the armed Y-axis coarse channel or QLCChannel::invalid() */
+    quint32 yMSB() const;
+
+    /** Get the armed Y-axis fine channel or QLCChannel::invalid() */
+    quint32 yLSB() const;
 };
 
 #endif
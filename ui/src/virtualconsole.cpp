@@ -31,6 +31,7 @@
 #include <QFileDialog>
 #include <QFontDialog>
 #include <QScrollArea>
+#include <QScrollBar>
 #include <QKeyEvent>
 #include <QMdiArea>
 #include <QMenuBar>
@@ -42,6 +43,7 @@
 #include <QtXml>
 
 #include "vcpropertieseditor.h"
+#include "vcrefreshscheduler.h"
 #include "addvcbuttonmatrix.h"
 #include "addvcslidermatrix.h"
 #include "virtualconsole.h"
@@ -74,6 +76,8 @@ VirtualConsole::VirtualConsole(QWidget* parent, Doc* doc)
     : QWidget(parent)
     , m_doc(doc)
 
+    , m_refreshScheduler(NULL)
+
     , m_editAction(EditNone)
     , m_toolbar(NULL)
 
@@ -140,6 +144,9 @@ VirtualConsole::VirtualConsole(QWidget* parent, Doc* doc)
     /* Initialize the singleton */
     s_instance = this;
 
+    /* Widgets register to the scheduler as they are created */
+    m_refreshScheduler = new VCRefreshScheduler(m_doc, this);
+
     /* Main layout */
     new QHBoxLayout(this);
     layout()->setMargin(1);
@@ -195,6 +202,15 @@ void VirtualConsole::createAndShow(QWidget* parent, Doc* doc)
     vc->dockArea()->refreshProperties();
 }
 
+/*****************************************************************************
+ * Refresh scheduler
+ *****************************************************************************/
+
+VCRefreshScheduler* VirtualConsole::refreshScheduler() const
+{
+    return m_refreshScheduler;
+}
+
 /*****************************************************************************
  * Properties
  *****************************************************************************/
@@ -714,6 +730,9 @@ void VirtualConsole::slotAddButtonMatrix()
     int v = abm.verticalCount();
     int sz = abm.buttonSize();
 
+    /* Each new button sets Doc modified; let that happen only once */
+    m_doc->beginBatch();
+
     VCFrame* frame = NULL;
     if (abm.frameStyle() == AddVCButtonMatrix::NormalFrame)
         frame = new VCFrame(parent, m_doc);
@@ -756,6 +775,7 @@ void VirtualConsole::slotAddButtonMatrix()
     m_selectedWidgets << frame;
     updateActions();
     m_doc->setModified();
+    m_doc->endBatch();
 }
 
 void VirtualConsole::slotAddSlider()
@@ -787,6 +807,9 @@ void VirtualConsole::slotAddSliderMatrix()
     int height = avsm.height();
     int count = avsm.amount();
 
+    /* Each new slider sets Doc modified; let that happen only once */
+    m_doc->beginBatch();
+
     VCFrame* frame = new VCFrame(parent, m_doc);
     Q_ASSERT(frame != NULL);
 
@@ -810,6 +833,7 @@ void VirtualConsole::slotAddSliderMatrix()
     m_selectedWidgets << frame;
     updateActions();
     m_doc->setModified();
+    m_doc->endBatch();
 }
 
 void VirtualConsole::slotAddSpeedDial()
@@ -1403,6 +1427,12 @@ void VirtualConsole::initContents()
     m_scrollArea->setAlignment(Qt::AlignCenter);
     m_scrollArea->setWidgetResizable(false);
 
+    /* Widgets that have postponed their refresh may have come into view */
+    connect(m_scrollArea->horizontalScrollBar(), SIGNAL(valueChanged(int)),
+            m_refreshScheduler, SLOT(slotViewChanged()));
+    connect(m_scrollArea->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            m_refreshScheduler, SLOT(slotViewChanged()));
+
     resetContents();
 }
 
@@ -1576,9 +1606,12 @@ bool VirtualConsole::loadXML(const QDomElement& root)
         }
         else if (tag.tagName() == KXMLQLCVCFrame)
         {
-            /* Contents */
+            /* Contents. Don't let each created widget schedule its own
+               repaint; the whole contents are painted once at the end. */
             Q_ASSERT(m_contents != NULL);
+            m_contents->setUpdatesEnabled(false);
             m_contents->loadXML(&tag);
+            m_contents->setUpdatesEnabled(true);
         }
         else
         {
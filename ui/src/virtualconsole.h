@@ -39,6 +39,7 @@ class QDomElement;
 class VCDockArea;
 class QKeyEvent;
 class QToolBar;
+class VCRefreshScheduler;
 class VCWidget;
 class VCFrame;
 class QAction;
@@ -71,6 +72,16 @@ protected:
     static VirtualConsole* s_instance;
     Doc* m_doc;
 
+    /*********************************************************************
+     * Refresh scheduler
+     *********************************************************************/
+public:
+    /** Get the scheduler that keeps widgets in sync with function state */
+    VCRefreshScheduler* refreshScheduler() const;
+
+private:
+    VCRefreshScheduler* m_refreshScheduler;
+
     /*********************************************************************
      * Properties
      *********************************************************************/
@@ -0,0 +1,20 @@
+include(../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = fixturetreemodel_test
+
+QT      += testlib xml gui script
+
+INCLUDEPATH += ../../../plugins/interfaces
+INCLUDEPATH += ../../../engine/src
+INCLUDEPATH += ../../src
+DEPENDPATH  += ../../src
+
+QMAKE_LIBDIR += ../../../engine/src
+QMAKE_LIBDIR += ../../src
+LIBS        += -lqlcengine -lqlcui
+
+# Test sources
+SOURCES += fixturetreemodel_test.cpp
+HEADERS += fixturetreemodel_test.h
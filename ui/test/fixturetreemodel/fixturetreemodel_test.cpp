@@ -0,0 +1,280 @@
+/*
+  Q Light Controller
+  fixturetreemodel_test.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "fixturetreemodel_test.h"
+#include "fixturetreemodel.h"
+#include "fixturegroup.h"
+#include "fixture.h"
+#include "doc.h"
+
+void FixtureTreeModel_Test::init()
+{
+    m_doc = new Doc(this);
+
+    /* Added in reverse address order on purpose */
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setName("Charlie");
+    fxi->setChannels(6);
+    fxi->setAddress(20);
+    m_doc->addFixture(fxi);
+
+    fxi = new Fixture(m_doc);
+    fxi->setName("Bravo");
+    fxi->setChannels(4);
+    fxi->setAddress(10);
+    m_doc->addFixture(fxi);
+
+    fxi = new Fixture(m_doc);
+    fxi->setName("Alpha");
+    fxi->setChannels(2);
+    fxi->setUniverse(1);
+    fxi->setAddress(0);
+    m_doc->addFixture(fxi);
+
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    grp->setName("Group");
+    grp->setSize(QSize(2, 1));
+    m_doc->addFixtureGroup(grp);
+    grp->assignFixture(1);
+    grp->assignFixture(0);
+}
+
+void FixtureTreeModel_Test::cleanup()
+{
+    delete m_doc;
+    m_doc = NULL;
+}
+
+void FixtureTreeModel_Test::initial()
+{
+    FixtureTreeModel model(m_doc);
+    QCOMPARE(model.columnCount(), int(FixtureTreeModel::ColumnCount));
+    QCOMPARE(model.sortColumn(), int(FixtureTreeModel::AddressColumn));
+
+    /* Groups first, "All fixtures" last */
+    QCOMPARE(model.rowCount(), 2);
+    QModelIndex grp = model.index(0, 0);
+    QModelIndex all = model.index(1, 0);
+    QVERIFY(model.isGroup(grp) == true);
+    QVERIFY(model.isAllFixtures(grp) == false);
+    QCOMPARE(model.groupId(grp), quint32(0));
+    QCOMPARE(model.data(grp).toString(), QString("Group"));
+    QVERIFY(model.isGroup(all) == false);
+    QVERIFY(model.isAllFixtures(all) == true);
+    QCOMPARE(model.groupId(all), FixtureGroup::invalidId());
+    QCOMPARE(model.fixtureId(all), Fixture::invalidId());
+
+    QVERIFY(model.isGroup(QModelIndex()) == false);
+    QVERIFY(model.isAllFixtures(QModelIndex()) == false);
+    QCOMPARE(model.groupId(QModelIndex()), FixtureGroup::invalidId());
+    QCOMPARE(model.fixtureId(QModelIndex()), Fixture::invalidId());
+}
+
+void FixtureTreeModel_Test::fetch()
+{
+    FixtureTreeModel model(m_doc);
+    QModelIndex all = model.groupIndex(FixtureGroup::invalidId());
+    QVERIFY(all.isValid() == true);
+
+    /* Children are created only when they are first needed */
+    QVERIFY(model.hasChildren(all) == true);
+    QVERIFY(model.canFetchMore(all) == true);
+    QCOMPARE(model.rowCount(all), 0);
+
+    model.fetchMore(all);
+    QVERIFY(model.canFetchMore(all) == false);
+    QCOMPARE(model.rowCount(all), 3);
+
+    /* Sorted by address, then by universe */
+    QCOMPARE(model.fixtureId(model.index(0, 0, all)), quint32(2));
+    QCOMPARE(model.fixtureId(model.index(1, 0, all)), quint32(1));
+    QCOMPARE(model.fixtureId(model.index(2, 0, all)), quint32(0));
+    QCOMPARE(model.groupId(model.index(0, 0, all)), FixtureGroup::invalidId());
+    QCOMPARE(model.data(model.index(1, FixtureTreeModel::NameColumn, all)).toString(), QString("Bravo"));
+    QCOMPARE(model.data(model.index(1, FixtureTreeModel::UniverseColumn, all)).toString(), QString("1"));
+    QCOMPARE(model.data(model.index(1, FixtureTreeModel::AddressColumn, all)).toString(), QString("011 - 014"));
+    QCOMPARE(model.data(model.index(0, FixtureTreeModel::UniverseColumn, all)).toString(), QString("2"));
+
+    /* fixtureIndex() fetches on its own */
+    QModelIndex grp = model.groupIndex(0);
+    QVERIFY(model.canFetchMore(grp) == true);
+    QModelIndex index = model.fixtureIndex(0, 0);
+    QVERIFY(index.isValid() == true);
+    QVERIFY(model.canFetchMore(grp) == false);
+    QCOMPARE(index.parent(), grp);
+    QCOMPARE(index.row(), 1);
+    QCOMPARE(model.groupId(index), quint32(0));
+
+    QVERIFY(model.fixtureIndex(2, 0).isValid() == false);
+    QVERIFY(model.fixtureIndex(42).isValid() == false);
+}
+
+void FixtureTreeModel_Test::sort()
+{
+    FixtureTreeModel model(m_doc);
+    QModelIndex all = model.groupIndex(FixtureGroup::invalidId());
+    model.fetchMore(all);
+
+    QPersistentModelIndex alpha(model.fixtureIndex(2));
+    QCOMPARE(alpha.row(), 0);
+
+    model.sort(FixtureTreeModel::UniverseColumn, Qt::AscendingOrder);
+    QCOMPARE(model.fixtureId(model.index(0, 0, all)), quint32(1));
+    QCOMPARE(model.fixtureId(model.index(1, 0, all)), quint32(0));
+    QCOMPARE(model.fixtureId(model.index(2, 0, all)), quint32(2));
+    QCOMPARE(alpha.row(), 2);
+
+    model.sort(FixtureTreeModel::NameColumn, Qt::AscendingOrder);
+    QCOMPARE(model.fixtureId(model.index(0, 0, all)), quint32(2));
+    QCOMPARE(model.fixtureId(model.index(1, 0, all)), quint32(1));
+    QCOMPARE(model.fixtureId(model.index(2, 0, all)), quint32(0));
+    QCOMPARE(alpha.row(), 0);
+
+    model.sort(FixtureTreeModel::NameColumn, Qt::DescendingOrder);
+    QCOMPARE(model.fixtureId(model.index(0, 0, all)), quint32(0));
+    QCOMPARE(model.fixtureId(model.index(2, 0, all)), quint32(2));
+    QCOMPARE(alpha.row(), 2);
+
+    /* "All fixtures" stays last among the top level items */
+    QVERIFY(model.isAllFixtures(model.index(1, 0)) == true);
+}
+
+void FixtureTreeModel_Test::fixtureSignals()
+{
+    FixtureTreeModel model(m_doc);
+    QModelIndex all = model.groupIndex(FixtureGroup::invalidId());
+    model.fetchMore(all);
+
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(const QModelIndex&,int,int)));
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(const QModelIndex&,int,int)));
+    QSignalSpy reset(&model, SIGNAL(modelReset()));
+
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setName("Delta");
+    fxi->setChannels(1);
+    fxi->setAddress(15);
+    m_doc->addFixture(fxi);
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(model.rowCount(all), 4);
+    QCOMPARE(model.fixtureIndex(fxi->id()).row(), 2);
+
+    /* Moving the fixture moves its row */
+    fxi->setAddress(400);
+    QCOMPARE(model.fixtureIndex(fxi->id()).row(), 3);
+
+    m_doc->deleteFixture(fxi->id());
+    QCOMPARE(removed.size(), 1);
+    QCOMPARE(model.rowCount(all), 3);
+    QVERIFY(model.fixtureIndex(3).isValid() == false);
+
+    /* Removing a grouped fixture removes it from the group, too */
+    model.fetchMore(model.groupIndex(0));
+    m_doc->deleteFixture(0);
+    QCOMPARE(model.rowCount(all), 2);
+    QCOMPARE(model.rowCount(model.groupIndex(0)), 1);
+
+    QCOMPARE(reset.size(), 0);
+}
+
+void FixtureTreeModel_Test::groupSignals()
+{
+    FixtureTreeModel model(m_doc);
+    QCOMPARE(model.rowCount(), 2);
+
+    FixtureGroup* grp = new FixtureGroup(m_doc);
+    grp->setName("Another");
+    grp->setSize(QSize(1, 1));
+    m_doc->addFixtureGroup(grp);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.groupIndex(grp->id()).row(), 0);
+
+    grp->assignFixture(2);
+    QModelIndex index = model.groupIndex(grp->id());
+    QVERIFY(model.hasChildren(index) == true);
+    QCOMPARE(model.fixtureIndex(2, grp->id()).isValid(), true);
+
+    /* Renaming moves the group */
+    grp->setName("Zulu");
+    QCOMPARE(model.groupIndex(grp->id()).row(), 1);
+    QCOMPARE(model.data(model.groupIndex(grp->id())).toString(), QString("Zulu"));
+
+    grp->resignFixture(2);
+    QCOMPARE(model.rowCount(model.groupIndex(grp->id())), 0);
+
+    m_doc->deleteFixtureGroup(grp->id());
+    QCOMPARE(model.rowCount(), 2);
+    QVERIFY(model.isAllFixtures(model.index(1, 0)) == true);
+}
+
+void FixtureTreeModel_Test::batch()
+{
+    FixtureTreeModel model(m_doc);
+    QModelIndex all = model.groupIndex(FixtureGroup::invalidId());
+    model.fetchMore(all);
+
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(const QModelIndex&,int,int)));
+    QSignalSpy reset(&model, SIGNAL(modelReset()));
+
+    m_doc->beginBatch();
+    for (int i = 0; i < 3; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setChannels(1);
+        fxi->setAddress(100 + i);
+        m_doc->addFixture(fxi);
+    }
+
+    /* Nothing happens until the batch is over */
+    QCOMPARE(inserted.size(), 0);
+    QCOMPARE(model.rowCount(all), 3);
+
+    m_doc->endBatch();
+    QCOMPARE(inserted.size(), 3);
+    QCOMPARE(reset.size(), 0);
+    QCOMPARE(model.rowCount(all), 6);
+}
+
+void FixtureTreeModel_Test::batchRefresh()
+{
+    FixtureTreeModel model(m_doc);
+    QSignalSpy reset(&model, SIGNAL(modelReset()));
+
+    m_doc->beginBatch();
+    for (int i = 0; i <= FixtureTreeModel::incrementalLimit(); i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setChannels(1);
+        fxi->setAddress(100 + i);
+        m_doc->addFixture(fxi);
+    }
+    m_doc->endBatch();
+
+    /* Large batches rebuild the model in one go */
+    QCOMPARE(reset.size(), 1);
+    QModelIndex all = model.groupIndex(FixtureGroup::invalidId());
+    model.fetchMore(all);
+    QCOMPARE(model.rowCount(all), 4 + FixtureTreeModel::incrementalLimit());
+}
+
+QTEST_MAIN(FixtureTreeModel_Test)
@@ -0,0 +1,20 @@
+include(../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = monitorcanvas_test
+
+QT      += testlib xml gui script
+
+INCLUDEPATH += ../../../plugins/interfaces
+INCLUDEPATH += ../../../engine/src
+INCLUDEPATH += ../../src
+DEPENDPATH  += ../../src
+
+QMAKE_LIBDIR += ../../../engine/src
+QMAKE_LIBDIR += ../../src
+LIBS        += -lqlcengine -lqlcui
+
+# Test sources
+SOURCES += monitorcanvas_test.cpp
+HEADERS += monitorcanvas_test.h
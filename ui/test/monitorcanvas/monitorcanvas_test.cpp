@@ -0,0 +1,223 @@
+/*
+  Q Light Controller
+  monitorcanvas_test.cpp
+
+  Copyright (C) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QScrollBar>
+#include <QPixmap>
+#include <QtTest>
+
+#define protected public
+#define private public
+#include "monitorcanvas.h"
+#undef protected
+#undef private
+
+#include "monitorcanvas_test.h"
+#include "fixture.h"
+#include "doc.h"
+
+void MonitorCanvas_Test::initTestCase()
+{
+    m_doc = new Doc(this);
+
+    /* Added in reverse address order on purpose */
+    Fixture* fxi = new Fixture(m_doc);
+    fxi->setName("Third");
+    fxi->setChannels(6);
+    fxi->setUniverse(1);
+    fxi->setAddress(0);
+    m_doc->addFixture(fxi);
+
+    fxi = new Fixture(m_doc);
+    fxi->setName("Second");
+    fxi->setChannels(4);
+    fxi->setAddress(100);
+    m_doc->addFixture(fxi);
+
+    fxi = new Fixture(m_doc);
+    fxi->setName("First");
+    fxi->setChannels(2);
+    fxi->setAddress(10);
+    m_doc->addFixture(fxi);
+}
+
+void MonitorCanvas_Test::cleanupTestCase()
+{
+    delete m_doc;
+    m_doc = NULL;
+}
+
+void MonitorCanvas_Test::initial()
+{
+    MonitorCanvas mc(NULL, m_doc);
+    QCOMPARE(mc.m_channelStyle, Monitor::DMXChannels);
+    QCOMPARE(mc.m_valueStyle, Monitor::DMXValues);
+    QCOMPARE(mc.zoom(), qreal(1.0));
+    QVERIFY(mc.m_digitWidth > 0);
+    QVERIFY(mc.m_lineHeight > 0);
+    QCOMPARE(mc.m_digits.width(), 10 * mc.m_digitWidth);
+    QCOMPARE(mc.m_digits.height(), 2 * mc.m_lineHeight);
+    QVERIFY(mc.m_values.isEmpty() == true);
+}
+
+void MonitorCanvas_Test::rebuild()
+{
+    MonitorCanvas mc(NULL, m_doc);
+    QCOMPARE(mc.m_boxes.size(), 3);
+
+    /* Sorted by address */
+    QCOMPARE(mc.m_boxes[0].name, QString("First"));
+    QCOMPARE(mc.m_boxes[0].universeAddress, quint32(10));
+    QCOMPARE(mc.m_boxes[0].channels, quint32(2));
+    QCOMPARE(mc.m_boxes[1].name, QString("Second"));
+    QCOMPARE(mc.m_boxes[1].universeAddress, quint32(100));
+    QCOMPARE(mc.m_boxes[2].name, QString("Third"));
+    QCOMPARE(mc.m_boxes[2].address, quint32(0));
+    QCOMPARE(mc.m_boxes[2].universeAddress, quint32(512));
+
+    QCOMPARE(mc.m_addressIndex.size(), int(m_doc->outputMap()->universes() * 512));
+    QVERIFY(mc.m_addressIndex[9].isEmpty() == true);
+    QCOMPARE(mc.m_addressIndex[10], QList <int> () << 0);
+    QCOMPARE(mc.m_addressIndex[11], QList <int> () << 0);
+    QVERIFY(mc.m_addressIndex[12].isEmpty() == true);
+    QCOMPARE(mc.m_addressIndex[103], QList <int> () << 1);
+    QVERIFY(mc.m_addressIndex[104].isEmpty() == true);
+    QCOMPARE(mc.m_addressIndex[517], QList <int> () << 2);
+    QVERIFY(mc.m_addressIndex[518].isEmpty() == true);
+}
+
+void MonitorCanvas_Test::overlap()
+{
+    Doc doc(this);
+
+    Fixture* fxi = new Fixture(&doc);
+    fxi->setChannels(4);
+    fxi->setAddress(0);
+    doc.addFixture(fxi);
+
+    fxi = new Fixture(&doc);
+    fxi->setChannels(4);
+    fxi->setAddress(2);
+    doc.addFixture(fxi);
+
+    /* Both boxes must show the overlapping addresses */
+    MonitorCanvas mc(NULL, &doc);
+    QCOMPARE(mc.m_boxes.size(), 2);
+    QCOMPARE(mc.m_addressIndex[1], QList <int> () << 0);
+    QCOMPARE(mc.m_addressIndex[2], QList <int> () << 0 << 1);
+    QCOMPARE(mc.m_addressIndex[3], QList <int> () << 0 << 1);
+    QCOMPARE(mc.m_addressIndex[4], QList <int> () << 1);
+    QVERIFY(mc.m_addressIndex[6].isEmpty() == true);
+}
+
+void MonitorCanvas_Test::layout()
+{
+    MonitorCanvas mc(NULL, m_doc);
+
+    /* Wide enough for everything in one row */
+    mc.viewport()->resize(2000, 500);
+    mc.doLayout();
+    QCOMPARE(mc.m_rows.size(), 1);
+    QCOMPARE(mc.m_rows[0].first, 0);
+    QCOMPARE(mc.m_rows[0].last, 2);
+    QVERIFY(mc.m_boxes[0].rect.right() < mc.m_boxes[1].rect.left());
+    QVERIFY(mc.m_boxes[1].rect.right() < mc.m_boxes[2].rect.left());
+    QCOMPARE(mc.m_boxes[0].rect.width(), 2 * mc.m_cellWidth + 2 * mc.m_margin);
+
+    /* Too narrow for anything but one fixture per row */
+    mc.viewport()->resize(10, 500);
+    mc.doLayout();
+    QCOMPARE(mc.m_rows.size(), 3);
+    for (int i = 0; i < 3; i++)
+    {
+        QCOMPARE(mc.m_rows[i].first, i);
+        QCOMPARE(mc.m_rows[i].last, i);
+        QCOMPARE(mc.m_rows[i].top, mc.m_boxes[i].rect.top());
+        QCOMPARE(mc.m_rows[i].bottom, mc.m_boxes[i].rect.bottom());
+    }
+    QVERIFY(mc.m_contentSize.height() > mc.m_boxes[2].rect.bottom());
+    QVERIFY(mc.horizontalScrollBar()->maximum() > 0);
+
+    /* Value cells are below channel number cells */
+    QRect number(mc.cellRect(mc.m_boxes[1], 2, false));
+    QRect value(mc.cellRect(mc.m_boxes[1], 2, true));
+    QCOMPARE(number.x(), value.x());
+    QCOMPARE(value.y(), number.y() + mc.m_lineHeight);
+    QVERIFY(mc.m_boxes[1].rect.contains(value) == true);
+}
+
+void MonitorCanvas_Test::zoom()
+{
+    MonitorCanvas mc(NULL, m_doc);
+    int cellWidth = mc.m_cellWidth;
+
+    mc.zoomIn();
+    QVERIFY(mc.zoom() > 1.0);
+    QVERIFY(mc.m_cellWidth > cellWidth);
+
+    mc.setZoom(100);
+    QCOMPARE(mc.zoom(), qreal(4.0));
+    mc.setZoom(0);
+    QCOMPARE(mc.zoom(), qreal(0.5));
+
+    mc.setZoom(1.0);
+    QCOMPARE(mc.m_cellWidth, cellWidth);
+}
+
+void MonitorCanvas_Test::values()
+{
+    MonitorCanvas mc(NULL, m_doc);
+
+    QByteArray ba(4 * 512, 0);
+    ba[10] = 127;
+    ba[600] = 1;
+    mc.setValues(ba, QList <quint32> () << 10 << 600 << 5000);
+    QCOMPARE(mc.m_values, ba);
+
+    QCOMPARE(mc.displayValue(0), 0);
+    QCOMPARE(mc.displayValue(127), 127);
+    QCOMPARE(mc.displayValue(255), 255);
+
+    mc.slotValueStyleChanged(Monitor::PercentageValues);
+    QCOMPARE(mc.displayValue(0), 0);
+    QCOMPARE(mc.displayValue(127), 50);
+    QCOMPARE(mc.displayValue(255), 100);
+}
+
+void MonitorCanvas_Test::paint()
+{
+    MonitorCanvas mc(NULL, m_doc);
+    mc.viewport()->resize(300, 200);
+    mc.doLayout();
+    mc.setValues(QByteArray(4 * 512, char(200)), QList <quint32> () << 10);
+
+    /* Painting visits only visible boxes; just make sure it works in all
+       styles and at any scroll position */
+    QPixmap pm = QPixmap::grabWidget(mc.viewport());
+    QVERIFY(pm.isNull() == false);
+
+    mc.slotChannelStyleChanged(Monitor::RelativeChannels);
+    mc.slotValueStyleChanged(Monitor::PercentageValues);
+    mc.verticalScrollBar()->setValue(mc.verticalScrollBar()->maximum());
+    pm = QPixmap::grabWidget(mc.viewport());
+    QVERIFY(pm.isNull() == false);
+}
+
+QTEST_MAIN(MonitorCanvas_Test)
@@ -3,6 +3,8 @@ SUBDIRS += aboutbox
 SUBDIRS += assignhotkey
 SUBDIRS += addfixture
 SUBDIRS += efxpreviewarea
+SUBDIRS += fixturetreemodel
+SUBDIRS += monitorcanvas
 SUBDIRS += monitorfixture
 SUBDIRS += vcbutton
 SUBDIRS += vccuelist
@@ -493,6 +493,10 @@ void VCButton_Test::toggle()
     btn.setAdjustIntensity(true);
     btn.setIntensityAdjustment(0.2);
 
+    /* The stop blink is shown only on screen */
+    w.show();
+    btn.show();
+
     // Mouse button press in design mode doesn't toggle the function
     QCOMPARE(m_doc->mode(), Doc::Design);
     QMouseEvent ev(QEvent::MouseButtonPress, QPoint(0, 0), Qt::LeftButton, 0, 0);
@@ -511,6 +515,8 @@ void VCButton_Test::toggle()
     btn.slotKeyReleased(QKeySequence(keySequenceB));
     m_doc->masterTimer()->timerTick(); // Allow MasterTimer to take the function under execution
     QCOMPARE(sc->stopped(), false);
+    QCOMPARE(btn.isOn(), false);
+    btn.refreshState();
     QCOMPARE(btn.isOn(), true);
 
     ev = QMouseEvent(QEvent::MouseButtonPress, QPoint(0, 0), Qt::LeftButton, 0, 0);
@@ -518,7 +524,9 @@ void VCButton_Test::toggle()
     QCOMPARE(sc->m_stop, true);
     QCOMPARE(btn.isOn(), true);
 
-    btn.slotFunctionStopped(sc->id());
+    m_doc->masterTimer()->timerTick(); // Allow MasterTimer to stop the function
+    QCOMPARE(btn.isOn(), true);
+    btn.refreshState();
     QCOMPARE(btn.isOn(), false);
     VCButton another(&w, m_doc);
     QVERIFY(btn.palette().color(QPalette::Button) != another.palette().color(QPalette::Button));
@@ -561,8 +569,13 @@ void VCButton_Test::flash()
     QCOMPARE(spy[1][0].toUInt(), sc->id());
     QCOMPARE(spy[1][1].toBool(), false);
 
-    btn.slotFunctionFlashing(sc->id() + 1, true);
+    /* Flashing some other function doesn't concern the button */
+    Scene* other = new Scene(m_doc);
+    m_doc->addFunction(other);
+    other->flash(m_doc->masterTimer());
+    btn.refreshState();
     QCOMPARE(btn.isOn(), false);
+    other->unFlash(m_doc->masterTimer());
 
     m_doc->setMode(Doc::Design);
 }
@@ -612,6 +625,7 @@ void VCButton_Test::input()
 
     btn.slotInputValueChanged(0, 0, 255);
     m_doc->masterTimer()->timerTick();
+    btn.refreshState();
     QCOMPARE(btn.isOn(), true);
     QCOMPARE(sc->intensity(), btn.intensityAdjustment());
 
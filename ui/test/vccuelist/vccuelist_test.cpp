@@ -763,6 +763,10 @@ void VCCueList_Test::keyboardNextPrevious()
     c->setDuration(Function::infiniteSpeed());
     cl.setChaser(c->id());
 
+    /* The selection follows the runner only while the list is on screen */
+    w.show();
+    cl.show();
+
     cl.setNextKeySequence(QKeySequence(keySequenceB));
     cl.setPreviousKeySequence(QKeySequence(keySequenceA));
     cl.setStopKeySequence(QKeySequence(keySequenceD));
@@ -774,42 +778,49 @@ void VCCueList_Test::keyboardNextPrevious()
     // Next keyboard key
     cl.slotKeyPressed(QKeySequence(keySequenceB));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 0);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 0);
 
     // Next keyboard key
     cl.slotKeyPressed(QKeySequence(keySequenceB));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 1);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 1);
 
     // Unrecognized keyboard key
     cl.slotKeyPressed(QKeySequence(QKeySequence::SelectAll));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 1);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 1);
 
     // Previous keyboard key
     cl.slotKeyPressed(QKeySequence(keySequenceA));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 0);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 0);
 
     // Previous keyboard key
     cl.slotKeyPressed(QKeySequence(keySequenceA));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 3);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 3);
 
     // Next keyboard key
     cl.slotKeyPressed(QKeySequence(keySequenceB));
     timer->timerTick();
+    cl.refreshState();
     QCOMPARE(cl.m_runner->currentStep(), 0);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), 0);
 
     // Stop
     cl.slotKeyPressed(QKeySequence(keySequenceD));
     timer->timerTick();
+    cl.refreshState();
     QVERIFY(cl.m_runner == NULL);
     QCOMPARE(cl.m_tree->indexOfTopLevelItem(cl.m_tree->currentItem()), -1);
 }
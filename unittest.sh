@@ -59,6 +59,20 @@ do
     fi
 done
 
+#############################################################################
+# Headless engine tests
+#############################################################################
+
+pushd .
+cd headless/test
+./test.sh
+RESULT=$?
+if [ $RESULT != 0 ]; then
+    echo "${RESULT} Headless engine unit tests failed. Please fix before commit."
+    exit $RESULT
+fi
+popd
+
 #############################################################################
 # Enttec wing tests
 #############################################################################
@@ -105,6 +119,20 @@ if [ $RESULT != 0 ]; then
 fi
 popd
 
+#############################################################################
+# MIDI Output tests
+#############################################################################
+
+pushd .
+cd plugins/midiout/test
+./midiout_test
+RESULT=$?
+if [ $RESULT != 0 ]; then
+    echo "MIDI Output unit test failed ($RESULT). Please fix before commit."
+    exit $RESULT
+fi
+popd
+
 #############################################################################
 # Final judgment
 #############################################################################